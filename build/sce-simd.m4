@@ -0,0 +1,42 @@
+dnl SCE_CHECK_SIMD
+dnl --------------
+dnl Checks whether the compiler builds SSSE3, AVX2 and F16C functions
+dnl without the matching -m flags, and provides cpuid.h, then the SIMD
+dnl kernels are chosen at run time. Defines SCE_SIMD_CFLAGS
+AC_DEFUN([SCE_CHECK_SIMD],
+[
+    AC_ARG_ENABLE([simd_dispatch],
+                  AS_HELP_STRING([--disable-simd-dispatch],
+                                 [only build the SIMD kernels enabled by the compiler flags @<:@default=no@:>@]),
+                  [enable_simd_dispatch="$enableval"],
+                  [enable_simd_dispatch="yes"])
+
+    SCE_SIMD_CFLAGS=
+
+    AS_IF([test "x$enable_simd_dispatch" = "xyes"],
+    [
+        AC_MSG_CHECKING([for per function SIMD targets])
+        AC_COMPILE_IFELSE(
+            [AC_LANG_PROGRAM([[
+#include <immintrin.h>
+#include <cpuid.h>
+__attribute__ ((target ("ssse3")))
+static __m128i f (__m128i a, __m128i m) { return _mm_shuffle_epi8 (a, m); }
+__attribute__ ((target ("avx2")))
+static __m256i g (__m256i a, __m256i m) { return _mm256_shuffle_epi8 (a, m); }
+__attribute__ ((target ("avx,f16c")))
+static __m256 h (__m128i a) { return _mm256_cvtph_ps (a); }
+]], [[
+unsigned int a, b, c, d;
+__get_cpuid (1, &a, &b, &c, &d);
+__cpuid_count (7, 0, a, b, c, d);
+(void)f; (void)g; (void)h;
+]])],
+            [SCE_SIMD_CFLAGS="-DSCE_SIMD_DISPATCH"
+             AC_MSG_RESULT([yes])],
+            [enable_simd_dispatch="no"
+             AC_MSG_RESULT([no])])
+    ])
+
+    AC_SUBST([SCE_SIMD_CFLAGS])
+])
@@ -0,0 +1,127 @@
+/*------------------------------------------------------------------------------
+    SCEngine - A 3D real time rendering engine written in the C language
+    Copyright (C) 2006-2013  Antony Martin <martin(dot)antony(at)yahoo(dot)fr>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/* created: 19/10/2026
+   updated: 19/10/2026 */
+
+#ifndef SCERATLAS_H
+#define SCERATLAS_H
+
+#include <SCE/utils/SCEUtils.h>
+#include <SCE/core/SCECore.h>
+#include "SCE/renderer/SCERTexture.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \ingroup atlas
+ * @{
+ */
+
+typedef struct sce_ratlas SCE_RAtlas;
+typedef struct sce_ratlaspage SCE_RAtlasPage;
+
+/** \copydoc sce_ratlasentry */
+typedef struct sce_ratlasentry SCE_RAtlasEntry;
+/**
+ * \brief An image packed into an atlas
+ *
+ * Texture coordinates of the image map to the atlas with
+ * uv * \c scale + \c offset. They change when the atlas is repacked.
+ */
+struct sce_ratlasentry {
+    SCE_RAtlasPage *page;       /**< Page holding the image */
+    int x, y;                   /**< Position of the padded rectangle */
+    int w, h;                   /**< Size of the image */
+    int pw, ph;                 /**< Size of the padded rectangle */
+    float scale[2];             /**< Texture coordinates scale */
+    float offset[2];            /**< Texture coordinates offset */
+    unsigned char *pixels;      /**< Padded copy of the image, for repacking */
+    SCE_SListIterator it;       /**< Own iterator, list of the page */
+};
+
+/** \brief A segment of the skyline of a page */
+typedef struct {
+    int x, y, w;
+} SCE_RSkylineNode;
+
+/**
+ * \brief A page of an atlas: a 2D texture or a layer of the array texture
+ */
+struct sce_ratlaspage {
+    SCE_RAtlas *atlas;          /**< Atlas of the page */
+    SCE_RTexture *tex;          /**< Texture of the page */
+    int layer;                  /**< Layer in \c tex */
+    SCE_RSkylineNode *nodes;    /**< Skyline, sorted by x */
+    int n_nodes;                /**< Number of nodes */
+    size_t used;                /**< Area of the packed rectangles */
+    SCE_SList entries;          /**< SCE_RAtlasEntry */
+    int dirty;                  /**< Have the mipmaps to be regenerated? */
+    SCE_SListIterator it;
+};
+
+/**
+ * \brief A texture atlas manager
+ */
+struct sce_ratlas {
+    int width, height;          /**< Size of the pages */
+    SCE_EPixelFormat pxf;       /**< Pixel format of the textures */
+    SCE_EImageFormat fmt;       /**< Format of the images */
+    SCE_EType type;             /**< Type of the components of the images */
+    size_t pixel_size;          /**< Size of a pixel of the images */
+    int padding;                /**< Border replicated around each image */
+    int align;                  /**< Alignment of the padded rectangles */
+    int use_mipmap;             /**< Do the pages have mipmaps? */
+    int max_layers;             /**< Layers of the array texture, 0 when
+                                 * each page is a 2D texture */
+    SCE_RTexture *array;        /**< Array texture when \c max_layers > 0 */
+    SCE_SList pages;            /**< SCE_RAtlasPage */
+    int n_pages;                /**< Number of pages */
+    float repack_threshold;     /**< Wasted fraction of a page above which
+                                 * it is repacked */
+};
+
+/** @} */
+
+void SCE_RInitAtlas (SCE_RAtlas*);
+void SCE_RClearAtlas (SCE_RAtlas*);
+SCE_RAtlas* SCE_RCreateAtlas (void);
+void SCE_RDeleteAtlas (SCE_RAtlas*);
+
+void SCE_RSetAtlasPadding (SCE_RAtlas*, int, int);
+void SCE_RSetAtlasMipmapping (SCE_RAtlas*, int);
+void SCE_RSetAtlasRepackThreshold (SCE_RAtlas*, float);
+int SCE_RBuildAtlas (SCE_RAtlas*, int, int, SCE_EPixelFormat,
+                     SCE_EImageFormat, SCE_EType, int);
+
+SCE_RAtlasEntry* SCE_RAddAtlasEntry (SCE_RAtlas*, int, int, const void*);
+void SCE_RUpdateAtlasEntry (SCE_RAtlasEntry*, const void*);
+void SCE_RRemoveAtlasEntry (SCE_RAtlasEntry*);
+SCE_RTexture* SCE_RGetAtlasEntryTexture (SCE_RAtlasEntry*);
+int SCE_RGetAtlasEntryLayer (SCE_RAtlasEntry*);
+
+void SCE_RUpdateAtlas (SCE_RAtlas*);
+unsigned int SCE_RRepackAtlas (SCE_RAtlas*, unsigned long);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* guard */
@@ -0,0 +1,73 @@
+/*------------------------------------------------------------------------------
+    SCEngine - A 3D real time rendering engine written in the C language
+    Copyright (C) 2006-2013  Antony Martin <martin(dot)antony(at)yahoo(dot)fr>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/* created: 19/10/2026
+   updated: 19/10/2026 */
+
+#ifndef SCERCOMPRESS_H
+#define SCERCOMPRESS_H
+
+#include <SCE/utils/SCEUtils.h>
+#include <SCE/core/SCECore.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \ingroup compress
+ * @{
+ */
+
+/**
+ * \brief Block compression formats
+ */
+enum sce_rblockformat {
+    SCE_BC1,                    /**< RGB, 4 bits per pixel (DXT1) */
+    SCE_BC2,                    /**< RGB + explicit alpha, 8 bpp (DXT3) */
+    SCE_BC3,                    /**< RGB + interpolated alpha, 8 bpp (DXT5) */
+    SCE_BC4,                    /**< One channel, 4 bpp (RGTC1) */
+    SCE_BC5,                    /**< Two channels, 8 bpp (RGTC2, 3DC) */
+    SCE_NUM_BLOCK_FORMATS
+};
+/** \copydoc sce_rblockformat */
+typedef enum sce_rblockformat SCE_RBlockFormat;
+
+/**
+ * \brief Trade-off between encoding speed and quality
+ */
+enum sce_rcompressquality {
+    SCE_COMPRESS_FAST,          /**< Bounding box endpoints */
+    SCE_COMPRESS_NORMAL,        /**< Principal axis endpoints, one refinement */
+    SCE_COMPRESS_HIGH           /**< Iterative refinement, all block modes */
+};
+/** \copydoc sce_rcompressquality */
+typedef enum sce_rcompressquality SCE_RCompressQuality;
+
+/** @} */
+
+size_t SCE_RGetCompressedSize (int, int, SCE_RBlockFormat);
+int SCE_RGetPxfBlockFormat (SCE_EPixelFormat, SCE_RBlockFormat*);
+int SCE_RCompressImage (const void*, int, int, SCE_EImageFormat,
+                        SCE_RBlockFormat, SCE_RCompressQuality, void*);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* guard */
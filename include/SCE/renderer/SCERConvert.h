@@ -0,0 +1,59 @@
+/*------------------------------------------------------------------------------
+    SCEngine - A 3D real time rendering engine written in the C language
+    Copyright (C) 2006-2013  Antony Martin <martin(dot)antony(at)yahoo(dot)fr>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/* created: 19/10/2026
+   updated: 19/10/2026 */
+
+#ifndef SCERCONVERT_H
+#define SCERCONVERT_H
+
+#include <SCE/utils/SCEUtils.h>
+#include <SCE/core/SCECore.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \ingroup convert
+ * @{
+ */
+
+/** Multiply the color components by the alpha component */
+#define SCE_CONVERT_PREMULTIPLY 1
+
+/** @} */
+
+float SCE_RHalfToFloat (unsigned short);
+unsigned short SCE_RFloatToHalf (float);
+void SCE_RFloatToHalfRow (const float*, unsigned short*, size_t);
+void SCE_RHalfToFloatRow (const unsigned short*, float*, size_t);
+void SCE_RUnormToFloatRow (const unsigned char*, float*, size_t);
+void SCE_RFloatToUnormRow (const float*, unsigned char*, size_t);
+
+int SCE_RIsConversionSupported (SCE_EImageFormat, SCE_EType,
+                                SCE_EImageFormat, SCE_EType);
+size_t SCE_RGetConvertedImageSize (int, int, SCE_EImageFormat, SCE_EType);
+int SCE_RConvertImage (const void*, SCE_EImageFormat, SCE_EType, int, int,
+                       SCE_EImageFormat, SCE_EType, int, void*);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* guard */
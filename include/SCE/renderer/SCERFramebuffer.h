@@ -104,10 +104,15 @@ int SCE_RAddRenderTexture (SCE_RFramebuffer*, SCE_RBufferType, SCEenum,
 
 int SCE_RAddRenderBuffer (SCE_RFramebuffer*, SCE_RBufferType,
                           SCE_EPixelFormat, int, int);
+int SCE_RAddRenderBufferFormat (SCE_RFramebuffer*, SCE_RBufferType,
+                                SCE_RInternalFormat, int, int);
 
 SCE_RTexture* SCE_RAddNewRenderTexture (SCE_RFramebuffer*, SCE_RBufferType,
                                         SCE_EPixelFormat, SCE_EImageFormat,
                                         SCE_EType, int, int);
+SCE_RTexture*
+SCE_RAddNewRenderTextureFormat (SCE_RFramebuffer*, SCE_RBufferType,
+                                SCE_RInternalFormat, int, int);
 
 SCE_RTexture* SCE_RGetRenderTexture (SCE_RFramebuffer*, SCE_RBufferType);
 
@@ -35,15 +35,21 @@ enum sce_rmatrix {
     SCE_MAT_PROJECTION,
     SCE_MAT_TEXTURE,
     SCE_MAT_MODELVIEW,
+    SCE_MAT_MODELVIEWPROJECTION,
+    SCE_MAT_NORMAL,
     SCE_NUM_MATRICES
 };
 typedef enum sce_rmatrix SCE_RMatrix;
 
+/* number of texture units that have a texture matrix of their own */
+#define SCE_NUM_TEXTURE_MATRICES 16
+
 typedef void (*SCE_RSetMatrixFunc) (void);
 
 extern SCE_TMatrix4 sce_rmatrices[SCE_NUM_MATRICES];
 
 void SCE_RLoadMatrix (SCE_RMatrix, const SCE_TMatrix4);
+void SCE_RFlushMatrices (void);
 
 void SCE_RMapMatrices (SCE_RSetMatrixFunc*);
 
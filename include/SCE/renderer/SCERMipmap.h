@@ -0,0 +1,60 @@
+/*------------------------------------------------------------------------------
+    SCEngine - A 3D real time rendering engine written in the C language
+    Copyright (C) 2006-2013  Antony Martin <martin(dot)antony(at)yahoo(dot)fr>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/* created: 19/10/2026
+   updated: 19/10/2026 */
+
+#ifndef SCERMIPMAP_H
+#define SCERMIPMAP_H
+
+#include <SCE/utils/SCEUtils.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \ingroup mipmap
+ * @{
+ */
+
+/**
+ * \brief Downsampling filters
+ */
+enum sce_rmipmapfilter {
+    SCE_MIPMAP_BOX,             /**< Box filter, average of the covered pixels */
+    SCE_MIPMAP_KAISER           /**< Kaiser windowed sinc, sharper */
+};
+/** \copydoc sce_rmipmapfilter */
+typedef enum sce_rmipmapfilter SCE_RMipmapFilter;
+
+/** @} */
+
+int SCE_RMipmapInit (void);
+void SCE_RMipmapQuit (void);
+
+int SCE_RIsMipmapFormatSupported (int, SCE_EType);
+size_t SCE_RGetMipmapLevelSize (int, int, int, SCE_EType);
+int SCE_RDownsampleImage (const void*, int, int, int, SCE_EType,
+                          SCE_RMipmapFilter, int, void*);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* guard */
@@ -0,0 +1,79 @@
+/*------------------------------------------------------------------------------
+    SCEngine - A 3D real time rendering engine written in the C language
+    Copyright (C) 2006-2013  Antony Martin <martin(dot)antony(at)yahoo(dot)fr>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/* created: 19/10/2026
+   updated: 19/10/2026 */
+
+#ifndef SCERRESAMPLE_H
+#define SCERRESAMPLE_H
+
+#include <SCE/utils/SCEUtils.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \ingroup resample
+ * @{
+ */
+
+/**
+ * \brief Resampling filters
+ */
+enum sce_rresamplefilter {
+    SCE_RESAMPLE_BOX,           /**< Average of the covered pixels when
+                                 * shrinking, nearest pixel when enlarging */
+    SCE_RESAMPLE_MITCHELL,      /**< Mitchell-Netravali cubic (B = C = 1/3) */
+    SCE_RESAMPLE_LANCZOS        /**< Lanczos windowed sinc, 3 lobes */
+};
+/** \copydoc sce_rresamplefilter */
+typedef enum sce_rresamplefilter SCE_RResampleFilter;
+
+/** \copydoc sce_rresampletaps */
+typedef struct sce_rresampletaps SCE_RResampleTaps;
+/**
+ * \internal
+ * \brief Filter taps of each destination pixel along one axis, shared with
+ * the mipmap generation
+ */
+struct sce_rresampletaps {
+    int n;                      /**< Taps per destination pixel */
+    int *idx;                   /**< Source indices, clamped to the edge */
+    float *w;                   /**< Normalized weights */
+};
+
+/** @} */
+
+int SCE_RAllocResampleTaps (SCE_RResampleTaps*, int);
+void SCE_RClearResampleTaps (SCE_RResampleTaps*);
+void SCE_RTrimResampleTaps (SCE_RResampleTaps*, int);
+void SCE_RAccumulateResampleRow (float*, const float*, float, size_t);
+void SCE_RFilterResampleRow (const SCE_RResampleTaps*, int, int,
+                             const float*, float*);
+
+int SCE_RIsResampleFormatSupported (int, SCE_EType);
+size_t SCE_RGetResampledImageSize (int, int, int, int, SCE_EType);
+int SCE_RResampleImage (const void*, int, int, int, int, SCE_EType,
+                        int, int, int, SCE_RResampleFilter, void*);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* guard */
@@ -0,0 +1,85 @@
+/*------------------------------------------------------------------------------
+    SCEngine - A 3D real time rendering engine written in the C language
+    Copyright (C) 2006-2013  Antony Martin <martin(dot)antony(at)yahoo(dot)fr>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/* created: 19/10/2026
+   updated: 19/10/2026 */
+
+#ifndef SCERSAMPLER_H
+#define SCERSAMPLER_H
+
+#include <SCE/utils/SCEUtils.h>
+#include "SCE/renderer/SCERType.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \ingroup sampler
+ * @{
+ */
+
+/** \copydoc sce_rsamplerdesc */
+typedef struct sce_rsamplerdesc SCE_RSamplerDesc;
+/**
+ * \brief Description of the sampling state of a texture
+ */
+struct sce_rsamplerdesc {
+    SCEenum min_filter;         /**< GL_TEXTURE_MIN_FILTER */
+    SCEenum mag_filter;         /**< GL_TEXTURE_MAG_FILTER */
+    SCEenum wrap[3];            /**< GL_TEXTURE_WRAP_S, T and R */
+    SCEfloat anisotropy;        /**< Maximum anisotropy, 1 to disable */
+    SCEenum compare_mode;       /**< GL_TEXTURE_COMPARE_MODE */
+    SCEenum compare_func;       /**< GL_TEXTURE_COMPARE_FUNC */
+    SCEfloat min_lod;           /**< GL_TEXTURE_MIN_LOD */
+    SCEfloat max_lod;           /**< GL_TEXTURE_MAX_LOD */
+    SCEfloat lod_bias;          /**< GL_TEXTURE_LOD_BIAS */
+    SCEfloat border[4];         /**< GL_TEXTURE_BORDER_COLOR */
+};
+
+/** \copydoc sce_rsampler */
+typedef struct sce_rsampler SCE_RSampler;
+/**
+ * \brief A shared GL sampler object, see SCE_RGetSampler()
+ */
+struct sce_rsampler {
+    SCE_RSamplerDesc desc;      /**< State of the sampler */
+    SCEuint id;                 /**< GL identifier */
+    SCEuint hash;               /**< Hash of \c desc */
+    SCE_RSampler *next;         /**< Next sampler of the same bucket */
+};
+
+/** @} */
+
+int SCE_RSamplerInit (void);
+void SCE_RSamplerQuit (void);
+
+float SCE_RGetMaxAnisotropy (void);
+
+void SCE_RInitSamplerDesc (SCE_RSamplerDesc*);
+void SCE_RApplySamplerDesc (SCEenum, const SCE_RSamplerDesc*);
+
+SCE_RSampler* SCE_RGetSampler (const SCE_RSamplerDesc*);
+unsigned int SCE_RGetNumSamplers (void);
+void SCE_RUseSampler (SCE_RSampler*, int);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* guard */
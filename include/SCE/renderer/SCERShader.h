@@ -72,14 +72,20 @@ typedef enum {
 #define SCE_MAT_PROJECTION_NAME "sce_projectionmatrix"
 #define SCE_MAT_TEXTURE_NAME "sce_texturematrix"
 #define SCE_MAT_MODELVIEW_NAME "sce_modelviewmatrix"
+#define SCE_MAT_MODELVIEWPROJECTION_NAME "sce_modelviewprojectionmatrix"
+#define SCE_MAT_NORMAL_NAME "sce_normalmatrix"
 
 
+/** \copydoc sce_rglobject */
+typedef struct sce_rglobject SCE_RGLObject;
+
 /**
  * \brief GL shader
  */
 typedef struct sce_rshaderglsl SCE_RShaderGLSL;
 struct sce_rshaderglsl {
-    SCEuint id;                 /**< OpenGL identifier */
+    SCEuint id;                 /**< OpenGL identifier, shared */
+    SCE_RGLObject *object;      /**< Shared GL object, see SCE_RShaderStats */
     SCE_RShaderType type;       /**< Type */
     SCEenum gltype;             /**< OpenGL type constant */
     SCEchar *data;              /**< Source code */
@@ -87,6 +93,8 @@ struct sce_rshaderglsl {
 };
 
 #define SCE_SHADER_OUTPUT_LENGTH 64
+/** Maximum number of shaders attached to a program */
+#define SCE_MAX_PROGRAM_SHADERS 8
 
 /**
  * \brief GL program
@@ -94,7 +102,11 @@ struct sce_rshaderglsl {
 typedef struct sce_rprogram SCE_RProgram;
 struct sce_rprogram {
     SCEuint id;                   /**< OpenGL identifier */
+    SCE_RGLObject *object;        /**< Shared GL object, NULL if not shared */
     int linked;                   /**< Is the program linked? */
+    /** Attached shaders, attached to the GL program at link time */
+    SCE_RShaderGLSL *shaders[SCE_MAX_PROGRAM_SHADERS];
+    size_t n_shaders;             /**< Number of attached shaders */
     SCE_RVertexAttributesMap map; /**< Vertex attributes mappings */
     int map_built;                /**< Is the attributes map built? */
     int use_vmap;                 /**< Use vertex attributes mapping? */
@@ -104,6 +116,11 @@ struct sce_rprogram {
     int use_mmap;                 /**< Use matrices mapping? */
     int use_tess;
     int patch_vertices;           /**< Tessellation patch vertices */
+    int separable;                /**< Can be bound to a pipeline stage */
+    int shared;                   /**< Share the GL program? */
+    SCEenum prim_in;              /**< Geometry shader input primitive */
+    SCEenum prim_out;             /**< Geometry shader output primitive */
+    SCEbitfield stages;           /**< Attached shader types (1 << type) */
     int fb_enabled;      /**< Whether transform feedback is enabled */
     SCE_RFeedbackStorageMode fb_mode; /**< Transform feedback attribs storage */
     char **fb_varyings;     /**< Transform feedback output varyings */
@@ -111,10 +128,50 @@ struct sce_rprogram {
     char outputs[SCE_MAX_ATTACHMENT_BUFFERS][SCE_SHADER_OUTPUT_LENGTH];
 };
 
+/**
+ * \brief GL program pipeline, assembles separable programs
+ * \sa SCE_RGetProgramPipeline()
+ */
+typedef struct sce_rprogrampipeline SCE_RProgramPipeline;
+struct sce_rprogrampipeline {
+    SCEuint id;                 /**< OpenGL identifier */
+    /** Program bound to each stage, NULL if the stage is unused */
+    SCE_RProgram *stages[SCE_NUM_SHADER_TYPES];
+    SCE_RProgram *progs[SCE_NUM_SHADER_TYPES]; /**< Distinct programs */
+    size_t n_progs;                            /**< Number of \c progs */
+    /** Functions that map the matrices, see SCE_RMapMatrices() */
+    SCE_RSetMatrixFunc funs[SCE_NUM_MATRICES];
+    SCEuint hash;                   /**< Hash of \c stages */
+    SCE_RProgramPipeline *next;     /**< Next pipeline in the cache bucket */
+};
+
+
+/**
+ * \brief Shared GL objects statistics
+ *
+ * Shaders with the same type and source share one GL shader, and shared
+ * programs (see SCE_RSetProgramShared()) with the same shaders, feedback
+ * varyings, outputs and parameters share one GL program. These counters
+ * tell how much compiling and linking was saved.
+ * \sa SCE_RGetShaderStats()
+ */
+typedef struct sce_rshaderstats SCE_RShaderStats;
+struct sce_rshaderstats {
+    unsigned long compiles;         /**< Number of shaders compiled */
+    unsigned long compiles_avoided; /**< Builds that reused a shader */
+    unsigned long links;            /**< Number of programs linked */
+    unsigned long links_avoided;    /**< Builds that reused a program */
+    unsigned long shaders;          /**< Live GL shaders */
+    unsigned long programs;         /**< Live GL programs */
+};
+
 
 int SCE_RShaderInit (void);
 void SCE_RShaderQuit (void);
 
+void SCE_RGetShaderStats (SCE_RShaderStats*);
+void SCE_RResetShaderStats (void);
+
 SCE_RShaderGLSL* SCE_RCreateShaderGLSL (SCE_RShaderType);
 
 void SCE_RDeleteShaderGLSL (SCE_RShaderGLSL*);
@@ -130,6 +187,9 @@ int SCE_RSetProgramShader (SCE_RProgram*, SCE_RShaderGLSL*, int);
 int SCE_RSetProgramFeedbackVaryings (SCE_RProgram*, SCEuint, const char**,
                                      SCE_RFeedbackStorageMode);
 
+void SCE_RSetProgramSeparable (SCE_RProgram*, int);
+void SCE_RSetProgramShared (SCE_RProgram*, int);
+
 int SCE_RBuildProgram (SCE_RProgram*);
 int SCE_RValidateProgram (SCE_RProgram*);
 
@@ -143,6 +203,13 @@ void SCE_RSetProgramPatchVertices (SCE_RProgram*, int);
 void SCE_RSetProgramOutputTarget (SCE_RProgram*, const char*, SCE_RBufferType);
 
 void SCE_RUseProgram (SCE_RProgram*);
+SCE_RProgram* SCE_RGetUsedProgram (void);
+
+SCE_RProgramPipeline* SCE_RGetProgramPipeline (SCE_RProgram**, size_t);
+void SCE_RUseProgramPipeline (SCE_RProgramPipeline*);
+SCE_RProgramPipeline* SCE_RGetUsedProgramPipeline (void);
+void SCE_RFlushProgramPipelines (void);
+void SCE_RDropProgramPipelines (SCE_RProgram*);
 
 #if 0
 void SCE_RDisableShaderGLSL (void);
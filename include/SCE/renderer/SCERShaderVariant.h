@@ -0,0 +1,113 @@
+/*------------------------------------------------------------------------------
+    SCEngine - A 3D real time rendering engine written in the C language
+    Copyright (C) 2006-2013  Antony Martin <martin(dot)antony(at)yahoo(dot)fr>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/* created: 19/10/2026
+   updated: 19/10/2026 */
+
+#ifndef SCERSHADERVARIANT_H
+#define SCERSHADERVARIANT_H
+
+#include <SCE/utils/SCEUtils.h>
+#include "SCE/renderer/SCERShader.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \ingroup shadervariant
+ * @{
+ */
+
+/** Maximum number of feature keys of a variant set (bits of the mask) */
+#define SCE_MAX_SHADER_FEATURES 32
+/** Maximum nesting of \#include directives */
+#define SCE_MAX_SHADER_INCLUDE_DEPTH 16
+
+/**
+ * \brief Called on each new variant program before it is linked
+ * \sa SCE_RSetShaderVariantsSetupFunc()
+ */
+typedef void (*SCE_FShaderVariantSetup)(SCE_RProgram*, SCEbitfield, void*);
+
+/** \copydoc sce_rshadervariant */
+typedef struct sce_rshadervariant SCE_RShaderVariant;
+/**
+ * \brief A built variant: the program of one feature combination
+ */
+struct sce_rshadervariant {
+    SCEbitfield mask;           /**< Enabled features */
+    SCE_RProgram *prog;         /**< Linked program */
+    SCE_RShaderGLSL *shaders[SCE_NUM_SHADER_TYPES]; /**< Shaders of \c prog */
+    char *sources[SCE_NUM_SHADER_TYPES]; /**< Preprocessed sources */
+};
+
+/** \copydoc sce_rshadervariants */
+typedef struct sce_rshadervariants SCE_RShaderVariants;
+/**
+ * \brief A set of shader sources and the feature keys that can be
+ * toggled on them
+ */
+struct sce_rshadervariants {
+    char *sources[SCE_NUM_SHADER_TYPES]; /**< Unprocessed source of each stage */
+    char *keys[SCE_MAX_SHADER_FEATURES]; /**< Feature keys (macro names) */
+    size_t n_keys;                       /**< Number of feature keys */
+    SCE_RShaderVariant *variants;        /**< Built variants (hash table) */
+    size_t n_variants;                   /**< Number of built variants */
+    size_t size;                         /**< Size of \c variants */
+    int attrib_mapping;         /**< Setup attributes mapping after link? */
+    int matrices_mapping;       /**< Setup matrices mapping after link? */
+    SCE_FShaderVariantSetup setup; /**< Pre-link callback */
+    void *udata;                   /**< User data given to \c setup */
+};
+
+/** @} */
+
+int SCE_RShaderVariantInit (void);
+void SCE_RShaderVariantQuit (void);
+
+int SCE_RAddShaderInclude (const char*, const char*);
+void SCE_RRemoveShaderInclude (const char*);
+void SCE_RClearShaderIncludes (void);
+
+char* SCE_RPreprocessShaderSource (const char*, const char**, size_t);
+
+void SCE_RInitShaderVariants (SCE_RShaderVariants*);
+void SCE_RClearShaderVariants (SCE_RShaderVariants*);
+SCE_RShaderVariants* SCE_RCreateShaderVariants (void);
+void SCE_RDeleteShaderVariants (SCE_RShaderVariants*);
+
+int SCE_RSetShaderVariantsSource (SCE_RShaderVariants*, SCE_RShaderType,
+                                  const char*);
+SCEbitfield SCE_RAddShaderVariantsFeature (SCE_RShaderVariants*, const char*);
+SCEbitfield SCE_RGetShaderVariantsFeature (const SCE_RShaderVariants*,
+                                           const char*);
+void SCE_RSetShaderVariantsMapping (SCE_RShaderVariants*, int, int);
+void SCE_RSetShaderVariantsSetupFunc (SCE_RShaderVariants*,
+                                      SCE_FShaderVariantSetup, void*);
+
+SCE_RProgram* SCE_RGetShaderVariant (SCE_RShaderVariants*, SCEbitfield);
+int SCE_RPrecompileShaderVariants (SCE_RShaderVariants*, const SCEbitfield*,
+                                   size_t);
+void SCE_RFlushShaderVariants (SCE_RShaderVariants*);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* guard */
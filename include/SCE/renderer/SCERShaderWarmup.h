@@ -0,0 +1,128 @@
+/*------------------------------------------------------------------------------
+    SCEngine - A 3D real time rendering engine written in the C language
+    Copyright (C) 2006-2013  Antony Martin <martin(dot)antony(at)yahoo(dot)fr>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/* created: 19/10/2026
+   updated: 19/10/2026 */
+
+#ifndef SCERSHADERWARMUP_H
+#define SCERSHADERWARMUP_H
+
+#include <stdio.h>
+#include <SCE/utils/SCEUtils.h>
+#include <SCE/core/SCECore.h>
+#include "SCE/renderer/SCERShader.h"
+#include "SCE/renderer/SCERVertexBuffer.h"
+#include "SCE/renderer/SCERFramebuffer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \ingroup shaderwarmup
+ * @{
+ */
+
+#define SCE_WARMUP_NAME_LENGTH 64
+
+/** \copydoc sce_rshaderwarmupstate */
+typedef struct sce_rshaderwarmupstate SCE_RShaderWarmupState;
+/**
+ * \brief State combination a program is drawn with
+ *
+ * Programs and vertex layouts are identified by names so that a list
+ * recorded during a session can be saved and reloaded by the next one.
+ */
+struct sce_rshaderwarmupstate {
+    char prog[SCE_WARMUP_NAME_LENGTH];   /**< Program name */
+    char layout[SCE_WARMUP_NAME_LENGTH]; /**< Vertex layout name */
+    SCE_EPixelFormat color;     /**< Color target format, or SCE_PXF_NONE */
+    SCE_EPixelFormat depth;     /**< Depth target format, or SCE_PXF_NONE */
+    int blending;               /**< Is blending enabled? */
+    SCEenum src, dst;           /**< Blending factors */
+};
+
+/**
+ * \brief Gets the objects of a state, called before warming an entry up
+ * \returns SCE_ERROR if the state can't be resolved, the entry is skipped
+ */
+typedef int (*SCE_FShaderWarmupResolve)(const SCE_RShaderWarmupState*,
+                                        SCE_RProgram**, SCE_RVertexBuffer**,
+                                        void*);
+
+/** \copydoc sce_rshaderwarmupentry */
+typedef struct sce_rshaderwarmupentry SCE_RShaderWarmupEntry;
+/**
+ * \brief An entry of a warm-up list
+ */
+struct sce_rshaderwarmupentry {
+    SCE_RShaderWarmupState state;
+    SCE_RProgram *prog;         /**< Resolved program */
+    SCE_RVertexBuffer *vb;      /**< Resolved vertex layout */
+    long time;                  /**< Warm-up time in microseconds, -1 if
+                                 * not done yet or failed */
+    int done;                   /**< Has the entry been processed? */
+    SCE_SListIterator it;
+};
+
+/** \copydoc sce_rshaderwarmup */
+typedef struct sce_rshaderwarmup SCE_RShaderWarmup;
+/**
+ * \brief A warm-up list
+ */
+struct sce_rshaderwarmup {
+    SCE_SList entries;          /**< SCE_RShaderWarmupEntry */
+    size_t n_entries;           /**< Number of entries */
+    size_t n_done;              /**< Number of processed entries */
+    SCE_SList targets;          /**< 1x1 framebuffers, one per format pair */
+    SCE_FShaderWarmupResolve resolve;
+    void *udata;                /**< Given to \c resolve */
+};
+
+/** @} */
+
+void SCE_RInitShaderWarmupState (SCE_RShaderWarmupState*);
+void SCE_RSetShaderWarmupStateNames (SCE_RShaderWarmupState*, const char*,
+                                     const char*);
+
+void SCE_RInitShaderWarmup (SCE_RShaderWarmup*);
+void SCE_RClearShaderWarmup (SCE_RShaderWarmup*);
+SCE_RShaderWarmup* SCE_RCreateShaderWarmup (void);
+void SCE_RDeleteShaderWarmup (SCE_RShaderWarmup*);
+
+void SCE_RSetShaderWarmupResolveFunc (SCE_RShaderWarmup*,
+                                      SCE_FShaderWarmupResolve, void*);
+
+SCE_RShaderWarmupEntry* SCE_RAddShaderWarmup (SCE_RShaderWarmup*,
+                                              const SCE_RShaderWarmupState*);
+void SCE_RSetShaderWarmupObjects (SCE_RShaderWarmupEntry*, SCE_RProgram*,
+                                  SCE_RVertexBuffer*);
+
+int SCE_RSaveShaderWarmup (const SCE_RShaderWarmup*, const char*);
+int SCE_RLoadShaderWarmup (SCE_RShaderWarmup*, const char*);
+
+size_t SCE_RRunShaderWarmup (SCE_RShaderWarmup*, unsigned long);
+int SCE_RIsShaderWarmupDone (const SCE_RShaderWarmup*);
+void SCE_RRestartShaderWarmup (SCE_RShaderWarmup*);
+void SCE_RPrintShaderWarmupReport (const SCE_RShaderWarmup*, FILE*);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* guard */
@@ -55,6 +55,17 @@ enum sce_rcapability {
     SCE_OCCLUSION_QUERY,        /**< Occlusion queries support */
     SCE_MRT,                    /**< Multiple render targets (MRT) support */
     SCE_HW_INSTANCING,          /**< Hardware instancing support */
+    SCE_SEPARATE_SHADERS,       /**< Separable programs and pipelines support */
+    SCE_SYNC,                   /**< Fence sync objects support */
+    SCE_BUFFER_STORAGE,         /**< Immutable, persistently mapped buffers */
+    SCE_TEX_STORAGE,            /**< Immutable texture storage support */
+    SCE_SAMPLER_OBJECTS,        /**< Sampler objects support */
+    SCE_TEX_ANISOTROPY,         /**< Anisotropic filtering support */
+    SCE_COPY_IMAGE,             /**< Copies between texture images support */
+    SCE_TEX_FLOAT,              /**< Floating point internal formats support */
+    SCE_TEX_PACKED_FLOAT,       /**< R11F_G11F_B10F internal format support */
+    SCE_TEX_SHARED_EXPONENT,    /**< RGB9_E5 internal format support */
+    SCE_TEX_RG,                 /**< R8 and RG8 internal formats support */
     SCE_NUM_CAPS
 };
 /**
@@ -25,6 +25,11 @@
 #include <stdarg.h>
 #include <SCE/utils/SCEUtils.h>
 #include <SCE/core/SCECore.h>
+#include "SCE/renderer/SCERType.h"
+#include "SCE/renderer/SCERMipmap.h"
+#include "SCE/renderer/SCERResample.h"
+#include "SCE/renderer/SCERCompress.h"
+#include "SCE/renderer/SCERSampler.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -92,6 +97,26 @@ typedef enum {
     SCE_NUM_TEX_WRAP_MODES
 } SCE_RTexWrapMode;
 
+struct sce_rtexturestream;
+
+/** Maximum number of mipmap levels tracked per texture */
+#define SCE_MAX_TEXTURE_LEVELS 16
+
+/** Maximum number of dirty boxes tracked per texture */
+#define SCE_MAX_TEXTURE_DIRTY_BOXES 8
+
+/** \copydoc sce_rtexturebox */
+typedef struct sce_rtexturebox SCE_RTextureBox;
+/**
+ * \brief A modified region of a texture, see SCE_RAddTextureDirtyBox()
+ */
+struct sce_rtexturebox {
+    unsigned int face;          /**< Index of the cube face, 0 otherwise */
+    unsigned int level;         /**< Mipmap level */
+    int x, y, z;                /**< Origin, in pixels */
+    int w, h, d;                /**< Size, 1 for the unused dimensions */
+};
+
 /** \copydoc sce_rtexture */
 typedef struct sce_rtexture SCE_RTexture;
 /**
@@ -107,7 +132,59 @@ struct sce_rtexture {
 
     int use_mipmap;     /**< Do we use mipmapping ? */
     int hw_mipmap;      /**< Do we use hardware for mipmaps generation ? */
+    SCE_RMipmapFilter mipmap_filter; /**< Filter of the CPU generated levels */
+    int srgb;           /**< Are the 8 bits colors sRGB encoded ? */
+    SCE_EPixelFormat compression; /**< Compressed format the data is encoded
+                                   * to when built, or SCE_PXF_NONE */
+    SCE_RCompressQuality compression_quality; /**< Encoding quality */
+    SCE_EImageFormat conv_fmt;  /**< Format the data is converted to when
+                                 * built, SCE_IMAGE_NONE to keep it */
+    SCE_EType conv_type;        /**< Type the data is converted to when built,
+                                 * SCE_NONE_TYPE to keep it */
+    int conv_flags;             /**< Conversion flags of the next build */
+    SCE_RInternalFormat internal_fmt; /**< Internal format overriding the
+                                       * pixel format of the data */
     SCEfloat aniso_level;       /**< Anisotropic filtering level */
+    SCE_RSamplerDesc sampler;   /**< Filtering and wrapping state */
+    SCE_RSampler *sampler_obj;  /**< Sampler object of \c sampler, NULL
+                                 * until the texture is used */
+
+    /** Stream the uploads are queued to while building, see
+     * SCE_RStreamTexture() */
+    struct sce_rtexturestream *stream;
+    unsigned int pending;       /**< Number of queued uploads not done yet */
+    /** Mapped files the data point into, see SCE_RLoadTextureFile() */
+    struct sce_rtexturefile *file;
+    int progressive;            /**< Are the levels streamed lowest resolution
+                                 * first? See SCE_RStreamTextureProgressive()*/
+    float requested_lod;        /**< Most detailed level wanted, orders the
+                                 * progressive uploads */
+    /** Number of queued uploads of each level */
+    unsigned char level_pending[SCE_MAX_TEXTURE_LEVELS];
+
+    int immutable;      /**< Is the storage allocated by glTexStorage*() ? */
+    int storage_w, storage_h, storage_d; /**< Size of the storage */
+    unsigned int storage_levels;         /**< Levels of the storage */
+    SCEenum storage_pxf;                 /**< Internal format of the storage */
+
+    SCE_RTextureBox *dirty;     /**< Regions to upload on the next update,
+                                 * NULL until the first one is added */
+    unsigned int n_dirty;       /**< Number of boxes in \c dirty */
+    int dirty_overflow;         /**< More regions than tracked were added,
+                                 * the next update uploads everything */
+
+    unsigned int n_levels;      /**< Number of levels allocated by the GL */
+    size_t level_size[SCE_MAX_TEXTURE_LEVELS]; /**< Bytes of each level,
+                                                * all faces included */
+    unsigned int base_level;    /**< First resident level, the levels below
+                                 * are dropped, see SCE_RSetTextureBaseLevel()*/
+    int unrealized;             /**< Is the build deferred? See
+                                 * SCE_RSetTextureRealizeMode() */
+    SCE_SListIterator realize_it; /**< Own iterator, realization queue */
+    unsigned long last_used;    /**< Last frame the texture was bound */
+    int budgeted;               /**< Is the texture in the budget manager? */
+    SCE_SListIterator budget_it; /**< Own iterator, LRU list of the budget
+                                  * manager */
 
     enum SCE_ETexType {
         SCE_TEXTYPE_1D, SCE_TEXTYPE_2D, SCE_TEXTYPE_2D_ARRAY, SCE_TEXTYPE_3D,
@@ -115,6 +192,19 @@ struct sce_rtexture {
     } type;             /**< Dunno olol */
 };
 
+/** \copydoc sce_rtexturebindcounters */
+typedef struct sce_rtexturebindcounters SCE_RTextureBindCounters;
+/**
+ * \brief Statistics of the texture bindings
+ */
+struct sce_rtexturebindcounters {
+    unsigned long requested;    /**< Calls to SCE_RUseTexture() and
+                                 * SCE_RBindTexture() */
+    unsigned long binds;        /**< glBindTexture() calls issued */
+    unsigned long enables;      /**< glEnable() and glDisable() calls issued */
+    unsigned long units;        /**< glActiveTexture() calls issued */
+};
+
 /** @} */
 
 int SCE_RTextureInit (void);
@@ -123,6 +213,13 @@ void SCE_RTextureQuit (void);
 int SCE_RGetTextureResourceType (void);
 
 void SCE_RSetTextureAnisotropic (SCE_RTexture*, SCEfloat);
+void SCE_RSetTextureMipmapFilter (SCE_RTexture*, SCE_RMipmapFilter, int);
+void SCE_RSetTextureCompression (SCE_RTexture*, SCE_EPixelFormat,
+                                 SCE_RCompressQuality);
+void SCE_RSetTextureConversion (SCE_RTexture*, SCE_EImageFormat, SCE_EType,
+                                int);
+void SCE_RSetTextureInternalFormat (SCE_RTexture*, SCE_RInternalFormat);
+SCE_RInternalFormat SCE_RGetTextureInternalFormat (SCE_RTexture*);
 float SCE_RGetTextureMaxAnisotropic (void);
 
 SCE_RTexture* SCE_RCreateTexture (SCE_RTexType);
@@ -136,6 +233,9 @@ int SCE_RGetMaxTexture3DSize (void);
 void SCE_RSetTextureFilter (SCE_RTexture*, SCE_RTexFilter);
 void SCE_RPixelizeTexture (SCE_RTexture*, int);
 void SCE_RSetTextureWrapMode (SCE_RTexture*, SCE_RTexWrapMode);
+void SCE_RSetTextureBorderColor (SCE_RTexture*, const SCEfloat*);
+const SCE_RSamplerDesc* SCE_RGetTextureSamplerDesc (SCE_RTexture*);
+SCE_RSampler* SCE_RGetTextureSampler (SCE_RTexture*);
 
 void SCE_RSetTextureParam (SCE_RTexture*, SCEenum, int) SCE_GNUC_DEPRECATED;
 void SCE_RSetTextureParamf (SCE_RTexture*, SCEenum, float) SCE_GNUC_DEPRECATED;
@@ -147,6 +247,7 @@ void SCE_RSetTextureGenfv (SCE_RTexture*, SCEenum, SCEenum, float*) SCE_GNUC_DEP
 void SCE_RForceTexturePixelFormat (int, SCE_EPixelFormat);
 void SCE_RForceTextureType (int, SCE_EType);
 void SCE_RForceTextureFormat (int, SCE_EImageFormat);
+void SCE_RSetTextureResizeFilter (SCE_RResampleFilter);
 
 SCE_RTexType SCE_RGetTextureType (SCE_RTexture*);
 
@@ -181,10 +282,33 @@ SCE_RTexture* SCE_RLoadTexture (int, int, int, int, int, ...);
 
 void SCE_RBuildTexture (SCE_RTexture*, int, int);
 void SCE_RUpdateTexture (SCE_RTexture*, int, int);
+void SCE_RUploadTextureTexData (SCE_RTexture*, SCE_STexData*, int,
+                                const void*);
+int SCE_RAddTextureDirtyBox (SCE_RTexture*, SCE_RTexCubeFace, int,
+                             int, int, int, int, int, int);
+unsigned int SCE_RGetNumTextureDirtyBoxes (const SCE_RTexture*);
+void SCE_RClearTextureDirtyBoxes (SCE_RTexture*);
+int SCE_RIsTextureResident (SCE_RTexture*);
+
+size_t SCE_RGetTextureUsedVRAM (const SCE_RTexture*);
+size_t SCE_RGetTextureFullVRAM (const SCE_RTexture*);
+unsigned int SCE_RGetTextureMaxBaseLevel (SCE_RTexture*);
+int SCE_RSetTextureBaseLevel (SCE_RTexture*, unsigned int);
+
+int SCE_RGenerateTextureMipmaps (SCE_RTexture*);
+int SCE_RConvertTexture (SCE_RTexture*);
+int SCE_RCompressTexture (SCE_RTexture*);
 
 void SCE_RSetActiveTextureUnit (unsigned int);
+int SCE_RGetActiveTextureUnit (void);
+
+void SCE_RBindTexture (SCE_RTexture*);
+void SCE_RForgetTextureBindings (SCE_RTexture*);
+void SCE_RGetTextureBindCounters (SCE_RTextureBindCounters*);
+void SCE_RResetTextureBindCounters (void);
 
 void SCE_RUseTexture (SCE_RTexture*, int);
+void SCE_RUseTextureSampler (SCE_RTexture*, SCE_RSampler*, int);
 
 #ifdef __cplusplus
 } /* extern "C" */
@@ -0,0 +1,111 @@
+/*------------------------------------------------------------------------------
+    SCEngine - A 3D real time rendering engine written in the C language
+    Copyright (C) 2006-2013  Antony Martin <martin(dot)antony(at)yahoo(dot)fr>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/* created: 19/10/2026
+   updated: 19/10/2026 */
+
+#ifndef SCERTEXTUREARRAYPOOL_H
+#define SCERTEXTUREARRAYPOOL_H
+
+#include <SCE/utils/SCEUtils.h>
+#include <SCE/core/SCECore.h>
+#include "SCE/renderer/SCERType.h"
+#include "SCE/renderer/SCERSampler.h"
+#include "SCE/renderer/SCERTexture.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \ingroup texturearraypool
+ * @{
+ */
+
+typedef struct sce_rtexturearraypool SCE_RTextureArrayPool;
+typedef struct sce_rtexturearrayentry SCE_RTextureArrayEntry;
+
+/** \copydoc sce_rtexturearray */
+typedef struct sce_rtexturearray SCE_RTextureArray;
+/**
+ * \brief A 2D array texture shared by compatible textures
+ */
+struct sce_rtexturearray {
+    SCE_RTextureArrayPool *pool; /**< Pool of the array */
+    SCE_RTexture *tex;          /**< The array texture, replaced when the
+                                 * array grows */
+    SCE_EPixelFormat pxf;       /**< Pixel format of the layers */
+    SCE_RInternalFormat ifmt;   /**< Internal format of the layers */
+    SCEenum gl_pxf;             /**< GL internal format */
+    SCE_EImageFormat fmt;       /**< Format of uncompressed pixels */
+    SCE_EType type;             /**< Type of uncompressed pixels */
+    int compressed;             /**< Is \c pxf a compressed format? */
+    int width, height;          /**< Size of the first level */
+    unsigned int n_levels;      /**< Mipmap levels */
+    size_t layer_size[SCE_MAX_TEXTURE_LEVELS]; /**< Bytes of a layer */
+    SCE_RSamplerDesc sampler;   /**< Sampling state of the layers */
+    int capacity;               /**< Number of layers allocated */
+    int n_used;                 /**< Number of layers used */
+    SCE_RTextureArrayEntry **entries; /**< Entry of each layer, NULL for
+                                       * the free layers */
+    SCE_SListIterator it;       /**< Own iterator, list of the pool */
+};
+
+/**
+ * \brief A texture copied into a layer of an array
+ */
+struct sce_rtexturearrayentry {
+    SCE_RTextureArray *array;   /**< Array holding the texture */
+    int layer;                  /**< Layer of the texture */
+};
+
+/**
+ * \brief Groups textures of the same format into 2D array textures
+ */
+struct sce_rtexturearraypool {
+    SCE_SList arrays;           /**< SCE_RTextureArray */
+    int initial_layers;         /**< Layers of a new array */
+    int max_layers;             /**< Maximum layers of an array, 0 for the
+                                 * GL limit */
+    unsigned int n_grows;       /**< Number of times an array grew */
+};
+
+/** @} */
+
+void SCE_RInitTextureArrayPool (SCE_RTextureArrayPool*);
+void SCE_RClearTextureArrayPool (SCE_RTextureArrayPool*);
+SCE_RTextureArrayPool* SCE_RCreateTextureArrayPool (void);
+void SCE_RDeleteTextureArrayPool (SCE_RTextureArrayPool*);
+
+void SCE_RSetTextureArrayPoolLayers (SCE_RTextureArrayPool*, int, int);
+
+SCE_RTextureArrayEntry*
+SCE_RAddTextureArrayPoolTexture (SCE_RTextureArrayPool*, SCE_RTexture*);
+void SCE_RRemoveTextureArrayPoolEntry (SCE_RTextureArrayEntry*);
+
+SCE_RTexture* SCE_RGetTextureArrayEntryTexture (SCE_RTextureArrayEntry*);
+int SCE_RGetTextureArrayEntryLayer (SCE_RTextureArrayEntry*);
+
+unsigned int SCE_RGetTextureArrayPoolNumArrays (SCE_RTextureArrayPool*);
+unsigned int SCE_RGetTextureArrayPoolNumGrows (SCE_RTextureArrayPool*);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* guard */
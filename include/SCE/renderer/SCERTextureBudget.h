@@ -0,0 +1,71 @@
+/*------------------------------------------------------------------------------
+    SCEngine - A 3D real time rendering engine written in the C language
+    Copyright (C) 2006-2013  Antony Martin <martin(dot)antony(at)yahoo(dot)fr>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/* created: 19/10/2026
+   updated: 19/10/2026 */
+
+#ifndef SCERTEXTUREBUDGET_H
+#define SCERTEXTUREBUDGET_H
+
+#include <SCE/utils/SCEUtils.h>
+#include "SCE/renderer/SCERTexture.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \ingroup texturebudget
+ * @{
+ */
+
+/** \copydoc sce_rtexturebudgetreport */
+typedef struct sce_rtexturebudgetreport SCE_RTextureBudgetReport;
+/**
+ * \brief Texture memory statistics
+ */
+struct sce_rtexturebudgetreport {
+    size_t budget;              /**< Budget, 0 when unlimited */
+    size_t resident;            /**< Bytes of the resident levels */
+    size_t full;                /**< Bytes with all the levels resident */
+    unsigned int n_textures;    /**< Number of managed textures */
+    unsigned int n_reduced;     /**< Number of textures with dropped levels */
+    size_t evicted;             /**< Bytes dropped by the last update */
+    size_t restored;            /**< Bytes restored by the last update */
+};
+
+/** @} */
+
+int SCE_RTextureBudgetInit (void);
+void SCE_RTextureBudgetQuit (void);
+
+void SCE_RSetTextureBudget (size_t);
+size_t SCE_RGetTextureBudget (void);
+
+void SCE_RTrackTexture (SCE_RTexture*);
+void SCE_RUntrackTexture (SCE_RTexture*);
+void SCE_RMarkTextureUsed (SCE_RTexture*);
+
+void SCE_RUpdateTextureBudget (void);
+void SCE_RGetTextureBudgetReport (SCE_RTextureBudgetReport*);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* guard */
@@ -0,0 +1,87 @@
+/*------------------------------------------------------------------------------
+    SCEngine - A 3D real time rendering engine written in the C language
+    Copyright (C) 2006-2013  Antony Martin <martin(dot)antony(at)yahoo(dot)fr>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/* created: 19/10/2026
+   updated: 19/10/2026 */
+
+#ifndef SCERTEXTUREFILE_H
+#define SCERTEXTUREFILE_H
+
+#include <SCE/utils/SCEUtils.h>
+#include <SCE/core/SCECore.h>
+#include "SCE/renderer/SCERTexture.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \ingroup texturefile
+ * @{
+ */
+
+/**
+ * \brief Texture container formats
+ */
+typedef enum {
+    SCE_TEXFILE_DDS,
+    SCE_TEXFILE_KTX
+} SCE_RTextureFileFormat;
+
+/** \copydoc sce_rtexturefile */
+typedef struct sce_rtexturefile SCE_RTextureFile;
+/**
+ * \brief A memory mapped DDS or KTX file
+ */
+struct sce_rtexturefile {
+    unsigned char *map;         /**< Mapping of the whole file */
+    size_t size;                /**< Size of the file */
+    SCE_RTextureFileFormat format; /**< Container format */
+    size_t data_offset;         /**< Offset of the first image */
+    SCE_RTexType type;          /**< Type of the texture */
+    int width, height, depth;   /**< Size of the first level */
+    unsigned int n_layers;      /**< Array layers, 1 for non-array textures */
+    unsigned int n_faces;       /**< 6 for cube maps, 1 otherwise */
+    unsigned int n_levels;      /**< Mipmap levels */
+    SCE_EPixelFormat pxf;       /**< Pixel format */
+    SCE_EImageFormat fmt;       /**< Format of uncompressed pixels */
+    SCE_EType data_type;        /**< Type of uncompressed pixels */
+    size_t pixel_size;          /**< Bytes per pixel, 0 when compressed */
+    SCE_RTextureFile *next;     /**< Next file of the same texture */
+};
+
+/** @} */
+
+int SCE_RIsTextureFileName (const char*);
+
+int SCE_RMapTextureFile (SCE_RTextureFile*, const char*);
+void SCE_RUnmapTextureFile (SCE_RTextureFile*);
+const unsigned char* SCE_RGetTextureFileImage (const SCE_RTextureFile*,
+                                               unsigned int, unsigned int,
+                                               unsigned int, size_t*);
+
+SCE_RTexture* SCE_RLoadTextureFile (const char*);
+SCE_RTexture* SCE_RLoadTextureFiles (SCE_RTexType, const char**,
+                                     unsigned int);
+void SCE_RReleaseTextureFile (SCE_RTexture*);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* guard */
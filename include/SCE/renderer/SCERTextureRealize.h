@@ -0,0 +1,72 @@
+/*------------------------------------------------------------------------------
+    SCEngine - A 3D real time rendering engine written in the C language
+    Copyright (C) 2006-2013  Antony Martin <martin(dot)antony(at)yahoo(dot)fr>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/* created: 19/10/2026
+   updated: 19/10/2026 */
+
+#ifndef SCERTEXTUREREALIZE_H
+#define SCERTEXTUREREALIZE_H
+
+#include <SCE/utils/SCEUtils.h>
+#include "SCE/renderer/SCERType.h"
+#include "SCE/renderer/SCERTexture.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \ingroup texturerealize
+ * @{
+ */
+
+/**
+ * \brief When the textures given pixels are built
+ */
+enum sce_rtexturerealizemode {
+    SCE_TEX_REALIZE_NOW,        /**< SCE_RBuildTexture() uploads the texture
+                                 * (default) */
+    SCE_TEX_REALIZE_ON_BIND,    /**< The first SCE_RUseTexture() uploads it */
+    SCE_TEX_REALIZE_IDLE        /**< SCE_RRealizeTextures() uploads it, a
+                                 * placeholder is bound meanwhile */
+};
+/** \copydoc sce_rtexturerealizemode */
+typedef enum sce_rtexturerealizemode SCE_RTextureRealizeMode;
+
+/** @} */
+
+int SCE_RTextureRealizeInit (void);
+void SCE_RTextureRealizeQuit (void);
+
+void SCE_RSetTextureRealizeMode (SCE_RTextureRealizeMode);
+SCE_RTextureRealizeMode SCE_RGetTextureRealizeMode (void);
+
+int SCE_RDeferTextureBuild (SCE_RTexture*);
+void SCE_RCancelTextureRealization (SCE_RTexture*);
+SCEuint SCE_RRequestTextureRealization (SCE_RTexture*);
+
+int SCE_RIsTextureRealized (const SCE_RTexture*);
+void SCE_RRealizeTexture (SCE_RTexture*);
+unsigned int SCE_RRealizeTextures (size_t);
+unsigned int SCE_RGetNumUnrealizedTextures (void);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* guard */
@@ -0,0 +1,98 @@
+/*------------------------------------------------------------------------------
+    SCEngine - A 3D real time rendering engine written in the C language
+    Copyright (C) 2006-2013  Antony Martin <martin(dot)antony(at)yahoo(dot)fr>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/* created: 19/10/2026
+   updated: 19/10/2026 */
+
+#ifndef SCERTEXTURESTREAM_H
+#define SCERTEXTURESTREAM_H
+
+#include <SCE/utils/SCEUtils.h>
+#include <SCE/core/SCECore.h>
+#include "SCE/renderer/SCERTexture.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \ingroup texturestream
+ * @{
+ */
+
+/** Default size of the ring of a texture stream */
+#define SCE_TEXTURE_STREAM_DEFAULT_SIZE (16 * 1024 * 1024)
+
+/** Largest dimension of the levels uploaded immediately by
+ * SCE_RStreamTextureProgressive() */
+#define SCE_TEXTURE_MIP_TAIL_SIZE 64
+
+/** \copydoc sce_rtexturestream */
+typedef struct sce_rtexturestream SCE_RTextureStream;
+/**
+ * \brief Uploads textures asynchronously through a ring of pixel buffer
+ */
+struct sce_rtexturestream {
+    SCEuint pbo;                /**< Pixel unpack buffer holding the ring */
+    size_t size;                /**< Size of the ring in bytes */
+    size_t head;                /**< Allocation position, never wraps */
+    size_t tail;                /**< Retire position, never wraps */
+    unsigned char *map;         /**< Persistent mapping of \c pbo, NULL when
+                                 * persistent mapping is not supported */
+    size_t budget;              /**< Bytes started per frame, 0: no limit */
+    SCE_SList pending;          /**< Uploads waiting for ring space */
+    SCE_SList copying;          /**< Uploads being copied into the ring */
+    SCE_SList submitted;        /**< Uploads waiting for their fence */
+    size_t n_bytes;             /**< Bytes uploaded since creation */
+    SCE_SListIterator it;       /**< Own iterator, global list of streams */
+};
+
+/** @} */
+
+int SCE_RTextureStreamInit (void);
+void SCE_RTextureStreamQuit (void);
+
+void SCE_RInitTextureStream (SCE_RTextureStream*);
+void SCE_RClearTextureStream (SCE_RTextureStream*);
+SCE_RTextureStream* SCE_RCreateTextureStream (void);
+void SCE_RDeleteTextureStream (SCE_RTextureStream*);
+
+int SCE_RBuildTextureStream (SCE_RTextureStream*, size_t);
+void SCE_RSetTextureStreamBudget (SCE_RTextureStream*, size_t);
+size_t SCE_RGetTextureStreamQueuedBytes (SCE_RTextureStream*);
+
+void SCE_RStreamTexture (SCE_RTextureStream*, SCE_RTexture*, int, int);
+void SCE_RStreamTextureUpdate (SCE_RTextureStream*, SCE_RTexture*, int, int);
+void SCE_RStreamTextureProgressive (SCE_RTextureStream*, SCE_RTexture*,
+                                    int, int);
+
+void SCE_RSetTextureRequestedLOD (SCE_RTexture*, float);
+float SCE_RGetTextureRequestedLOD (SCE_RTexture*);
+
+void SCE_RQueueTextureStream (SCE_RTextureStream*, SCE_RTexture*,
+                              SCE_STexData*, int);
+void SCE_RCancelTextureStream (SCE_RTexture*);
+
+void SCE_RUpdateTextureStream (SCE_RTextureStream*);
+void SCE_RFlushTextureStream (SCE_RTextureStream*);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* guard */
@@ -34,6 +34,32 @@
 extern "C" {
 #endif
 
+/**
+ * \brief GL internal formats of the textures and render targets that have no
+ * SCE_EPixelFormat equivalent, the color ones sorted by size
+ * \sa SCE_RSetTextureInternalFormat(), SCE_RChooseInternalFormat()
+ */
+enum sce_rinternalformat {
+    SCE_IFMT_NONE,              /**< Use the pixel format of the data */
+    SCE_IFMT_R8,                /**< One 8 bits normalized channel */
+    SCE_IFMT_RG8,               /**< Two 8 bits normalized channels */
+    SCE_IFMT_RGBA8,             /**< 8 bits normalized, 4 bytes */
+    SCE_IFMT_RGB10_A2,          /**< 10 bits normalized, 4 bytes */
+    SCE_IFMT_R11F_G11F_B10F,    /**< Unsigned floats without alpha, 4 bytes */
+    SCE_IFMT_RGB9_E5,           /**< Shared exponent without alpha, 4 bytes,
+                                 * can't be rendered to */
+    SCE_IFMT_RGBA16F,           /**< Half floats, 8 bytes */
+    SCE_IFMT_RGBA32F,           /**< Floats, 16 bytes */
+    SCE_NUM_INTERNAL_FORMATS
+};
+/** \copydoc sce_rinternalformat */
+typedef enum sce_rinternalformat SCE_RInternalFormat;
+
+/* requirements of SCE_RChooseInternalFormat() */
+#define SCE_IFMT_ALPHA 1        /**< Needs an alpha channel */
+#define SCE_IFMT_SIGNED 2       /**< Needs negative values */
+#define SCE_IFMT_RENDERABLE 4   /**< Needs to be a render target */
+
 extern SCEenum sce_rgltypes[SCE_NUM_TYPES];
 extern SCEenum sce_rprimtypes_true[SCE_NUM_PRIMITIVE_TYPES];
 extern SCEenum *sce_rprimtypes;
@@ -51,11 +77,22 @@ float SCE_RGetFloat (SCEenum);
 void SCE_RGetIntegerv (SCEenum, int*);
 void SCE_RGetFloatv (SCEenum, float*);
 
+/* initial value of SCE_RHashData() */
+#define SCE_HASH_INIT 2166136261u
+SCEuint SCE_RHashData (const void*, size_t, SCEuint);
+
 SCE_EType SCE_RGLTypeToSCE (SCEenum);
 
 SCEenum SCE_RSCEImgTypeToGL (SCE_EImageType);
 SCEenum SCE_RSCEImgFormatToGL (SCE_EImageFormat);
 SCEenum SCE_RSCEPxfToGL (SCE_EPixelFormat);
+SCEenum SCE_RSCEPxfToGLSized (SCE_EPixelFormat);
+
+SCEenum SCE_RInternalFormatToGL (SCE_RInternalFormat);
+size_t SCE_RGetInternalFormatSize (SCE_RInternalFormat);
+int SCE_RHasInternalFormatAlpha (SCE_RInternalFormat);
+int SCE_RIsInternalFormatSupported (SCE_RInternalFormat, int);
+SCE_RInternalFormat SCE_RChooseInternalFormat (unsigned int, float, int);
 
 #ifdef __cplusplus
 } /* extern "C" */
@@ -0,0 +1,104 @@
+/*------------------------------------------------------------------------------
+    SCEngine - A 3D real time rendering engine written in the C language
+    Copyright (C) 2006-2013  Antony Martin <martin(dot)antony(at)yahoo(dot)fr>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/* created: 19/10/2026
+   updated: 19/10/2026 */
+
+#ifndef SCERUPLOAD_H
+#define SCERUPLOAD_H
+
+#include <SCE/utils/SCEUtils.h>
+#include "SCE/renderer/SCERType.h"
+#include "SCE/renderer/SCERTexture.h"
+#include "SCE/renderer/SCERBuffer.h"
+#include "SCE/renderer/SCERMatrix.h"
+#include "SCE/renderer/SCERShader.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \ingroup upload
+ * @{
+ */
+
+/**
+ * \brief Makes the shared context current on the calling thread, or
+ * releases it
+ * \returns SCE_ERROR on error, SCE_OK otherwise
+ */
+typedef int (*SCE_FUploadContext)(void*);
+
+/**
+ * \brief Kind of work of an upload
+ */
+enum sce_ruploadtype {
+    SCE_UPLOAD_BUFFER,          /**< SCE_RBuildBuffer() */
+    SCE_UPLOAD_TEXTURE,         /**< SCE_RBuildTexture() */
+    SCE_UPLOAD_TEXTURE_UPDATE,  /**< SCE_RUpdateTexture() */
+    SCE_UPLOAD_PROGRAM          /**< SCE_RBuildProgram() */
+};
+/** \copydoc sce_ruploadtype */
+typedef enum sce_ruploadtype SCE_RUploadType;
+
+/** \copydoc sce_rupload */
+typedef struct sce_rupload SCE_RUpload;
+/**
+ * \brief Handle of a work submitted to the upload thread, memory managed by
+ * the user
+ */
+struct sce_rupload {
+    SCE_RUploadType type;       /**< Kind of work */
+    void *object;               /**< Buffer, texture or program */
+    SCEenum target;             /**< Target of a buffer */
+    SCE_RBufferUsage usage;     /**< Usage of a buffer */
+    int use_mipmap, hw_mipmap;  /**< Build parameters of a texture */
+    int status;                 /**< SCE_ERROR if a program failed to link,
+                                 * SCE_OK otherwise */
+    int state;                  /**< Internal state, protected by the
+                                 * upload thread */
+    GLsync fence;               /**< Signaled when the GL is done */
+    SCE_RUpload *next;          /**< Next upload in the queue */
+};
+
+/** @} */
+
+int SCE_RUploadInit (void);
+void SCE_RUploadQuit (void);
+
+int SCE_RStartUploadThread (SCE_FUploadContext, SCE_FUploadContext, void*);
+void SCE_RStopUploadThread (void);
+int SCE_RHasUploadThread (void);
+int SCE_RIsUploadThread (void);
+
+void SCE_RInitUpload (SCE_RUpload*);
+void SCE_RSubmitBuffer (SCE_RUpload*, SCE_RBuffer*, SCEenum, SCE_RBufferUsage);
+void SCE_RSubmitTexture (SCE_RUpload*, SCE_RTexture*, int, int);
+void SCE_RSubmitTextureUpdate (SCE_RUpload*, SCE_RTexture*, int, int);
+void SCE_RSubmitProgram (SCE_RUpload*, SCE_RProgram*);
+
+int SCE_RIsUploadReady (SCE_RUpload*);
+void SCE_RWaitUpload (SCE_RUpload*);
+int SCE_RGetUploadStatus (const SCE_RUpload*);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* guard */
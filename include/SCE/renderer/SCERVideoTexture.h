@@ -0,0 +1,141 @@
+/*------------------------------------------------------------------------------
+    SCEngine - A 3D real time rendering engine written in the C language
+    Copyright (C) 2006-2013  Antony Martin <martin(dot)antony(at)yahoo(dot)fr>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/* created: 19/10/2026
+   updated: 19/10/2026 */
+
+#ifndef SCERVIDEOTEXTURE_H
+#define SCERVIDEOTEXTURE_H
+
+#include <SCE/utils/SCEUtils.h>
+#include "SCE/renderer/SCERType.h"
+#include "SCE/renderer/SCERTexture.h"
+#include "SCE/renderer/SCERMatrix.h"
+#include "SCE/renderer/SCERShader.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \ingroup videotexture
+ * @{
+ */
+
+/** Number of frames a video texture holds: one decoded, one uploaded and
+ * one sampled */
+#define SCE_VIDEO_TEXTURE_SLOTS 3
+/** Maximum number of planes of a frame */
+#define SCE_VIDEO_MAX_PLANES 3
+
+/**
+ * \brief Layouts of the frames, both 4:2:0
+ */
+enum sce_rvideoformat {
+    SCE_VIDEO_I420,             /**< Y, U and V planes */
+    SCE_VIDEO_NV12              /**< Y plane and interleaved UV plane */
+};
+/** \copydoc sce_rvideoformat */
+typedef enum sce_rvideoformat SCE_RVideoFormat;
+
+/**
+ * \brief YUV to RGB conversions
+ */
+enum sce_rvideocolorspace {
+    SCE_VIDEO_BT601,            /**< Standard definition video */
+    SCE_VIDEO_BT709             /**< High definition video */
+};
+/** \copydoc sce_rvideocolorspace */
+typedef enum sce_rvideocolorspace SCE_RVideoColorSpace;
+
+/** \copydoc sce_rvideoframe */
+typedef struct sce_rvideoframe SCE_RVideoFrame;
+/**
+ * \brief Memory a frame is decoded to, see SCE_RMapVideoFrame()
+ */
+struct sce_rvideoframe {
+    unsigned char *planes[SCE_VIDEO_MAX_PLANES]; /**< Y, U and V, or Y and
+                                                  * UV */
+    size_t pitch[SCE_VIDEO_MAX_PLANES]; /**< Bytes between two rows */
+    int width[SCE_VIDEO_MAX_PLANES];    /**< Width of each plane, in pixels */
+    int height[SCE_VIDEO_MAX_PLANES];   /**< Height of each plane */
+    unsigned int slot;                  /**< Slot of the frame */
+};
+
+/** \copydoc sce_rvideotexture */
+typedef struct sce_rvideotexture SCE_RVideoTexture;
+/**
+ * \brief Planar YUV textures fed through pixel buffers
+ */
+struct sce_rvideotexture {
+    SCE_RVideoFormat format;    /**< Layout of the frames */
+    int width, height;          /**< Size of the luma plane */
+    unsigned int n_planes;      /**< Number of planes of a frame */
+    int plane_w[SCE_VIDEO_MAX_PLANES], plane_h[SCE_VIDEO_MAX_PLANES];
+    size_t pitch[SCE_VIDEO_MAX_PLANES];  /**< Rows of the planes in a slot */
+    size_t offset[SCE_VIDEO_MAX_PLANES]; /**< Planes in a slot */
+    size_t frame_size;          /**< Bytes of a slot */
+
+    /** Textures of the planes of each slot */
+    SCE_RTexture *planes[SCE_VIDEO_TEXTURE_SLOTS][SCE_VIDEO_MAX_PLANES];
+    SCEuint pbo[SCE_VIDEO_TEXTURE_SLOTS]; /**< Pixel unpack buffers, 0 without
+                                           * PBO support */
+    int persistent;             /**< Are the buffers persistently mapped? */
+    /** Memory of the slots: mapping of the buffers, or client memory */
+    unsigned char *map[SCE_VIDEO_TEXTURE_SLOTS];
+    int state[SCE_VIDEO_TEXTURE_SLOTS]; /**< What each slot is used for */
+    GLsync fences[SCE_VIDEO_TEXTURE_SLOTS]; /**< Uploads of the slots */
+    unsigned long seq[SCE_VIDEO_TEXTURE_SLOTS]; /**< Frame of each slot */
+    unsigned long n_frames;     /**< Number of frames mapped */
+    int front;                  /**< Slot sampled, -1 until the first frame
+                                 * is uploaded */
+    unsigned int n_dropped;     /**< Frames replaced before being sampled */
+
+    float matrix[16];           /**< YUV to RGB conversion, row major */
+    float chroma[4];            /**< Channels of the chroma textures */
+};
+
+/** @} */
+
+int SCE_RVideoTextureInit (void);
+void SCE_RVideoTextureQuit (void);
+
+void SCE_RInitVideoTexture (SCE_RVideoTexture*);
+void SCE_RClearVideoTexture (SCE_RVideoTexture*);
+SCE_RVideoTexture* SCE_RCreateVideoTexture (void);
+void SCE_RDeleteVideoTexture (SCE_RVideoTexture*);
+
+int SCE_RBuildVideoTexture (SCE_RVideoTexture*, SCE_RVideoFormat, int, int);
+void SCE_RSetVideoTextureColorSpace (SCE_RVideoTexture*, SCE_RVideoColorSpace,
+                                     int);
+
+int SCE_RMapVideoFrame (SCE_RVideoTexture*, SCE_RVideoFrame*);
+void SCE_RUnmapVideoFrame (SCE_RVideoTexture*, SCE_RVideoFrame*);
+int SCE_RUploadVideoFrame (SCE_RVideoTexture*, const unsigned char* const*,
+                           const size_t*);
+int SCE_RUpdateVideoTexture (SCE_RVideoTexture*);
+unsigned int SCE_RGetVideoTextureDroppedFrames (SCE_RVideoTexture*);
+
+const char* SCE_RGetVideoTextureGLSL (void);
+void SCE_RUseVideoTexture (SCE_RVideoTexture*, SCE_RProgram*, int);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* guard */
@@ -0,0 +1,176 @@
+/*------------------------------------------------------------------------------
+    SCEngine - A 3D real time rendering engine written in the C language
+    Copyright (C) 2006-2013  Antony Martin <martin(dot)antony(at)yahoo(dot)fr>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/* created: 19/10/2026
+   updated: 19/10/2026 */
+
+#ifndef SCERVIRTUALTEXTURE_H
+#define SCERVIRTUALTEXTURE_H
+
+#include <SCE/utils/SCEUtils.h>
+#include "SCE/renderer/SCERType.h"
+#include "SCE/renderer/SCERTexture.h"
+#include "SCE/renderer/SCERFramebuffer.h"
+#include "SCE/renderer/SCERShader.h"
+#include "SCE/renderer/SCERWorker.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \ingroup virtualtexture
+ * @{
+ */
+
+/** Maximum number of levels of a virtual texture */
+#define SCE_VT_MAX_LEVELS 16
+/** Number of feedback readbacks in flight */
+#define SCE_VT_READBACK_FRAMES 3
+
+/**
+ * \brief Loads a page of a virtual texture, called by the worker threads
+ * \param level mipmap level of the page
+ * \param x \param y position of the page in its level, in pages
+ * \param texels destination, (page size + 2 * border)^2 RGBA8 texels, the
+ *        border included
+ * \param data user data given to SCE_RBuildVirtualTexture()
+ * \returns SCE_ERROR on error, SCE_OK otherwise
+ */
+typedef int (*SCE_FLoadVirtualPage)(int level, int x, int y,
+                                    unsigned char *texels, void *data);
+
+/** \brief States of a slot of the page cache */
+typedef enum {
+    SCE_VT_PAGE_FREE,
+    SCE_VT_PAGE_LOADING,
+    SCE_VT_PAGE_RESIDENT
+} SCE_RVirtualPageState;
+
+typedef struct sce_rvirtualtexture SCE_RVirtualTexture;
+
+/** \copydoc sce_rvirtualpage */
+typedef struct sce_rvirtualpage SCE_RVirtualPage;
+/**
+ * \brief A slot of the page cache
+ */
+struct sce_rvirtualpage {
+    SCE_RVirtualTexture *vt;    /**< Virtual texture of the page */
+    int slot;                   /**< Index of the slot in the cache */
+    SCE_RVirtualPageState state; /**< State of the slot */
+    int level, x, y;            /**< Virtual page held */
+    unsigned long last_used;    /**< Last frame the page was requested */
+    int pinned;                 /**< Is the page never evicted? */
+    unsigned char *texels;      /**< Loaded texels waiting for upload */
+    int loaded;                 /**< Did the loader succeed? */
+    SCE_RWorkerJob job;         /**< Load job */
+    SCE_SListIterator it;       /**< Own iterator, list of the resident or
+                                 * of the loading pages */
+};
+
+/** \brief A page requested by the feedback pass */
+typedef struct {
+    int level, x, y;            /**< Requested page */
+    unsigned int count;         /**< Number of feedback pixels */
+} SCE_RVirtualPageRequest;
+
+/**
+ * \brief A virtual texture
+ *
+ * Only the requested pages are resident, in slots of \c cache. The
+ * indirection texture has one texel per page and per level, giving the
+ * slot and the level of the most detailed resident page covering it.
+ */
+struct sce_rvirtualtexture {
+    int width, height;          /**< Virtual size in texels */
+    int page_size;              /**< Texels of a page side, border excluded */
+    int border;                 /**< Texels replicated around each page */
+    int n_levels;               /**< Number of levels */
+    int pages_w[SCE_VT_MAX_LEVELS]; /**< Pages of each level */
+    int pages_h[SCE_VT_MAX_LEVELS]; /**< Pages of each level */
+    /** Slot of each page, -1 when absent */
+    int *table[SCE_VT_MAX_LEVELS];
+    /** Levels of \c indirection, owned by its data */
+    unsigned char *indirection_data[SCE_VT_MAX_LEVELS];
+    SCE_RTexture *indirection;  /**< Indirection texture, RGBA8 */
+    int indirection_dirty;      /**< Has \c indirection to be updated? */
+
+    SCE_RTexture *cache;        /**< Physical pages, RGBA8 */
+    int cache_w, cache_h;       /**< Size of the cache in slots */
+    SCE_RVirtualPage *pages;    /**< The slots */
+    int *free_slots;            /**< Stack of the free slots */
+    int n_free;                 /**< Size of \c free_slots */
+    SCE_SList lru;              /**< Resident pages, least recently used
+                                 * first */
+    SCE_SList loading;          /**< Pages being loaded */
+
+    SCE_FLoadVirtualPage load;  /**< Page loader */
+    void *load_data;            /**< Given to \c load */
+    unsigned int max_loads;     /**< Loads started per frame */
+    unsigned int max_uploads;   /**< Pages uploaded per frame */
+
+    SCE_RFramebuffer *feedback; /**< Feedback render target */
+    int feedback_w, feedback_h; /**< Size of \c feedback */
+    float feedback_bias;        /**< Level bias of the feedback pass */
+    SCEuint pbo[SCE_VT_READBACK_FRAMES]; /**< Readback buffers */
+    GLsync fences[SCE_VT_READBACK_FRAMES]; /**< Fences of the readbacks */
+    unsigned int rb_head;       /**< Readbacks issued */
+    unsigned int rb_tail;       /**< Readbacks processed */
+    unsigned char *readback;    /**< Client memory readback, without PBO */
+
+    SCE_RVirtualPageRequest *requests; /**< Requests of the frame */
+    size_t n_requests;          /**< Number of requests */
+    size_t max_requests;        /**< Size of \c requests */
+
+    unsigned long frame;        /**< Frame counter */
+    unsigned int n_uploaded;    /**< Pages uploaded during the last frame */
+    unsigned int n_evicted;     /**< Pages evicted during the last frame */
+};
+
+/** @} */
+
+int SCE_RVirtualTextureInit (void);
+void SCE_RVirtualTextureQuit (void);
+
+void SCE_RInitVirtualTexture (SCE_RVirtualTexture*);
+void SCE_RClearVirtualTexture (SCE_RVirtualTexture*);
+SCE_RVirtualTexture* SCE_RCreateVirtualTexture (void);
+void SCE_RDeleteVirtualTexture (SCE_RVirtualTexture*);
+
+void SCE_RSetVirtualTextureBudget (SCE_RVirtualTexture*, unsigned int,
+                                   unsigned int);
+int SCE_RBuildVirtualTexture (SCE_RVirtualTexture*, int, int, int, int,
+                              int, int, SCE_FLoadVirtualPage, void*);
+int SCE_RBuildVirtualTextureFeedback (SCE_RVirtualTexture*, int, int, int);
+
+const char* SCE_RGetVirtualTextureGLSL (void);
+SCE_RShaderGLSL* SCE_RCreateVirtualTextureShader (void);
+
+void SCE_RBeginVirtualTextureFeedback (SCE_RVirtualTexture*);
+void SCE_REndVirtualTextureFeedback (SCE_RVirtualTexture*);
+
+void SCE_RUpdateVirtualTexture (SCE_RVirtualTexture*);
+void SCE_RUseVirtualTexture (SCE_RVirtualTexture*, SCE_RProgram*, int);
+
+unsigned int SCE_RGetVirtualTextureResidentPages (SCE_RVirtualTexture*);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* guard */
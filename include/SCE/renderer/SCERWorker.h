@@ -0,0 +1,75 @@
+/*------------------------------------------------------------------------------
+    SCEngine - A 3D real time rendering engine written in the C language
+    Copyright (C) 2006-2013  Antony Martin <martin(dot)antony(at)yahoo(dot)fr>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/* created: 19/10/2026
+   updated: 19/10/2026 */
+
+#ifndef SCERWORKER_H
+#define SCERWORKER_H
+
+#include <SCE/utils/SCEUtils.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \ingroup worker
+ * @{
+ */
+
+/** Maximum number of worker threads */
+#define SCE_MAX_WORKERS 16
+
+/** \brief A job function */
+typedef void (*SCE_FWorkerJob)(void*);
+/** \brief A parallel loop body, called on the range [begin, end[ */
+typedef void (*SCE_FWorkerRange)(size_t, size_t, void*);
+
+/** \copydoc sce_rworkerjob */
+typedef struct sce_rworkerjob SCE_RWorkerJob;
+/**
+ * \brief A job run by the worker threads, memory managed by the user
+ */
+struct sce_rworkerjob {
+    SCE_FWorkerJob fun;         /**< Job function */
+    void *data;                 /**< Given to \c fun */
+    int state;                  /**< Internal state, protected by the pool */
+    SCE_RWorkerJob *next;       /**< Next job in the queue */
+};
+
+/** @} */
+
+int SCE_RWorkerInit (void);
+void SCE_RWorkerQuit (void);
+
+void SCE_RSetNumWorkers (unsigned int);
+unsigned int SCE_RGetNumWorkers (void);
+
+void SCE_RInitWorkerJob (SCE_RWorkerJob*, SCE_FWorkerJob, void*);
+void SCE_RPushWorkerJob (SCE_RWorkerJob*);
+int SCE_RIsWorkerJobDone (SCE_RWorkerJob*);
+void SCE_RWaitWorkerJob (SCE_RWorkerJob*);
+
+void SCE_RParallelFor (size_t, size_t, SCE_FWorkerRange, void*);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* guard */
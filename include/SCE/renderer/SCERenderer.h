@@ -33,9 +33,26 @@
 #include "SCE/renderer/SCERVertexArray.h"
 #include "SCE/renderer/SCERVertexBuffer.h"
 #include "SCE/renderer/SCERFeedback.h"
+#include "SCE/renderer/SCERWorker.h"
+#include "SCE/renderer/SCERMipmap.h"
+#include "SCE/renderer/SCERConvert.h"
+#include "SCE/renderer/SCERResample.h"
+#include "SCE/renderer/SCERCompress.h"
 #include "SCE/renderer/SCERTexture.h"
+#include "SCE/renderer/SCERTextureStream.h"
+#include "SCE/renderer/SCERTextureBudget.h"
+#include "SCE/renderer/SCERTextureRealize.h"
+#include "SCE/renderer/SCERUpload.h"
+#include "SCE/renderer/SCERTextureFile.h"
+#include "SCE/renderer/SCERSampler.h"
+#include "SCE/renderer/SCERAtlas.h"
+#include "SCE/renderer/SCERTextureArrayPool.h"
+#include "SCE/renderer/SCERVirtualTexture.h"
+#include "SCE/renderer/SCERVideoTexture.h"
 #include "SCE/renderer/SCERFramebuffer.h"
 #include "SCE/renderer/SCERShader.h"
+#include "SCE/renderer/SCERShaderVariant.h"
+#include "SCE/renderer/SCERShaderWarmup.h"
 #include "SCE/renderer/SCERMaterial.h"
 #include "SCE/renderer/SCERLight.h"
 #include "SCE/renderer/SCEROcclusionQuery.h"
@@ -0,0 +1,717 @@
+/*------------------------------------------------------------------------------
+    SCEngine - A 3D real time rendering engine written in the C language
+    Copyright (C) 2006-2013  Antony Martin <martin(dot)antony(at)yahoo(dot)fr>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/* created: 19/10/2026
+   updated: 19/10/2026 */
+
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+#include <GL/glew.h>
+#include <SCE/utils/SCEUtils.h>
+#include "SCE/renderer/SCERType.h"
+#include "SCE/renderer/SCERSupport.h"
+#include "SCE/renderer/SCERAtlas.h"
+
+/**
+ * \file SCERAtlas.c
+ * \copydoc atlas
+ *
+ * \file SCERAtlas.h
+ * \copydoc atlas
+ */
+
+/**
+ * \defgroup atlas Texture atlases
+ * \ingroup renderer-gl
+ * \brief Packs many small images into a few large textures
+ *
+ * Binding hundreds of tiny textures costs as many state changes. An atlas
+ * packs images into pages, which are either 2D textures or the layers of a
+ * 2D array texture, with a skyline bottom-left packer. Each image is
+ * surrounded by a border replicating its edges and its rectangle can be
+ * aligned, so that filtering and the first mipmap levels don't bleed
+ * between neighbours. Images are uploaded as they are added.
+ *
+ * Removed images leave holes which are reclaimed by SCE_RRepackAtlas(),
+ * that repacks the most wasted pages within a time budget. Repacking moves
+ * the images: read the texture coordinates transform of the entries again
+ * afterwards.
+ * @{
+ */
+
+static unsigned long SCE_RGetAtlasTime (void)
+{
+    struct timespec t;
+    clock_gettime (CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1000000ul + t.tv_nsec / 1000;
+}
+
+
+static void SCE_RFreeAtlasEntry (void *e)
+{
+    SCE_RAtlasEntry *entry = e;
+    SCE_free (entry->pixels);
+    SCE_free (entry);
+}
+
+static void SCE_RFreeAtlasPage (void *p)
+{
+    SCE_RAtlasPage *page = p;
+    SCE_List_Clear (&page->entries);
+    if (page->tex != page->atlas->array)
+        SCE_RDeleteTexture (page->tex);
+    SCE_free (page->nodes);
+    SCE_free (page);
+}
+
+
+void SCE_RInitAtlas (SCE_RAtlas *atlas)
+{
+    atlas->width = atlas->height = 0;
+    atlas->pxf = SCE_PXF_RGBA;
+    atlas->fmt = SCE_IMAGE_RGBA;
+    atlas->type = SCE_UNSIGNED_BYTE;
+    atlas->pixel_size = 4;
+    atlas->padding = 2;
+    atlas->align = 4;
+    atlas->use_mipmap = SCE_FALSE;
+    atlas->max_layers = 0;
+    atlas->array = NULL;
+    SCE_List_Init (&atlas->pages);
+    SCE_List_SetFreeFunc (&atlas->pages, SCE_RFreeAtlasPage);
+    atlas->n_pages = 0;
+    atlas->repack_threshold = 0.25f;
+}
+void SCE_RClearAtlas (SCE_RAtlas *atlas)
+{
+    SCE_List_Clear (&atlas->pages);
+    SCE_RDeleteTexture (atlas->array);
+}
+SCE_RAtlas* SCE_RCreateAtlas (void)
+{
+    SCE_RAtlas *atlas = NULL;
+    if (!(atlas = SCE_malloc (sizeof *atlas)))
+        SCEE_LogSrc ();
+    else
+        SCE_RInitAtlas (atlas);
+    return atlas;
+}
+void SCE_RDeleteAtlas (SCE_RAtlas *atlas)
+{
+    if (atlas) {
+        SCE_RClearAtlas (atlas);
+        SCE_free (atlas);
+    }
+}
+
+/**
+ * \brief Sets the border and the alignment of the images
+ * \param atlas an atlas
+ * \param padding number of pixels replicated around each image, default 2
+ * \param align the padded rectangles sizes are multiples of it, default 4
+ *
+ * With mipmapping, a border of 2^n pixels and an alignment of 2^n keep the
+ * n first levels free of bleeding. Call it before adding images.
+ */
+void SCE_RSetAtlasPadding (SCE_RAtlas *atlas, int padding, int align)
+{
+    atlas->padding = MAX (padding, 0);
+    atlas->align = MAX (align, 1);
+}
+/**
+ * \brief Enables mipmapping of the pages, call it before SCE_RBuildAtlas()
+ * \sa SCE_RUpdateAtlas()
+ */
+void SCE_RSetAtlasMipmapping (SCE_RAtlas *atlas, int use)
+{
+    atlas->use_mipmap = use;
+}
+/**
+ * \brief Sets the wasted fraction of a page above which SCE_RRepackAtlas()
+ * repacks it, default 0.25
+ */
+void SCE_RSetAtlasRepackThreshold (SCE_RAtlas *atlas, float threshold)
+{
+    atlas->repack_threshold = threshold;
+}
+
+static int SCE_RGetAtlasComponents (SCE_EImageFormat fmt)
+{
+    switch (fmt) {
+    case SCE_IMAGE_RED: return 1;
+    case SCE_IMAGE_RG: return 2;
+    case SCE_IMAGE_RGB:
+    case SCE_IMAGE_BGR: return 3;
+    case SCE_IMAGE_RGBA:
+    case SCE_IMAGE_BGRA: return 4;
+    default: return 0;
+    }
+}
+
+/* allocates the levels of a page texture */
+static void SCE_RAllocAtlasTexture (SCE_RAtlas *atlas, SCE_RTexture *tex,
+                                    int layers)
+{
+    SCEenum pxf = SCE_RSCEPxfToGLSized (atlas->pxf);
+    SCEenum fmt = SCE_RSCEImgFormatToGL (atlas->fmt);
+    SCEenum type = sce_rgltypes[atlas->type];
+    int i, levels = 1, w = atlas->width, h = atlas->height;
+
+    if (atlas->use_mipmap) {
+        int m = MAX (w, h);
+        while (m > 1) {
+            m /= 2;
+            levels++;
+        }
+    }
+
+    SCE_RBindTexture (tex);
+    if (pxf && SCE_RHasCap (SCE_TEX_STORAGE)) {
+        if (layers > 0)
+            glTexStorage3D (tex->target, levels, pxf, w, h, layers);
+        else
+            glTexStorage2D (tex->target, levels, pxf, w, h);
+    } else {
+        if (!pxf)
+            pxf = SCE_RSCEPxfToGL (atlas->pxf);
+        for (i = 0; i < levels; i++) {
+            if (layers > 0)
+                glTexImage3D (tex->target, i, pxf, w, h, layers, 0, fmt, type,
+                              NULL);
+            else
+                glTexImage2D (tex->target, i, pxf, w, h, 0, fmt, type, NULL);
+            w = MAX (w / 2, 1);
+            h = MAX (h / 2, 1);
+        }
+    }
+    glTexParameteri (tex->target, GL_TEXTURE_MAX_LEVEL, levels - 1);
+    SCE_RSetTextureFilter (tex, atlas->use_mipmap ?
+                           SCE_TEX_TRILINEAR : SCE_TEX_LINEAR);
+    SCE_RPixelizeTexture (tex, SCE_FALSE);
+    SCE_RSetTextureWrapMode (tex, SCE_TEX_CLAMP);
+}
+
+/**
+ * \brief Creates the textures of an atlas
+ * \param atlas an atlas
+ * \param w \param h size of the pages
+ * \param pxf pixel format of the textures
+ * \param fmt \param type format of the images given to SCE_RAddAtlasEntry()
+ * \param layers maximum number of pages, packed into the layers of a 2D
+ *        array texture, or 0 for an unlimited number of 2D textures
+ * \returns SCE_ERROR on error, SCE_OK otherwise
+ */
+int SCE_RBuildAtlas (SCE_RAtlas *atlas, int w, int h, SCE_EPixelFormat pxf,
+                     SCE_EImageFormat fmt, SCE_EType type, int layers)
+{
+    int n_comps = SCE_RGetAtlasComponents (fmt);
+
+    if (!n_comps || w <= 0 || h <= 0) {
+        SCEE_Log (SCE_INVALID_ARG);
+        SCEE_LogMsg ("invalid atlas format or size");
+        return SCE_ERROR;
+    }
+    atlas->width = w;
+    atlas->height = h;
+    atlas->pxf = pxf;
+    atlas->fmt = fmt;
+    atlas->type = type;
+    atlas->pixel_size = n_comps * SCE_Type_Sizeof (type);
+    atlas->max_layers = MAX (layers, 0);
+    if (atlas->max_layers > 0) {
+        if (!(atlas->array = SCE_RCreateTexture (SCE_TEX_2D_ARRAY))) {
+            SCEE_LogSrc ();
+            return SCE_ERROR;
+        }
+        SCE_RAllocAtlasTexture (atlas, atlas->array, atlas->max_layers);
+    }
+    return SCE_OK;
+}
+
+
+static SCE_RAtlasPage* SCE_RAddAtlasPage (SCE_RAtlas *atlas)
+{
+    SCE_RAtlasPage *page = NULL;
+
+    if (atlas->max_layers > 0 && atlas->n_pages >= atlas->max_layers) {
+        SCEE_Log (SCE_INVALID_OPERATION);
+        SCEE_LogMsg ("all the %d layers of the atlas are full",
+                     atlas->max_layers);
+        return NULL;
+    }
+    if (!(page = SCE_malloc (sizeof *page)))
+        goto fail;
+    page->atlas = atlas;
+    page->tex = atlas->array;
+    page->layer = atlas->n_pages;
+    page->n_nodes = 1;
+    page->used = 0;
+    page->dirty = SCE_FALSE;
+    SCE_List_Init (&page->entries);
+    SCE_List_SetFreeFunc (&page->entries, SCE_RFreeAtlasEntry);
+    SCE_List_InitIt (&page->it);
+    SCE_List_SetData (&page->it, page);
+    if (!(page->nodes = SCE_malloc ((atlas->width + 1) *
+                                    sizeof *page->nodes))) {
+        SCE_free (page);
+        goto fail;
+    }
+    page->nodes[0].x = page->nodes[0].y = 0;
+    page->nodes[0].w = atlas->width;
+
+    if (!page->tex) {
+        if (!(page->tex = SCE_RCreateTexture (SCE_TEX_2D))) {
+            SCE_free (page->nodes);
+            SCE_free (page);
+            goto fail;
+        }
+        page->layer = 0;
+        SCE_RAllocAtlasTexture (atlas, page->tex, 0);
+    }
+    SCE_List_Appendl (&atlas->pages, &page->it);
+    atlas->n_pages++;
+    return page;
+fail:
+    SCEE_LogSrc ();
+    return NULL;
+}
+
+static void SCE_RResetAtlasPage (SCE_RAtlasPage *page)
+{
+    page->n_nodes = 1;
+    page->nodes[0].x = page->nodes[0].y = 0;
+    page->nodes[0].w = page->atlas->width;
+    page->used = 0;
+}
+
+/* lowest y the rectangle can have at node i, -1 if it doesn't fit */
+static int SCE_RFitSkyline (SCE_RAtlasPage *page, int i, int w, int h)
+{
+    int x = page->nodes[i].x, y = page->nodes[i].y, left = w;
+
+    if (x + w > page->atlas->width)
+        return -1;
+    while (left > 0) {
+        if (i >= page->n_nodes)
+            return -1;
+        y = MAX (y, page->nodes[i].y);
+        if (y + h > page->atlas->height)
+            return -1;
+        left -= page->nodes[i].w;
+        i++;
+    }
+    return y;
+}
+/* skyline bottom-left insertion, returns SCE_FALSE if the page is full */
+static int SCE_RInsertSkyline (SCE_RAtlasPage *page, int w, int h,
+                               int *px, int *py)
+{
+    SCE_RSkylineNode *nodes = page->nodes;
+    int i, best = -1, best_y = 0, best_w = 0;
+
+    for (i = 0; i < page->n_nodes; i++) {
+        int y = SCE_RFitSkyline (page, i, w, h);
+        if (y >= 0 && (best < 0 || y + h < best_y + h ||
+                       (y == best_y && nodes[i].w < best_w))) {
+            best = i;
+            best_y = y;
+            best_w = nodes[i].w;
+        }
+    }
+    if (best < 0)
+        return SCE_FALSE;
+
+    *px = nodes[best].x;
+    *py = best_y;
+    /* new node on top of the rectangle */
+    memmove (&nodes[best + 1], &nodes[best],
+             (page->n_nodes - best) * sizeof *nodes);
+    nodes[best].x = *px;
+    nodes[best].y = best_y + h;
+    nodes[best].w = w;
+    page->n_nodes++;
+    /* shrink the nodes it covers */
+    for (i = best + 1; i < page->n_nodes; i++) {
+        int end = nodes[i - 1].x + nodes[i - 1].w;
+        if (nodes[i].x >= end)
+            break;
+        nodes[i].w -= end - nodes[i].x;
+        nodes[i].x = end;
+        if (nodes[i].w > 0)
+            break;
+        memmove (&nodes[i], &nodes[i + 1],
+                 (page->n_nodes - i - 1) * sizeof *nodes);
+        page->n_nodes--;
+        i--;
+    }
+    /* merge the nodes of the same height */
+    for (i = 0; i + 1 < page->n_nodes; i++) {
+        if (nodes[i].y == nodes[i + 1].y) {
+            nodes[i].w += nodes[i + 1].w;
+            memmove (&nodes[i + 1], &nodes[i + 2],
+                     (page->n_nodes - i - 2) * sizeof *nodes);
+            page->n_nodes--;
+            i--;
+        }
+    }
+    page->used += (size_t)w * h;
+    return SCE_TRUE;
+}
+
+/* area under the skyline not used by any rectangle */
+static float SCE_RGetAtlasPageWaste (SCE_RAtlasPage *page)
+{
+    size_t area = 0;
+    int i;
+    for (i = 0; i < page->n_nodes; i++)
+        area += (size_t)page->nodes[i].w * page->nodes[i].y;
+    return (float)(area - page->used) /
+        ((float)page->atlas->width * page->atlas->height);
+}
+
+
+/* builds the padded copy of an image, borders replicate the edges */
+static void SCE_RPadAtlasImage (SCE_RAtlasEntry *entry, const void *pixels)
+{
+    SCE_RAtlas *atlas = entry->page->atlas;
+    const unsigned char *src = pixels;
+    size_t ps = atlas->pixel_size;
+    int x, y, pad = atlas->padding;
+
+    for (y = 0; y < entry->ph; y++) {
+        int sy = MAX (0, MIN (y - pad, entry->h - 1));
+        unsigned char *row = &entry->pixels[(size_t)y * entry->pw * ps];
+        for (x = 0; x < entry->pw; x++) {
+            int sx = MAX (0, MIN (x - pad, entry->w - 1));
+            memcpy (&row[x * ps], &src[((size_t)sy * entry->w + sx) * ps], ps);
+        }
+    }
+}
+
+static void SCE_RUploadAtlasEntry (SCE_RAtlasEntry *entry)
+{
+    SCE_RAtlasPage *page = entry->page;
+    SCE_RAtlas *atlas = page->atlas;
+    SCEenum fmt = SCE_RSCEImgFormatToGL (atlas->fmt);
+    SCEenum type = sce_rgltypes[atlas->type];
+    SCEint unpack;
+
+    glGetIntegerv (GL_UNPACK_ALIGNMENT, &unpack);
+    glPixelStorei (GL_UNPACK_ALIGNMENT, 1);
+    SCE_RBindTexture (page->tex);
+    if (page->tex->target == SCE_TEX_2D_ARRAY)
+        glTexSubImage3D (GL_TEXTURE_2D_ARRAY, 0, entry->x, entry->y,
+                         page->layer, entry->pw, entry->ph, 1, fmt, type,
+                         entry->pixels);
+    else
+        glTexSubImage2D (GL_TEXTURE_2D, 0, entry->x, entry->y, entry->pw,
+                         entry->ph, fmt, type, entry->pixels);
+    glPixelStorei (GL_UNPACK_ALIGNMENT, unpack);
+    page->dirty = SCE_TRUE;
+}
+
+static void SCE_RPlaceAtlasEntry (SCE_RAtlasEntry *entry,
+                                  SCE_RAtlasPage *page, int x, int y)
+{
+    SCE_RAtlas *atlas = page->atlas;
+    entry->page = page;
+    entry->x = x;
+    entry->y = y;
+    entry->scale[0] = (float)entry->w / atlas->width;
+    entry->scale[1] = (float)entry->h / atlas->height;
+    entry->offset[0] = (float)(x + atlas->padding) / atlas->width;
+    entry->offset[1] = (float)(y + atlas->padding) / atlas->height;
+    SCE_List_Appendl (&page->entries, &entry->it);
+}
+
+/* finds room for an entry in any page, adds a page if needed */
+static int SCE_RPackAtlasEntry (SCE_RAtlas *atlas, SCE_RAtlasEntry *entry,
+                                SCE_RAtlasPage *skip)
+{
+    SCE_SListIterator *it = NULL;
+    SCE_RAtlasPage *page = NULL;
+    int x, y;
+
+    SCE_List_ForEach (it, &atlas->pages) {
+        page = SCE_List_GetData (it);
+        if (page != skip &&
+            SCE_RInsertSkyline (page, entry->pw, entry->ph, &x, &y)) {
+            SCE_RPlaceAtlasEntry (entry, page, x, y);
+            return SCE_OK;
+        }
+    }
+    if (!(page = SCE_RAddAtlasPage (atlas)))
+        goto fail;
+    if (!SCE_RInsertSkyline (page, entry->pw, entry->ph, &x, &y)) {
+        SCEE_Log (SCE_INVALID_ARG);
+        SCEE_LogMsg ("image of %dx%d doesn't fit in the atlas",
+                     entry->w, entry->h);
+        goto fail;
+    }
+    SCE_RPlaceAtlasEntry (entry, page, x, y);
+    return SCE_OK;
+fail:
+    SCEE_LogSrc ();
+    return SCE_ERROR;
+}
+
+/**
+ * \brief Adds an image to an atlas and uploads it
+ * \param atlas an atlas built with SCE_RBuildAtlas()
+ * \param w \param h size of the image
+ * \param pixels pixels of the image, in the format given to
+ *        SCE_RBuildAtlas(), rows tightly packed
+ * \returns the new entry, NULL on error
+ */
+SCE_RAtlasEntry* SCE_RAddAtlasEntry (SCE_RAtlas *atlas, int w, int h,
+                                     const void *pixels)
+{
+    SCE_RAtlasEntry *entry = NULL;
+    int a = atlas->align;
+
+    if (!(entry = SCE_malloc (sizeof *entry)))
+        goto fail;
+    entry->w = MAX (w, 1);
+    entry->h = MAX (h, 1);
+    entry->pw = (entry->w + 2 * atlas->padding + a - 1) / a * a;
+    entry->ph = (entry->h + 2 * atlas->padding + a - 1) / a * a;
+    entry->pixels = NULL;
+    SCE_List_InitIt (&entry->it);
+    SCE_List_SetData (&entry->it, entry);
+
+    if (SCE_RPackAtlasEntry (atlas, entry, NULL) < 0) {
+        SCE_free (entry);
+        goto fail;
+    }
+    if (!(entry->pixels = SCE_malloc ((size_t)entry->pw * entry->ph *
+                                      atlas->pixel_size))) {
+        SCE_RRemoveAtlasEntry (entry);
+        goto fail;
+    }
+    SCE_RPadAtlasImage (entry, pixels);
+    SCE_RUploadAtlasEntry (entry);
+    return entry;
+fail:
+    SCEE_LogSrc ();
+    return NULL;
+}
+
+/**
+ * \brief Replaces the pixels of an image, its size doesn't change
+ */
+void SCE_RUpdateAtlasEntry (SCE_RAtlasEntry *entry, const void *pixels)
+{
+    SCE_RPadAtlasImage (entry, pixels);
+    SCE_RUploadAtlasEntry (entry);
+}
+
+/**
+ * \brief Removes an image from its atlas
+ *
+ * Its space is reclaimed when its page is repacked.
+ * \sa SCE_RRepackAtlas()
+ */
+void SCE_RRemoveAtlasEntry (SCE_RAtlasEntry *entry)
+{
+    if (entry) {
+        SCE_List_Remove (&entry->it);
+        entry->page->used -= (size_t)entry->pw * entry->ph;
+        SCE_RFreeAtlasEntry (entry);
+    }
+}
+
+/**
+ * \brief Gets the texture to bind to use an image
+ */
+SCE_RTexture* SCE_RGetAtlasEntryTexture (SCE_RAtlasEntry *entry)
+{
+    return entry->page->tex;
+}
+/**
+ * \brief Gets the layer of the array texture holding an image, 0 when the
+ * pages are 2D textures
+ */
+int SCE_RGetAtlasEntryLayer (SCE_RAtlasEntry *entry)
+{
+    return entry->page->layer;
+}
+
+/**
+ * \brief Regenerates the mipmaps of the modified pages
+ *
+ * Call it once per frame after adding images when mipmapping is enabled.
+ */
+void SCE_RUpdateAtlas (SCE_RAtlas *atlas)
+{
+    SCE_SListIterator *it = NULL;
+    int array_dirty = SCE_FALSE;
+
+    SCE_List_ForEach (it, &atlas->pages) {
+        SCE_RAtlasPage *page = SCE_List_GetData (it);
+        if (!page->dirty)
+            continue;
+        page->dirty = SCE_FALSE;
+        if (!atlas->use_mipmap)
+            continue;
+        if (page->tex == atlas->array)
+            array_dirty = SCE_TRUE;
+        else {
+            SCE_RBindTexture (page->tex);
+            glGenerateMipmap (page->tex->target);
+        }
+    }
+    if (array_dirty) {
+        SCE_RBindTexture (atlas->array);
+        glGenerateMipmap (atlas->array->target);
+    }
+}
+
+static int SCE_RCompareAtlasEntries (const void *a, const void *b)
+{
+    const SCE_RAtlasEntry *ea = *(SCE_RAtlasEntry* const*)a;
+    const SCE_RAtlasEntry *eb = *(SCE_RAtlasEntry* const*)b;
+    if (ea->ph != eb->ph)
+        return eb->ph - ea->ph;
+    return eb->pw - ea->pw;
+}
+/* repacks the entries of a page within the page, nothing moves unless they
+   all fit and less space is wasted; returns SCE_TRUE if the page was
+   repacked */
+static int SCE_RRepackAtlasPage (SCE_RAtlasPage *page)
+{
+    SCE_SListIterator *it = NULL;
+    SCE_RAtlasEntry **entries = NULL;
+    SCE_RSkylineNode *nodes = NULL;
+    int *pos = NULL, n_nodes = page->n_nodes;
+    size_t i, n = 0, used = page->used;
+    float waste = SCE_RGetAtlasPageWaste (page);
+
+    SCE_List_ForEach (it, &page->entries)
+        n++;
+    if (!(nodes = SCE_malloc (n_nodes * sizeof *nodes)))
+        goto fail;
+    if (n > 0 && (!(entries = SCE_malloc (n * sizeof *entries)) ||
+                  !(pos = SCE_malloc (2 * n * sizeof *pos))))
+        goto fail;
+    memcpy (nodes, page->nodes, n_nodes * sizeof *nodes);
+    n = 0;
+    SCE_List_ForEach (it, &page->entries)
+        entries[n++] = SCE_List_GetData (it);
+    /* tallest first packs tighter */
+    if (n > 0)
+        qsort (entries, n, sizeof *entries, SCE_RCompareAtlasEntries);
+
+    SCE_RResetAtlasPage (page);
+    for (i = 0; i < n; i++) {
+        if (!SCE_RInsertSkyline (page, entries[i]->pw, entries[i]->ph,
+                                 &pos[2 * i], &pos[2 * i + 1]))
+            break;
+    }
+    if (i < n || SCE_RGetAtlasPageWaste (page) >= waste) {
+        /* the entries keep their place */
+        memcpy (page->nodes, nodes, n_nodes * sizeof *nodes);
+        page->n_nodes = n_nodes;
+        page->used = used;
+        SCE_free (pos);
+        SCE_free (entries);
+        SCE_free (nodes);
+        return SCE_FALSE;
+    }
+
+    for (i = 0; i < n; i++) {
+        SCE_List_Remove (&entries[i]->it);
+        SCE_RPlaceAtlasEntry (entries[i], page, pos[2 * i], pos[2 * i + 1]);
+        SCE_RUploadAtlasEntry (entries[i]);
+    }
+    SCE_free (pos);
+    SCE_free (entries);
+    SCE_free (nodes);
+    return SCE_TRUE;
+fail:
+    SCE_free (pos);
+    SCE_free (entries);
+    SCE_free (nodes);
+    SCEE_LogSrc ();
+    return SCE_ERROR;
+}
+
+typedef struct {
+    SCE_RAtlasPage *page;
+    float waste;
+} SCE_RAtlasPageWaste;
+
+static int SCE_RCompareAtlasPageWastes (const void *a, const void *b)
+{
+    float wa = ((const SCE_RAtlasPageWaste*)a)->waste;
+    float wb = ((const SCE_RAtlasPageWaste*)b)->waste;
+    return (wa < wb) - (wa > wb);
+}
+/**
+ * \brief Repacks the pages that waste too much space
+ * \param atlas an atlas
+ * \param budget time budget in microseconds, 0 for no limit
+ *
+ * Pages are repacked one at a time, most wasted first, until the budget is
+ * exceeded; call it again on the next frames to continue. Each page is
+ * repacked at most once per call. The images stay in their page, a page
+ * is left as it is when its images wouldn't all fit or when repacking
+ * wouldn't waste less space.
+ * \returns the number of repacked pages
+ * \sa SCE_RSetAtlasRepackThreshold()
+ */
+unsigned int SCE_RRepackAtlas (SCE_RAtlas *atlas, unsigned long budget)
+{
+    unsigned long start = SCE_RGetAtlasTime ();
+    SCE_SListIterator *it = NULL;
+    SCE_RAtlasPageWaste *pages = NULL;
+    unsigned int n = 0;
+    size_t i, n_pages = 0;
+
+    if (atlas->n_pages == 0)
+        return 0;
+    if (!(pages = SCE_malloc (atlas->n_pages * sizeof *pages))) {
+        SCEE_LogSrc ();
+        return 0;
+    }
+    SCE_List_ForEach (it, &atlas->pages) {
+        SCE_RAtlasPage *page = SCE_List_GetData (it);
+        float waste = SCE_RGetAtlasPageWaste (page);
+        if (waste > atlas->repack_threshold) {
+            pages[n_pages].page = page;
+            pages[n_pages].waste = waste;
+            n_pages++;
+        }
+    }
+    /* most wasted first */
+    qsort (pages, n_pages, sizeof *pages, SCE_RCompareAtlasPageWastes);
+
+    for (i = 0; i < n_pages; i++) {
+        int r = SCE_RRepackAtlasPage (pages[i].page);
+        if (r < 0)
+            break;
+        if (r)
+            n++;
+        if (budget && SCE_RGetAtlasTime () - start >= budget)
+            break;
+    }
+    SCE_free (pages);
+    return n;
+}
+
+/** @} */
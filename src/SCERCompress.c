@@ -0,0 +1,544 @@
+/*------------------------------------------------------------------------------
+    SCEngine - A 3D real time rendering engine written in the C language
+    Copyright (C) 2006-2013  Antony Martin <martin(dot)antony(at)yahoo(dot)fr>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/* created: 19/10/2026
+   updated: 19/10/2026 */
+
+#include <string.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include <SCE/utils/SCEUtils.h>
+#include "SCE/renderer/SCERWorker.h"
+#include "SCE/renderer/SCERCompress.h"
+
+/**
+ * \file SCERCompress.c
+ * \copydoc compress
+ *
+ * \file SCERCompress.h
+ * \copydoc compress
+ */
+
+/**
+ * \defgroup compress Block compression
+ * \ingroup renderer-gl
+ * \brief Runtime encoder of BC1 to BC5 (DXT, RGTC) textures
+ *
+ * Compresses 8 bits images generated at runtime (lightmaps, atlases...) so
+ * that they take 4 to 8 times less video memory. Rows of 4x4 blocks are
+ * encoded in parallel by the worker threads. Color endpoints come from the
+ * bounding box or the principal axis of the block and are refined by least
+ * squares depending on the quality; indices are fitted with SSE2 when
+ * available. See SCE_RSetTextureCompression() to compress the data of a
+ * texture when it is built.
+ * @{
+ */
+
+static const size_t block_sizes[SCE_NUM_BLOCK_FORMATS] = {8, 16, 16, 8, 16};
+
+/**
+ * \brief Gets the size in bytes of a compressed image
+ */
+size_t SCE_RGetCompressedSize (int w, int h, SCE_RBlockFormat bc)
+{
+    size_t bw = (MAX (w, 1) + 3) / 4, bh = (MAX (h, 1) + 3) / 4;
+    return bw * bh * block_sizes[bc];
+}
+
+/**
+ * \brief Gets the block format of a compressed pixel format
+ * \returns SCE_TRUE if \p pxf is a format the encoder produces
+ */
+int SCE_RGetPxfBlockFormat (SCE_EPixelFormat pxf, SCE_RBlockFormat *bc)
+{
+    switch (pxf) {
+    case SCE_PXF_DXT1: *bc = SCE_BC1; return SCE_TRUE;
+    case SCE_PXF_DXT3: *bc = SCE_BC2; return SCE_TRUE;
+    case SCE_PXF_DXT5: *bc = SCE_BC3; return SCE_TRUE;
+    case SCE_PXF_3DC: *bc = SCE_BC5; return SCE_TRUE;
+    default: return SCE_FALSE;
+    }
+}
+
+
+/* RGBA pixels of a 4x4 block */
+typedef unsigned char SCE_RBlock[16][4];
+
+static void SCE_RPutLE16 (unsigned char *p, unsigned int v)
+{
+    p[0] = v & 0xff;
+    p[1] = (v >> 8) & 0xff;
+}
+
+static unsigned int SCE_RPack565 (const float *c)
+{
+    int r = (int)(c[0] * 31.0f / 255.0f + 0.5f);
+    int g = (int)(c[1] * 63.0f / 255.0f + 0.5f);
+    int b = (int)(c[2] * 31.0f / 255.0f + 0.5f);
+    r = MAX (0, MIN (r, 31));
+    g = MAX (0, MIN (g, 63));
+    b = MAX (0, MIN (b, 31));
+    return (r << 11) | (g << 5) | b;
+}
+static void SCE_RUnpack565 (unsigned int c, float *out)
+{
+    unsigned int r = (c >> 11) & 31, g = (c >> 5) & 63, b = c & 31;
+    out[0] = (r << 3) | (r >> 2);
+    out[1] = (g << 2) | (g >> 4);
+    out[2] = (b << 3) | (b >> 2);
+}
+
+/* assigns the nearest of the 4 palette colors to each pixel, returns the
+   squared error */
+static float SCE_RFitColorIndices (const float px[3][16], float pal[4][3],
+                                   unsigned char *idx)
+{
+    float err = 0.0f;
+    int i, k;
+#ifdef __SSE2__
+    for (i = 0; i < 16; i += 4) {
+        __m128 r = _mm_loadu_ps (&px[0][i]);
+        __m128 g = _mm_loadu_ps (&px[1][i]);
+        __m128 b = _mm_loadu_ps (&px[2][i]);
+        __m128 best = _mm_set1_ps (1e30f);
+        __m128i besti = _mm_setzero_si128 ();
+        float e[4];
+        int bi[4];
+        for (k = 0; k < 4; k++) {
+            __m128 dr = _mm_sub_ps (r, _mm_set1_ps (pal[k][0]));
+            __m128 dg = _mm_sub_ps (g, _mm_set1_ps (pal[k][1]));
+            __m128 db = _mm_sub_ps (b, _mm_set1_ps (pal[k][2]));
+            __m128 d = _mm_add_ps (_mm_add_ps (_mm_mul_ps (dr, dr),
+                                               _mm_mul_ps (dg, dg)),
+                                   _mm_mul_ps (db, db));
+            __m128 less = _mm_cmplt_ps (d, best);
+            __m128i lessi = _mm_castps_si128 (less);
+            best = _mm_min_ps (d, best);
+            besti = _mm_or_si128 (_mm_and_si128 (lessi, _mm_set1_epi32 (k)),
+                                  _mm_andnot_si128 (lessi, besti));
+        }
+        _mm_storeu_ps (e, best);
+        _mm_storeu_si128 ((__m128i*)bi, besti);
+        for (k = 0; k < 4; k++) {
+            idx[i + k] = bi[k];
+            err += e[k];
+        }
+    }
+#else
+    for (i = 0; i < 16; i++) {
+        float best = 1e30f;
+        for (k = 0; k < 4; k++) {
+            float dr = px[0][i] - pal[k][0], dg = px[1][i] - pal[k][1];
+            float db = px[2][i] - pal[k][2];
+            float d = dr * dr + dg * dg + db * db;
+            if (d < best) {
+                best = d;
+                idx[i] = k;
+            }
+        }
+        err += best;
+    }
+#endif
+    return err;
+}
+
+/* quantizes the endpoints, fits the indices; returns the squared error */
+static float SCE_REncodeColorEndpoints (const float px[3][16], const float *a,
+                                        const float *b, unsigned int *c0,
+                                        unsigned int *c1, unsigned char *idx)
+{
+    float pal[4][3];
+    int i;
+
+    *c0 = SCE_RPack565 (a);
+    *c1 = SCE_RPack565 (b);
+    if (*c0 < *c1) {
+        unsigned int t = *c0;
+        *c0 = *c1;
+        *c1 = t;
+    }
+    SCE_RUnpack565 (*c0, pal[0]);
+    SCE_RUnpack565 (*c1, pal[1]);
+    for (i = 0; i < 3; i++) {
+        pal[2][i] = (2.0f * pal[0][i] + pal[1][i]) / 3.0f;
+        pal[3][i] = (pal[0][i] + 2.0f * pal[1][i]) / 3.0f;
+    }
+    if (*c0 == *c1) {
+        /* 3 colors mode, all the pixels use the first one */
+        float err = 0.0f;
+        for (i = 0; i < 16; i++) {
+            float dr = px[0][i] - pal[0][0], dg = px[1][i] - pal[0][1];
+            float db = px[2][i] - pal[0][2];
+            idx[i] = 0;
+            err += dr * dr + dg * dg + db * db;
+        }
+        return err;
+    }
+    return SCE_RFitColorIndices (px, pal, idx);
+}
+
+/* least squares endpoints for the given indices */
+static int SCE_RRefineColorEndpoints (const float px[3][16],
+                                      const unsigned char *idx,
+                                      float *a, float *b)
+{
+    static const float weights[4] = {1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f};
+    float aa = 0.0f, bb = 0.0f, ab = 0.0f, ax[3] = {0}, bx[3] = {0}, det;
+    int i, c;
+
+    for (i = 0; i < 16; i++) {
+        float w = weights[idx[i]], v = 1.0f - w;
+        aa += w * w;
+        bb += v * v;
+        ab += w * v;
+        for (c = 0; c < 3; c++) {
+            ax[c] += w * px[c][i];
+            bx[c] += v * px[c][i];
+        }
+    }
+    det = aa * bb - ab * ab;
+    if (det < 1e-6f && det > -1e-6f)
+        return SCE_FALSE;
+    for (c = 0; c < 3; c++) {
+        a[c] = MAX (0.0f, MIN ((ax[c] * bb - bx[c] * ab) / det, 255.0f));
+        b[c] = MAX (0.0f, MIN ((bx[c] * aa - ax[c] * ab) / det, 255.0f));
+    }
+    return SCE_TRUE;
+}
+
+/* endpoints at the extremes of the principal axis of the block */
+static void SCE_RGetColorAxisEndpoints (const float px[3][16], float *a,
+                                        float *b)
+{
+    float mean[3] = {0}, cov[6] = {0}, axis[3] = {1.0f, 1.0f, 1.0f};
+    float tmin = 1e30f, tmax = -1e30f;
+    int i, k;
+
+    for (i = 0; i < 16; i++)
+        for (k = 0; k < 3; k++)
+            mean[k] += px[k][i] / 16.0f;
+    for (i = 0; i < 16; i++) {
+        float r = px[0][i] - mean[0], g = px[1][i] - mean[1];
+        float bl = px[2][i] - mean[2];
+        cov[0] += r * r; cov[1] += r * g; cov[2] += r * bl;
+        cov[3] += g * g; cov[4] += g * bl; cov[5] += bl * bl;
+    }
+    /* power iterations */
+    for (k = 0; k < 8; k++) {
+        float x = cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2];
+        float y = cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2];
+        float z = cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2];
+        float m = MAX (MAX (x < 0 ? -x : x, y < 0 ? -y : y), z < 0 ? -z : z);
+        if (m < 1e-6f)
+            break;
+        axis[0] = x / m;
+        axis[1] = y / m;
+        axis[2] = z / m;
+    }
+    for (i = 0; i < 16; i++) {
+        float t = (px[0][i] - mean[0]) * axis[0] +
+            (px[1][i] - mean[1]) * axis[1] + (px[2][i] - mean[2]) * axis[2];
+        tmin = MIN (tmin, t);
+        tmax = MAX (tmax, t);
+    }
+    {
+        float n = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2];
+        if (n < 1e-12f)
+            n = 1.0f;
+        for (k = 0; k < 3; k++) {
+            a[k] = MAX (0.0f, MIN (mean[k] + axis[k] * tmax / n, 255.0f));
+            b[k] = MAX (0.0f, MIN (mean[k] + axis[k] * tmin / n, 255.0f));
+        }
+    }
+}
+
+static void SCE_RGetColorBoxEndpoints (const float px[3][16], float *a,
+                                       float *b)
+{
+    int i, k;
+    for (k = 0; k < 3; k++) {
+        float mn = 255.0f, mx = 0.0f, inset;
+        for (i = 0; i < 16; i++) {
+            mn = MIN (mn, px[k][i]);
+            mx = MAX (mx, px[k][i]);
+        }
+        inset = (mx - mn) / 16.0f;
+        a[k] = mx - inset;
+        b[k] = mn + inset;
+    }
+}
+
+static void SCE_REncodeColorBlock (SCE_RBlock block, SCE_RCompressQuality q,
+                                   unsigned char *out)
+{
+    float px[3][16], a[3], b[3], err;
+    unsigned int c0, c1, bits = 0;
+    unsigned char idx[16];
+    int i, k, n_iter;
+
+    for (i = 0; i < 16; i++)
+        for (k = 0; k < 3; k++)
+            px[k][i] = block[i][k];
+
+    if (q == SCE_COMPRESS_FAST)
+        SCE_RGetColorBoxEndpoints (px, a, b);
+    else
+        SCE_RGetColorAxisEndpoints (px, a, b);
+    err = SCE_REncodeColorEndpoints (px, a, b, &c0, &c1, idx);
+
+    n_iter = (q == SCE_COMPRESS_FAST ? 0 : q == SCE_COMPRESS_NORMAL ? 1 : 4);
+    for (i = 0; i < n_iter && err > 0.0f; i++) {
+        unsigned int d0, d1;
+        unsigned char didx[16];
+        float derr;
+        if (!SCE_RRefineColorEndpoints (px, idx, a, b))
+            break;
+        derr = SCE_REncodeColorEndpoints (px, a, b, &d0, &d1, didx);
+        if (derr >= err)
+            break;
+        err = derr;
+        c0 = d0;
+        c1 = d1;
+        memcpy (idx, didx, 16);
+    }
+
+    for (i = 15; i >= 0; i--)
+        bits = (bits << 2) | idx[i];
+    SCE_RPutLE16 (out, c0);
+    SCE_RPutLE16 (&out[2], c1);
+    SCE_RPutLE16 (&out[4], bits & 0xffff);
+    SCE_RPutLE16 (&out[6], bits >> 16);
+}
+
+/* interpolated single channel block (BC3 alpha, BC4, BC5) */
+static void SCE_RGetChannelPalette (int a0, int a1, int *pal)
+{
+    int i;
+    pal[0] = a0;
+    pal[1] = a1;
+    if (a0 > a1) {
+        for (i = 1; i < 7; i++)
+            pal[i + 1] = ((7 - i) * a0 + i * a1 + 3) / 7;
+    } else {
+        for (i = 1; i < 5; i++)
+            pal[i + 1] = ((5 - i) * a0 + i * a1 + 2) / 5;
+        pal[6] = 0;
+        pal[7] = 255;
+    }
+}
+static int SCE_RFitChannelIndices (const int *v, int a0, int a1,
+                                   unsigned char *idx)
+{
+    int pal[8], i, k, err = 0;
+    SCE_RGetChannelPalette (a0, a1, pal);
+    for (i = 0; i < 16; i++) {
+        int best = 1 << 30;
+        for (k = 0; k < 8; k++) {
+            int d = (v[i] - pal[k]) * (v[i] - pal[k]);
+            if (d < best) {
+                best = d;
+                idx[i] = k;
+            }
+        }
+        err += best;
+    }
+    return err;
+}
+static void SCE_REncodeChannelBlock (SCE_RBlock block, int channel,
+                                     SCE_RCompressQuality q,
+                                     unsigned char *out)
+{
+    int v[16], i, mn = 255, mx = 0, a0, a1, err;
+    unsigned char idx[16];
+    unsigned long long bits = 0;
+
+    for (i = 0; i < 16; i++) {
+        v[i] = block[i][channel];
+        mn = MIN (mn, v[i]);
+        mx = MAX (mx, v[i]);
+    }
+    a0 = mx;
+    a1 = mn;
+    if (mx == mn) {
+        memset (idx, 0, 16);
+        err = 0;
+    } else if (q == SCE_COMPRESS_FAST) {
+        /* projection on the 8 steps between the endpoints */
+        for (i = 0; i < 16; i++) {
+            int k = ((v[i] - mn) * 7 + (mx - mn) / 2) / (mx - mn);
+            idx[i] = (k == 7 ? 0 : k == 0 ? 1 : 8 - k);
+        }
+        err = 0;
+    } else
+        err = SCE_RFitChannelIndices (v, a0, a1, idx);
+
+    if (q == SCE_COMPRESS_HIGH && err > 0) {
+        /* 6 values mode, 0 and 255 are exact, the endpoints cover the rest */
+        int m0 = 255, m1 = 0, e6;
+        unsigned char idx6[16];
+        for (i = 0; i < 16; i++) {
+            if (v[i] > 0 && v[i] < 255) {
+                m0 = MIN (m0, v[i]);
+                m1 = MAX (m1, v[i]);
+            }
+        }
+        if (m0 > m1)
+            m0 = m1 = 0;
+        e6 = SCE_RFitChannelIndices (v, m0, m1, idx6);
+        if (e6 < err) {
+            a0 = m0;
+            a1 = m1;
+            memcpy (idx, idx6, 16);
+        }
+    }
+
+    for (i = 15; i >= 0; i--)
+        bits = (bits << 3) | idx[i];
+    out[0] = a0;
+    out[1] = a1;
+    for (i = 0; i < 6; i++)
+        out[2 + i] = (bits >> (8 * i)) & 0xff;
+}
+
+static void SCE_REncodeExplicitAlphaBlock (SCE_RBlock block,
+                                           unsigned char *out)
+{
+    int i;
+    for (i = 0; i < 16; i += 2) {
+        int lo = (block[i][3] * 15 + 127) / 255;
+        int hi = (block[i + 1][3] * 15 + 127) / 255;
+        out[i / 2] = lo | (hi << 4);
+    }
+}
+
+
+typedef struct {
+    const unsigned char *src;
+    unsigned char *dst;
+    int w, h, n_comps, bgr;
+    SCE_RBlockFormat bc;
+    SCE_RCompressQuality q;
+} SCE_RCompressJob;
+
+/* reads a 4x4 block as RGBA, clamped to the image edge */
+static void SCE_RGetBlock (const SCE_RCompressJob *job, int bx, int by,
+                           SCE_RBlock block)
+{
+    int x, y, c;
+    for (y = 0; y < 4; y++) {
+        int sy = MIN (by * 4 + y, job->h - 1);
+        for (x = 0; x < 4; x++) {
+            int sx = MIN (bx * 4 + x, job->w - 1);
+            const unsigned char *p =
+                &job->src[((size_t)sy * job->w + sx) * job->n_comps];
+            unsigned char *o = block[y * 4 + x];
+            o[0] = o[1] = o[2] = 0;
+            o[3] = 255;
+            for (c = 0; c < job->n_comps; c++)
+                o[c] = p[c];
+            if (job->bgr) {
+                o[0] = p[2];
+                o[2] = p[0];
+            }
+        }
+    }
+}
+
+static void SCE_RCompressBlockRows (size_t begin, size_t end, void *data)
+{
+    SCE_RCompressJob *job = data;
+    int bw = (job->w + 3) / 4, bx;
+    size_t by, size = block_sizes[job->bc];
+    SCE_RBlock block;
+
+    for (by = begin; by < end; by++) {
+        for (bx = 0; bx < bw; bx++) {
+            unsigned char *out = &job->dst[(by * bw + bx) * size];
+            SCE_RGetBlock (job, bx, by, block);
+            switch (job->bc) {
+            case SCE_BC1:
+                SCE_REncodeColorBlock (block, job->q, out);
+                break;
+            case SCE_BC2:
+                SCE_REncodeExplicitAlphaBlock (block, out);
+                SCE_REncodeColorBlock (block, job->q, &out[8]);
+                break;
+            case SCE_BC3:
+                SCE_REncodeChannelBlock (block, 3, job->q, out);
+                SCE_REncodeColorBlock (block, job->q, &out[8]);
+                break;
+            case SCE_BC4:
+                SCE_REncodeChannelBlock (block, 0, job->q, out);
+                break;
+            case SCE_BC5:
+                SCE_REncodeChannelBlock (block, 0, job->q, out);
+                SCE_REncodeChannelBlock (block, 1, job->q, &out[8]);
+                break;
+            default:;
+            }
+        }
+    }
+}
+
+/**
+ * \brief Compresses an image
+ * \param src source pixels, 8 bits per component, rows tightly packed
+ * \param w \param h size of the image
+ * \param fmt format of \p src: SCE_IMAGE_RED, RG, RGB, BGR, RGBA or BGRA
+ * \param bc block format to produce
+ * \param q encoding quality
+ * \param dst compressed blocks, of SCE_RGetCompressedSize() bytes
+ *
+ * Missing components read as 0, alpha as 255. BC4 encodes the first
+ * component and BC5 the first two.
+ * \returns SCE_ERROR on error, SCE_OK otherwise
+ */
+int SCE_RCompressImage (const void *src, int w, int h, SCE_EImageFormat fmt,
+                        SCE_RBlockFormat bc, SCE_RCompressQuality q, void *dst)
+{
+    SCE_RCompressJob job;
+    size_t bh;
+
+    job.bgr = SCE_FALSE;
+    switch (fmt) {
+    case SCE_IMAGE_RED: job.n_comps = 1; break;
+    case SCE_IMAGE_RG: job.n_comps = 2; break;
+    case SCE_IMAGE_BGR: job.bgr = SCE_TRUE; /* fall through */
+    case SCE_IMAGE_RGB: job.n_comps = 3; break;
+    case SCE_IMAGE_BGRA: job.bgr = SCE_TRUE; /* fall through */
+    case SCE_IMAGE_RGBA: job.n_comps = 4; break;
+    default:
+        SCEE_Log (SCE_INVALID_ARG);
+        SCEE_LogMsg ("can't compress images of format %d", (int)fmt);
+        return SCE_ERROR;
+    }
+    job.src = src;
+    job.dst = dst;
+    job.w = MAX (w, 1);
+    job.h = MAX (h, 1);
+    job.bc = bc;
+    job.q = q;
+
+    bh = (job.h + 3) / 4;
+    SCE_RParallelFor (bh, MAX (1, 256 / ((job.w + 3) / 4)),
+                      SCE_RCompressBlockRows, &job);
+    return SCE_OK;
+}
+
+/** @} */
@@ -0,0 +1,674 @@
+/*------------------------------------------------------------------------------
+    SCEngine - A 3D real time rendering engine written in the C language
+    Copyright (C) 2006-2013  Antony Martin <martin(dot)antony(at)yahoo(dot)fr>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/* created: 19/10/2026
+   updated: 19/10/2026 */
+
+#include <string.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#if defined (SCE_SIMD_DISPATCH) || defined (__SSSE3__) || \
+    defined (__AVX2__) || defined (__F16C__)
+#include <immintrin.h>
+#endif
+#ifdef SCE_SIMD_DISPATCH
+#include <cpuid.h>
+#endif
+#include <SCE/utils/SCEUtils.h>
+#include "SCE/renderer/SCERWorker.h"
+#include "SCE/renderer/SCERConvert.h"
+
+/**
+ * \file SCERConvert.c
+ * \copydoc convert
+ *
+ * \file SCERConvert.h
+ * \copydoc convert
+ */
+
+/**
+ * \defgroup convert Pixel format conversion
+ * \ingroup renderer-gl
+ * \brief Conversion of images between formats and component types
+ *
+ * Converts images between the formats SCE_IMAGE_RED, SCE_IMAGE_RG,
+ * SCE_IMAGE_RGB, SCE_IMAGE_BGR, SCE_IMAGE_RGBA and SCE_IMAGE_BGRA of
+ * components of type SCE_UNSIGNED_BYTE, SCE_HALF_FLOAT or SCE_FLOAT,
+ * optionally premultiplying the alpha. Missing color components are 0 and
+ * a missing alpha is 1. Used by SCE_RBuildTexture() when the data of a
+ * texture isn't in the format it is uploaded in, see
+ * SCE_RSetTextureConversion(). The functions don't call the GL.
+ *
+ * The common cases have their own kernels: 8 bits expansion and swizzling
+ * (SSSE3, AVX2), 8 bits premultiplication (SSE2) and float to half float
+ * conversions (F16C), the others go through a float row. The row
+ * conversions between 8 bits or half floats and floats are also used by
+ * the mipmap generation and the resampling. Rows are split among the
+ * worker threads.
+ *
+ * The SSSE3, AVX2 and F16C kernels are built when the compiler targets
+ * these instruction sets. When configure finds that the compiler supports
+ * per function targets, SCE_SIMD_DISPATCH is defined: the kernels are
+ * always built and chosen at run time from what cpuid reports.
+ * @{
+ */
+
+#ifdef SCE_SIMD_DISPATCH
+#define SCE_SIMD_SSSE3 1
+#define SCE_SIMD_AVX2 1
+#define SCE_SIMD_F16C 1
+#define SCE_TARGET(t) __attribute__ ((target (t)))
+#define SCE_HAS_SIMD(f) (SCE_RGetCPUFeatures () & (f))
+#else
+#ifdef __SSSE3__
+#define SCE_SIMD_SSSE3 1
+#endif
+#ifdef __AVX2__
+#define SCE_SIMD_AVX2 1
+#endif
+#if defined (__F16C__) && defined (__AVX__)
+#define SCE_SIMD_F16C 1
+#endif
+#define SCE_TARGET(t)
+#define SCE_HAS_SIMD(f) 1
+#endif
+
+enum {
+    SCE_CPU_SSSE3 = 1,
+    SCE_CPU_AVX2 = 2,
+    SCE_CPU_F16C = 4
+};
+
+#ifdef SCE_SIMD_DISPATCH
+/* the threads may all compute it at first, they get the same value */
+static unsigned int SCE_RGetCPUFeatures (void)
+{
+    static int features = -1;
+    unsigned int a, b, c, d, f = 0;
+    int avx = SCE_FALSE;
+
+    if (features >= 0)
+        return features;
+    if (__get_cpuid (1, &a, &b, &c, &d)) {
+        if (c & bit_SSSE3)
+            f |= SCE_CPU_SSSE3;
+        /* the OS must save the AVX registers */
+        if ((c & bit_OSXSAVE) && (c & bit_AVX)) {
+            unsigned int lo, hi;
+            __asm__ ("xgetbv" : "=a" (lo), "=d" (hi) : "c" (0));
+            avx = (lo & 6) == 6;
+        }
+        if (avx && (c & bit_F16C))
+            f |= SCE_CPU_F16C;
+        if (avx && __get_cpuid_max (0, NULL) >= 7) {
+            __cpuid_count (7, 0, a, b, c, d);
+            if (b & bit_AVX2)
+                f |= SCE_CPU_AVX2;
+        }
+    }
+    features = f;
+    return f;
+}
+#endif
+
+/* source component of each channel (R, G, B, A), -1 when missing */
+typedef struct {
+    int n;
+    int map[4];
+} SCE_RConvertFormat;
+
+static const SCE_RConvertFormat sce_rconvformats[] = {
+    {0, {-1, -1, -1, -1}},      /* SCE_IMAGE_NONE */
+    {1, {0, -1, -1, -1}},       /* SCE_IMAGE_RED */
+    {2, {0, 1, -1, -1}},        /* SCE_IMAGE_RG */
+    {3, {0, 1, 2, -1}},         /* SCE_IMAGE_RGB */
+    {3, {2, 1, 0, -1}},         /* SCE_IMAGE_BGR */
+    {4, {0, 1, 2, 3}},          /* SCE_IMAGE_RGBA */
+    {4, {2, 1, 0, 3}}           /* SCE_IMAGE_BGRA */
+};
+#define SCE_NUM_CONVERT_FORMATS \
+    (sizeof sce_rconvformats / sizeof sce_rconvformats[0])
+
+typedef struct sce_rconvertjob SCE_RConvertJob;
+typedef void (*SCE_FConvertRow)(const SCE_RConvertJob*, const void*, void*,
+                                float*);
+
+struct sce_rconvertjob {
+    const unsigned char *src;
+    unsigned char *dst;
+    int w;
+    size_t src_pitch, dst_pitch;
+    SCE_EType stype, dtype;
+    const SCE_RConvertFormat *sfmt, *dfmt;
+    int dch[4];                 /* channel of each destination component */
+    int pattern[4];             /* 8 bits: source byte of each destination
+                                 * component, -1 for fill */
+    unsigned char fill[4];
+    int premultiply;
+    SCE_FConvertRow fun;
+    int failed;
+};
+
+
+/**
+ * \brief Converts a half float to a float
+ */
+float SCE_RHalfToFloat (unsigned short h)
+{
+    union { unsigned int u; float f; } v;
+    unsigned int s = (h & 0x8000) << 16, e = (h >> 10) & 0x1f, m = h & 0x3ff;
+
+    if (e == 0) {
+        float f = m / 16777216.0f;
+        return s ? -f : f;
+    } else if (e == 31)
+        v.u = s | 0x7f800000 | (m << 13);
+    else
+        v.u = s | ((e + 112) << 23) | (m << 13);
+    return v.f;
+}
+/**
+ * \brief Converts a float to a half float, rounding to the nearest
+ */
+unsigned short SCE_RFloatToHalf (float f)
+{
+    union { unsigned int u; float f; } v;
+    unsigned int s, m;
+    int e;
+
+    v.f = f;
+    s = (v.u >> 16) & 0x8000;
+    m = v.u & 0x7fffff;
+    if (((v.u >> 23) & 0xff) == 0xff)
+        return s | 0x7c00 | (m ? 0x200 : 0);
+    e = (int)((v.u >> 23) & 0xff) - 127 + 15;
+    if (e >= 31)
+        return s | 0x7c00;
+    if (e <= 0) {
+        unsigned int shift, hm;
+        if (e < -10)
+            return s;
+        m |= 0x800000;
+        shift = 14 - e;
+        hm = m >> shift;
+        if ((m >> (shift - 1)) & 1)
+            hm++;
+        return s | hm;
+    }
+    m += 0x1000;
+    if (m & 0x800000) {
+        m = 0;
+        if (++e >= 31)
+            return s | 0x7c00;
+    }
+    return s | (e << 10) | (m >> 13);
+}
+
+
+static size_t SCE_RGetConvertTypeSize (SCE_EType type)
+{
+    switch (type) {
+    case SCE_UNSIGNED_BYTE: return 1;
+    case SCE_HALF_FLOAT: return 2;
+    case SCE_FLOAT: return 4;
+    default: return 0;
+    }
+}
+static const SCE_RConvertFormat* SCE_RGetConvertFormat (SCE_EImageFormat fmt)
+{
+    if (fmt <= SCE_IMAGE_NONE || fmt >= SCE_NUM_CONVERT_FORMATS)
+        return NULL;
+    return &sce_rconvformats[fmt];
+}
+
+/**
+ * \brief Checks whether images can be converted between two formats
+ */
+int SCE_RIsConversionSupported (SCE_EImageFormat sfmt, SCE_EType stype,
+                                SCE_EImageFormat dfmt, SCE_EType dtype)
+{
+    return SCE_RGetConvertFormat (sfmt) && SCE_RGetConvertFormat (dfmt) &&
+        SCE_RGetConvertTypeSize (stype) && SCE_RGetConvertTypeSize (dtype);
+}
+
+/**
+ * \brief Gets the size in bytes of an image, 0 when its format isn't
+ * supported by SCE_RConvertImage()
+ */
+size_t SCE_RGetConvertedImageSize (int w, int h, SCE_EImageFormat fmt,
+                                   SCE_EType type)
+{
+    const SCE_RConvertFormat *f = SCE_RGetConvertFormat (fmt);
+    if (!f)
+        return 0;
+    return (size_t)MAX (w, 1) * MAX (h, 1) * f->n *
+        SCE_RGetConvertTypeSize (type);
+}
+
+
+/* (x * a + 127) / 255, exactly */
+#define SCE_RMUL8(x, a) ((((x) * (a) + 128) + (((x) * (a) + 128) >> 8)) >> 8)
+
+static void SCE_RPremultiplyRow8 (unsigned char *p, int w)
+{
+    int x = 0;
+#ifdef __SSE2__
+    const __m128i zero = _mm_setzero_si128 ();
+    const __m128i half = _mm_set1_epi16 (128);
+    /* alpha lanes keep their value: multiplied by 255 */
+    const __m128i amask = _mm_set_epi16 (-1, 0, 0, 0, -1, 0, 0, 0);
+    const __m128i a255 = _mm_set_epi16 (255, 0, 0, 0, 255, 0, 0, 0);
+
+    for (; x + 4 <= w; x += 4) {
+        __m128i v = _mm_loadu_si128 ((const __m128i*)&p[x * 4]);
+        __m128i lo = _mm_unpacklo_epi8 (v, zero);
+        __m128i hi = _mm_unpackhi_epi8 (v, zero);
+        __m128i alo, ahi, t;
+
+        alo = _mm_shufflehi_epi16 (_mm_shufflelo_epi16 (lo, 0xff), 0xff);
+        ahi = _mm_shufflehi_epi16 (_mm_shufflelo_epi16 (hi, 0xff), 0xff);
+        alo = _mm_or_si128 (_mm_andnot_si128 (amask, alo), a255);
+        ahi = _mm_or_si128 (_mm_andnot_si128 (amask, ahi), a255);
+
+        t = _mm_add_epi16 (_mm_mullo_epi16 (lo, alo), half);
+        lo = _mm_srli_epi16 (_mm_add_epi16 (t, _mm_srli_epi16 (t, 8)), 8);
+        t = _mm_add_epi16 (_mm_mullo_epi16 (hi, ahi), half);
+        hi = _mm_srli_epi16 (_mm_add_epi16 (t, _mm_srli_epi16 (t, 8)), 8);
+        _mm_storeu_si128 ((__m128i*)&p[x * 4], _mm_packus_epi16 (lo, hi));
+    }
+#endif
+    for (; x < w; x++) {
+        unsigned int a = p[x * 4 + 3];
+        p[x * 4] = SCE_RMUL8 (p[x * 4], a);
+        p[x * 4 + 1] = SCE_RMUL8 (p[x * 4 + 1], a);
+        p[x * 4 + 2] = SCE_RMUL8 (p[x * 4 + 2], a);
+    }
+}
+
+#if defined (SCE_SIMD_SSSE3) || defined (SCE_SIMD_AVX2)
+/* byte of each destination component for 4 pixels, 0x80 for fill */
+static void SCE_RMakeShuffleMask (const SCE_RConvertJob *job,
+                                  unsigned char *mask, unsigned char *fill)
+{
+    int k, j, sn = job->sfmt->n;
+    for (k = 0; k < 4; k++) {
+        for (j = 0; j < 4; j++) {
+            int p = job->pattern[j];
+            mask[k * 4 + j] = p >= 0 ? k * sn + p : 0x80;
+            fill[k * 4 + j] = p >= 0 ? 0 : job->fill[j];
+        }
+    }
+}
+#endif
+#ifdef SCE_SIMD_SSSE3
+/* 3 or 4 to 4 components, returns the number of pixels done */
+SCE_TARGET ("ssse3")
+static int SCE_RShuffleRow8SSSE3 (const SCE_RConvertJob *job,
+                                  const unsigned char *s, unsigned char *d,
+                                  int x)
+{
+    unsigned char m[16], f[16];
+    __m128i mask, fill;
+    int sn = job->sfmt->n;
+
+    SCE_RMakeShuffleMask (job, m, f);
+    mask = _mm_loadu_si128 ((const __m128i*)m);
+    fill = _mm_loadu_si128 ((const __m128i*)f);
+    /* 16 bytes are read, 12 are used when sn == 3 */
+    for (; (size_t)x * sn + 16 <= (size_t)job->w * sn; x += 4) {
+        __m128i v = _mm_loadu_si128 ((const __m128i*)&s[x * sn]);
+        v = _mm_or_si128 (_mm_shuffle_epi8 (v, mask), fill);
+        _mm_storeu_si128 ((__m128i*)&d[x * 4], v);
+    }
+    return x;
+}
+#endif
+#ifdef SCE_SIMD_AVX2
+/* 4 to 4 components, returns the number of pixels done */
+SCE_TARGET ("avx2")
+static int SCE_RShuffleRow8AVX2 (const SCE_RConvertJob *job,
+                                 const unsigned char *s, unsigned char *d)
+{
+    unsigned char m[16], f[16];
+    __m256i mask, fill;
+    int x = 0;
+
+    SCE_RMakeShuffleMask (job, m, f);
+    mask = _mm256_broadcastsi128_si256 (_mm_loadu_si128 ((const __m128i*)m));
+    fill = _mm256_broadcastsi128_si256 (_mm_loadu_si128 ((const __m128i*)f));
+    for (; x + 8 <= job->w; x += 8) {
+        __m256i v = _mm256_loadu_si256 ((const __m256i*)&s[x * 4]);
+        v = _mm256_or_si256 (_mm256_shuffle_epi8 (v, mask), fill);
+        _mm256_storeu_si256 ((__m256i*)&d[x * 4], v);
+    }
+    return x;
+}
+#endif
+
+/* 8 bits to 8 bits, any format */
+static void SCE_RShuffleRow8 (const SCE_RConvertJob *job, const void *src,
+                              void *dst, float *tmp)
+{
+    const unsigned char *s = src;
+    unsigned char *d = dst;
+    int x = 0, j, sn = job->sfmt->n, dn = job->dfmt->n;
+
+    if (dn == 4 && (sn == 3 || sn == 4)) {
+#ifdef SCE_SIMD_AVX2
+        if (sn == 4 && SCE_HAS_SIMD (SCE_CPU_AVX2))
+            x = SCE_RShuffleRow8AVX2 (job, s, d);
+#endif
+#ifdef SCE_SIMD_SSSE3
+        if (SCE_HAS_SIMD (SCE_CPU_SSSE3))
+            x = SCE_RShuffleRow8SSSE3 (job, s, d, x);
+#endif
+    }
+    for (; x < job->w; x++) {
+        for (j = 0; j < dn; j++) {
+            int p = job->pattern[j];
+            d[x * dn + j] = p >= 0 ? s[x * sn + p] : job->fill[j];
+        }
+    }
+    if (job->premultiply)
+        SCE_RPremultiplyRow8 (d, job->w);
+}
+
+#ifdef SCE_SIMD_F16C
+/* return the number of components done */
+SCE_TARGET ("avx,f16c")
+static size_t SCE_RFloatToHalfRowF16C (const float *s, unsigned short *d,
+                                       size_t n)
+{
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m128i h = _mm256_cvtps_ph (_mm256_loadu_ps (&s[i]),
+                                     _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128 ((__m128i*)&d[i], h);
+    }
+    return i;
+}
+SCE_TARGET ("avx,f16c")
+static size_t SCE_RHalfToFloatRowF16C (const unsigned short *s, float *d,
+                                       size_t n)
+{
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m128i h = _mm_loadu_si128 ((const __m128i*)&s[i]);
+        _mm256_storeu_ps (&d[i], _mm256_cvtph_ps (h));
+    }
+    return i;
+}
+#endif
+
+/**
+ * \brief Converts floats to half floats
+ * \param src \p n floats
+ * \param dst \p n half floats
+ * \param n number of components
+ */
+void SCE_RFloatToHalfRow (const float *src, unsigned short *dst, size_t n)
+{
+    size_t i = 0;
+#ifdef SCE_SIMD_F16C
+    if (SCE_HAS_SIMD (SCE_CPU_F16C))
+        i = SCE_RFloatToHalfRowF16C (src, dst, n);
+#endif
+    for (; i < n; i++)
+        dst[i] = SCE_RFloatToHalf (src[i]);
+}
+/**
+ * \brief Converts half floats to floats
+ * \param src \p n half floats
+ * \param dst \p n floats
+ * \param n number of components
+ */
+void SCE_RHalfToFloatRow (const unsigned short *src, float *dst, size_t n)
+{
+    size_t i = 0;
+#ifdef SCE_SIMD_F16C
+    if (SCE_HAS_SIMD (SCE_CPU_F16C))
+        i = SCE_RHalfToFloatRowF16C (src, dst, n);
+#endif
+    for (; i < n; i++)
+        dst[i] = SCE_RHalfToFloat (src[i]);
+}
+/**
+ * \brief Converts 8 bits normalized components to floats in [0, 1]
+ * \param src \p n components
+ * \param dst \p n floats
+ * \param n number of components
+ */
+void SCE_RUnormToFloatRow (const unsigned char *src, float *dst, size_t n)
+{
+    size_t i = 0;
+#ifdef __SSE2__
+    const __m128 k = _mm_set1_ps (1.0f / 255.0f);
+    const __m128i z = _mm_setzero_si128 ();
+    for (; i + 16 <= n; i += 16) {
+        __m128i b = _mm_loadu_si128 ((const __m128i*)&src[i]);
+        __m128i lo = _mm_unpacklo_epi8 (b, z);
+        __m128i hi = _mm_unpackhi_epi8 (b, z);
+        _mm_storeu_ps (&dst[i], _mm_mul_ps (
+            _mm_cvtepi32_ps (_mm_unpacklo_epi16 (lo, z)), k));
+        _mm_storeu_ps (&dst[i + 4], _mm_mul_ps (
+            _mm_cvtepi32_ps (_mm_unpackhi_epi16 (lo, z)), k));
+        _mm_storeu_ps (&dst[i + 8], _mm_mul_ps (
+            _mm_cvtepi32_ps (_mm_unpacklo_epi16 (hi, z)), k));
+        _mm_storeu_ps (&dst[i + 12], _mm_mul_ps (
+            _mm_cvtepi32_ps (_mm_unpackhi_epi16 (hi, z)), k));
+    }
+#endif
+    for (; i < n; i++)
+        dst[i] = src[i] * (1.0f / 255.0f);
+}
+/**
+ * \brief Converts floats to 8 bits normalized components, clamped to
+ * [0, 1] and rounded to the nearest
+ * \param src \p n floats
+ * \param dst \p n components
+ * \param n number of components
+ */
+void SCE_RFloatToUnormRow (const float *src, unsigned char *dst, size_t n)
+{
+    size_t i = 0;
+#ifdef __SSE2__
+    const __m128 zero = _mm_setzero_ps (), one = _mm_set1_ps (1.0f);
+    const __m128 k = _mm_set1_ps (255.0f), half = _mm_set1_ps (0.5f);
+    for (; i + 16 <= n; i += 16) {
+        __m128i v[4];
+        int j;
+        for (j = 0; j < 4; j++) {
+            __m128 f = _mm_loadu_ps (&src[i + j * 4]);
+            f = _mm_mul_ps (_mm_min_ps (_mm_max_ps (f, zero), one), k);
+            /* rounded as the scalar loop below */
+            v[j] = _mm_cvttps_epi32 (_mm_add_ps (f, half));
+        }
+        _mm_storeu_si128 ((__m128i*)&dst[i], _mm_packus_epi16 (
+            _mm_packs_epi32 (v[0], v[1]), _mm_packs_epi32 (v[2], v[3])));
+    }
+#endif
+    for (; i < n; i++) {
+        float v = MAX (0.0f, MIN (src[i], 1.0f));
+        dst[i] = v * 255.0f + 0.5f;
+    }
+}
+
+/* same format, float to half float */
+static void SCE_RConvertFloatToHalfRow (const SCE_RConvertJob *job,
+                                        const void *src, void *dst,
+                                        float *tmp)
+{
+    SCE_RFloatToHalfRow (src, dst, (size_t)job->w * job->sfmt->n);
+}
+/* same format, half float to float */
+static void SCE_RConvertHalfToFloatRow (const SCE_RConvertJob *job,
+                                        const void *src, void *dst,
+                                        float *tmp)
+{
+    SCE_RHalfToFloatRow (src, dst, (size_t)job->w * job->sfmt->n);
+}
+
+static float SCE_RLoadComponent (SCE_EType type, const void *p, size_t i)
+{
+    switch (type) {
+    case SCE_UNSIGNED_BYTE: return ((const unsigned char*)p)[i] / 255.0f;
+    case SCE_HALF_FLOAT:
+        return SCE_RHalfToFloat (((const unsigned short*)p)[i]);
+    default: return ((const float*)p)[i];
+    }
+}
+static void SCE_RStoreComponent (SCE_EType type, void *p, size_t i, float v)
+{
+    switch (type) {
+    case SCE_UNSIGNED_BYTE:
+        v = MAX (0.0f, MIN (v, 1.0f));
+        ((unsigned char*)p)[i] = v * 255.0f + 0.5f;
+        break;
+    case SCE_HALF_FLOAT:
+        ((unsigned short*)p)[i] = SCE_RFloatToHalf (v);
+        break;
+    default: ((float*)p)[i] = v;
+    }
+}
+/* anything, through a RGBA float row */
+static void SCE_RConvertRowFloat (const SCE_RConvertJob *job, const void *src,
+                                  void *dst, float *tmp)
+{
+    const SCE_RConvertFormat *sf = job->sfmt;
+    int x, c, sn = sf->n, dn = job->dfmt->n;
+
+    for (x = 0; x < job->w; x++) {
+        float *p = &tmp[x * 4];
+        for (c = 0; c < 4; c++) {
+            int i = sf->map[c];
+            p[c] = i >= 0 ? SCE_RLoadComponent (job->stype, src,
+                                                (size_t)x * sn + i) :
+                (c == 3 ? 1.0f : 0.0f);
+        }
+        if (job->premultiply) {
+            p[0] *= p[3];
+            p[1] *= p[3];
+            p[2] *= p[3];
+        }
+        for (c = 0; c < dn; c++)
+            SCE_RStoreComponent (job->dtype, dst, (size_t)x * dn + c,
+                                 p[job->dch[c]]);
+    }
+}
+
+static void SCE_RConvertRows (size_t begin, size_t end, void *data)
+{
+    SCE_RConvertJob *job = data;
+    float *tmp = NULL;
+    size_t y;
+
+    if (job->fun == SCE_RConvertRowFloat &&
+        !(tmp = SCE_malloc ((size_t)job->w * 4 * sizeof *tmp))) {
+        job->failed = SCE_TRUE;
+        return;
+    }
+    for (y = begin; y < end; y++)
+        job->fun (job, &job->src[y * job->src_pitch],
+                  &job->dst[y * job->dst_pitch], tmp);
+    SCE_free (tmp);
+}
+
+/**
+ * \brief Converts an image
+ * \param src source pixels, rows are tightly packed
+ * \param sfmt \param stype format of \p src
+ * \param w \param h size of the image
+ * \param dfmt \param dtype format of \p dst
+ * \param flags 0 or SCE_CONVERT_PREMULTIPLY
+ * \param dst destination pixels, of SCE_RGetConvertedImageSize() bytes, must
+ *        not overlap \p src
+ * \returns SCE_ERROR on error, SCE_OK otherwise
+ * \sa SCE_RIsConversionSupported()
+ */
+int SCE_RConvertImage (const void *src, SCE_EImageFormat sfmt,
+                       SCE_EType stype, int w, int h, SCE_EImageFormat dfmt,
+                       SCE_EType dtype, int flags, void *dst)
+{
+    SCE_RConvertJob job;
+    size_t grain;
+    int c, j;
+
+    if (!SCE_RIsConversionSupported (sfmt, stype, dfmt, dtype)) {
+        SCEE_Log (SCE_INVALID_ARG);
+        SCEE_LogMsg ("can't convert images of format %d type %d to format "
+                     "%d type %d", (int)sfmt, (int)stype, (int)dfmt,
+                     (int)dtype);
+        return SCE_ERROR;
+    }
+    w = MAX (w, 1);
+    h = MAX (h, 1);
+
+    job.src = src;
+    job.dst = dst;
+    job.w = w;
+    job.stype = stype;
+    job.dtype = dtype;
+    job.sfmt = SCE_RGetConvertFormat (sfmt);
+    job.dfmt = SCE_RGetConvertFormat (dfmt);
+    job.src_pitch = (size_t)w * job.sfmt->n * SCE_RGetConvertTypeSize (stype);
+    job.dst_pitch = (size_t)w * job.dfmt->n * SCE_RGetConvertTypeSize (dtype);
+    job.premultiply = (flags & SCE_CONVERT_PREMULTIPLY) &&
+        job.dfmt->map[3] >= 0;
+    job.failed = SCE_FALSE;
+
+    for (j = 0; j < 4; j++) {
+        job.dch[j] = 0;
+        job.pattern[j] = -1;
+        job.fill[j] = 0;
+    }
+    for (c = 0; c < 4; c++) {
+        if ((j = job.dfmt->map[c]) < 0)
+            continue;
+        job.dch[j] = c;
+        job.pattern[j] = job.sfmt->map[c];
+        job.fill[j] = (c == 3 ? 255 : 0);
+    }
+
+    if (sfmt == dfmt && stype == dtype && !job.premultiply) {
+        memcpy (dst, src, job.src_pitch * h);
+        return SCE_OK;
+    }
+    if (stype == SCE_UNSIGNED_BYTE && dtype == SCE_UNSIGNED_BYTE &&
+        (!job.premultiply || job.dfmt->n == 4))
+        job.fun = SCE_RShuffleRow8;
+    else if (sfmt == dfmt && !job.premultiply && stype == SCE_FLOAT &&
+             dtype == SCE_HALF_FLOAT)
+        job.fun = SCE_RConvertFloatToHalfRow;
+    else if (sfmt == dfmt && !job.premultiply && stype == SCE_HALF_FLOAT &&
+             dtype == SCE_FLOAT)
+        job.fun = SCE_RConvertHalfToFloatRow;
+    else
+        job.fun = SCE_RConvertRowFloat;
+
+    /* about 64 KB per range */
+    grain = MAX (65536 / MAX (job.dst_pitch, 1), 1);
+    SCE_RParallelFor (h, grain, SCE_RConvertRows, &job);
+    if (job.failed) {
+        SCEE_LogSrc ();
+        return SCE_ERROR;
+    }
+    return SCE_OK;
+}
+
+/** @} */
@@ -257,38 +257,14 @@ int SCE_RAddRenderTexture (SCE_RFramebuffer *fb, SCE_RBufferType id,
 }
 
 
-/**
- * \brief Adds a new render buffer
- * \param fb the frame buffer to which to add the render buffer
- * \param id render buffer's identifier
- * \param fmt the format of the new render buffer, can be SCE_IMAGE_NONE
- * \param w width of the new render buffer
- * \param h height of the new render buffer
- * \note If you called SCE_RAddRenderTexture() previously, \p w
- * and \p h can be set to 0 then the dimensions of the render
- * buffer are automatically set to those of the texture passed to
- * SCE_RAddRenderTexture().
- * \note If you set \p fmt at less than 0, an adapted format is used
- * automatically.
- * \sa SCE_RAddRenderTexture()
- */
-int SCE_RAddRenderBuffer (SCE_RFramebuffer *fb, SCE_RBufferType id,
-                          SCE_EPixelFormat pxf, int w, int h)
+/* adds a render buffer of the given GL internal format */
+static int SCE_RAddRenderBufferGL (SCE_RFramebuffer *fb, SCE_RBufferType id,
+                                  SCEenum glpxf, int w, int h)
 {
     int type, status;
 
     type = SCE_RIDToGLBuffer (id);
 
-    /* assignation des valeurs par defaut */
-    if (pxf == SCE_PXF_NONE) {
-        if (id == SCE_DEPTH_BUFFER)
-            pxf = SCE_PXF_DEPTH32; /* make it aligned */
-        else if (id == SCE_STENCIL_BUFFER)
-            pxf = SCE_PXF_STENCIL8; /* NOTE: doesn't work, wtf */
-        else if (id == SCE_DEPTH_STENCIL_BUFFER)
-            pxf = SCE_PXF_DEPTH_STENCIL;
-    }
-
     if (w <= 0)
         w = fb->w;
     else
@@ -316,7 +292,7 @@ int SCE_RAddRenderBuffer (SCE_RFramebuffer *fb, SCE_RBufferType id,
 
     /* creation du render buffer */
     glBindRenderbufferEXT (GL_RENDERBUFFER_EXT, fb->buffers[id].id);
-    glRenderbufferStorageEXT (GL_RENDERBUFFER_EXT, SCE_RSCEPxfToGL (pxf), w, h);
+    glRenderbufferStorageEXT (GL_RENDERBUFFER_EXT, glpxf, w, h);
     glBindRenderbufferEXT (GL_RENDERBUFFER_EXT, 0);
 
     /* on l'ajoute au FBO */
@@ -337,6 +313,56 @@ int SCE_RAddRenderBuffer (SCE_RFramebuffer *fb, SCE_RBufferType id,
     return SCE_OK;
 }
 
+/**
+ * \brief Adds a new render buffer
+ * \param fb the frame buffer to which to add the render buffer
+ * \param id render buffer's identifier
+ * \param fmt the format of the new render buffer, can be SCE_IMAGE_NONE
+ * \param w width of the new render buffer
+ * \param h height of the new render buffer
+ * \note If you called SCE_RAddRenderTexture() previously, \p w
+ * and \p h can be set to 0 then the dimensions of the render
+ * buffer are automatically set to those of the texture passed to
+ * SCE_RAddRenderTexture().
+ * \note If you set \p fmt at less than 0, an adapted format is used
+ * automatically.
+ * \sa SCE_RAddRenderTexture()
+ */
+int SCE_RAddRenderBuffer (SCE_RFramebuffer *fb, SCE_RBufferType id,
+                          SCE_EPixelFormat pxf, int w, int h)
+{
+    /* assignation des valeurs par defaut */
+    if (pxf == SCE_PXF_NONE) {
+        if (id == SCE_DEPTH_BUFFER)
+            pxf = SCE_PXF_DEPTH32; /* make it aligned */
+        else if (id == SCE_STENCIL_BUFFER)
+            pxf = SCE_PXF_STENCIL8; /* NOTE: doesn't work, wtf */
+        else if (id == SCE_DEPTH_STENCIL_BUFFER)
+            pxf = SCE_PXF_DEPTH_STENCIL;
+    }
+    return SCE_RAddRenderBufferGL (fb, id, SCE_RSCEPxfToGL (pxf), w, h);
+}
+/**
+ * \brief Adds a new color render buffer of an internal format
+ * \param fb the frame buffer to which to add the render buffer
+ * \param id render buffer's identifier
+ * \param fmt internal format of the render buffer, it must be renderable
+ * \param w width of the new render buffer, 0 to keep the one of \p fb
+ * \param h height of the new render buffer, 0 to keep the one of \p fb
+ * \returns SCE_ERROR on error, SCE_OK otherwise
+ * \sa SCE_RAddRenderBuffer(), SCE_RChooseInternalFormat()
+ */
+int SCE_RAddRenderBufferFormat (SCE_RFramebuffer *fb, SCE_RBufferType id,
+                                SCE_RInternalFormat fmt, int w, int h)
+{
+    if (!SCE_RIsInternalFormatSupported (fmt, SCE_TRUE)) {
+        SCEE_Log (SCE_INVALID_ARG);
+        SCEE_LogMsg ("internal format %d can't be rendered to", fmt);
+        return SCE_ERROR;
+    }
+    return SCE_RAddRenderBufferGL (fb, id, SCE_RInternalFormatToGL (fmt), w, h);
+}
+
 
 /**
  * \brief Creates a new render texture and add it as a new render target to the
@@ -405,6 +431,61 @@ SCE_RAddNewRenderTexture (SCE_RFramebuffer *fb, SCE_RBufferType id,
     return tex;
 }
 
+/**
+ * \brief Creates a new color render texture of an internal format and adds
+ * it as a new render target to the given frame buffer
+ * \param fb the frame buffer to which to add the new render texture
+ * \param id render target's identifier
+ * \param fmt internal format of the new texture, it must be renderable
+ * \param w width of the new texture
+ * \param h height of the new texture
+ * \returns the new texture, or NULL on error. As with
+ * SCE_RAddNewRenderTexture(), it doesn't belong to \p fb
+ *
+ * Meant for the formats SCE_EPixelFormat lacks, e.g. HDR lighting buffers
+ * in SCE_IFMT_R11F_G11F_B10F take 4 bytes per pixel instead of the 8 of
+ * SCE_IFMT_RGBA16F.
+ * \sa SCE_RChooseInternalFormat(), SCE_RSetTextureInternalFormat()
+ */
+SCE_RTexture*
+SCE_RAddNewRenderTextureFormat (SCE_RFramebuffer *fb, SCE_RBufferType id,
+                                SCE_RInternalFormat fmt, int w, int h)
+{
+    SCE_RTexture *tex = NULL;
+    SCE_STexData data;
+
+    if (!SCE_RIsInternalFormatSupported (fmt, SCE_TRUE)) {
+        SCEE_Log (SCE_INVALID_ARG);
+        SCEE_LogMsg ("internal format %d can't be rendered to", fmt);
+        return NULL;
+    }
+    if (!(tex = SCE_RCreateTexture (SCE_TEX_2D))) {
+        SCEE_LogSrc ();
+        return NULL;
+    }
+    SCE_RSetTextureInternalFormat (tex, fmt);
+
+    /* nothing is uploaded, the format and type only describe the data */
+    SCE_TexData_Init (&data);
+    SCE_TexData_SetDimensions (&data, w, h, 0);
+    SCE_TexData_SetDataType (&data, SCE_FLOAT);
+    SCE_TexData_SetPixelFormat (&data, SCE_RHasInternalFormatAlpha (fmt) ?
+                                SCE_PXF_RGBA : SCE_PXF_RGB);
+    SCE_TexData_SetDataFormat (&data, SCE_RHasInternalFormatAlpha (fmt) ?
+                               SCE_IMAGE_RGBA : SCE_IMAGE_RGB);
+
+    if (!SCE_RAddTextureTexDataDup (tex, 0, &data)) {
+        SCEE_LogSrc ();
+        SCE_RDeleteTexture (tex);
+        return NULL;
+    }
+
+    SCE_RBuildTexture (tex, SCE_FALSE, SCE_FALSE);
+    SCE_RAddRenderTexture (fb, id, SCE_TEX_2D, tex, 0, SCE_FALSE);
+
+    return tex;
+}
+
 /**
  * \brief Gets one of the render textures of a frame buffer
  * \param fb the frame buffer to which get the texture
@@ -19,6 +19,12 @@
 /* created: 10/01/2007
    updated: 20/06/2011 */
 
+#if defined (__SSE__)
+#include <xmmintrin.h>
+#elif defined (__ARM_NEON) || defined (__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+#include "SCE/renderer/SCERTexture.h" /* SCE_RGetActiveTextureUnit() */
 #include "SCE/renderer/SCERMatrix.h"
 
 /**
@@ -45,9 +51,26 @@ SCE_TMatrix4 sce_rmatrices[SCE_NUM_MATRICES] = {
     SCE_MATRIX4_IDENTITY,
     SCE_MATRIX4_IDENTITY,
     SCE_MATRIX4_IDENTITY,
+    SCE_MATRIX4_IDENTITY,
+    SCE_MATRIX4_IDENTITY,
     SCE_MATRIX4_IDENTITY
 };
 
+#define SCE_MATRIX_BIT(m) (1u << (m))
+
+/* derived matrices that have to be recomputed before being read */
+static SCEbitfield stale = 0;
+/* matrices that have to be sent to the GL before the next draw call */
+static SCEbitfield dirty = 0;
+
+/* texture matrix of each texture unit */
+static SCE_TMatrix4 texmatrices[SCE_NUM_TEXTURE_MATRICES];
+/* units whose texture matrix was ever loaded, and those to send */
+static SCEbitfield texunits = 0, dirty_units = 0;
+
+static void SCE_RSetNoneMatrix (void)
+{
+}
 static void SCE_RSetModelviewMatrix (void)
 {
     glMatrixMode (GL_MODELVIEW);
@@ -60,39 +83,197 @@ static void SCE_RSetProjectionMatrix (void)
 }
 static void SCE_RSetTextureMatrix (void)
 {
+    int i;
     glMatrixMode (GL_TEXTURE);
-    glLoadTransposeMatrixf (sce_rmatrices[SCE_MAT_TEXTURE]);
+    for (i = 0; i < SCE_NUM_TEXTURE_MATRICES; i++) {
+        if (dirty_units & SCE_MATRIX_BIT (i)) {
+            glActiveTexture (GL_TEXTURE0 + i);
+            glLoadTransposeMatrixf (texmatrices[i]);
+        }
+    }
+    /* restores the unit the textures manager thinks is active */
+    glActiveTexture (GL_TEXTURE0 + SCE_RGetActiveTextureUnit ());
 }
 
-/* default are common GL functions */
+/* default are common GL functions, object and camera matrices are sent
+   through the modelview matrix, the GL computes the others by itself */
 static SCE_RSetMatrixFunc sce_setmatrix_funs[SCE_NUM_MATRICES] = {
-    SCE_RSetModelviewMatrix,
-    SCE_RSetModelviewMatrix,
+    SCE_RSetNoneMatrix,
+    SCE_RSetNoneMatrix,
     SCE_RSetProjectionMatrix,
     SCE_RSetTextureMatrix,
-    SCE_RSetModelviewMatrix
+    SCE_RSetModelviewMatrix,
+    SCE_RSetNoneMatrix,
+    SCE_RSetNoneMatrix
 };
 
 static SCE_RSetMatrixFunc *setmatrix = sce_setmatrix_funs;
 
+
+/* r = a * b, matrices are row-major and r must not alias a or b */
+#if defined (__SSE__)
+static void SCE_RMulMatrix (const float *a, const float *b, float *r)
+{
+    int i;
+    __m128 b0 = _mm_loadu_ps (&b[0]);
+    __m128 b1 = _mm_loadu_ps (&b[4]);
+    __m128 b2 = _mm_loadu_ps (&b[8]);
+    __m128 b3 = _mm_loadu_ps (&b[12]);
+    for (i = 0; i < 16; i += 4) {
+        __m128 row;
+        row = _mm_mul_ps (_mm_set1_ps (a[i]), b0);
+        row = _mm_add_ps (row, _mm_mul_ps (_mm_set1_ps (a[i + 1]), b1));
+        row = _mm_add_ps (row, _mm_mul_ps (_mm_set1_ps (a[i + 2]), b2));
+        row = _mm_add_ps (row, _mm_mul_ps (_mm_set1_ps (a[i + 3]), b3));
+        _mm_storeu_ps (&r[i], row);
+    }
+}
+#elif defined (__ARM_NEON) || defined (__ARM_NEON__)
+static void SCE_RMulMatrix (const float *a, const float *b, float *r)
+{
+    int i;
+    float32x4_t b0 = vld1q_f32 (&b[0]);
+    float32x4_t b1 = vld1q_f32 (&b[4]);
+    float32x4_t b2 = vld1q_f32 (&b[8]);
+    float32x4_t b3 = vld1q_f32 (&b[12]);
+    for (i = 0; i < 16; i += 4) {
+        float32x4_t row;
+        row = vmulq_n_f32 (b0, a[i]);
+        row = vmlaq_n_f32 (row, b1, a[i + 1]);
+        row = vmlaq_n_f32 (row, b2, a[i + 2]);
+        row = vmlaq_n_f32 (row, b3, a[i + 3]);
+        vst1q_f32 (&r[i], row);
+    }
+}
+#else
+static void SCE_RMulMatrix (const float *a, const float *b, float *r)
+{
+    SCE_Matrix4_Mul (a, b, r);
+}
+#endif
+
+/* inverse transpose of the upper 3x3 of m, stored in the upper 3x3 of r */
+static void SCE_RMakeNormalMatrix (const float *m, float *r)
+{
+    float c[9], det;
+
+    c[0] = m[5] * m[10] - m[6] * m[9];
+    c[1] = m[6] * m[8] - m[4] * m[10];
+    c[2] = m[4] * m[9] - m[5] * m[8];
+    c[3] = m[2] * m[9] - m[1] * m[10];
+    c[4] = m[0] * m[10] - m[2] * m[8];
+    c[5] = m[1] * m[8] - m[0] * m[9];
+    c[6] = m[1] * m[6] - m[2] * m[5];
+    c[7] = m[2] * m[4] - m[0] * m[6];
+    c[8] = m[0] * m[5] - m[1] * m[4];
+
+    det = m[0] * c[0] + m[1] * c[1] + m[2] * c[2];
+    if (det > -SCE_EPSILONF && det < SCE_EPSILONF)
+        det = 1.0f;             /* degenerated matrix, do our best */
+    det = 1.0f / det;
+
+    /* the cofactor matrix is already the transpose of the adjugate */
+    r[0] = c[0] * det; r[1] = c[1] * det; r[2]  = c[2] * det; r[3]  = 0.0f;
+    r[4] = c[3] * det; r[5] = c[4] * det; r[6]  = c[5] * det; r[7]  = 0.0f;
+    r[8] = c[6] * det; r[9] = c[7] * det; r[10] = c[8] * det; r[11] = 0.0f;
+    r[12] = r[13] = r[14] = 0.0f; r[15] = 1.0f;
+}
+
+/* recomputes the derived matrices */
+static void SCE_RComputeMatrices (void)
+{
+    if (stale & SCE_MATRIX_BIT (SCE_MAT_MODELVIEW)) {
+        SCE_RMulMatrix (sce_rmatrices[SCE_MAT_CAMERA],
+                        sce_rmatrices[SCE_MAT_OBJECT],
+                        sce_rmatrices[SCE_MAT_MODELVIEW]);
+    }
+    if (stale & SCE_MATRIX_BIT (SCE_MAT_MODELVIEWPROJECTION)) {
+        SCE_RMulMatrix (sce_rmatrices[SCE_MAT_PROJECTION],
+                        sce_rmatrices[SCE_MAT_MODELVIEW],
+                        sce_rmatrices[SCE_MAT_MODELVIEWPROJECTION]);
+    }
+    if (stale & SCE_MATRIX_BIT (SCE_MAT_NORMAL)) {
+        SCE_RMakeNormalMatrix (sce_rmatrices[SCE_MAT_MODELVIEW],
+                               sce_rmatrices[SCE_MAT_NORMAL]);
+    }
+    stale = 0;
+}
+
 /**
  * \brief Load the specified matrix
  *
  * \param matrix use of the matrix to load
  * \param m a matrix
+ *
+ * The matrix is only stored, derived matrices (modelview, modelview
+ * projection and normal matrices) are computed and sent to the GL by
+ * SCE_RFlushMatrices(), which is called by the render functions right
+ * before each draw call. The texture matrix is the one of the active
+ * texture unit, see SCE_RSetActiveTextureUnit(); each unit keeps its own
+ * until the flush. The shaders only have one texture matrix, they get the
+ * last one loaded.
+ * \sa SCE_RFlushMatrices()
  */
 void SCE_RLoadMatrix (SCE_RMatrix matrix, const SCE_TMatrix4 m)
 {
+    SCEbitfield bits = SCE_MATRIX_BIT (matrix);
+    int unit;
+
     SCE_Matrix4_Copy (sce_rmatrices[matrix], m);
-    if (matrix == SCE_MAT_OBJECT || matrix == SCE_MAT_CAMERA) {
-        SCE_Matrix4_Mul (sce_rmatrices[SCE_MAT_CAMERA],
-                         sce_rmatrices[SCE_MAT_OBJECT],
-                         sce_rmatrices[SCE_MAT_MODELVIEW]);
-        setmatrix[SCE_MAT_MODELVIEW] ();
+    switch (matrix) {
+    case SCE_MAT_TEXTURE:
+        unit = SCE_RGetActiveTextureUnit ();
+        if (unit < SCE_NUM_TEXTURE_MATRICES) {
+            SCE_Matrix4_Copy (texmatrices[unit], m);
+            texunits |= SCE_MATRIX_BIT (unit);
+            dirty_units |= SCE_MATRIX_BIT (unit);
+        }
+        break;
+    case SCE_MAT_OBJECT:
+    case SCE_MAT_CAMERA:
+    case SCE_MAT_MODELVIEW:
+        if (matrix != SCE_MAT_MODELVIEW)
+            stale |= SCE_MATRIX_BIT (SCE_MAT_MODELVIEW);
+        else
+            stale &= ~SCE_MATRIX_BIT (SCE_MAT_MODELVIEW);
+        stale |= SCE_MATRIX_BIT (SCE_MAT_NORMAL);
+        bits |= SCE_MATRIX_BIT (SCE_MAT_MODELVIEW) |
+            SCE_MATRIX_BIT (SCE_MAT_NORMAL);
+        /* no break */
+    case SCE_MAT_PROJECTION:
+        stale |= SCE_MATRIX_BIT (SCE_MAT_MODELVIEWPROJECTION);
+        bits |= SCE_MATRIX_BIT (SCE_MAT_MODELVIEWPROJECTION);
+        break;
+    default:
+        /* explicitly loaded derived matrix */
+        stale &= ~bits;
     }
-    /* when no shader is active are we are in a full GL3 context, this call
-       should be removed */
-    setmatrix[matrix] ();
+    dirty |= bits;
+}
+
+/**
+ * \brief Sends the modified matrices to the GL
+ *
+ * Computes the derived matrices if one of the matrices they depend on was
+ * loaded since the last call, then calls the matrix setter of each modified
+ * matrix once, and the texture matrix of each unit whose one was loaded.
+ * This function is called by all the render functions of the renderer,
+ * call it yourself before issuing draw calls without them.
+ * \sa SCE_RLoadMatrix(), SCE_RMapMatrices()
+ */
+void SCE_RFlushMatrices (void)
+{
+    int i;
+
+    if (!dirty)
+        return;
+    SCE_RComputeMatrices ();
+    for (i = 0; i < SCE_NUM_MATRICES; i++) {
+        if (dirty & SCE_MATRIX_BIT (i))
+            setmatrix[i] ();
+    }
+    dirty = 0;
+    dirty_units = 0;
 }
 
 /**
@@ -101,29 +282,42 @@ void SCE_RLoadMatrix (SCE_RMatrix matrix, const SCE_TMatrix4 m)
  * or NULL to restore the default state
  *
  * In practice this function is used by the shaders manager to map the
- * matrices to shader uniform variables.
+ * matrices to shader uniform variables. All the matrices will be sent
+ * again through \p funs on the next call to SCE_RFlushMatrices().
  */
 void SCE_RMapMatrices (SCE_RSetMatrixFunc *funs)
 {
-    int i;
     if (funs)
         setmatrix = funs;
     else
         setmatrix = sce_setmatrix_funs;
     /* refresh matrix state */
-    for (i = 0; i < SCE_NUM_MATRICES; i++)
-        setmatrix[i] ();
+    dirty = SCE_MATRIX_BIT (SCE_NUM_MATRICES) - 1;
+    dirty_units = texunits;
 }
 
 /**
  * \brief Gets a matrix
  * \param matrix matrix to get
  * \param m retrieved matrix will be stored here
- * 
+ *
+ * The texture matrix is the one of the active texture unit.
  * \see SCE_TMatrix4
  */
 void SCE_RGetMatrix (SCE_RMatrix matrix, SCE_TMatrix4 m)
 {
+    int unit;
+    if (matrix == SCE_MAT_TEXTURE) {
+        unit = SCE_RGetActiveTextureUnit ();
+        if (unit < SCE_NUM_TEXTURE_MATRICES &&
+            texunits & SCE_MATRIX_BIT (unit))
+            SCE_Matrix4_Copy (m, texmatrices[unit]);
+        else
+            SCE_Matrix4_Identity (m);
+        return;
+    }
+    if (stale)
+        SCE_RComputeMatrices ();
     SCE_Matrix4_Copy (m, sce_rmatrices[matrix]);
 }
 
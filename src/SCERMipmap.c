@@ -0,0 +1,329 @@
+/*------------------------------------------------------------------------------
+    SCEngine - A 3D real time rendering engine written in the C language
+    Copyright (C) 2006-2013  Antony Martin <martin(dot)antony(at)yahoo(dot)fr>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/* created: 19/10/2026
+   updated: 19/10/2026 */
+
+#include <math.h>
+#include <string.h>
+#include <SCE/utils/SCEUtils.h>
+#include "SCE/renderer/SCERWorker.h"
+#include "SCE/renderer/SCERConvert.h"   /* row conversions */
+#include "SCE/renderer/SCERResample.h"  /* taps and row filtering */
+#include "SCE/renderer/SCERMipmap.h"
+
+/**
+ * \file SCERMipmap.c
+ * \copydoc mipmap
+ *
+ * \file SCERMipmap.h
+ * \copydoc mipmap
+ */
+
+/**
+ * \defgroup mipmap CPU mipmap generation
+ * \ingroup renderer-gl
+ * \brief Downsampling of images into mipmap levels
+ *
+ * Used by SCE_RBuildTexture() to fill the levels missing from the texture
+ * data when the GL doesn't generate them. The functions don't call the GL,
+ * an offline tool only has to call SCE_RMipmapInit(), and SCE_RWorkerInit()
+ * to use several threads.
+ *
+ * Images are 8 bits normalized or half float, with 1 to 4 components. The
+ * filtering is separable and done in linear space: 8 bits sRGB images are
+ * linearized first, their last component (alpha) excepted when they have 2
+ * or 4 components. Rows of the destination are split among the worker
+ * threads, each source row is decoded once per band of destination rows.
+ * @{
+ */
+
+#define SCE_KAISER_WIDTH 2.0    /* radius, in destination pixels */
+#define SCE_KAISER_ALPHA 4.0
+#define SCE_SRGB_LUT_SIZE 16384
+
+static float unorm_to_float[256];
+static float srgb_to_linear[256];
+static unsigned char linear_to_srgb[SCE_SRGB_LUT_SIZE + 1];
+
+
+/**
+ * \internal
+ */
+int SCE_RMipmapInit (void)
+{
+    unsigned int i;
+    for (i = 0; i < 256; i++) {
+        double c = i / 255.0;
+        unorm_to_float[i] = c;
+        srgb_to_linear[i] = (c <= 0.04045 ? c / 12.92 :
+                             pow ((c + 0.055) / 1.055, 2.4));
+    }
+    for (i = 0; i <= SCE_SRGB_LUT_SIZE; i++) {
+        double l = (double)i / SCE_SRGB_LUT_SIZE;
+        double c = (l <= 0.0031308 ? l * 12.92 :
+                    1.055 * pow (l, 1.0 / 2.4) - 0.055);
+        linear_to_srgb[i] = c * 255.0 + 0.5;
+    }
+    return SCE_OK;
+}
+void SCE_RMipmapQuit (void)
+{
+}
+
+
+/**
+ * \brief Checks whether images of the given format can be downsampled
+ * \param n_comps number of components per pixel
+ * \param type type of the components
+ */
+int SCE_RIsMipmapFormatSupported (int n_comps, SCE_EType type)
+{
+    return n_comps >= 1 && n_comps <= 4 &&
+        (type == SCE_UNSIGNED_BYTE || type == SCE_HALF_FLOAT);
+}
+
+/**
+ * \brief Gets the size in bytes of an image
+ */
+size_t SCE_RGetMipmapLevelSize (int w, int h, int n_comps, SCE_EType type)
+{
+    size_t size = (size_t)MAX (w, 1) * MAX (h, 1) * n_comps;
+    return type == SCE_HALF_FLOAT ? size * 2 : size;
+}
+
+
+static double SCE_RBesselI0 (double x)
+{
+    double sum = 1.0, term = 1.0;
+    int k;
+    for (k = 1; k < 32 && term > sum * 1e-9; k++) {
+        term *= (x * x / 4.0) / ((double)k * k);
+        sum += term;
+    }
+    return sum;
+}
+/* t in destination pixels */
+static double SCE_RKaiserSinc (double t)
+{
+    double r = t / SCE_KAISER_WIDTH, sinc;
+    if (r <= -1.0 || r >= 1.0)
+        return 0.0;
+    sinc = (fabs (t) < 1e-6 ? 1.0 : sin (M_PI * t) / (M_PI * t));
+    return sinc * SCE_RBesselI0 (SCE_KAISER_ALPHA * sqrt (1.0 - r * r)) /
+        SCE_RBesselI0 (SCE_KAISER_ALPHA);
+}
+
+static int SCE_RMakeMipmapTaps (SCE_RResampleTaps *taps, int src, int dst,
+                                SCE_RMipmapFilter filter)
+{
+    double s = (double)src / dst, r;
+    int x, k;
+
+    r = (filter == SCE_MIPMAP_KAISER ? SCE_KAISER_WIDTH * s : s * 0.5);
+    taps->n = (int)ceil (2.0 * r) + 1;
+    if (SCE_RAllocResampleTaps (taps, dst) < 0)
+        return SCE_ERROR;
+
+    for (x = 0; x < dst; x++) {
+        double c = (x + 0.5) * s, sum = 0.0;
+        int first = (int)floor (c - r);
+        int *idx = &taps->idx[x * taps->n];
+        float *w = &taps->w[x * taps->n];
+
+        for (k = 0; k < taps->n; k++) {
+            int i = first + k;
+            double wk;
+            if (filter == SCE_MIPMAP_KAISER)
+                wk = SCE_RKaiserSinc ((i + 0.5 - c) / s);
+            else                /* coverage of [c - r, c + r[ */
+                wk = MAX (0.0, MIN (i + 1.0, c + r) - MAX ((double)i, c - r));
+            idx[k] = MAX (0, MIN (i, src - 1));
+            w[k] = wk;
+            sum += wk;
+        }
+        for (k = 0; k < taps->n; k++)
+            w[k] /= sum;
+    }
+
+    SCE_RTrimResampleTaps (taps, dst);
+    return SCE_OK;
+}
+
+
+typedef struct {
+    const unsigned char *src;
+    unsigned char *dst;
+    int w, h, dw, dh, n_comps;
+    SCE_EType type;
+    int srgb;
+    SCE_RResampleTaps xtaps, ytaps;
+    int failed;
+} SCE_RMipmapJob;
+
+static void SCE_RDecodeMipmapRow (const SCE_RMipmapJob *job, int y, float *out)
+{
+    size_t i, n = (size_t)job->w * job->n_comps;
+
+    if (job->type == SCE_HALF_FLOAT) {
+        SCE_RHalfToFloatRow ((const unsigned short*)job->src + y * n, out, n);
+    } else if (!job->srgb) {
+        SCE_RUnormToFloatRow (job->src + y * n, out, n);
+    } else {
+        const unsigned char *p = job->src + y * n;
+        int c, alpha = (job->n_comps == 2 || job->n_comps == 4);
+        for (i = 0; i < n; i += job->n_comps) {
+            for (c = 0; c < job->n_comps - alpha; c++)
+                out[i + c] = srgb_to_linear[p[i + c]];
+            if (alpha)
+                out[i + c] = unorm_to_float[p[i + c]];
+        }
+    }
+}
+static void SCE_REncodeMipmapRow (const SCE_RMipmapJob *job, int y,
+                                  const float *in)
+{
+    size_t i, n = (size_t)job->dw * job->n_comps;
+
+    if (job->type == SCE_HALF_FLOAT) {
+        SCE_RFloatToHalfRow (in, (unsigned short*)job->dst + y * n, n);
+    } else if (!job->srgb) {
+        SCE_RFloatToUnormRow (in, job->dst + y * n, n);
+    } else {
+        unsigned char *p = job->dst + y * n;
+        int c = 0, alpha = (job->n_comps == 2 || job->n_comps == 4);
+        for (i = 0; i < n; i++) {
+            float v = MAX (0.0f, MIN (in[i], 1.0f));
+            if (!(alpha && c == job->n_comps - 1))
+                p[i] = linear_to_srgb[(int)(v * SCE_SRGB_LUT_SIZE + 0.5f)];
+            else
+                p[i] = v * 255.0f + 0.5f;
+            if (++c == job->n_comps)
+                c = 0;
+        }
+    }
+}
+
+/* The source rows of a band of destination rows are decoded once each into
+   a ring of ytaps.n rows: the taps of a destination row span at most
+   ytaps.n consecutive source rows, the slot i % ytaps.n of the source row i
+   is thus not needed by another tap of the same destination row. */
+static void SCE_RDownsampleRows (size_t begin, size_t end, void *data)
+{
+    SCE_RMipmapJob *job = data;
+    size_t n = (size_t)job->w * job->n_comps;
+    int ring = job->ytaps.n;
+    float *rows = NULL, *acc = NULL, *out = NULL;
+    int *tags = NULL;
+    size_t y;
+    int k;
+
+    rows = SCE_malloc (ring * n * sizeof *rows);
+    tags = SCE_malloc (ring * sizeof *tags);
+    acc = SCE_malloc (n * sizeof *acc);
+    out = SCE_malloc ((size_t)job->dw * job->n_comps * sizeof *out);
+    if (!rows || !tags || !acc || !out) {
+        job->failed = SCE_TRUE;
+        goto end;
+    }
+    for (k = 0; k < ring; k++)
+        tags[k] = -1;
+
+    for (y = begin; y < end; y++) {
+        const int *idx = &job->ytaps.idx[y * job->ytaps.n];
+        const float *w = &job->ytaps.w[y * job->ytaps.n];
+        memset (acc, 0, n * sizeof *acc);
+        for (k = 0; k < job->ytaps.n; k++) {
+            int slot = idx[k] % ring;
+            float *row = &rows[slot * n];
+            if (w[k] == 0.0f)
+                continue;
+            if (tags[slot] != idx[k]) {
+                SCE_RDecodeMipmapRow (job, idx[k], row);
+                tags[slot] = idx[k];
+            }
+            SCE_RAccumulateResampleRow (acc, row, w[k], n);
+        }
+        SCE_RFilterResampleRow (&job->xtaps, job->n_comps, job->dw, acc, out);
+        SCE_REncodeMipmapRow (job, y, out);
+    }
+end:
+    SCE_free (out);
+    SCE_free (acc);
+    SCE_free (tags);
+    SCE_free (rows);
+}
+
+/**
+ * \brief Downsamples an image into its next mipmap level
+ * \param src source pixels, rows are tightly packed
+ * \param w \param h size of the source image
+ * \param n_comps number of components per pixel, 1 to 4
+ * \param type type of the components, SCE_UNSIGNED_BYTE or SCE_HALF_FLOAT
+ * \param filter downsampling filter
+ * \param srgb are the 8 bits components sRGB encoded?
+ * \param dst destination pixels, of size max (w / 2, 1) x max (h / 2, 1)
+ * \returns SCE_ERROR on error, SCE_OK otherwise
+ * \sa SCE_RGetMipmapLevelSize()
+ */
+int SCE_RDownsampleImage (const void *src, int w, int h, int n_comps,
+                          SCE_EType type, SCE_RMipmapFilter filter, int srgb,
+                          void *dst)
+{
+    SCE_RMipmapJob job;
+    size_t grain;
+
+    if (!SCE_RIsMipmapFormatSupported (n_comps, type)) {
+        SCEE_Log (SCE_INVALID_ARG);
+        SCEE_LogMsg ("can't downsample images of %d components of type %d",
+                     n_comps, (int)type);
+        return SCE_ERROR;
+    }
+
+    job.src = src;
+    job.dst = dst;
+    job.w = MAX (w, 1);
+    job.h = MAX (h, 1);
+    job.dw = MAX (job.w / 2, 1);
+    job.dh = MAX (job.h / 2, 1);
+    job.n_comps = n_comps;
+    job.type = type;
+    job.srgb = srgb && type == SCE_UNSIGNED_BYTE;
+    job.failed = SCE_FALSE;
+    if (SCE_RMakeMipmapTaps (&job.xtaps, job.w, job.dw, filter) < 0)
+        goto fail;
+    if (SCE_RMakeMipmapTaps (&job.ytaps, job.h, job.dh, filter) < 0) {
+        SCE_RClearResampleTaps (&job.xtaps);
+        goto fail;
+    }
+
+    /* about 64k destination pixels per job */
+    grain = MAX (1, 65536 / job.dw);
+    SCE_RParallelFor (job.dh, grain, SCE_RDownsampleRows, &job);
+
+    SCE_RClearResampleTaps (&job.ytaps);
+    SCE_RClearResampleTaps (&job.xtaps);
+    if (job.failed)
+        goto fail;
+    return SCE_OK;
+fail:
+    SCEE_LogSrc ();
+    return SCE_ERROR;
+}
+
+/** @} */
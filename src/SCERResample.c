@@ -0,0 +1,462 @@
+/*------------------------------------------------------------------------------
+    SCEngine - A 3D real time rendering engine written in the C language
+    Copyright (C) 2006-2013  Antony Martin <martin(dot)antony(at)yahoo(dot)fr>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/* created: 19/10/2026
+   updated: 19/10/2026 */
+
+#include <math.h>
+#include <string.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include <SCE/utils/SCEUtils.h>
+#include "SCE/renderer/SCERWorker.h"
+#include "SCE/renderer/SCERConvert.h"   /* row conversions */
+#include "SCE/renderer/SCERResample.h"
+
+/**
+ * \file SCERResample.c
+ * \copydoc resample
+ *
+ * \file SCERResample.h
+ * \copydoc resample
+ */
+
+/**
+ * \defgroup resample Image resampling
+ * \ingroup renderer-gl
+ * \brief Resizing of 2D and 3D images to any size
+ *
+ * Used by the texture loader to bring the images to hardware compatible
+ * dimensions, see SCE_RSetTextureResizeFilter(). The functions don't call
+ * the GL, they only need SCE_RWorkerInit() to use several threads.
+ *
+ * Images are 8 bits normalized, half float or float, with 1 to 4
+ * components. The filtering is separable: the weights of each axis are
+ * computed once per destination coordinate, the filter is widened by the
+ * reduction factor when shrinking. Each destination row is the weighted sum
+ * of the source rows it covers (and of the source slices for 3D images),
+ * then filtered horizontally. Rows of the destination are split among the
+ * worker threads.
+ * @{
+ */
+
+#define SCE_MITCHELL_B (1.0 / 3.0)
+#define SCE_MITCHELL_C (1.0 / 3.0)
+#define SCE_LANCZOS_LOBES 3.0
+
+/**
+ * \brief Checks whether images of the given format can be resampled
+ * \param n_comps number of components per pixel
+ * \param type type of the components
+ */
+int SCE_RIsResampleFormatSupported (int n_comps, SCE_EType type)
+{
+    return n_comps >= 1 && n_comps <= 4 &&
+        (type == SCE_UNSIGNED_BYTE || type == SCE_HALF_FLOAT ||
+         type == SCE_FLOAT);
+}
+
+static size_t SCE_RGetResampleTypeSize (SCE_EType type)
+{
+    switch (type) {
+    case SCE_HALF_FLOAT: return 2;
+    case SCE_FLOAT: return 4;
+    default: return 1;
+    }
+}
+
+/**
+ * \brief Gets the size in bytes of an image
+ */
+size_t SCE_RGetResampledImageSize (int w, int h, int d, int n_comps,
+                                   SCE_EType type)
+{
+    return (size_t)MAX (w, 1) * MAX (h, 1) * MAX (d, 1) * n_comps *
+        SCE_RGetResampleTypeSize (type);
+}
+
+
+static double SCE_RMitchell (double t)
+{
+    const double b = SCE_MITCHELL_B, c = SCE_MITCHELL_C;
+    t = fabs (t);
+    if (t < 1.0)
+        return ((12.0 - 9.0 * b - 6.0 * c) * t * t * t +
+                (-18.0 + 12.0 * b + 6.0 * c) * t * t + (6.0 - 2.0 * b)) / 6.0;
+    if (t < 2.0)
+        return ((-b - 6.0 * c) * t * t * t + (6.0 * b + 30.0 * c) * t * t +
+                (-12.0 * b - 48.0 * c) * t + (8.0 * b + 24.0 * c)) / 6.0;
+    return 0.0;
+}
+static double SCE_RLanczos (double t)
+{
+    double x;
+    if (t <= -SCE_LANCZOS_LOBES || t >= SCE_LANCZOS_LOBES)
+        return 0.0;
+    if (fabs (t) < 1e-6)
+        return 1.0;
+    x = M_PI * t;
+    return SCE_LANCZOS_LOBES * sin (x) * sin (x / SCE_LANCZOS_LOBES) / (x * x);
+}
+
+/**
+ * \internal
+ * \brief Frees the taps allocated by SCE_RAllocResampleTaps()
+ */
+void SCE_RClearResampleTaps (SCE_RResampleTaps *taps)
+{
+    SCE_free (taps->idx);
+    SCE_free (taps->w);
+}
+/**
+ * \internal
+ * \brief Allocates \p taps->n taps for each of \p dst destination pixels
+ */
+int SCE_RAllocResampleTaps (SCE_RResampleTaps *taps, int dst)
+{
+    taps->idx = SCE_malloc (dst * taps->n * sizeof *taps->idx);
+    taps->w = SCE_malloc (dst * taps->n * sizeof *taps->w);
+    if (!taps->idx || !taps->w) {
+        SCEE_LogSrc ();
+        SCE_RClearResampleTaps (taps);
+        return SCE_ERROR;
+    }
+    return SCE_OK;
+}
+/**
+ * \internal
+ * \brief Drops the leading and trailing taps that are always zero
+ */
+void SCE_RTrimResampleTaps (SCE_RResampleTaps *taps, int dst)
+{
+    int x, k, n = 1;
+    int *first = NULL;
+
+    if (!(first = SCE_malloc (dst * sizeof *first)))
+        return;                 /* untrimmed taps are still valid */
+    for (x = 0; x < dst; x++) {
+        const float *w = &taps->w[x * taps->n];
+        int lo = 0, hi = taps->n - 1;
+        while (lo < hi && w[lo] == 0.0f)
+            lo++;
+        while (hi > lo && w[hi] == 0.0f)
+            hi--;
+        first[x] = lo;
+        n = MAX (n, hi - lo + 1);
+    }
+    if (n < taps->n) {
+        /* in place: the destination never overtakes the source */
+        for (x = 0; x < dst; x++) {
+            int last = taps->n - 1;
+            for (k = 0; k < n; k++) {
+                int i = x * taps->n + MIN (first[x] + k, last);
+                float w = (first[x] + k <= last ? taps->w[i] : 0.0f);
+                taps->idx[x * n + k] = taps->idx[i];
+                taps->w[x * n + k] = w;
+            }
+        }
+        taps->n = n;
+    }
+    SCE_free (first);
+}
+static int SCE_RMakeResampleTaps (SCE_RResampleTaps *taps, int src, int dst,
+                                  SCE_RResampleFilter filter)
+{
+    double s = (double)src / dst, scale = MAX (s, 1.0), r;
+    int x, k;
+
+    if (src == dst) {
+        taps->n = 1;
+        if (SCE_RAllocResampleTaps (taps, dst) < 0)
+            return SCE_ERROR;
+        for (x = 0; x < dst; x++) {
+            taps->idx[x] = x;
+            taps->w[x] = 1.0f;
+        }
+        return SCE_OK;
+    }
+
+    switch (filter) {
+    case SCE_RESAMPLE_MITCHELL: r = 2.0; break;
+    case SCE_RESAMPLE_LANCZOS: r = SCE_LANCZOS_LOBES; break;
+    default: r = 0.5;
+    }
+    r *= scale;
+    taps->n = (int)ceil (2.0 * r) + 1;
+    if (SCE_RAllocResampleTaps (taps, dst) < 0)
+        return SCE_ERROR;
+
+    for (x = 0; x < dst; x++) {
+        double c = (x + 0.5) * s, sum = 0.0;
+        int first = (int)floor (c - r);
+        int *idx = &taps->idx[x * taps->n];
+        float *w = &taps->w[x * taps->n];
+
+        for (k = 0; k < taps->n; k++) {
+            int i = first + k;
+            double wk;
+            if (filter == SCE_RESAMPLE_MITCHELL)
+                wk = SCE_RMitchell ((i + 0.5 - c) / scale);
+            else if (filter == SCE_RESAMPLE_LANCZOS)
+                wk = SCE_RLanczos ((i + 0.5 - c) / scale);
+            else if (s > 1.0)   /* coverage of [c - r, c + r[ */
+                wk = MAX (0.0, MIN (i + 1.0, c + r) - MAX ((double)i, c - r));
+            else                /* nearest */
+                wk = (i == (int)floor (c));
+            idx[k] = MAX (0, MIN (i, src - 1));
+            w[k] = wk;
+            sum += wk;
+        }
+        if (sum != 0.0) {
+            for (k = 0; k < taps->n; k++)
+                w[k] /= sum;
+        }
+    }
+
+    SCE_RTrimResampleTaps (taps, dst);
+    return SCE_OK;
+}
+
+
+typedef struct {
+    const unsigned char *src;
+    unsigned char *dst;
+    int w, h, d, dw, dh, dd, n_comps;
+    SCE_EType type;
+    SCE_RResampleTaps xtaps, ytaps, ztaps;
+    int failed;
+} SCE_RResampleJob;
+
+/* returns the components of the source row \p y as floats, \p out is used
+   unless the source is already float */
+static const float* SCE_RDecodeResampleRow (const SCE_RResampleJob *job,
+                                            size_t y, float *out)
+{
+    size_t n = (size_t)job->w * job->n_comps;
+
+    if (job->type == SCE_FLOAT)
+        return (const float*)job->src + y * n;
+    else if (job->type == SCE_HALF_FLOAT)
+        SCE_RHalfToFloatRow ((const unsigned short*)job->src + y * n, out, n);
+    else
+        SCE_RUnormToFloatRow (job->src + y * n, out, n);
+    return out;
+}
+/* float destinations are filtered in place, see SCE_RResampleRows() */
+static void SCE_REncodeResampleRow (const SCE_RResampleJob *job, size_t y,
+                                    const float *in)
+{
+    size_t n = (size_t)job->dw * job->n_comps;
+
+    if (job->type == SCE_HALF_FLOAT)
+        SCE_RFloatToHalfRow (in, (unsigned short*)job->dst + y * n, n);
+    else
+        SCE_RFloatToUnormRow (in, job->dst + y * n, n);
+}
+
+/**
+ * \internal
+ * \brief Accumulates a row of floats: acc += row * w
+ */
+void SCE_RAccumulateResampleRow (float *acc, const float *row, float w,
+                                 size_t n)
+{
+    size_t i = 0;
+#ifdef __SSE2__
+    __m128 vw = _mm_set1_ps (w);
+    for (; i + 4 <= n; i += 4) {
+        __m128 a = _mm_loadu_ps (&acc[i]);
+        a = _mm_add_ps (a, _mm_mul_ps (_mm_loadu_ps (&row[i]), vw));
+        _mm_storeu_ps (&acc[i], a);
+    }
+#endif
+    for (; i < n; i++)
+        acc[i] += row[i] * w;
+}
+/**
+ * \internal
+ * \brief Filters a row of floats horizontally
+ * \param taps taps of the destination pixels
+ * \param n_comps number of components per pixel
+ * \param dw number of destination pixels
+ * \param in source row
+ * \param out destination row
+ */
+void SCE_RFilterResampleRow (const SCE_RResampleTaps *taps, int n_comps,
+                             int dw, const float *in, float *out)
+{
+    int x, k, c;
+
+#ifdef __SSE2__
+    if (n_comps == 4) {
+        for (x = 0; x < dw; x++) {
+            const int *idx = &taps->idx[x * taps->n];
+            const float *w = &taps->w[x * taps->n];
+            __m128 sum = _mm_setzero_ps ();
+            for (k = 0; k < taps->n; k++) {
+                __m128 p = _mm_loadu_ps (&in[idx[k] * 4]);
+                sum = _mm_add_ps (sum, _mm_mul_ps (p, _mm_set1_ps (w[k])));
+            }
+            _mm_storeu_ps (&out[x * 4], sum);
+        }
+        return;
+    }
+#endif
+    for (x = 0; x < dw; x++) {
+        const int *idx = &taps->idx[x * taps->n];
+        const float *w = &taps->w[x * taps->n];
+        for (c = 0; c < n_comps; c++) {
+            float sum = 0.0f;
+            for (k = 0; k < taps->n; k++)
+                sum += in[idx[k] * n_comps + c] * w[k];
+            out[x * n_comps + c] = sum;
+        }
+    }
+}
+
+static void SCE_RResampleRows (size_t begin, size_t end, void *data)
+{
+    SCE_RResampleJob *job = data;
+    const SCE_RResampleTaps *yt = &job->ytaps, *zt = &job->ztaps;
+    size_t n = (size_t)job->w * job->n_comps;
+    size_t dn = (size_t)job->dw * job->n_comps;
+    float *row = NULL, *acc = NULL, *out = NULL;
+    size_t r;
+    int ky, kz;
+
+    row = SCE_malloc (n * sizeof *row);
+    acc = SCE_malloc (n * sizeof *acc);
+    out = SCE_malloc (dn * sizeof *out);
+    if (!row || !acc || !out) {
+        job->failed = SCE_TRUE;
+        goto end;
+    }
+
+    for (r = begin; r < end; r++) {
+        size_t y = r % job->dh, z = r / job->dh;
+        const int *yidx = &yt->idx[y * yt->n], *zidx = &zt->idx[z * zt->n];
+        const float *yw = &yt->w[y * yt->n], *zw = &zt->w[z * zt->n];
+        const float *in;
+        float *o = (job->type == SCE_FLOAT ? (float*)job->dst + r * dn : out);
+
+        if (yt->n == 1 && zt->n == 1) {
+            /* single source row of weight 1 */
+            in = SCE_RDecodeResampleRow (job, (size_t)zidx[0] * job->h +
+                                         yidx[0], row);
+        } else {
+            memset (acc, 0, n * sizeof *acc);
+            for (kz = 0; kz < zt->n; kz++) {
+                for (ky = 0; ky < yt->n; ky++) {
+                    float w = zw[kz] * yw[ky];
+                    size_t sy = (size_t)zidx[kz] * job->h + yidx[ky];
+                    if (w == 0.0f)
+                        continue;
+                    SCE_RAccumulateResampleRow (
+                        acc, SCE_RDecodeResampleRow (job, sy, row), w, n);
+                }
+            }
+            in = acc;
+        }
+
+        if (job->dw != job->w)
+            SCE_RFilterResampleRow (&job->xtaps, job->n_comps, job->dw,
+                                    in, o);
+        else if (job->type == SCE_FLOAT)
+            memcpy (o, in, dn * sizeof *o);
+        else
+            o = (float*)in;
+        if (job->type != SCE_FLOAT)
+            SCE_REncodeResampleRow (job, r, o);
+    }
+end:
+    SCE_free (out);
+    SCE_free (acc);
+    SCE_free (row);
+}
+
+/**
+ * \brief Resamples an image to another size
+ * \param src source pixels, rows and slices are tightly packed
+ * \param w \param h \param d size of the source image, 1 for the unused
+ * dimensions
+ * \param n_comps number of components per pixel, 1 to 4
+ * \param type type of the components, SCE_UNSIGNED_BYTE, SCE_HALF_FLOAT or
+ * SCE_FLOAT
+ * \param dw \param dh \param dd size of the destination image
+ * \param filter resampling filter
+ * \param dst destination pixels
+ * \returns SCE_ERROR on error, SCE_OK otherwise
+ *
+ * 8 bits components are clamped to [0, 1], the filters other than the box
+ * can overshoot near sharp edges. \p src and \p dst must not overlap.
+ * \sa SCE_RGetResampledImageSize()
+ */
+int SCE_RResampleImage (const void *src, int w, int h, int d, int n_comps,
+                        SCE_EType type, int dw, int dh, int dd,
+                        SCE_RResampleFilter filter, void *dst)
+{
+    SCE_RResampleJob job;
+    size_t grain;
+
+    if (!SCE_RIsResampleFormatSupported (n_comps, type)) {
+        SCEE_Log (SCE_INVALID_ARG);
+        SCEE_LogMsg ("can't resample images of %d components of type %d",
+                     n_comps, (int)type);
+        return SCE_ERROR;
+    }
+
+    job.src = src;
+    job.dst = dst;
+    job.w = MAX (w, 1);
+    job.h = MAX (h, 1);
+    job.d = MAX (d, 1);
+    job.dw = MAX (dw, 1);
+    job.dh = MAX (dh, 1);
+    job.dd = MAX (dd, 1);
+    job.n_comps = n_comps;
+    job.type = type;
+    job.failed = SCE_FALSE;
+    if (SCE_RMakeResampleTaps (&job.xtaps, job.w, job.dw, filter) < 0)
+        goto fail;
+    if (SCE_RMakeResampleTaps (&job.ytaps, job.h, job.dh, filter) < 0) {
+        SCE_RClearResampleTaps (&job.xtaps);
+        goto fail;
+    }
+    if (SCE_RMakeResampleTaps (&job.ztaps, job.d, job.dd, filter) < 0) {
+        SCE_RClearResampleTaps (&job.ytaps);
+        SCE_RClearResampleTaps (&job.xtaps);
+        goto fail;
+    }
+
+    /* about 64k destination pixels per job */
+    grain = MAX (1, 65536 / job.dw);
+    SCE_RParallelFor ((size_t)job.dh * job.dd, grain, SCE_RResampleRows, &job);
+
+    SCE_RClearResampleTaps (&job.ztaps);
+    SCE_RClearResampleTaps (&job.ytaps);
+    SCE_RClearResampleTaps (&job.xtaps);
+    if (job.failed)
+        goto fail;
+    return SCE_OK;
+fail:
+    SCEE_LogSrc ();
+    return SCE_ERROR;
+}
+
+/** @} */
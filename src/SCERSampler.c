@@ -0,0 +1,238 @@
+/*------------------------------------------------------------------------------
+    SCEngine - A 3D real time rendering engine written in the C language
+    Copyright (C) 2006-2013  Antony Martin <martin(dot)antony(at)yahoo(dot)fr>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/* created: 19/10/2026
+   updated: 19/10/2026 */
+
+#include <string.h>
+#include <GL/glew.h>
+#include <SCE/utils/SCEUtils.h>
+#include "SCE/renderer/SCERType.h"
+#include "SCE/renderer/SCERSupport.h"
+#include "SCE/renderer/SCERTexture.h"
+#include "SCE/renderer/SCERSampler.h"
+
+/**
+ * \file SCERSampler.c
+ * \copydoc sampler
+ *
+ * \file SCERSampler.h
+ * \copydoc sampler
+ */
+
+/**
+ * \defgroup sampler Samplers
+ * \ingroup renderer-gl
+ * \brief Cache of GL sampler objects
+ *
+ * The filtering, wrapping, depth comparison and level of detail state of
+ * the textures is described by a SCE_RSamplerDesc. Descriptions are
+ * hashed into a table of GL sampler objects, so that each distinct state
+ * has exactly one sampler shared by all the textures using it.
+ * SCE_RUseTexture() binds the sampler of a texture to its unit alongside
+ * it, a texture can thus be sampled in different ways without changing its
+ * parameters, see SCE_RUseTextureSampler(). Without GL_ARB_sampler_objects,
+ * the state is stored as parameters of the textures as before.
+ * @{
+ */
+
+#define SCE_SAMPLER_TABLE_SIZE 64
+
+static SCE_RSampler *samplers[SCE_SAMPLER_TABLE_SIZE];
+static unsigned int n_samplers = 0;
+static SCEuint *bound = NULL;   /* sampler bound to each texture unit */
+static int n_units = 0;
+static float max_anisotropy = 1.0f;
+
+
+/**
+ * \internal
+ * \brief Initializes the samplers manager, after the textures manager
+ */
+int SCE_RSamplerInit (void)
+{
+    size_t i;
+
+    for (i = 0; i < SCE_SAMPLER_TABLE_SIZE; i++)
+        samplers[i] = NULL;
+    n_samplers = 0;
+    max_anisotropy = 1.0f;
+    if (SCE_RHasCap (SCE_TEX_ANISOTROPY))
+        glGetFloatv (GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &max_anisotropy);
+
+    n_units = SCE_RGetMaxTextureUnits ();
+    if (!(bound = SCE_malloc (n_units * sizeof *bound))) {
+        SCEE_LogSrc ();
+        SCEE_LogSrcMsg ("failed to initialize samplers manager");
+        return SCE_ERROR;
+    }
+    for (i = 0; i < n_units; i++)
+        bound[i] = 0;
+    return SCE_OK;
+}
+/**
+ * \internal
+ * \brief Quits the samplers manager, deletes the GL samplers
+ */
+void SCE_RSamplerQuit (void)
+{
+    size_t i;
+    for (i = 0; i < SCE_SAMPLER_TABLE_SIZE; i++) {
+        while (samplers[i]) {
+            SCE_RSampler *next = samplers[i]->next;
+            glDeleteSamplers (1, &samplers[i]->id);
+            SCE_free (samplers[i]);
+            samplers[i] = next;
+        }
+    }
+    n_samplers = 0;
+    SCE_free (bound);
+    bound = NULL;
+}
+
+/**
+ * \brief Gets the maximum anisotropy supported, 1 when anisotropic filtering
+ * isn't supported
+ *
+ * The value is queried once by SCE_RSamplerInit().
+ */
+float SCE_RGetMaxAnisotropy (void)
+{
+    return max_anisotropy;
+}
+
+/**
+ * \brief Initializes a sampler description to the default GL state
+ */
+void SCE_RInitSamplerDesc (SCE_RSamplerDesc *desc)
+{
+    /* hashed as raw bytes */
+    memset (desc, 0, sizeof *desc);
+    desc->min_filter = GL_NEAREST_MIPMAP_LINEAR;
+    desc->mag_filter = GL_LINEAR;
+    desc->wrap[0] = desc->wrap[1] = desc->wrap[2] = GL_REPEAT;
+    desc->anisotropy = 1.0f;
+    desc->compare_mode = GL_NONE;
+    desc->compare_func = GL_LEQUAL;
+    desc->min_lod = -1000.0f;
+    desc->max_lod = 1000.0f;
+    desc->lod_bias = 0.0f;
+}
+
+/**
+ * \brief Sets the sampling state of \p desc as parameters of the texture
+ * bound to \p target
+ */
+void SCE_RApplySamplerDesc (SCEenum target, const SCE_RSamplerDesc *desc)
+{
+    glTexParameteri (target, GL_TEXTURE_MIN_FILTER, desc->min_filter);
+    glTexParameteri (target, GL_TEXTURE_MAG_FILTER, desc->mag_filter);
+    glTexParameteri (target, GL_TEXTURE_WRAP_S, desc->wrap[0]);
+    glTexParameteri (target, GL_TEXTURE_WRAP_T, desc->wrap[1]);
+    glTexParameteri (target, GL_TEXTURE_WRAP_R, desc->wrap[2]);
+    if (SCE_RHasCap (SCE_TEX_ANISOTROPY))
+        glTexParameterf (target, GL_TEXTURE_MAX_ANISOTROPY_EXT,
+                         desc->anisotropy);
+    glTexParameteri (target, GL_TEXTURE_COMPARE_MODE, desc->compare_mode);
+    glTexParameteri (target, GL_TEXTURE_COMPARE_FUNC, desc->compare_func);
+    glTexParameterf (target, GL_TEXTURE_MIN_LOD, desc->min_lod);
+    glTexParameterf (target, GL_TEXTURE_MAX_LOD, desc->max_lod);
+    glTexParameterf (target, GL_TEXTURE_LOD_BIAS, desc->lod_bias);
+    glTexParameterfv (target, GL_TEXTURE_BORDER_COLOR, desc->border);
+}
+
+
+static SCEuint SCE_RHashSamplerDesc (const SCE_RSamplerDesc *desc)
+{
+    return SCE_RHashData (desc, sizeof *desc, SCE_HASH_INIT);
+}
+
+/**
+ * \brief Gets the sampler object of a state
+ * \param desc the sampling state
+ *
+ * Samplers are created on the first request of a state and shared until
+ * SCE_RSamplerQuit().
+ * \returns the sampler, NULL on error or when sampler objects aren't
+ * supported
+ */
+SCE_RSampler* SCE_RGetSampler (const SCE_RSamplerDesc *desc)
+{
+    SCEuint h;
+    SCE_RSampler *s = NULL;
+
+    if (!SCE_RHasCap (SCE_SAMPLER_OBJECTS))
+        return NULL;
+    h = SCE_RHashSamplerDesc (desc);
+    for (s = samplers[h % SCE_SAMPLER_TABLE_SIZE]; s; s = s->next) {
+        if (s->hash == h && !memcmp (&s->desc, desc, sizeof *desc))
+            return s;
+    }
+
+    if (!(s = SCE_malloc (sizeof *s))) {
+        SCEE_LogSrc ();
+        return NULL;
+    }
+    s->desc = *desc;
+    s->hash = h;
+    glGenSamplers (1, &s->id);
+    glSamplerParameteri (s->id, GL_TEXTURE_MIN_FILTER, desc->min_filter);
+    glSamplerParameteri (s->id, GL_TEXTURE_MAG_FILTER, desc->mag_filter);
+    glSamplerParameteri (s->id, GL_TEXTURE_WRAP_S, desc->wrap[0]);
+    glSamplerParameteri (s->id, GL_TEXTURE_WRAP_T, desc->wrap[1]);
+    glSamplerParameteri (s->id, GL_TEXTURE_WRAP_R, desc->wrap[2]);
+    if (SCE_RHasCap (SCE_TEX_ANISOTROPY))
+        glSamplerParameterf (s->id, GL_TEXTURE_MAX_ANISOTROPY_EXT,
+                             desc->anisotropy);
+    glSamplerParameteri (s->id, GL_TEXTURE_COMPARE_MODE, desc->compare_mode);
+    glSamplerParameteri (s->id, GL_TEXTURE_COMPARE_FUNC, desc->compare_func);
+    glSamplerParameterf (s->id, GL_TEXTURE_MIN_LOD, desc->min_lod);
+    glSamplerParameterf (s->id, GL_TEXTURE_MAX_LOD, desc->max_lod);
+    glSamplerParameterf (s->id, GL_TEXTURE_LOD_BIAS, desc->lod_bias);
+    glSamplerParameterfv (s->id, GL_TEXTURE_BORDER_COLOR, desc->border);
+    s->next = samplers[h % SCE_SAMPLER_TABLE_SIZE];
+    samplers[h % SCE_SAMPLER_TABLE_SIZE] = s;
+    n_samplers++;
+    return s;
+}
+/**
+ * \brief Gets the number of sampler objects created
+ */
+unsigned int SCE_RGetNumSamplers (void)
+{
+    return n_samplers;
+}
+
+/**
+ * \brief Binds a sampler to a texture unit
+ * \param s a sampler, NULL to sample with the parameters of the textures
+ * \param unit a texture unit
+ *
+ * Nothing is done when \p s is already bound to \p unit.
+ * \sa SCE_RUseTextureSampler()
+ */
+void SCE_RUseSampler (SCE_RSampler *s, int unit)
+{
+    SCEuint id = s ? s->id : 0;
+    if (unit >= 0 && unit < n_units && bound[unit] != id) {
+        glBindSampler (unit, id);
+        bound[unit] = id;
+    }
+}
+
+/** @} */
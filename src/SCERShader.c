@@ -19,6 +19,7 @@
 /* created: 11/02/2007
    updated: 29/01/2012 */
 
+#include <pthread.h>
 #include <SCE/utils/SCEUtils.h>
 #include "SCE/renderer/SCERenderer.h"     /* SCE_RGetError() */
 #include "SCE/renderer/SCERSupport.h"
@@ -44,13 +45,137 @@ static const char *sce_typename[SCE_NUM_SHADER_TYPES] = {
     "tessellation evaluation",
 };
 
+static SCEbitfield sce_glstagebit[SCE_NUM_SHADER_TYPES] = {
+    GL_VERTEX_SHADER_BIT,
+    GL_FRAGMENT_SHADER_BIT,
+    GL_GEOMETRY_SHADER_BIT,
+    GL_TESS_CONTROL_SHADER_BIT,
+    GL_TESS_EVALUATION_SHADER_BIT
+};
+
+#define SCE_PIPELINE_CACHE_SIZE 64
+
+static SCE_RProgramPipeline *pipelines[SCE_PIPELINE_CACHE_SIZE];
+static SCE_RProgramPipeline *sce_rpipeline = NULL; /* bound pipeline */
+static SCE_RProgram *sce_rprogram = NULL;          /* used program */
+
+
+/**
+ * \internal
+ * \brief Shared GL object, identified by the content it was built from
+ */
+struct sce_rglobject {
+    SCEuint hash;
+    void *key;                  /**< Content the object was built from */
+    size_t key_size;
+    SCEuint id;                 /**< GL object */
+    unsigned int refs;
+    SCE_RGLObject *next;
+};
+
+#define SCE_GLOBJECT_TABLE_SIZE 256
+
+static SCE_RGLObject *shader_objects[SCE_GLOBJECT_TABLE_SIZE];
+static SCE_RGLObject *program_objects[SCE_GLOBJECT_TABLE_SIZE];
+/* programs are also linked by the upload thread, see SCE_RSubmitProgram() */
+static pthread_mutex_t programs_mutex = PTHREAD_MUTEX_INITIALIZER;
+static SCE_RShaderStats stats;
+
 
 int SCE_RShaderInit (void)
 {
+    size_t i;
+    for (i = 0; i < SCE_PIPELINE_CACHE_SIZE; i++)
+        pipelines[i] = NULL;
+    sce_rpipeline = NULL;
+    sce_rprogram = NULL;
+    for (i = 0; i < SCE_GLOBJECT_TABLE_SIZE; i++)
+        shader_objects[i] = program_objects[i] = NULL;
+    memset (&stats, 0, sizeof stats);
     return SCE_OK;
 }
 void SCE_RShaderQuit (void)
 {
+    SCE_RFlushProgramPipelines ();
+    /* remaining objects belong to shaders or programs not deleted by the
+       user, the GL objects go with the context */
+}
+
+/**
+ * \brief Gets the statistics of shared shaders and programs
+ * \param s filled with the current counters
+ */
+void SCE_RGetShaderStats (SCE_RShaderStats *s)
+{
+    *s = stats;
+}
+/**
+ * \brief Resets the compile and link counters
+ */
+void SCE_RResetShaderStats (void)
+{
+    stats.compiles = stats.compiles_avoided = 0;
+    stats.links = stats.links_avoided = 0;
+}
+
+
+static SCEuint SCE_RHashKey (const void *key, size_t size)
+{
+    return SCE_RHashData (key, size, SCE_HASH_INIT);
+}
+
+/* gets a reference on the object built from key, if any */
+static SCE_RGLObject* SCE_RAcquireGLObject (SCE_RGLObject **table,
+                                            const void *key, size_t size)
+{
+    SCEuint h = SCE_RHashKey (key, size);
+    SCE_RGLObject *obj = table[h % SCE_GLOBJECT_TABLE_SIZE];
+    while (obj) {
+        if (obj->hash == h && obj->key_size == size &&
+            !memcmp (obj->key, key, size)) {
+            obj->refs++;
+            return obj;
+        }
+        obj = obj->next;
+    }
+    return NULL;
+}
+
+/* registers a new GL object, the key is taken */
+static SCE_RGLObject* SCE_RAddGLObject (SCE_RGLObject **table, void *key,
+                                        size_t size, SCEuint id)
+{
+    SCE_RGLObject *obj = NULL;
+    SCEuint h = SCE_RHashKey (key, size);
+
+    if (!(obj = SCE_malloc (sizeof *obj))) {
+        SCEE_LogSrc ();
+        return NULL;
+    }
+    obj->hash = h;
+    obj->key = key;
+    obj->key_size = size;
+    obj->id = id;
+    obj->refs = 1;
+    obj->next = table[h % SCE_GLOBJECT_TABLE_SIZE];
+    table[h % SCE_GLOBJECT_TABLE_SIZE] = obj;
+    return obj;
+}
+
+/* drops a reference, returns TRUE if the GL object must be deleted */
+static int SCE_RReleaseGLObject (SCE_RGLObject **table, SCE_RGLObject *obj)
+{
+    SCE_RGLObject **p = NULL;
+
+    if (--obj->refs > 0)
+        return SCE_FALSE;
+    p = &table[obj->hash % SCE_GLOBJECT_TABLE_SIZE];
+    while (*p != obj)
+        p = &(*p)->next;
+    *p = obj->next;
+    SCE_free (obj->key);
+    SCE_free (obj);
+    return SCE_TRUE;
 }
 
 
@@ -64,26 +189,33 @@ SCE_RShaderGLSL* SCE_RCreateShaderGLSL (SCE_RShaderType type)
         return NULL;
     }
 
+    shader->id = 0;             /* created or shared at build time */
+    shader->object = NULL;
     shader->data = NULL;
     shader->compiled = SCE_FALSE;
     shader->type = type;
     shader->gltype = sce_gltype[type];
 
-    shader->id = glCreateShader (shader->gltype);
-    if (shader->id == 0) {
-        SCEE_Log (SCE_ERROR);
-        SCEE_LogMsg ("failed to create shader: %s", SCE_RGetError ());
-        SCE_free (shader);
-        return NULL;
-    }
-
     return shader;
 }
+
+static void SCE_RReleaseShaderGLSL (SCE_RShaderGLSL *shader)
+{
+    if (shader->object) {
+        if (SCE_RReleaseGLObject (shader_objects, shader->object)) {
+            glDeleteShader (shader->id);
+            stats.shaders--;
+        }
+        shader->object = NULL;
+        shader->id = 0;
+        shader->compiled = SCE_FALSE;
+    }
+}
+
 void SCE_RDeleteShaderGLSL (SCE_RShaderGLSL *shader)
 {
     if (shader) {
-        if (glIsShader (shader->id))
-            glDeleteShader (shader->id);
+        SCE_RReleaseShaderGLSL (shader);
         SCE_free (shader);
     }
 }
@@ -94,36 +226,83 @@ void SCE_RSetShaderGLSLSource (SCE_RShaderGLSL *shader, char *src)
     shader->data = src;
 }
 
+/**
+ * \brief Compiles a shader
+ * \param shader a shader with a source
+ * \returns SCE_ERROR on error, SCE_OK otherwise
+ *
+ * If a shader of the same type and source was already compiled, its GL
+ * object is shared and no compilation occurs.
+ * \sa SCE_RGetShaderStats()
+ */
 int SCE_RBuildShaderGLSL (SCE_RShaderGLSL *shader)
 {
     int compile_status = GL_TRUE;
     int loginfo_size = 0;
     char *loginfo = NULL;
+    size_t len = strlen (shader->data) + 1;
+    size_t size = sizeof shader->type + len;
+    unsigned char *key = NULL;
+    SCEuint id;
 
-    glShaderSource (shader->id, 1, (const GLchar**)&shader->data, NULL);
-    glCompileShader (shader->id);
+    /* key: type followed by the source */
+    if (!(key = SCE_malloc (size))) {
+        SCEE_LogSrc ();
+        return SCE_ERROR;
+    }
+    memcpy (key, &shader->type, sizeof shader->type);
+    memcpy (&key[sizeof shader->type], shader->data, len);
+
+    SCE_RReleaseShaderGLSL (shader);
+    if ((shader->object = SCE_RAcquireGLObject (shader_objects, key, size))) {
+        SCE_free (key);
+        shader->id = shader->object->id;
+        shader->compiled = SCE_TRUE;
+        stats.compiles_avoided++;
+        return SCE_OK;
+    }
+
+    if (!(id = glCreateShader (shader->gltype))) {
+        SCEE_Log (SCE_ERROR);
+        SCEE_LogMsg ("failed to create shader: %s", SCE_RGetError ());
+        SCE_free (key);
+        return SCE_ERROR;
+    }
+    glShaderSource (id, 1, (const GLchar**)&shader->data, NULL);
+    glCompileShader (id);
+    stats.compiles++;
 
-    glGetShaderiv (shader->id, GL_COMPILE_STATUS, &compile_status);
+    glGetShaderiv (id, GL_COMPILE_STATUS, &compile_status);
     if (compile_status != GL_TRUE) {
         SCEE_Log (SCE_INVALID_OPERATION);
-        glGetShaderiv (shader->id, GL_INFO_LOG_LENGTH, &loginfo_size);
+        glGetShaderiv (id, GL_INFO_LOG_LENGTH, &loginfo_size);
         loginfo = SCE_malloc (loginfo_size + 1);
         if (!loginfo) {
             SCEE_LogSrc ();
-            return SCE_ERROR;
+            goto fail;
         }
 
         memset (loginfo, '\0', loginfo_size + 1);
-        glGetShaderInfoLog (shader->id, loginfo_size, &loginfo_size, loginfo);
+        glGetShaderInfoLog (id, loginfo_size, &loginfo_size, loginfo);
 
         SCEE_LogMsg ("error while compiling GLSL %s shader :\n%s",
                      sce_typename[shader->type], loginfo);
         SCE_free (loginfo);
-        return SCE_ERROR;
+        goto fail;
     }
 
+    if (!(shader->object = SCE_RAddGLObject (shader_objects, key, size, id))) {
+        SCEE_LogSrc ();
+        goto fail;
+    }
+    stats.shaders++;
+    shader->id = id;
     shader->compiled = SCE_TRUE;
     return SCE_OK;
+fail:
+    glDeleteShader (id);
+    SCE_free (key);
+    return SCE_ERROR;
 }
 
 /* :) */
@@ -140,8 +319,10 @@ SCE_RProgram* SCE_RCreateProgram (void)
         return NULL;
     }
 
-    prog->id = glCreateProgram ();
+    prog->id = 0;               /* created or shared at link time */
+    prog->object = NULL;
     prog->linked = SCE_FALSE;
+    prog->n_shaders = 0;
     SCE_RInitVertexAttributesMap (prog->map);
     prog->map_built = SCE_FALSE;
     prog->use_vmap = SCE_FALSE;
@@ -152,6 +333,10 @@ SCE_RProgram* SCE_RCreateProgram (void)
     prog->use_mmap = SCE_FALSE;
     prog->use_tess = SCE_FALSE;
     prog->patch_vertices = 0;
+    prog->separable = SCE_FALSE;
+    prog->shared = SCE_FALSE;
+    prog->stages = 0;
+    prog->prim_in = prog->prim_out = 0;
     prog->fb_enabled = SCE_FALSE;
     prog->fb_mode = SCE_FEEDBACK_INTERLEAVED;
     prog->fb_varyings = NULL;
@@ -162,12 +347,31 @@ SCE_RProgram* SCE_RCreateProgram (void)
     return prog;
 }
 
+static void SCE_RReleaseProgram (SCE_RProgram *prog)
+{
+    if (prog->object) {
+        if (SCE_RReleaseGLObject (program_objects, prog->object)) {
+            glDeleteProgram (prog->id);
+            stats.programs--;
+        }
+        prog->object = NULL;
+    } else if (prog->id) {
+        glDeleteProgram (prog->id);
+        stats.programs--;
+    }
+    prog->id = 0;
+}
+
 void SCE_RDeleteProgram (SCE_RProgram *prog)
 {
     if (prog) {
         size_t i;
-        if (glIsProgram (prog->id))
-            glDeleteProgram (prog->id);
+        SCE_RDropProgramPipelines (prog);
+        if (sce_rprogram == prog)
+            sce_rprogram = NULL;
+        pthread_mutex_lock (&programs_mutex);
+        SCE_RReleaseProgram (prog);
+        pthread_mutex_unlock (&programs_mutex);
         for (i = 0; i < prog->n_varyings; i++)
             SCE_free (prog->fb_varyings[i]);
         SCE_free (prog->fb_varyings);
@@ -178,10 +382,28 @@ void SCE_RDeleteProgram (SCE_RProgram *prog)
 int SCE_RSetProgramShader (SCE_RProgram *prog, SCE_RShaderGLSL *shader,
                            int attach)
 {
-    if (attach)
-        glAttachShader (prog->id, shader->id);
-    else
-        glDetachShader (prog->id, shader->id);
+    size_t i;
+
+    for (i = 0; i < prog->n_shaders; i++) {
+        if (prog->shaders[i] == shader)
+            break;
+    }
+    if (attach) {
+        if (i == prog->n_shaders) {
+            if (prog->n_shaders >= SCE_MAX_PROGRAM_SHADERS) {
+                SCEE_Log (SCE_INVALID_OPERATION);
+                SCEE_LogMsg ("too many shaders attached, maximum is %d",
+                             SCE_MAX_PROGRAM_SHADERS);
+                return SCE_ERROR;
+            }
+            prog->shaders[prog->n_shaders++] = shader;
+        }
+        prog->stages |= 1 << shader->type;
+    } else {
+        if (i < prog->n_shaders)
+            prog->shaders[i] = prog->shaders[--prog->n_shaders];
+        prog->stages &= ~(1 << shader->type);
+    }
 
     if (shader->type == SCE_TESS_EVALUATION_SHADER ||
         shader->type == SCE_TESS_CONTROL_SHADER)
@@ -231,21 +453,147 @@ fail:
     return SCE_ERROR;
 }
 
+/**
+ * \brief Makes a program bindable to the stages of a pipeline
+ * \param prog a program
+ * \param separable boolean
+ *
+ * A separable program only needs the shaders of the stages it covers, it is
+ * combined with other separable programs by SCE_RGetProgramPipeline(), so that
+ * each stage is linked once instead of once per combination of stages.
+ * \sa SCE_RGetProgramPipeline()
+ */
+void SCE_RSetProgramSeparable (SCE_RProgram *prog, int separable)
+{
+    prog->separable = separable;
+    prog->linked = SCE_FALSE;
+}
 
-int SCE_RBuildProgram (SCE_RProgram *prog)
+
+/**
+ * \brief Lets a program share its GL program with identical programs
+ * \param prog a program
+ * \param shared boolean, default is FALSE
+ *
+ * Shared programs with the same shaders, parameters, feedback varyings and
+ * outputs are linked once and use the same GL program, so they also share
+ * the values of their uniforms: a uniform set through one of them is seen by
+ * all the others. Only share programs whose uniforms are set before each use,
+ * or never changed.
+ * \sa SCE_RGetShaderStats()
+ */
+void SCE_RSetProgramShared (SCE_RProgram *prog, int shared)
+{
+    prog->shared = shared;
+    prog->linked = SCE_FALSE;
+}
+
+
+/* everything the link depends on: shaders, parameters, varyings, outputs */
+static void* SCE_RMakeProgramKey (SCE_RProgram *prog, size_t *size)
+{
+    SCEuint ids[SCE_MAX_PROGRAM_SHADERS];
+    SCEuint params[5];
+    unsigned char *key = NULL, *p = NULL;
+    size_t i, j, n = 0;
+
+    /* sorted, the attach order doesn't matter */
+    for (i = 0; i < prog->n_shaders; i++) {
+        SCEuint id = prog->shaders[i]->id;
+        for (j = i; j > 0 && ids[j - 1] > id; j--)
+            ids[j] = ids[j - 1];
+        ids[j] = id;
+    }
+    params[0] = prog->separable;
+    params[1] = prog->prim_in;
+    params[2] = prog->prim_out;
+    params[3] = prog->fb_enabled ? prog->n_varyings : 0;
+    params[4] = prog->fb_mode;
+
+    n = prog->n_shaders * sizeof *ids + sizeof params;
+    for (i = 0; i < params[3]; i++)
+        n += strlen (prog->fb_varyings[i]) + 1;
+    n += sizeof prog->outputs;
+
+    if (!(p = key = SCE_malloc (n))) {
+        SCEE_LogSrc ();
+        return NULL;
+    }
+    memcpy (p, ids, prog->n_shaders * sizeof *ids);
+    p += prog->n_shaders * sizeof *ids;
+    memcpy (p, params, sizeof params);
+    p += sizeof params;
+    for (i = 0; i < params[3]; i++) {
+        size_t len = strlen (prog->fb_varyings[i]) + 1;
+        memcpy (p, prog->fb_varyings[i], len);
+        p += len;
+    }
+    memcpy (p, prog->outputs, sizeof prog->outputs);
+
+    *size = n;
+    return key;
+}
+
+static int SCE_RLinkProgram (SCE_RProgram *prog)
 {
     const int modes[2] = {GL_INTERLEAVED_ATTRIBS, GL_SEPARATE_ATTRIBS};
     int status = GL_TRUE;
     int loginfo_size = 0;
     char *loginfo = NULL;
-    int i, j;
+    void *key = NULL;
+    size_t size = 0;
+    SCEuint id;
+    int j;
+    size_t i;
 
     if (prog->linked)
         return SCE_OK;
 
+    /* the pipelines use the GL program about to be replaced. They belong
+       to the rendering context, SCE_RSubmitProgram() drops them before
+       the upload thread relinks */
+    if (!SCE_RIsUploadThread ())
+        SCE_RDropProgramPipelines (prog);
+
+    for (i = 0; i < prog->n_shaders; i++) {
+        if (!prog->shaders[i]->compiled) {
+            SCEE_Log (SCE_INVALID_OPERATION);
+            SCEE_LogMsg ("can't link program, %s shader not compiled",
+                         sce_typename[prog->shaders[i]->type]);
+            return SCE_ERROR;
+        }
+    }
+
+    SCE_RReleaseProgram (prog);
+    if (prog->shared) {
+        if (!(key = SCE_RMakeProgramKey (prog, &size))) {
+            SCEE_LogSrc ();
+            return SCE_ERROR;
+        }
+        prog->object = SCE_RAcquireGLObject (program_objects, key, size);
+        if (prog->object) {
+            SCE_free (key);
+            prog->id = prog->object->id;
+            stats.links_avoided++;
+            goto linked;
+        }
+    }
+
+    id = glCreateProgram ();
+    if (prog->separable)
+        glProgramParameteri (id, GL_PROGRAM_SEPARABLE, GL_TRUE);
+    if (prog->prim_in)
+        glProgramParameteri (id, GL_GEOMETRY_INPUT_TYPE_EXT, prog->prim_in);
+    if (prog->prim_out)
+        glProgramParameteri (id, GL_GEOMETRY_OUTPUT_TYPE_EXT, prog->prim_out);
+    /* shaders are never detached: it keeps their names reserved, which keeps
+       the program keys unique */
+    for (i = 0; i < prog->n_shaders; i++)
+        glAttachShader (id, prog->shaders[i]->id);
+
     /* setting transform feedback up */
     if (prog->fb_enabled) {
-        glTransformFeedbackVaryings (prog->id, prog->n_varyings,
+        glTransformFeedbackVaryings (id, prog->n_varyings,
                                      (const GLchar**)prog->fb_varyings,
                                      modes[prog->fb_mode]);
     }
@@ -254,38 +602,77 @@ int SCE_RBuildProgram (SCE_RProgram *prog)
     j = 0;
     for (i = 0; i < SCE_MAX_ATTACHMENT_BUFFERS; i++) {
         if (*prog->outputs[i])
-            glBindFragDataLocation (prog->id, j++, prog->outputs[i]);
+            glBindFragDataLocation (id, j++, prog->outputs[i]);
     }
 
-    glLinkProgram (prog->id);
+    glLinkProgram (id);
+    stats.links++;
 
-    glGetProgramiv (prog->id, GL_LINK_STATUS, &status);
+    glGetProgramiv (id, GL_LINK_STATUS, &status);
     if (status != GL_TRUE) {
         SCEE_Log (SCE_INVALID_OPERATION);
 
-        glGetProgramiv (prog->id, GL_INFO_LOG_LENGTH, &loginfo_size);
+        glGetProgramiv (id, GL_INFO_LOG_LENGTH, &loginfo_size);
         loginfo = SCE_malloc (loginfo_size + 1);
         if (!loginfo) {
             SCEE_LogSrc ();
-            return SCE_ERROR;
+            goto fail;
         }
         memset (loginfo, '\0', loginfo_size + 1);
-        glGetProgramInfoLog (prog->id, loginfo_size, &loginfo_size, loginfo);
+        glGetProgramInfoLog (id, loginfo_size, &loginfo_size, loginfo);
 
         /* TODO: add program name */
         SCEE_LogMsg ("can't link program, reason: %s", loginfo);
 
         SCE_free (loginfo);
-        return SCE_ERROR;
+        goto fail;
+    }
+
+    if (prog->shared &&
+        !(prog->object = SCE_RAddGLObject (program_objects, key, size, id))) {
+        SCEE_LogSrc ();
+        goto fail;
     }
+    stats.programs++;
+    prog->id = id;
 
+linked:
     prog->linked = SCE_TRUE;
 
     /* if the map was previously built, rebuild it */
     if (prog->map_built)
         SCE_RSetupProgramAttributesMapping (prog);
+    /* the uniform locations belong to the GL program, which is new */
+    if (prog->use_mmap)
+        SCE_RSetupProgramMatricesMapping (prog);
+    /* the program in use had its GL program replaced, bind the new one; the
+       upload thread's context doesn't use programs */
+    if (!SCE_RIsUploadThread () && sce_rprogram == prog)
+        glUseProgram (prog->id);
 
     return SCE_OK;
+fail:
+    glDeleteProgram (id);
+    SCE_free (key);
+    return SCE_ERROR;
+}
+/**
+ * \brief Links a program
+ * \param prog a program whose attached shaders are compiled
+ * \returns SCE_ERROR on error, SCE_OK otherwise
+ *
+ * If \p prog is shared and a shared program with the same shaders,
+ * parameters, feedback varyings and outputs was already linked, its GL
+ * object is used and no link occurs.
+ * \sa SCE_RSetProgramShared(), SCE_RGetShaderStats(), SCE_RSubmitProgram()
+ */
+int SCE_RBuildProgram (SCE_RProgram *prog)
+{
+    int ret;
+    pthread_mutex_lock (&programs_mutex);
+    ret = SCE_RLinkProgram (prog);
+    pthread_mutex_unlock (&programs_mutex);
+    return ret;
 }
 
 int SCE_RValidateProgram (SCE_RProgram *prog)
@@ -405,12 +792,94 @@ static void SCE_RSetProgramModelviewMatrix (void)
                         sce_rmatrices[SCE_MAT_MODELVIEW]);
 }
 
+static void SCE_RSetProgramModelviewProjectionMatrix (void)
+{
+    glUniformMatrix4fv (sce_rmatindex[SCE_MAT_MODELVIEWPROJECTION],
+                        1, SCE_TRUE,
+                        sce_rmatrices[SCE_MAT_MODELVIEWPROJECTION]);
+}
+static void SCE_RGetNormalMatrix3 (SCE_TMatrix3 n)
+{
+    const float *m = sce_rmatrices[SCE_MAT_NORMAL];
+    n[0] = m[0]; n[1] = m[1]; n[2] = m[2];
+    n[3] = m[4]; n[4] = m[5]; n[5] = m[6];
+    n[6] = m[8]; n[7] = m[9]; n[8] = m[10];
+}
+static void SCE_RSetProgramNormalMatrix (void)
+{
+    SCE_TMatrix3 n;
+    SCE_RGetNormalMatrix3 (n);
+    glUniformMatrix3fv (sce_rmatindex[SCE_MAT_NORMAL], 1, SCE_TRUE, n);
+}
+
 static SCE_RSetMatrixFunc sce_setprogrammatrix[SCE_NUM_MATRICES] = {
     SCE_RSetProgramObjectMatrix,
     SCE_RSetProgramCameraMatrix,
     SCE_RSetProgramProjectionMatrix,
     SCE_RSetProgramTextureMatrix,
-    SCE_RSetProgramModelviewMatrix
+    SCE_RSetProgramModelviewMatrix,
+    SCE_RSetProgramModelviewProjectionMatrix,
+    SCE_RSetProgramNormalMatrix
+};
+
+/* pipelines: upload the matrix to every stage program that declares it */
+static void SCE_RSetPipelineMatrix (SCE_RMatrix mat)
+{
+    size_t i;
+    SCE_TMatrix3 n;
+
+    if (mat == SCE_MAT_NORMAL)
+        SCE_RGetNormalMatrix3 (n);
+
+    for (i = 0; i < sce_rpipeline->n_progs; i++) {
+        SCE_RProgram *prog = sce_rpipeline->progs[i];
+        if (!prog->use_mmap || prog->mat_map[mat] == -1)
+            continue;
+        if (mat == SCE_MAT_NORMAL)
+            glProgramUniformMatrix3fv (prog->id, prog->mat_map[mat],
+                                       1, SCE_TRUE, n);
+        else
+            glProgramUniformMatrix4fv (prog->id, prog->mat_map[mat],
+                                       1, SCE_TRUE, sce_rmatrices[mat]);
+    }
+}
+static void SCE_RSetPipelineObjectMatrix (void)
+{
+    SCE_RSetPipelineMatrix (SCE_MAT_OBJECT);
+}
+static void SCE_RSetPipelineCameraMatrix (void)
+{
+    SCE_RSetPipelineMatrix (SCE_MAT_CAMERA);
+}
+static void SCE_RSetPipelineProjectionMatrix (void)
+{
+    SCE_RSetPipelineMatrix (SCE_MAT_PROJECTION);
+}
+static void SCE_RSetPipelineTextureMatrix (void)
+{
+    SCE_RSetPipelineMatrix (SCE_MAT_TEXTURE);
+}
+static void SCE_RSetPipelineModelviewMatrix (void)
+{
+    SCE_RSetPipelineMatrix (SCE_MAT_MODELVIEW);
+}
+static void SCE_RSetPipelineModelviewProjectionMatrix (void)
+{
+    SCE_RSetPipelineMatrix (SCE_MAT_MODELVIEWPROJECTION);
+}
+static void SCE_RSetPipelineNormalMatrix (void)
+{
+    SCE_RSetPipelineMatrix (SCE_MAT_NORMAL);
+}
+
+static SCE_RSetMatrixFunc sce_setpipelinematrix[SCE_NUM_MATRICES] = {
+    SCE_RSetPipelineObjectMatrix,
+    SCE_RSetPipelineCameraMatrix,
+    SCE_RSetPipelineProjectionMatrix,
+    SCE_RSetPipelineTextureMatrix,
+    SCE_RSetPipelineModelviewMatrix,
+    SCE_RSetPipelineModelviewProjectionMatrix,
+    SCE_RSetPipelineNormalMatrix
 };
 
 
@@ -430,6 +899,8 @@ void SCE_RSetupProgramMatricesMapping (SCE_RProgram *prog)
     SCE_RGETMAP (SCE_MAT_PROJECTION);
     SCE_RGETMAP (SCE_MAT_TEXTURE);
     SCE_RGETMAP (SCE_MAT_MODELVIEW);
+    SCE_RGETMAP (SCE_MAT_MODELVIEWPROJECTION);
+    SCE_RGETMAP (SCE_MAT_NORMAL);
 #undef SCE_RGETMAP
 
     for (i = 0; i < SCE_NUM_MATRICES; i++) {
@@ -478,6 +949,12 @@ void SCE_RSetProgramOutputTarget (SCE_RProgram *prog, const char *output,
 void SCE_RUseProgram (SCE_RProgram *prog)
 {
     if (prog) {
+        /* unbound, or the pipeline would come back with glUseProgram (0) */
+        if (sce_rpipeline) {
+            glBindProgramPipeline (0);
+            sce_rpipeline = NULL;
+        }
+        sce_rprogram = prog;
         glUseProgram (prog->id);
 
         /* useless 'if' statements in a full GL3 renderer */
@@ -502,13 +979,275 @@ void SCE_RUseProgram (SCE_RProgram *prog)
             SCE_RUsePrimitives ();
 
     } else {
+        sce_rprogram = NULL;
         SCE_RUsePrimitives ();
         glUseProgram (0);
+        if (sce_rpipeline) {
+            glBindProgramPipeline (0);
+            sce_rpipeline = NULL;
+        }
         /* useless calls in a full GL3 renderer */
         SCE_RDisableVertexAttributesMap ();
         SCE_RMapMatrices (NULL);
     }
 }
+/**
+ * \brief Gets the program given to SCE_RUseProgram() last, NULL if no
+ * program or a pipeline is used
+ */
+SCE_RProgram* SCE_RGetUsedProgram (void)
+{
+    return sce_rprogram;
+}
+
+
+
+static SCEuint SCE_RHashPipelineStages (SCE_RProgram **stages)
+{
+    size_t i;
+    SCEuint h = 0;
+    for (i = 0; i < SCE_NUM_SHADER_TYPES; i++)
+        h = h * 31 + (SCEuint)((size_t)stages[i] >> 4);
+    return h;
+}
+
+static void SCE_RDeleteProgramPipeline (SCE_RProgramPipeline *pipeline)
+{
+    /* the matrices are mapped to the functions of the pipeline */
+    if (sce_rpipeline == pipeline)
+        SCE_RUseProgramPipeline (NULL);
+    glDeleteProgramPipelines (1, &pipeline->id);
+    SCE_free (pipeline);
+}
+
+static SCE_RProgramPipeline*
+SCE_RCreateProgramPipeline (SCE_RProgram **stages, SCEuint hash)
+{
+    SCE_RProgramPipeline *pipeline = NULL;
+    size_t i, j;
+    int status = GL_TRUE;
+
+    if (!(pipeline = SCE_malloc (sizeof *pipeline))) {
+        SCEE_LogSrc ();
+        return NULL;
+    }
+    glGenProgramPipelines (1, &pipeline->id);
+    pipeline->n_progs = 0;
+    pipeline->hash = hash;
+    pipeline->next = NULL;
+    for (i = 0; i < SCE_NUM_SHADER_TYPES; i++) {
+        pipeline->stages[i] = stages[i];
+        pipeline->progs[i] = NULL;
+    }
+
+    /* one glUseProgramStages() per distinct program */
+    for (i = 0; i < SCE_NUM_SHADER_TYPES; i++) {
+        SCEbitfield bits = 0;
+        if (!stages[i])
+            continue;
+        for (j = 0; j < pipeline->n_progs; j++) {
+            if (pipeline->progs[j] == stages[i])
+                break;
+        }
+        if (j < pipeline->n_progs)
+            continue;
+        pipeline->progs[pipeline->n_progs++] = stages[i];
+        for (j = i; j < SCE_NUM_SHADER_TYPES; j++) {
+            if (stages[j] == stages[i])
+                bits |= sce_glstagebit[j];
+        }
+        glUseProgramStages (pipeline->id, bits, stages[i]->id);
+    }
+
+    glValidateProgramPipeline (pipeline->id);
+    glGetProgramPipelineiv (pipeline->id, GL_VALIDATE_STATUS, &status);
+    if (status != GL_TRUE) {
+        int loginfo_size = 0;
+        char *loginfo = NULL;
+
+        SCEE_Log (SCE_INVALID_OPERATION);
+        glGetProgramPipelineiv (pipeline->id, GL_INFO_LOG_LENGTH,
+                                &loginfo_size);
+        if ((loginfo = SCE_malloc (loginfo_size + 1))) {
+            memset (loginfo, '\0', loginfo_size + 1);
+            glGetProgramPipelineInfoLog (pipeline->id, loginfo_size,
+                                         &loginfo_size, loginfo);
+            SCEE_LogMsg ("can't validate program pipeline, reason: %s",
+                         loginfo);
+            SCE_free (loginfo);
+        }
+        SCE_RDeleteProgramPipeline (pipeline);
+        return NULL;
+    }
+
+    return pipeline;
+}
+
+/**
+ * \brief Gets the pipeline combining the given separable programs
+ * \param progs linked separable programs
+ * \param n number of programs
+ * \returns the pipeline, NULL on error
+ *
+ * Each program is bound to the stages of the shaders attached to it. Pipelines
+ * are cached by stage tuple: asking twice for the same combination returns
+ * the same pipeline, and assembling a new one requires no link. A pipeline
+ * is released when one of its programs is deleted or linked again.
+ * \sa SCE_RSetProgramSeparable(), SCE_RUseProgramPipeline()
+ */
+SCE_RProgramPipeline* SCE_RGetProgramPipeline (SCE_RProgram **progs, size_t n)
+{
+    SCE_RProgram *stages[SCE_NUM_SHADER_TYPES];
+    SCE_RProgramPipeline *pipeline = NULL;
+    SCEuint h;
+    size_t i, j;
+
+    if (!SCE_RHasCap (SCE_SEPARATE_SHADERS)) {
+        SCEE_Log (SCE_INVALID_OPERATION);
+        SCEE_LogMsg ("separable programs are not supported");
+        return NULL;
+    }
+
+    for (i = 0; i < SCE_NUM_SHADER_TYPES; i++)
+        stages[i] = NULL;
+    for (i = 0; i < n; i++) {
+        if (!progs[i]->separable || !progs[i]->linked) {
+            SCEE_Log (SCE_INVALID_ARG);
+            SCEE_LogMsg ("pipeline stages must be linked separable programs");
+            return NULL;
+        }
+        for (j = 0; j < SCE_NUM_SHADER_TYPES; j++) {
+            if (!(progs[i]->stages & (1 << j)))
+                continue;
+            if (stages[j]) {
+                SCEE_Log (SCE_INVALID_ARG);
+                SCEE_LogMsg ("%s stage is provided by two programs",
+                             sce_typename[j]);
+                return NULL;
+            }
+            stages[j] = progs[i];
+        }
+    }
+
+    h = SCE_RHashPipelineStages (stages);
+    pipeline = pipelines[h % SCE_PIPELINE_CACHE_SIZE];
+    while (pipeline) {
+        if (pipeline->hash == h &&
+            !memcmp (pipeline->stages, stages, sizeof stages))
+            return pipeline;
+        pipeline = pipeline->next;
+    }
+
+    if (!(pipeline = SCE_RCreateProgramPipeline (stages, h))) {
+        SCEE_LogSrc ();
+        return NULL;
+    }
+    pipeline->next = pipelines[h % SCE_PIPELINE_CACHE_SIZE];
+    pipelines[h % SCE_PIPELINE_CACHE_SIZE] = pipeline;
+    return pipeline;
+}
+
+/**
+ * \internal
+ * \brief Removes from the cache the pipelines that use a program
+ *
+ * Called when \p prog is deleted or relinked, a bound pipeline is unbound.
+ */
+void SCE_RDropProgramPipelines (SCE_RProgram *prog)
+{
+    size_t i, j;
+    for (i = 0; i < SCE_PIPELINE_CACHE_SIZE; i++) {
+        SCE_RProgramPipeline **p = &pipelines[i];
+        while (*p) {
+            SCE_RProgramPipeline *pipeline = *p;
+            for (j = 0; j < pipeline->n_progs; j++) {
+                if (pipeline->progs[j] == prog)
+                    break;
+            }
+            if (j < pipeline->n_progs) {
+                *p = pipeline->next;
+                SCE_RDeleteProgramPipeline (pipeline);
+            } else
+                p = &pipeline->next;
+        }
+    }
+}
+
+/**
+ * \brief Deletes all the cached pipelines
+ */
+void SCE_RFlushProgramPipelines (void)
+{
+    size_t i;
+    for (i = 0; i < SCE_PIPELINE_CACHE_SIZE; i++) {
+        while (pipelines[i]) {
+            SCE_RProgramPipeline *pipeline = pipelines[i];
+            pipelines[i] = pipeline->next;
+            SCE_RDeleteProgramPipeline (pipeline);
+        }
+    }
+}
+
+/**
+ * \brief Binds a program pipeline, the pipeline equivalent of
+ * SCE_RUseProgram()
+ * \param pipeline a pipeline, NULL unbinds
+ *
+ * The vertex attributes mapping of the vertex stage program is used, and
+ * matrices are uploaded to each stage program that has its matrices mapping
+ * activated.
+ */
+void SCE_RUseProgramPipeline (SCE_RProgramPipeline *pipeline)
+{
+    SCE_RProgram *vs = NULL, *tess = NULL;
+    size_t i, j;
+
+    if (!pipeline) {
+        SCE_RUseProgram (NULL);
+        return;
+    }
+
+    /* a current program would override the pipeline */
+    sce_rprogram = NULL;
+    glUseProgram (0);
+    glBindProgramPipeline (pipeline->id);
+    sce_rpipeline = pipeline;
+
+    vs = pipeline->stages[SCE_VERTEX_SHADER];
+    if (vs && vs->use_vmap)
+        SCE_RUseVertexAttributesMap (vs->map);
+    else
+        SCE_RDisableVertexAttributesMap ();
+
+    for (i = 0; i < SCE_NUM_MATRICES; i++) {
+        pipeline->funs[i] = SCE_RSetProgramNoneMatrix;
+        for (j = 0; j < pipeline->n_progs; j++) {
+            if (pipeline->progs[j]->use_mmap &&
+                pipeline->progs[j]->mat_map[i] != -1) {
+                pipeline->funs[i] = sce_setpipelinematrix[i];
+                break;
+            }
+        }
+    }
+    SCE_RMapMatrices (pipeline->funs);
+
+    tess = pipeline->stages[SCE_TESS_CONTROL_SHADER];
+    if (!tess)
+        tess = pipeline->stages[SCE_TESS_EVALUATION_SHADER];
+    if (tess) {
+        glPatchParameteri (GL_PATCH_VERTICES, tess->patch_vertices);
+        SCE_RUsePatches ();
+    } else
+        SCE_RUsePrimitives ();
+}
+/**
+ * \brief Gets the pipeline bound by SCE_RUseProgramPipeline(), NULL if no
+ * pipeline is bound
+ */
+SCE_RProgramPipeline* SCE_RGetUsedProgramPipeline (void)
+{
+    return sce_rpipeline;
+}
 
 
 #if 0
@@ -542,7 +1281,7 @@ int SCE_RSetProgramInputPrimitive (SCE_RProgram *prog,
     SCEenum p = sce_rprimtypes[prim];
     if (adj)
         p = SCE_RAdjacentPrim (p);
-    glProgramParameteri (prog->id, GL_GEOMETRY_INPUT_TYPE_EXT, p);
+    prog->prim_in = p;
     if (prog->linked) {
         /* automatic relink if the shader was already linked */
         prog->linked = SCE_FALSE;
@@ -560,8 +1299,7 @@ int SCE_RSetProgramInputPrimitive (SCE_RProgram *prog,
 int SCE_RSetProgramOutputPrimitive (SCE_RProgram *prog,
                                     SCE_EPrimitiveType prim)
 {
-    SCEenum p = sce_rprimtypes[prim];
-    glProgramParameteri (prog->id, GL_GEOMETRY_OUTPUT_TYPE_EXT, p);
+    prog->prim_out = sce_rprimtypes[prim];
     if (prog->linked) {
         /* automatic relink if the shader was already linked */
         prog->linked = SCE_FALSE;
@@ -0,0 +1,735 @@
+/*------------------------------------------------------------------------------
+    SCEngine - A 3D real time rendering engine written in the C language
+    Copyright (C) 2006-2013  Antony Martin <martin(dot)antony(at)yahoo(dot)fr>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/* created: 19/10/2026
+   updated: 19/10/2026 */
+
+#include <string.h>
+#include <stdio.h>
+#include <SCE/utils/SCEUtils.h>
+#include "SCE/renderer/SCERenderer.h"
+#include "SCE/renderer/SCERShaderVariant.h"
+
+/**
+ * \file SCERShaderVariant.c
+ * \copydoc shadervariant
+ *
+ * \file SCERShaderVariant.h
+ * \copydoc shadervariant
+ */
+
+/**
+ * \defgroup shadervariant Shader variants
+ * \ingroup renderer-gl
+ * \brief Shader preprocessing and feature permutations
+ *
+ * A shader variants set holds the sources of each stage of a program and a
+ * list of feature keys. Requesting the program of a feature mask resolves
+ * the \#include directives of the sources, defines the keys of the enabled
+ * features right after the \#version directive, then compiles and links the
+ * result. Stages only get the keys they use, and SCE_RBuildShaderGLSL()
+ * shares the GL shaders built from the same source: two variants producing
+ * the same stage source compile it once.
+ * @{
+ */
+
+typedef struct sce_rshaderinclude SCE_RShaderInclude;
+struct sce_rshaderinclude {
+    char *name;
+    char *source;
+    SCE_RShaderInclude *next;
+};
+
+/* growing string used to build the resolved sources */
+typedef struct {
+    char *str;
+    size_t len;
+    size_t size;
+} SCE_RShaderText;
+
+static SCE_RShaderInclude *includes = NULL;
+
+
+int SCE_RShaderVariantInit (void)
+{
+    includes = NULL;
+    return SCE_OK;
+}
+void SCE_RShaderVariantQuit (void)
+{
+    SCE_RClearShaderIncludes ();
+}
+
+
+static void SCE_RInitShaderText (SCE_RShaderText *t)
+{
+    t->str = NULL;
+    t->len = t->size = 0;
+}
+static int SCE_RAppendShaderText (SCE_RShaderText *t, const char *s, size_t n)
+{
+    if (t->len + n + 1 > t->size) {
+        size_t size = t->size ? t->size : 256;
+        char *p = NULL;
+        while (t->len + n + 1 > size)
+            size *= 2;
+        if (!(p = SCE_realloc (t->str, size))) {
+            SCEE_LogSrc ();
+            return SCE_ERROR;
+        }
+        t->str = p;
+        t->size = size;
+    }
+    memcpy (&t->str[t->len], s, n);
+    t->len += n;
+    t->str[t->len] = 0;
+    return SCE_OK;
+}
+static int SCE_RAppendShaderLine (SCE_RShaderText *t, const char *fmt,
+                                  const char *s, int n)
+{
+    char buf[256];
+    int len;
+    if (s)
+        len = snprintf (buf, sizeof buf, fmt, s);
+    else
+        len = snprintf (buf, sizeof buf, fmt, n);
+    if (len < 0 || len >= (int)sizeof buf) {
+        SCEE_Log (SCE_INVALID_ARG);
+        SCEE_LogMsg ("shader directive too long");
+        return SCE_ERROR;
+    }
+    return SCE_RAppendShaderText (t, buf, len);
+}
+
+
+static SCE_RShaderInclude* SCE_RLocateShaderInclude (const char *name,
+                                                     size_t len)
+{
+    SCE_RShaderInclude *inc = includes;
+    while (inc) {
+        if (strlen (inc->name) == len && !strncmp (inc->name, name, len))
+            return inc;
+        inc = inc->next;
+    }
+    return NULL;
+}
+
+/**
+ * \brief Registers a source that shaders can include
+ * \param name name used in the \#include directive
+ * \param source GLSL code, copied
+ * \returns SCE_ERROR on error, SCE_OK otherwise
+ *
+ * A directive \#include "name" (or \#include <name>) found in a source given
+ * to SCE_RPreprocessShaderSource() is replaced by \p source. Registering an
+ * already known name replaces its source.
+ * \sa SCE_RRemoveShaderInclude(), SCE_RClearShaderIncludes()
+ */
+int SCE_RAddShaderInclude (const char *name, const char *source)
+{
+    SCE_RShaderInclude *inc = NULL;
+    char *src = NULL;
+
+    if (!(src = SCE_String_Dup (source)))
+        goto fail;
+    if ((inc = SCE_RLocateShaderInclude (name, strlen (name)))) {
+        SCE_free (inc->source);
+        inc->source = src;
+        return SCE_OK;
+    }
+    if (!(inc = SCE_malloc (sizeof *inc)))
+        goto fail;
+    if (!(inc->name = SCE_String_Dup (name))) {
+        SCE_free (inc);
+        goto fail;
+    }
+    inc->source = src;
+    inc->next = includes;
+    includes = inc;
+    return SCE_OK;
+fail:
+    SCE_free (src);
+    SCEE_LogSrc ();
+    return SCE_ERROR;
+}
+/**
+ * \brief Unregisters an include source
+ * \sa SCE_RAddShaderInclude()
+ */
+void SCE_RRemoveShaderInclude (const char *name)
+{
+    SCE_RShaderInclude **p = &includes;
+    while (*p) {
+        SCE_RShaderInclude *inc = *p;
+        if (!strcmp (inc->name, name)) {
+            *p = inc->next;
+            SCE_free (inc->name);
+            SCE_free (inc->source);
+            SCE_free (inc);
+            return;
+        }
+        p = &inc->next;
+    }
+}
+/**
+ * \brief Unregisters all the include sources
+ * \sa SCE_RAddShaderInclude()
+ */
+void SCE_RClearShaderIncludes (void)
+{
+    while (includes) {
+        SCE_RShaderInclude *inc = includes;
+        includes = inc->next;
+        SCE_free (inc->name);
+        SCE_free (inc->source);
+        SCE_free (inc);
+    }
+}
+
+
+/* returns the name of an include directive or NULL if line isn't one */
+static const char* SCE_RParseInclude (const char *line, const char *end,
+                                      size_t *len)
+{
+    const char *p = line, *name = NULL;
+    char close;
+
+    while (p < end && (*p == ' ' || *p == '\t'))
+        p++;
+    if (p == end || *p++ != '#')
+        return NULL;
+    while (p < end && (*p == ' ' || *p == '\t'))
+        p++;
+    if (end - p < 7 || strncmp (p, "include", 7))
+        return NULL;
+    p += 7;
+    while (p < end && (*p == ' ' || *p == '\t'))
+        p++;
+    if (p == end || (*p != '"' && *p != '<'))
+        return NULL;
+    close = (*p == '"' ? '"' : '>');
+    name = ++p;
+    while (p < end && *p != close)
+        p++;
+    if (p == end)
+        return NULL;
+    *len = p - name;
+    return name;
+}
+
+static int SCE_RExpandShaderSource (SCE_RShaderText *out, const char *src,
+                                    int depth)
+{
+    const char *line = src;
+    int n_line = 1;
+
+    if (depth > SCE_MAX_SHADER_INCLUDE_DEPTH) {
+        SCEE_Log (SCE_INVALID_OPERATION);
+        SCEE_LogMsg ("shader includes nested too deep, recursive include?");
+        return SCE_ERROR;
+    }
+
+    while (*line) {
+        const char *end = strchr (line, '\n');
+        const char *name = NULL;
+        size_t len = 0;
+
+        if (!end)
+            end = line + strlen (line);
+
+        if ((name = SCE_RParseInclude (line, end, &len))) {
+            SCE_RShaderInclude *inc = NULL;
+            if (!(inc = SCE_RLocateShaderInclude (name, len))) {
+                SCEE_Log (SCE_INVALID_ARG);
+                SCEE_LogMsg ("unknown shader include '%.*s'", (int)len, name);
+                return SCE_ERROR;
+            }
+            if (SCE_RExpandShaderSource (out, inc->source, depth + 1) < 0 ||
+                SCE_RAppendShaderText (out, "\n", 1) < 0 ||
+                SCE_RAppendShaderLine (out, "#line %d\n", NULL,
+                                       n_line + 1) < 0)
+                goto fail;
+        } else if (SCE_RAppendShaderText (out, line, end - line) < 0 ||
+                   (*end && SCE_RAppendShaderText (out, "\n", 1) < 0))
+            goto fail;
+
+        line = (*end ? end + 1 : end);
+        n_line++;
+    }
+    return SCE_OK;
+fail:
+    SCEE_LogSrc ();
+    return SCE_ERROR;
+}
+
+/* TRUE if the identifier key appears in src */
+static int SCE_RIsShaderKeyUsed (const char *src, const char *key)
+{
+    size_t len = strlen (key);
+    const char *p = src;
+#define SCE_ISIDENT(c) ((c) == '_' || ((c) >= 'a' && (c) <= 'z') ||  \
+                        ((c) >= 'A' && (c) <= 'Z') || ((c) >= '0' && (c) <= '9'))
+    while ((p = strstr (p, key))) {
+        if ((p == src || !SCE_ISIDENT (p[-1])) && !SCE_ISIDENT (p[len]))
+            return SCE_TRUE;
+        p += len;
+    }
+#undef SCE_ISIDENT
+    return SCE_FALSE;
+}
+
+/* returns the line following the #version directive of src, NULL if there
+   is none; comments and blank lines may precede the directive */
+static const char* SCE_RFindShaderVersion (const char *src, int *n_line)
+{
+    const char *line = src;
+    int comment = SCE_FALSE;    /* in a block comment? */
+
+    *n_line = 1;
+    while (*line) {
+        const char *end = strchr (line, '\n');
+        const char *p = line;
+        if (!end)
+            end = line + strlen (line);
+        (*n_line)++;
+        if (!comment) {
+            while (p < end && (*p == ' ' || *p == '\t' || *p == '\r'))
+                p++;
+            if (p < end && *p == '#') {
+                p++;
+                while (p < end && (*p == ' ' || *p == '\t'))
+                    p++;
+                if (end - p >= 7 && !strncmp (p, "version", 7))
+                    return end;
+                /* no #version once another directive is found */
+                return NULL;
+            }
+        }
+        for (; p < end; p++) {
+            if (comment) {
+                if (p[0] == '*' && p + 1 < end && p[1] == '/')
+                    comment = SCE_FALSE, p++;
+            } else if (p[0] == '/' && p + 1 < end) {
+                if (p[1] == '/')
+                    break;
+                if (p[1] == '*')
+                    comment = SCE_TRUE, p++;
+            } else if (*p != ' ' && *p != '\t' && *p != '\r')
+                return NULL;    /* code, the directive can't follow */
+        }
+        line = (*end ? end + 1 : end);
+    }
+    return NULL;
+}
+
+/* defines are written right after the #version directive if any, since
+   GLSL requires it to be the first statement */
+static char* SCE_RInjectShaderDefines (const char *body, const char **defines,
+                                       size_t n_defines, int only_used)
+{
+    SCE_RShaderText out;
+    const char *rest = body, *end = NULL;
+    size_t i;
+    int n_line = 1;
+
+    SCE_RInitShaderText (&out);
+
+    if ((end = SCE_RFindShaderVersion (body, &n_line))) {
+        rest = (*end ? end + 1 : end);
+        if (SCE_RAppendShaderText (&out, body, rest - body) < 0)
+            goto fail;
+        if (!*end && SCE_RAppendShaderText (&out, "\n", 1) < 0)
+            goto fail;
+    } else
+        n_line = 1;
+
+    for (i = 0; i < n_defines; i++) {
+        const char *fmt = (strchr (defines[i], ' ') ?
+                           "#define %s\n" : "#define %s 1\n");
+        if (only_used && !SCE_RIsShaderKeyUsed (rest, defines[i]))
+            continue;
+        if (SCE_RAppendShaderLine (&out, fmt, defines[i], 0) < 0)
+            goto fail;
+    }
+    if (SCE_RAppendShaderLine (&out, "#line %d\n", NULL, n_line) < 0 ||
+        SCE_RAppendShaderText (&out, rest, strlen (rest)) < 0)
+        goto fail;
+
+    return out.str;
+fail:
+    SCE_free (out.str);
+    SCEE_LogSrc ();
+    return NULL;
+}
+
+/**
+ * \brief Resolves the includes of a shader source and adds macro definitions
+ * \param src GLSL source
+ * \param defines macro definitions, either "NAME" (defined as 1) or
+ * "NAME VALUE", can be NULL if \p n_defines is 0
+ * \param n_defines number of definitions
+ * \returns a newly allocated source or NULL on error
+ *
+ * The definitions are inserted right after the \#version directive of \p src,
+ * followed by a \#line directive so that compilation error messages keep
+ * referring to the lines of \p src.
+ * \sa SCE_RAddShaderInclude()
+ */
+char* SCE_RPreprocessShaderSource (const char *src, const char **defines,
+                                   size_t n_defines)
+{
+    SCE_RShaderText body;
+    char *final = NULL;
+
+    SCE_RInitShaderText (&body);
+    if (SCE_RExpandShaderSource (&body, src, 0) < 0)
+        goto fail;
+    if (!body.str && SCE_RAppendShaderText (&body, "", 0) < 0)
+        goto fail;
+    if (!(final = SCE_RInjectShaderDefines (body.str, defines, n_defines,
+                                            SCE_FALSE)))
+        goto fail;
+    SCE_free (body.str);
+    return final;
+fail:
+    SCE_free (body.str);
+    SCEE_LogSrc ();
+    return NULL;
+}
+
+
+void SCE_RInitShaderVariants (SCE_RShaderVariants *vars)
+{
+    size_t i;
+    for (i = 0; i < SCE_NUM_SHADER_TYPES; i++)
+        vars->sources[i] = NULL;
+    for (i = 0; i < SCE_MAX_SHADER_FEATURES; i++)
+        vars->keys[i] = NULL;
+    vars->n_keys = 0;
+    vars->variants = NULL;
+    vars->n_variants = vars->size = 0;
+    vars->attrib_mapping = SCE_FALSE;
+    vars->matrices_mapping = SCE_FALSE;
+    vars->setup = NULL;
+    vars->udata = NULL;
+}
+void SCE_RClearShaderVariants (SCE_RShaderVariants *vars)
+{
+    size_t i;
+    SCE_RFlushShaderVariants (vars);
+    SCE_free (vars->variants);
+    for (i = 0; i < SCE_NUM_SHADER_TYPES; i++)
+        SCE_free (vars->sources[i]);
+    for (i = 0; i < vars->n_keys; i++)
+        SCE_free (vars->keys[i]);
+}
+SCE_RShaderVariants* SCE_RCreateShaderVariants (void)
+{
+    SCE_RShaderVariants *vars = NULL;
+    if (!(vars = SCE_malloc (sizeof *vars)))
+        SCEE_LogSrc ();
+    else
+        SCE_RInitShaderVariants (vars);
+    return vars;
+}
+void SCE_RDeleteShaderVariants (SCE_RShaderVariants *vars)
+{
+    if (vars) {
+        SCE_RClearShaderVariants (vars);
+        SCE_free (vars);
+    }
+}
+
+/**
+ * \brief Sets the source of one stage of a variants set
+ * \param vars a variants set
+ * \param type stage
+ * \param src unprocessed source (may contain \#include directives), copied,
+ * NULL removes the stage
+ * \returns SCE_ERROR on error, SCE_OK otherwise
+ *
+ * Already built variants are deleted.
+ */
+int SCE_RSetShaderVariantsSource (SCE_RShaderVariants *vars,
+                                  SCE_RShaderType type, const char *src)
+{
+    char *s = NULL;
+    if (src && !(s = SCE_String_Dup (src))) {
+        SCEE_LogSrc ();
+        return SCE_ERROR;
+    }
+    SCE_RFlushShaderVariants (vars);
+    SCE_free (vars->sources[type]);
+    vars->sources[type] = s;
+    return SCE_OK;
+}
+
+/**
+ * \brief Adds a feature key to a variants set
+ * \param vars a variants set
+ * \param key name of the macro defined when the feature is enabled
+ * \returns the mask bit of the feature, 0 on error
+ * \sa SCE_RGetShaderVariantsFeature(), SCE_RGetShaderVariant()
+ */
+SCEbitfield SCE_RAddShaderVariantsFeature (SCE_RShaderVariants *vars,
+                                          const char *key)
+{
+    SCEbitfield bit;
+    if ((bit = SCE_RGetShaderVariantsFeature (vars, key)))
+        return bit;
+    if (vars->n_keys >= SCE_MAX_SHADER_FEATURES) {
+        SCEE_Log (SCE_INVALID_OPERATION);
+        SCEE_LogMsg ("too many shader features, maximum is %d",
+                     SCE_MAX_SHADER_FEATURES);
+        return 0;
+    }
+    if (!(vars->keys[vars->n_keys] = SCE_String_Dup (key))) {
+        SCEE_LogSrc ();
+        return 0;
+    }
+    vars->n_keys++;
+    return 1u << (vars->n_keys - 1);
+}
+/**
+ * \brief Gets the mask bit of a feature key
+ * \returns the mask bit of \p key, 0 if \p key isn't a feature of \p vars
+ */
+SCEbitfield SCE_RGetShaderVariantsFeature (const SCE_RShaderVariants *vars,
+                                           const char *key)
+{
+    size_t i;
+    for (i = 0; i < vars->n_keys; i++) {
+        if (!strcmp (vars->keys[i], key))
+            return 1u << i;
+    }
+    return 0;
+}
+
+/**
+ * \brief Defines which mappings are set up on the variant programs
+ * \param vars a variants set
+ * \param attribs setup and activate vertex attributes mapping
+ * \param matrices setup and activate matrices mapping
+ * \sa SCE_RSetupProgramAttributesMapping(), SCE_RSetupProgramMatricesMapping()
+ */
+void SCE_RSetShaderVariantsMapping (SCE_RShaderVariants *vars, int attribs,
+                                    int matrices)
+{
+    vars->attrib_mapping = attribs;
+    vars->matrices_mapping = matrices;
+}
+/**
+ * \brief Sets a function called on each new variant program before its link
+ *
+ * Useful to set feedback varyings, output targets or primitive types.
+ */
+void SCE_RSetShaderVariantsSetupFunc (SCE_RShaderVariants *vars,
+                                      SCE_FShaderVariantSetup setup,
+                                      void *udata)
+{
+    vars->setup = setup;
+    vars->udata = udata;
+}
+
+
+static SCEuint SCE_RHashVariantMask (SCEbitfield mask)
+{
+    return mask * 2654435761u;
+}
+
+static SCE_RShaderVariant*
+SCE_RLocateShaderVariant (SCE_RShaderVariant *variants, size_t size,
+                          SCEbitfield mask)
+{
+    size_t i = SCE_RHashVariantMask (mask) & (size - 1);
+    while (variants[i].prog && variants[i].mask != mask)
+        i = (i + 1) & (size - 1);
+    return &variants[i];
+}
+
+static int SCE_RGrowShaderVariants (SCE_RShaderVariants *vars)
+{
+    size_t i, size = vars->size ? vars->size * 2 : 16;
+    SCE_RShaderVariant *v = NULL;
+
+    if (!(v = SCE_malloc (size * sizeof *v))) {
+        SCEE_LogSrc ();
+        return SCE_ERROR;
+    }
+    for (i = 0; i < size; i++)
+        v[i].prog = NULL;
+    for (i = 0; i < vars->size; i++) {
+        if (vars->variants[i].prog)
+            *SCE_RLocateShaderVariant (v, size, vars->variants[i].mask) =
+                vars->variants[i];
+    }
+    SCE_free (vars->variants);
+    vars->variants = v;
+    vars->size = size;
+    return SCE_OK;
+}
+
+/* deletes the program and the shaders of a variant */
+static void SCE_RClearShaderVariant (SCE_RShaderVariant *v)
+{
+    size_t i;
+    SCE_RDeleteProgram (v->prog);
+    v->prog = NULL;
+    for (i = 0; i < SCE_NUM_SHADER_TYPES; i++) {
+        SCE_RDeleteShaderGLSL (v->shaders[i]);
+        SCE_free (v->sources[i]);
+        v->shaders[i] = NULL;
+        v->sources[i] = NULL;
+    }
+}
+
+static int SCE_RBuildShaderVariant (SCE_RShaderVariants *vars,
+                                    SCE_RShaderVariant *v, SCEbitfield mask)
+{
+    const char *defines[SCE_MAX_SHADER_FEATURES];
+    size_t i, n_defines = 0;
+    SCE_RShaderText body;
+
+    SCE_RInitShaderText (&body);
+    for (i = 0; i < SCE_NUM_SHADER_TYPES; i++) {
+        v->shaders[i] = NULL;
+        v->sources[i] = NULL;
+    }
+
+    for (i = 0; i < vars->n_keys; i++) {
+        if (mask & (1u << i))
+            defines[n_defines++] = vars->keys[i];
+    }
+
+    if (!(v->prog = SCE_RCreateProgram ()))
+        goto fail;
+
+    for (i = 0; i < SCE_NUM_SHADER_TYPES; i++) {
+        if (!vars->sources[i])
+            continue;
+        body.len = 0;
+        if (SCE_RExpandShaderSource (&body, vars->sources[i], 0) < 0)
+            goto fail;
+        /* only define the keys a stage uses: stages that don't depend on a
+           feature get the same source and share their GL shader */
+        if (!(v->sources[i] = SCE_RInjectShaderDefines (body.str, defines,
+                                                        n_defines, SCE_TRUE)))
+            goto fail;
+        if (!(v->shaders[i] = SCE_RCreateShaderGLSL (i)))
+            goto fail;
+        SCE_RSetShaderGLSLSource (v->shaders[i], v->sources[i]);
+        if (SCE_RBuildShaderGLSL (v->shaders[i]) < 0)
+            goto fail;
+        SCE_RSetProgramShader (v->prog, v->shaders[i], SCE_TRUE);
+    }
+
+    if (vars->setup)
+        vars->setup (v->prog, mask, vars->udata);
+    if (SCE_RBuildProgram (v->prog) < 0)
+        goto fail;
+    if (vars->attrib_mapping) {
+        SCE_RSetupProgramAttributesMapping (v->prog);
+        SCE_RActivateProgramAttributesMapping (v->prog, SCE_TRUE);
+    }
+    if (vars->matrices_mapping) {
+        SCE_RSetupProgramMatricesMapping (v->prog);
+        SCE_RActivateProgramMatricesMapping (v->prog, SCE_TRUE);
+    }
+
+    SCE_free (body.str);
+    v->mask = mask;
+    return SCE_OK;
+fail:
+    SCE_free (body.str);
+    SCE_RClearShaderVariant (v);
+    SCEE_LogSrc ();
+    SCEE_LogSrcMsg ("failed to build shader variant 0x%x", mask);
+    return SCE_ERROR;
+}
+
+/**
+ * \brief Gets the program of a feature combination, building it if needed
+ * \param vars a variants set
+ * \param mask enabled features, bits as returned by
+ * SCE_RAddShaderVariantsFeature()
+ * \returns a linked program owned by \p vars, NULL on error
+ * \sa SCE_RPrecompileShaderVariants()
+ */
+SCE_RProgram* SCE_RGetShaderVariant (SCE_RShaderVariants *vars,
+                                     SCEbitfield mask)
+{
+    SCE_RShaderVariant *v = NULL;
+
+    if (vars->n_keys < SCE_MAX_SHADER_FEATURES)
+        mask &= (1u << vars->n_keys) - 1;
+
+    if (vars->size) {
+        v = SCE_RLocateShaderVariant (vars->variants, vars->size, mask);
+        if (v->prog)
+            return v->prog;
+    }
+
+    /* keep the table at most half full */
+    if ((vars->n_variants + 1) * 2 > vars->size) {
+        if (SCE_RGrowShaderVariants (vars) < 0)
+            goto fail;
+    }
+    v = SCE_RLocateShaderVariant (vars->variants, vars->size, mask);
+    if (SCE_RBuildShaderVariant (vars, v, mask) < 0)
+        goto fail;
+    vars->n_variants++;
+    return v->prog;
+fail:
+    SCEE_LogSrc ();
+    return NULL;
+}
+
+/**
+ * \brief Builds a list of variants at once, typically at startup
+ * \param vars a variants set
+ * \param masks feature combinations to build
+ * \param n number of masks
+ * \returns SCE_ERROR if one of the variants failed to build, SCE_OK otherwise
+ */
+int SCE_RPrecompileShaderVariants (SCE_RShaderVariants *vars,
+                                   const SCEbitfield *masks, size_t n)
+{
+    size_t i;
+    int ret = SCE_OK;
+    for (i = 0; i < n; i++) {
+        if (!SCE_RGetShaderVariant (vars, masks[i]))
+            ret = SCE_ERROR;
+    }
+    return ret;
+}
+
+/**
+ * \brief Deletes all the built variant programs of a variants set
+ */
+void SCE_RFlushShaderVariants (SCE_RShaderVariants *vars)
+{
+    size_t i;
+    for (i = 0; i < vars->size; i++) {
+        if (vars->variants[i].prog)
+            SCE_RClearShaderVariant (&vars->variants[i]);
+    }
+    vars->n_variants = 0;
+}
+
+/** @} */
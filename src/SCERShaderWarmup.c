@@ -0,0 +1,478 @@
+/*------------------------------------------------------------------------------
+    SCEngine - A 3D real time rendering engine written in the C language
+    Copyright (C) 2006-2013  Antony Martin <martin(dot)antony(at)yahoo(dot)fr>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/* created: 19/10/2026
+   updated: 19/10/2026 */
+
+#include <string.h>
+#include <stdio.h>
+#include <time.h>
+#include <SCE/utils/SCEUtils.h>
+#include "SCE/renderer/SCERenderer.h"
+#include "SCE/renderer/SCERShaderWarmup.h"
+
+/**
+ * \file SCERShaderWarmup.c
+ * \copydoc shaderwarmup
+ *
+ * \file SCERShaderWarmup.h
+ * \copydoc shaderwarmup
+ */
+
+/**
+ * \defgroup shaderwarmup Shader warm-up
+ * \ingroup renderer-gl
+ * \brief Draws each program once with its state combinations while loading
+ *
+ * Many drivers finish compiling a program the first time it is drawn with a
+ * given state, which causes a hitch the first time an effect shows up. A
+ * warm-up list holds the state combinations the programs are drawn with.
+ * SCE_RRunShaderWarmup() draws a single triangle for each of them into a 1x1
+ * framebuffer, processing as many entries as fit in a time budget so that it
+ * can be spread across loading frames.
+ * @{
+ */
+
+/* a cached 1x1 target */
+typedef struct {
+    SCE_EPixelFormat color, depth;
+    SCE_RFramebuffer *fb;
+    SCE_SListIterator it;
+} SCE_RWarmupTarget;
+
+
+static unsigned long SCE_RGetWarmupTime (void)
+{
+    struct timespec t;
+    clock_gettime (CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1000000ul + t.tv_nsec / 1000;
+}
+
+
+/**
+ * \brief Initializes a state: no names, RGBA color, 24 bits depth,
+ * no blending
+ */
+void SCE_RInitShaderWarmupState (SCE_RShaderWarmupState *state)
+{
+    /* zeroed: states are compared with memcmp() */
+    memset (state, 0, sizeof *state);
+    state->color = SCE_PXF_RGBA;
+    state->depth = SCE_PXF_DEPTH24;
+    state->blending = SCE_FALSE;
+    state->src = GL_ONE;
+    state->dst = GL_ZERO;
+}
+/**
+ * \brief Sets the program and vertex layout names of a state
+ *
+ * Names may not contain white spaces, they are truncated to
+ * SCE_WARMUP_NAME_LENGTH - 1 characters.
+ */
+void SCE_RSetShaderWarmupStateNames (SCE_RShaderWarmupState *state,
+                                     const char *prog, const char *layout)
+{
+    memset (state->prog, 0, sizeof state->prog);
+    memset (state->layout, 0, sizeof state->layout);
+    strncpy (state->prog, prog, SCE_WARMUP_NAME_LENGTH - 1);
+    strncpy (state->layout, layout, SCE_WARMUP_NAME_LENGTH - 1);
+}
+
+
+static void SCE_RFreeWarmupEntry (void *e)
+{
+    SCE_free (e);
+}
+static void SCE_RFreeWarmupTarget (void *t)
+{
+    SCE_RWarmupTarget *target = t;
+    SCE_RDeleteFramebuffer (target->fb);
+    SCE_free (target);
+}
+
+void SCE_RInitShaderWarmup (SCE_RShaderWarmup *w)
+{
+    SCE_List_Init (&w->entries);
+    SCE_List_SetFreeFunc (&w->entries, SCE_RFreeWarmupEntry);
+    w->n_entries = w->n_done = 0;
+    SCE_List_Init (&w->targets);
+    SCE_List_SetFreeFunc (&w->targets, SCE_RFreeWarmupTarget);
+    w->resolve = NULL;
+    w->udata = NULL;
+}
+void SCE_RClearShaderWarmup (SCE_RShaderWarmup *w)
+{
+    SCE_List_Clear (&w->entries);
+    SCE_List_Clear (&w->targets);
+}
+SCE_RShaderWarmup* SCE_RCreateShaderWarmup (void)
+{
+    SCE_RShaderWarmup *w = NULL;
+    if (!(w = SCE_malloc (sizeof *w)))
+        SCEE_LogSrc ();
+    else
+        SCE_RInitShaderWarmup (w);
+    return w;
+}
+void SCE_RDeleteShaderWarmup (SCE_RShaderWarmup *w)
+{
+    if (w) {
+        SCE_RClearShaderWarmup (w);
+        SCE_free (w);
+    }
+}
+
+/**
+ * \brief Sets the function giving the program and vertex buffer of the
+ * entries that have none, typically the entries of a loaded list
+ * \sa SCE_RLoadShaderWarmup(), SCE_RSetShaderWarmupObjects()
+ */
+void SCE_RSetShaderWarmupResolveFunc (SCE_RShaderWarmup *w,
+                                      SCE_FShaderWarmupResolve resolve,
+                                      void *udata)
+{
+    w->resolve = resolve;
+    w->udata = udata;
+}
+
+
+/**
+ * \brief Records a state combination
+ * \param w a warm-up list
+ * \param state the state, copied
+ * \returns the entry of \p state, NULL on error
+ *
+ * Recording a state already in the list returns its entry, so this can be
+ * called each time a new combination is first used during a session, and
+ * the list saved with SCE_RSaveShaderWarmup() for the next sessions.
+ */
+SCE_RShaderWarmupEntry* SCE_RAddShaderWarmup (SCE_RShaderWarmup *w,
+                                              const SCE_RShaderWarmupState
+                                              *state)
+{
+    SCE_SListIterator *it = NULL;
+    SCE_RShaderWarmupEntry *entry = NULL;
+
+    SCE_List_ForEach (it, &w->entries) {
+        entry = SCE_List_GetData (it);
+        if (!memcmp (&entry->state, state, sizeof *state))
+            return entry;
+    }
+
+    if (!(entry = SCE_malloc (sizeof *entry))) {
+        SCEE_LogSrc ();
+        return NULL;
+    }
+    entry->state = *state;
+    entry->prog = NULL;
+    entry->vb = NULL;
+    entry->time = -1;
+    entry->done = SCE_FALSE;
+    SCE_List_InitIt (&entry->it);
+    SCE_List_SetData (&entry->it, entry);
+    SCE_List_Appendl (&w->entries, &entry->it);
+    w->n_entries++;
+    return entry;
+}
+/**
+ * \brief Sets the objects of an entry, the resolve function isn't called
+ * for this entry anymore
+ */
+void SCE_RSetShaderWarmupObjects (SCE_RShaderWarmupEntry *entry,
+                                  SCE_RProgram *prog, SCE_RVertexBuffer *vb)
+{
+    entry->prog = prog;
+    entry->vb = vb;
+}
+
+
+/**
+ * \brief Saves the state combinations of a warm-up list in a text file
+ * \returns SCE_ERROR on error, SCE_OK otherwise
+ * \sa SCE_RLoadShaderWarmup()
+ */
+int SCE_RSaveShaderWarmup (const SCE_RShaderWarmup *w, const char *fname)
+{
+    SCE_SListIterator *it = NULL;
+    FILE *fp = NULL;
+
+    if (!(fp = fopen (fname, "w"))) {
+        SCEE_Log (SCE_FILE_NOT_FOUND);
+        SCEE_LogMsg ("can't open '%s' for writing", fname);
+        return SCE_ERROR;
+    }
+    SCE_List_ForEach (it, &w->entries) {
+        const SCE_RShaderWarmupEntry *e = SCE_List_GetData (it);
+        fprintf (fp, "%s %s %d %d %d %u %u\n", e->state.prog, e->state.layout,
+                 (int)e->state.color, (int)e->state.depth, e->state.blending,
+                 (unsigned int)e->state.src, (unsigned int)e->state.dst);
+    }
+    fclose (fp);
+    return SCE_OK;
+}
+/**
+ * \brief Adds the state combinations saved in a file to a warm-up list
+ * \returns SCE_ERROR on error, SCE_OK otherwise
+ * \sa SCE_RSaveShaderWarmup(), SCE_RSetShaderWarmupResolveFunc()
+ */
+int SCE_RLoadShaderWarmup (SCE_RShaderWarmup *w, const char *fname)
+{
+    char prog[SCE_WARMUP_NAME_LENGTH], layout[SCE_WARMUP_NAME_LENGTH];
+    int color, depth, blending;
+    unsigned int src, dst;
+    FILE *fp = NULL;
+
+    if (!(fp = fopen (fname, "r"))) {
+        SCEE_Log (SCE_FILE_NOT_FOUND);
+        SCEE_LogMsg ("can't open '%s' for reading", fname);
+        return SCE_ERROR;
+    }
+    while (fscanf (fp, "%63s %63s %d %d %d %u %u", prog, layout, &color,
+                   &depth, &blending, &src, &dst) == 7) {
+        SCE_RShaderWarmupState state;
+        if (color < 0 || color >= SCE_NUM_PIXEL_FORMATS ||
+            depth < 0 || depth >= SCE_NUM_PIXEL_FORMATS)
+            continue;
+        SCE_RInitShaderWarmupState (&state);
+        SCE_RSetShaderWarmupStateNames (&state, prog, layout);
+        state.color = color;
+        state.depth = depth;
+        state.blending = blending;
+        state.src = src;
+        state.dst = dst;
+        if (!SCE_RAddShaderWarmup (w, &state)) {
+            fclose (fp);
+            SCEE_LogSrc ();
+            return SCE_ERROR;
+        }
+    }
+    fclose (fp);
+    return SCE_OK;
+}
+
+
+static SCE_RFramebuffer* SCE_RGetWarmupTarget (SCE_RShaderWarmup *w,
+                                               SCE_EPixelFormat color,
+                                               SCE_EPixelFormat depth)
+{
+    SCE_SListIterator *it = NULL;
+    SCE_RWarmupTarget *target = NULL;
+
+    SCE_List_ForEach (it, &w->targets) {
+        target = SCE_List_GetData (it);
+        if (target->color == color && target->depth == depth)
+            return target->fb;
+    }
+
+    if (!(target = SCE_malloc (sizeof *target)))
+        goto fail;
+    target->fb = NULL;
+    target->color = color;
+    target->depth = depth;
+    if (!(target->fb = SCE_RCreateFramebuffer ()))
+        goto fail;
+    if ((color != SCE_PXF_NONE &&
+         SCE_RAddRenderBuffer (target->fb, SCE_COLOR_BUFFER, color, 1, 1) < 0)
+        || (depth != SCE_PXF_NONE &&
+            SCE_RAddRenderBuffer (target->fb, SCE_DEPTH_BUFFER, depth,
+                                  1, 1) < 0))
+        goto fail;
+
+    /* only complete targets are kept */
+    SCE_List_InitIt (&target->it);
+    SCE_List_SetData (&target->it, target);
+    SCE_List_Appendl (&w->targets, &target->it);
+    return target->fb;
+fail:
+    if (target) {
+        SCE_RDeleteFramebuffer (target->fb);
+        SCE_free (target);
+    }
+    SCEE_LogSrc ();
+    return NULL;
+}
+
+static int SCE_RWarmupEntry (SCE_RShaderWarmup *w,
+                             SCE_RShaderWarmupEntry *entry)
+{
+    SCE_RFramebuffer *fb = NULL;
+    SCE_RProgram *prev_prog = SCE_RGetUsedProgram ();
+    SCE_RProgramPipeline *prev_pipeline = SCE_RGetUsedProgramPipeline ();
+    int prev_fb, viewport[4], blend[4];
+    GLboolean blending;
+    SCEenum prim = GL_TRIANGLES;
+    SCEsizei count = 3;
+
+    if (!entry->prog && w->resolve &&
+        w->resolve (&entry->state, &entry->prog, &entry->vb, w->udata) < 0)
+        goto fail;
+    if (!entry->prog || !entry->vb) {
+        SCEE_Log (SCE_INVALID_ARG);
+        SCEE_LogMsg ("warm-up entry '%s' '%s' has no program or vertex buffer",
+                     entry->state.prog, entry->state.layout);
+        goto fail;
+    }
+    if (!(fb = SCE_RGetWarmupTarget (w, entry->state.color,
+                                     entry->state.depth)))
+        goto fail;
+
+    /* the states changed here are restored afterwards */
+    glGetIntegerv (GL_FRAMEBUFFER_BINDING, &prev_fb);
+    glGetIntegerv (GL_VIEWPORT, viewport);
+    blending = glIsEnabled (GL_BLEND);
+    glGetIntegerv (GL_BLEND_SRC_RGB, &blend[0]);
+    glGetIntegerv (GL_BLEND_DST_RGB, &blend[1]);
+    glGetIntegerv (GL_BLEND_SRC_ALPHA, &blend[2]);
+    glGetIntegerv (GL_BLEND_DST_ALPHA, &blend[3]);
+
+    SCE_RUseFramebuffer (fb, NULL, -1);
+    SCE_RUseProgram (entry->prog);
+    if (entry->state.blending) {
+        glEnable (GL_BLEND);
+        glBlendFunc (entry->state.src, entry->state.dst);
+    } else
+        glDisable (GL_BLEND);
+    SCE_RUseVertexBuffer (entry->vb);
+    SCE_RFlushMatrices ();
+
+    if (entry->prog->use_tess) {
+        prim = GL_PATCHES;
+        count = entry->prog->patch_vertices;
+    }
+    if (entry->vb->n_vertices < (unsigned int)count)
+        count = entry->vb->n_vertices;
+    glDrawArrays (prim, 0, count);
+
+    SCE_RFinishVertexBufferRender ();
+    if (prev_pipeline)
+        SCE_RUseProgramPipeline (prev_pipeline);
+    else
+        SCE_RUseProgram (prev_prog);
+    if (prev_fb) {
+        /* SCE_RUseFramebuffer() still thinks a framebuffer is bound */
+        glBindFramebufferEXT (GL_FRAMEBUFFER_EXT, prev_fb);
+        glViewport (viewport[0], viewport[1], viewport[2], viewport[3]);
+    } else
+        SCE_RUseFramebuffer (NULL, NULL, -1);
+    if (blending)
+        glEnable (GL_BLEND);
+    else
+        glDisable (GL_BLEND);
+    glBlendFuncSeparate (blend[0], blend[1], blend[2], blend[3]);
+    /* wait for the driver to actually process the draw */
+    glFinish ();
+    return SCE_OK;
+fail:
+    SCEE_LogSrc ();
+    return SCE_ERROR;
+}
+
+/**
+ * \brief Warms up the next entries of a list
+ * \param w a warm-up list
+ * \param budget time budget in microseconds
+ * \returns the number of entries left
+ *
+ * Entries are processed until \p budget is exceeded, at least one entry is
+ * processed per call. An entry that fails is logged and skipped, its time
+ * stays at -1.
+ * \sa SCE_RPrintShaderWarmupReport()
+ */
+size_t SCE_RRunShaderWarmup (SCE_RShaderWarmup *w, unsigned long budget)
+{
+    SCE_SListIterator *it = NULL;
+    unsigned long start = SCE_RGetWarmupTime ();
+
+    if (w->n_done == w->n_entries)
+        return 0;
+
+    SCE_List_ForEach (it, &w->entries) {
+        SCE_RShaderWarmupEntry *entry = SCE_List_GetData (it);
+        unsigned long t;
+
+        if (entry->done)
+            continue;
+        t = SCE_RGetWarmupTime ();
+
+        if (SCE_RWarmupEntry (w, entry) < 0)
+            SCEE_SendMsg ("shader warm-up: skipping entry '%s' '%s'\n",
+                          entry->state.prog, entry->state.layout);
+        else
+            entry->time = SCE_RGetWarmupTime () - t;
+        entry->done = SCE_TRUE;
+        w->n_done++;
+
+        if (SCE_RGetWarmupTime () - start >= budget)
+            break;
+    }
+    return w->n_entries - w->n_done;
+}
+/**
+ * \brief Checks whether all the entries of a list have been processed
+ */
+int SCE_RIsShaderWarmupDone (const SCE_RShaderWarmup *w)
+{
+    return w->n_done == w->n_entries;
+}
+/**
+ * \brief Resets a list so that its entries will be warmed up again, for
+ * instance after a context loss
+ */
+void SCE_RRestartShaderWarmup (SCE_RShaderWarmup *w)
+{
+    SCE_SListIterator *it = NULL;
+    SCE_List_ForEach (it, &w->entries) {
+        SCE_RShaderWarmupEntry *entry = SCE_List_GetData (it);
+        entry->time = -1;
+        entry->done = SCE_FALSE;
+    }
+    w->n_done = 0;
+}
+
+/**
+ * \brief Writes the warm-up time of each processed entry
+ * \param w a warm-up list
+ * \param fp output stream
+ */
+void SCE_RPrintShaderWarmupReport (const SCE_RShaderWarmup *w, FILE *fp)
+{
+    SCE_SListIterator *it = NULL;
+    unsigned long total = 0;
+    size_t failed = 0;
+
+    fprintf (fp, "shader warm-up: %lu/%lu entries processed\n",
+             (unsigned long)w->n_done, (unsigned long)w->n_entries);
+    SCE_List_ForEach (it, &w->entries) {
+        const SCE_RShaderWarmupEntry *e = SCE_List_GetData (it);
+        if (!e->done)
+            continue;
+        if (e->time < 0) {
+            fprintf (fp, "  %-24s %-16s  failed\n", e->state.prog,
+                     e->state.layout);
+            failed++;
+        } else {
+            fprintf (fp, "  %-24s %-16s %8.3f ms\n", e->state.prog,
+                     e->state.layout, e->time / 1000.0);
+            total += e->time;
+        }
+    }
+    fprintf (fp, "total: %.3f ms, %lu failed\n", total / 1000.0,
+             (unsigned long)failed);
+}
+
+/** @} */
@@ -64,7 +64,9 @@ static void SCE_RCheckCaps (void)
     caps[SCE_TEX_S3TC] =
     SCE_RIsSupported ("GL_EXT_texture_compression_s3tc");
 
-    caps[SCE_TEX_3DC] = SCE_FALSE; /* TODO: onlz */
+    caps[SCE_TEX_3DC] =
+    SCE_RIsSupported ("GL_ARB_texture_compression_rgtc") ||
+    SCE_RIsSupported ("GL_EXT_texture_compression_rgtc");
 
     caps[SCE_VBO] =
     SCE_RIsSupported ("GL_ARB_vertex_buffer_object");
@@ -109,6 +111,44 @@ static void SCE_RCheckCaps (void)
     caps[SCE_HW_INSTANCING] =
     SCE_RIsSupported ("GL_ARB_draw_instanced") ||
     SCE_RIsSupported ("GL_EXT_draw_instanced");
+
+    caps[SCE_SEPARATE_SHADERS] =
+    SCE_RIsSupported ("GL_ARB_separate_shader_objects");
+
+    caps[SCE_SYNC] =
+    SCE_RIsSupported ("GL_ARB_sync");
+
+    caps[SCE_BUFFER_STORAGE] =
+    SCE_RIsSupported ("GL_ARB_buffer_storage");
+
+    caps[SCE_TEX_STORAGE] =
+    SCE_RIsSupported ("GL_ARB_texture_storage");
+
+    caps[SCE_SAMPLER_OBJECTS] =
+    SCE_RIsSupported ("GL_ARB_sampler_objects");
+
+    caps[SCE_TEX_ANISOTROPY] =
+    SCE_RIsSupported ("GL_EXT_texture_filter_anisotropic") ||
+    SCE_RIsSupported ("GL_ARB_texture_filter_anisotropic");
+
+    caps[SCE_COPY_IMAGE] =
+    SCE_RIsSupported ("GL_ARB_copy_image");
+
+    caps[SCE_TEX_FLOAT] =
+    SCE_RIsSupported ("GL_ARB_texture_float") ||
+    SCE_RIsSupported ("GL_VERSION_3_0");
+
+    caps[SCE_TEX_PACKED_FLOAT] =
+    SCE_RIsSupported ("GL_EXT_packed_float") ||
+    SCE_RIsSupported ("GL_VERSION_3_0");
+
+    caps[SCE_TEX_SHARED_EXPONENT] =
+    SCE_RIsSupported ("GL_EXT_texture_shared_exponent") ||
+    SCE_RIsSupported ("GL_VERSION_3_0");
+
+    caps[SCE_TEX_RG] =
+    SCE_RIsSupported ("GL_ARB_texture_rg") ||
+    SCE_RIsSupported ("GL_VERSION_3_0");
 }
 
 /**
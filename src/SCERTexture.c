@@ -26,6 +26,14 @@
 #include "SCE/renderer/SCERType.h"
 #include "SCE/renderer/SCERSupport.h"
 #include "SCE/renderer/SCERTexture.h"
+#include "SCE/renderer/SCERTextureStream.h"
+#include "SCE/renderer/SCERTextureBudget.h"
+#include "SCE/renderer/SCERTextureRealize.h"
+#include "SCE/renderer/SCERUpload.h"
+#include "SCE/renderer/SCERTextureFile.h"
+#include "SCE/renderer/SCERSampler.h"
+#include "SCE/renderer/SCERConvert.h"
+#include "SCE/renderer/SCERWorker.h"
 
 /**
  * \file SCERTexture.c
@@ -60,6 +68,8 @@ unsigned int SCE_RGetTextureNumBatchs (void)
 /* TODO: french spotted. */
 /* booleen: true = reduction des images lors d'une redimension automatique */
 static int sce_tex_reduce = SCE_TRUE;
+/* filter of the automatic resize, see SCE_RResampleTextureImage() */
+static SCE_RResampleFilter sce_tex_resize_filter = SCE_RESAMPLE_MITCHELL;
 
 /* stocke les textures utilisees (via Use) */
 static SCE_RTexture **texused = NULL;
@@ -82,6 +92,21 @@ static SCE_EImageType forced_fmt;
 
 static int n_textype[SCE_NUM_TEXTYPE];
 
+/* state of a texture unit as last set by this module, calls that wouldn't
+   change it are dropped */
+typedef struct {
+    SCEuint bound[SCE_NUM_TEXTYPE];     /* texture bound to each target */
+    int enabled[SCE_NUM_TEXTYPE];       /* is each target enabled? */
+} SCE_RTexUnitState;
+
+static SCE_RTexUnitState *units = NULL;
+static int active_unit = 0;
+static SCE_RTextureBindCounters counters;
+
+static const SCEenum textype_targets[SCE_NUM_TEXTYPE] = {
+    SCE_TEX_1D, SCE_TEX_2D, SCE_TEX_2D_ARRAY, SCE_TEX_3D, SCE_TEX_CUBE
+};
+
 
 static void* SCE_RLoadTextureResource (const char*, int, void*);
 
@@ -111,6 +136,11 @@ int SCE_RTextureInit (void)
         goto fail;
     for (i = 0; i < max_tex_units; i++)
         texused[i] = NULL;
+    if (!(units = SCE_malloc (max_tex_units * sizeof *units)))
+        goto fail;
+    memset (units, 0, max_tex_units * sizeof *units);
+    active_unit = 0;
+    SCE_RResetTextureBindCounters ();
     resource_type = SCE_Resource_RegisterType (SCE_FALSE,
                                                SCE_RLoadTextureResource, NULL);
     if (resource_type < 0)
@@ -131,6 +161,8 @@ void SCE_RTextureQuit (void)
 {
     SCE_free (texused);
     texused = NULL;
+    SCE_free (units);
+    units = NULL;
 }
 
 
@@ -143,17 +175,162 @@ void SCE_RSetTextureAnisotropic (SCE_RTexture *tex, SCEfloat level)
 {
     tex->aniso_level = level;
 }
+/**
+ * \brief Sets how the missing mipmap levels of a texture are generated
+ * \param tex a texture
+ * \param filter downsampling filter
+ * \param srgb are the 8 bits colors of \p tex sRGB encoded ?
+ * \sa SCE_RGenerateTextureMipmaps()
+ */
+void SCE_RSetTextureMipmapFilter (SCE_RTexture *tex, SCE_RMipmapFilter filter,
+                                  int srgb)
+{
+    tex->mipmap_filter = filter;
+    tex->srgb = srgb;
+}
+/**
+ * \brief Compresses the data of a texture when it is built
+ * \param tex a texture
+ * \param pxf SCE_PXF_DXT1, SCE_PXF_DXT3, SCE_PXF_DXT5, SCE_PXF_3DC or
+ *        SCE_PXF_NONE to keep the data uncompressed
+ * \param q encoding quality
+ * \sa SCE_RCompressTexture(), SCE_RForceTexturePixelFormat()
+ */
+void SCE_RSetTextureCompression (SCE_RTexture *tex, SCE_EPixelFormat pxf,
+                                 SCE_RCompressQuality q)
+{
+    tex->compression = pxf;
+    tex->compression_quality = q;
+}
+/**
+ * \brief Converts the data of a texture when it is built
+ * \param tex a texture
+ * \param fmt format of the uploaded data, SCE_IMAGE_NONE to keep the format
+ *        of the data
+ * \param type type of the uploaded components, SCE_NONE_TYPE to keep it
+ * \param flags 0 or SCE_CONVERT_PREMULTIPLY, applied by the next build only
+ * \sa SCE_RConvertTexture(), SCE_RConvertImage()
+ */
+void SCE_RSetTextureConversion (SCE_RTexture *tex, SCE_EImageFormat fmt,
+                                SCE_EType type, int flags)
+{
+    tex->conv_fmt = fmt;
+    tex->conv_type = type;
+    tex->conv_flags = flags;
+}
+/**
+ * \brief Sets the internal format of a texture, used instead of the pixel
+ * format of its data when it is built
+ * \param tex a texture
+ * \param fmt an internal format, SCE_IFMT_NONE to use the pixel format of
+ *        the data
+ *
+ * The data given to \p tex are converted by the GL, e.g. floats or half
+ * floats to SCE_IFMT_R11F_G11F_B10F. Compressed data keep their format.
+ * \sa SCE_RChooseInternalFormat(), SCE_RAddNewRenderTextureFormat()
+ */
+void SCE_RSetTextureInternalFormat (SCE_RTexture *tex, SCE_RInternalFormat fmt)
+{
+    tex->internal_fmt = fmt;
+}
+/**
+ * \brief Gets the internal format set by SCE_RSetTextureInternalFormat()
+ */
+SCE_RInternalFormat SCE_RGetTextureInternalFormat (SCE_RTexture *tex)
+{
+    return tex->internal_fmt;
+}
 float SCE_RGetTextureMaxAnisotropic (void)
 {
-    SCEfloat max;
-    glGetFloatv (GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &max);
-    return max;
+    return SCE_RGetMaxAnisotropy ();
 }
 
 
-static void SCE_RBindTexture (SCE_RTexture *tex)
+static void SCE_RActivateTextureUnit (int unit)
 {
-    glBindTexture (tex->target, tex->id);
+    if (unit != active_unit) {
+        glActiveTexture (SCE_TEX0 + unit);
+        active_unit = unit;
+        counters.units++;
+    }
+}
+static void SCE_RBindTextureUnit (int unit, enum SCE_ETexType type, SCEuint id)
+{
+    if (units[unit].bound[type] != id) {
+        SCE_RActivateTextureUnit (unit);
+        glBindTexture (textype_targets[type], id);
+        units[unit].bound[type] = id;
+        counters.binds++;
+    }
+}
+static void SCE_REnableTextureUnit (int unit, enum SCE_ETexType type,
+                                    int enable)
+{
+    if (units[unit].enabled[type] != enable) {
+        SCE_RActivateTextureUnit (unit);
+        if (enable)
+            glEnable (textype_targets[type]);
+        else
+            glDisable (textype_targets[type]);
+        units[unit].enabled[type] = enable;
+        counters.enables++;
+    }
+}
+/**
+ * \brief Binds a texture to the active unit, to modify it
+ *
+ * Use it instead of glBindTexture(), so that the bindings cached by
+ * SCE_RUseTexture() stay valid.
+ */
+void SCE_RBindTexture (SCE_RTexture *tex)
+{
+    /* the cached bindings are those of the rendering context */
+    if (SCE_RIsUploadThread ()) {
+        glBindTexture (tex->target, tex->id);
+        return;
+    }
+    counters.requested++;
+    SCE_RBindTextureUnit (active_unit, tex->type, tex->id);
+}
+/**
+ * \internal
+ * \brief Forgets the cached bindings of a texture, so that the next
+ * SCE_RUseTexture() binds it again
+ *
+ * A texture modified by another context must be bound again to see the
+ * changes, see SCE_RIsUploadReady().
+ */
+void SCE_RForgetTextureBindings (SCE_RTexture *tex)
+{
+    int i;
+    for (i = 0; i < max_tex_units; i++) {
+        if (units[i].bound[tex->type] == tex->id)
+            units[i].bound[tex->type] = 0;
+    }
+}
+/* deletes the GL texture, the units it was bound to now have no texture */
+static void SCE_RDeleteTextureObject (SCE_RTexture *tex)
+{
+    SCE_RForgetTextureBindings (tex);
+    glDeleteTextures (1, &tex->id);
+}
+
+/**
+ * \brief Gets the number of texture binds requested and issued
+ * \param c filled with the counters since the last call to
+ *        SCE_RResetTextureBindCounters()
+ */
+void SCE_RGetTextureBindCounters (SCE_RTextureBindCounters *c)
+{
+    *c = counters;
+}
+/**
+ * \brief Resets the counters of SCE_RGetTextureBindCounters()
+ */
+void SCE_RResetTextureBindCounters (void)
+{
+    counters.requested = counters.binds = 0;
+    counters.enables = counters.units = 0;
 }
 
 
@@ -170,6 +347,41 @@ static void SCE_RInitTexture (SCE_RTexture *tex)
     tex->have_data = SCE_FALSE;
     tex->use_mipmap = tex->hw_mipmap = SCE_FALSE;
     tex->aniso_level = 0.0;
+    SCE_RInitSamplerDesc (&tex->sampler);
+    tex->sampler_obj = NULL;
+    tex->mipmap_filter = SCE_MIPMAP_BOX;
+    tex->srgb = SCE_FALSE;
+    tex->compression = SCE_PXF_NONE;
+    tex->compression_quality = SCE_COMPRESS_NORMAL;
+    tex->conv_fmt = SCE_IMAGE_NONE;
+    tex->conv_type = SCE_NONE_TYPE;
+    tex->conv_flags = 0;
+    tex->internal_fmt = SCE_IFMT_NONE;
+    tex->stream = NULL;
+    tex->pending = 0;
+    tex->file = NULL;
+    tex->progressive = SCE_FALSE;
+    tex->requested_lod = 0.0f;
+    for (i = 0; i < SCE_MAX_TEXTURE_LEVELS; i++)
+        tex->level_pending[i] = 0;
+    tex->immutable = SCE_FALSE;
+    tex->storage_w = tex->storage_h = tex->storage_d = 0;
+    tex->storage_levels = 0;
+    tex->storage_pxf = 0;
+    tex->dirty = NULL;
+    tex->n_dirty = 0;
+    tex->dirty_overflow = SCE_FALSE;
+    tex->n_levels = 0;
+    for (i = 0; i < SCE_MAX_TEXTURE_LEVELS; i++)
+        tex->level_size[i] = 0;
+    tex->base_level = 0;
+    tex->unrealized = SCE_FALSE;
+    SCE_List_InitIt (&tex->realize_it);
+    SCE_List_SetData (&tex->realize_it, tex);
+    tex->last_used = 0;
+    tex->budgeted = SCE_FALSE;
+    SCE_List_InitIt (&tex->budget_it);
+    SCE_List_SetData (&tex->budget_it, tex);
     for (i = 0; i < 6; i++) {
         SCE_List_Init (&tex->data[i]);
         SCE_List_SetFreeFunc (&tex->data[i], SCE_RDeleteTexData);
@@ -218,9 +430,19 @@ void SCE_RDeleteTexture (SCE_RTexture *tex)
         unsigned int i;
         if (!SCE_Resource_Free (tex))
             return;
+        if (tex->pending)
+            SCE_RCancelTextureStream (tex);
+        SCE_RReleaseTextureFile (tex);
+        SCE_RUntrackTexture (tex);
+        SCE_RCancelTextureRealization (tex);
+        for (i = 0; i < max_tex_units; i++) {
+            if (texused[i] == tex)
+                SCE_RUseTexture (NULL, i);
+        }
         for (i = 0; i < 6; i++)
             SCE_List_Clear (&tex->data[i]);
-        glDeleteTextures (1, &tex->id);
+        SCE_RDeleteTextureObject (tex);
+        SCE_free (tex->dirty);
         SCE_free (tex);
     }
 }
@@ -257,6 +479,61 @@ int SCE_RGetMaxTexture3DSize (void)
 }
 
 
+/* changes the sampling state of a texture, returns FALSE if pname isn't part
+   of it; a bound sampler object overrides all these texture parameters */
+static int SCE_RSetTextureSamplerParam (SCE_RTexture *tex, SCEenum pname,
+                                        SCEint param)
+{
+    SCE_RSamplerDesc *desc = &tex->sampler;
+    switch (pname) {
+    case GL_TEXTURE_MIN_FILTER: desc->min_filter = param; break;
+    case GL_TEXTURE_MAG_FILTER: desc->mag_filter = param; break;
+    case GL_TEXTURE_WRAP_S: desc->wrap[0] = param; break;
+    case GL_TEXTURE_WRAP_T: desc->wrap[1] = param; break;
+    case GL_TEXTURE_WRAP_R: desc->wrap[2] = param; break;
+    case GL_TEXTURE_COMPARE_MODE: desc->compare_mode = param; break;
+    case GL_TEXTURE_COMPARE_FUNC: desc->compare_func = param; break;
+    case GL_TEXTURE_MIN_LOD: desc->min_lod = param; break;
+    case GL_TEXTURE_MAX_LOD: desc->max_lod = param; break;
+    case GL_TEXTURE_LOD_BIAS: desc->lod_bias = param; break;
+    default: return SCE_FALSE;
+    }
+    /* looked up again at the next use */
+    tex->sampler_obj = NULL;
+    if (!SCE_RHasCap (SCE_SAMPLER_OBJECTS)) {
+        SCE_RBindTexture (tex);
+        glTexParameteri (tex->target, pname, param);
+    }
+    return SCE_TRUE;
+}
+/* float version, keeps the fractions of the levels of detail */
+static int SCE_RSetTextureSamplerParamf (SCE_RTexture *tex, SCEenum pname,
+                                         SCEfloat param)
+{
+    SCE_RSamplerDesc *desc = &tex->sampler;
+    switch (pname) {
+    case GL_TEXTURE_MIN_LOD: desc->min_lod = param; break;
+    case GL_TEXTURE_MAX_LOD: desc->max_lod = param; break;
+    case GL_TEXTURE_LOD_BIAS: desc->lod_bias = param; break;
+    default: return SCE_RSetTextureSamplerParam (tex, pname, param);
+    }
+    tex->sampler_obj = NULL;
+    if (!SCE_RHasCap (SCE_SAMPLER_OBJECTS)) {
+        SCE_RBindTexture (tex);
+        glTexParameterf (tex->target, pname, param);
+    }
+    return SCE_TRUE;
+}
+static void SCE_RSetTextureSamplerAnisotropy (SCE_RTexture *tex, float aniso)
+{
+    tex->sampler.anisotropy = aniso;
+    tex->sampler_obj = NULL;
+    if (!SCE_RHasCap (SCE_SAMPLER_OBJECTS) && SCE_RHasCap (SCE_TEX_ANISOTROPY)) {
+        SCE_RBindTexture (tex);
+        glTexParameterf (tex->target, GL_TEXTURE_MAX_ANISOTROPY_EXT, aniso);
+    }
+}
+
 /**
  * \brief Sets the filter of a texture when it goes far away from the view point
  * \param tex a texture
@@ -267,7 +544,7 @@ int SCE_RGetMaxTexture3DSize (void)
  */
 void SCE_RSetTextureFilter (SCE_RTexture *tex, SCE_RTexFilter filter)
 {
-    SCE_RSetTextureParam (tex, GL_TEXTURE_MIN_FILTER, filter);
+    SCE_RSetTextureSamplerParam (tex, GL_TEXTURE_MIN_FILTER, filter);
 }
 
 /**
@@ -279,8 +556,8 @@ void SCE_RSetTextureFilter (SCE_RTexture *tex, SCE_RTexFilter filter)
  */
 void SCE_RPixelizeTexture (SCE_RTexture *tex, int p)
 {
-    SCE_RSetTextureParam (tex, GL_TEXTURE_MAG_FILTER,
-                          (p ? GL_NEAREST : GL_LINEAR));
+    SCE_RSetTextureSamplerParam (tex, GL_TEXTURE_MAG_FILTER,
+                                 (p ? GL_NEAREST : GL_LINEAR));
 }
 
 /**
@@ -295,10 +572,46 @@ void SCE_RSetTextureWrapMode (SCE_RTexture *tex, SCE_RTexWrapMode mode)
         GL_REPEAT
     };
     SCEenum m = modes[mode];
-    glBindTexture (tex->target, tex->id);
-    glTexParameteri (tex->target, GL_TEXTURE_WRAP_S, m);
-    glTexParameteri (tex->target, GL_TEXTURE_WRAP_T, m);
-    glTexParameteri (tex->target, GL_TEXTURE_WRAP_R, m);
+    SCE_RSetTextureSamplerParam (tex, GL_TEXTURE_WRAP_S, m);
+    SCE_RSetTextureSamplerParam (tex, GL_TEXTURE_WRAP_T, m);
+    SCE_RSetTextureSamplerParam (tex, GL_TEXTURE_WRAP_R, m);
+}
+
+/**
+ * \brief Sets the color sampled outside of a texture with the
+ * GL_CLAMP_TO_BORDER wrap mode
+ * \param tex a texture
+ * \param color RGBA color
+ */
+void SCE_RSetTextureBorderColor (SCE_RTexture *tex, const SCEfloat *color)
+{
+    memcpy (tex->sampler.border, color, sizeof tex->sampler.border);
+    tex->sampler_obj = NULL;
+    if (!SCE_RHasCap (SCE_SAMPLER_OBJECTS)) {
+        SCE_RBindTexture (tex);
+        glTexParameterfv (tex->target, GL_TEXTURE_BORDER_COLOR, color);
+    }
+}
+
+/**
+ * \brief Gets the sampling state of a texture
+ *
+ * Copy it to sample the texture differently with SCE_RUseTextureSampler().
+ */
+const SCE_RSamplerDesc* SCE_RGetTextureSamplerDesc (SCE_RTexture *tex)
+{
+    return &tex->sampler;
+}
+/**
+ * \brief Gets the sampler object matching the sampling state of a texture
+ * \returns the sampler, NULL when sampler objects aren't supported
+ * \sa SCE_RGetSampler()
+ */
+SCE_RSampler* SCE_RGetTextureSampler (SCE_RTexture *tex)
+{
+    if (!tex->sampler_obj)
+        tex->sampler_obj = SCE_RGetSampler (&tex->sampler);
+    return tex->sampler_obj;
 }
 
 /**
@@ -308,15 +621,19 @@ void SCE_RSetTextureWrapMode (SCE_RTexture *tex, SCE_RTexWrapMode mode)
  * \param pname the type of the parameter
  * \param param the value of the parameter
  *
- * This function calls glTexParameteri()
+ * This function calls glTexParameteri(). The filters, the wrap modes, the
+ * depth comparison and the levels of detail go to the sampling state of
+ * \p tex, since a sampler object overrides them.
  *
  * \sa SCE_RSetTextureParamf()
  * \todo this function is GL-specific, so remove it.
  */
 void SCE_RSetTextureParam (SCE_RTexture *tex, SCEenum pname, SCEint param)
 {
-    SCE_RBindTexture (tex);
-    glTexParameteri (tex->target, pname, param);
+    if (!SCE_RSetTextureSamplerParam (tex, pname, param)) {
+        SCE_RBindTexture (tex);
+        glTexParameteri (tex->target, pname, param);
+    }
 }
 
 /**
@@ -333,8 +650,12 @@ void SCE_RSetTextureParam (SCE_RTexture *tex, SCEenum pname, SCEint param)
  */
 void SCE_RSetTextureParamf (SCE_RTexture *tex, SCEenum pname, SCEfloat param)
 {
-    SCE_RBindTexture (tex);
-    glTexParameterf (tex->target, pname, param);
+    if (pname == GL_TEXTURE_MAX_ANISOTROPY_EXT)
+        SCE_RSetTextureSamplerAnisotropy (tex, param);
+    else if (!SCE_RSetTextureSamplerParamf (tex, pname, param)) {
+        SCE_RBindTexture (tex);
+        glTexParameterf (tex->target, pname, param);
+    }
 }
 
 /**
@@ -389,6 +710,10 @@ void SCE_RSetTextureGenfv (SCE_RTexture *tex, SCEenum a, SCEenum b, float *c)
  * \brief Forces the pixel format when calling SCE_RAddTextureTexData()
  * \param force do we force the pixel format ?
  * \param pxf forced pixel format
+ *
+ * Forcing a compressed format supported by SCE_RCompressImage() onto
+ * uncompressed data makes the texture compress it when built, see
+ * SCE_RSetTextureCompression().
  * \warning this function has side-effets; it changes local static variables
  */
 void SCE_RForceTexturePixelFormat (int force, SCE_EPixelFormat pxf)
@@ -418,6 +743,16 @@ void SCE_RForceTextureFormat (int force, SCE_EImageFormat fmt)
     force_fmt = force;
     forced_fmt = fmt;
 }
+/**
+ * \brief Sets the filter used to resize the images added to the textures
+ * \param filter resampling filter, SCE_RESAMPLE_MITCHELL by default
+ * \warning this function has side-effets; it changes local static variables
+ * \sa SCE_RAddTextureImage(), SCE_RResampleImage()
+ */
+void SCE_RSetTextureResizeFilter (SCE_RResampleFilter filter)
+{
+    sce_tex_resize_filter = filter;
+}
 
 
 /**
@@ -549,6 +884,20 @@ int SCE_RGetTextureValidSize (int min, int s)
 }
 
 
+/* resolves the size of an automatic resize of \p img */
+static void SCE_RGetTextureImageSize (SCE_SImage *img, int *w, int *h, int *d)
+{
+    if (*w <= 0)
+        *w = SCE_Image_GetWidth (img);
+    if (*h <= 0)
+        *h = SCE_Image_GetHeight (img);
+    if (*d <= 0)
+        *d = SCE_Image_GetDepth (img);
+    *w = SCE_RGetTextureValidSize (sce_tex_reduce, *w);
+    *h = SCE_RGetTextureValidSize (sce_tex_reduce, *h);
+    *d = SCE_RGetTextureValidSize (sce_tex_reduce, *d);
+}
+
 /**
  * \brief Resizes an image with hardware compatibles dimensions
  * \param img the image to resize
@@ -558,56 +907,126 @@ int SCE_RGetTextureValidSize (int min, int s)
  *
  * Calls SCE_RResizeImage() over \p img after the check of \p w, \p h and \p d
  * with SCE_RGetTextureValidSize().
+ * \sa SCE_RAddTextureImage()
  */
 void SCE_RResizeTextureImage (SCE_SImage *img, int w, int h, int d)
 {
-    if (w <= 0)
-        w = SCE_Image_GetWidth (img);
-    if (h <= 0)
-        h = SCE_Image_GetHeight (img);
-    if (d <= 0)
-        d = SCE_Image_GetDepth (img);
-    w = SCE_RGetTextureValidSize (sce_tex_reduce, w);
-    h = SCE_RGetTextureValidSize (sce_tex_reduce, h);
-    d = SCE_RGetTextureValidSize (sce_tex_reduce, d);
+    SCE_RGetTextureImageSize (img, &w, &h, &d);
     if (w != SCE_Image_GetWidth (img) || h != SCE_Image_GetHeight (img) ||
         d != SCE_Image_GetDepth (img))
         SCE_Image_Resize (img, w, h, d);
 }
 
+static int SCE_RGetImageFormatComponents (SCE_EImageFormat);
 
-/**
- * \brief Adds an image to a texture
- * \param tex the texture where add the image
- * \param target the target where bind the image
- * \param img the image to add
- * \param canfree can \p tex's deletion deletes \p img ?
- *
- * Add an image to a texture and bind it as \p target, this parameter can be 0
- * then is automatically set, or can be SCE_TEX_nD for n dimension texture or
- * SCE_TEX_POSX + n where n is the cube face of the cubemap (requires that
- * \p tex is a cubemap). \p img is automatically resized to hardware compatibles
- * dimentions.
- */
-int SCE_RAddTextureImage (SCE_RTexture *tex, int target,
-                          SCE_SImage *img, int canfree)
+/* prepares the resampling of the current level of \p img to hardware
+   compatible dimensions: \p src refers to the pixels of \p img and \p dst
+   is allocated, SCE_RRunTextureResample() fills it. Both are set to NULL
+   when \p img is used as is, SCE_RResizeTextureImage() resizes the formats
+   that SCE_RResampleImage() doesn't handle. Calls the image loader, which
+   isn't reentrant */
+static int SCE_RPrepareTextureResample (SCE_SImage *img, int w, int h, int d,
+                                        SCE_STexData **src,
+                                        SCE_STexData **dst)
 {
-    SCE_STexData *d = NULL;
+    SCE_STexData *s = NULL, *o = NULL;
+    void *pixels = NULL;
+    SCE_EType type;
+    int n_comps;
+
+    *src = *dst = NULL;
+    SCE_RGetTextureImageSize (img, &w, &h, &d);
+    if (w == SCE_Image_GetWidth (img) && h == SCE_Image_GetHeight (img) &&
+        d == SCE_Image_GetDepth (img))
+        return SCE_OK;
+
+    if (!(s = SCE_TexData_CreateFromImage (img, SCE_FALSE)))
+        goto fail;
+    n_comps = SCE_RGetImageFormatComponents (SCE_TexData_GetDataFormat (s));
+    type = SCE_TexData_GetDataType (s);
+    if (SCE_TexData_IsCompressed (s) || !SCE_TexData_GetData (s) ||
+        !SCE_RIsResampleFormatSupported (n_comps, type)) {
+        SCE_TexData_Delete (s);
+        SCE_RResizeTextureImage (img, w, h, d);
+        return SCE_OK;
+    }
+
+    if (!(pixels = SCE_malloc (SCE_RGetResampledImageSize (w, h, d, n_comps,
+                                                           type))))
+        goto fail;
+    if (!(o = SCE_TexData_Create ()))
+        goto fail;
+    SCE_TexData_SetDimensions (o, w, SCE_TexData_GetHeight (s) ? h : 0,
+                               SCE_TexData_GetDepth (s) ? d : 0);
+    SCE_TexData_SetPixelFormat (o, SCE_TexData_GetPixelFormat (s));
+    SCE_TexData_SetDataType (o, type);
+    SCE_TexData_SetDataFormat (o, SCE_TexData_GetDataFormat (s));
+    SCE_TexData_SetData (o, pixels, SCE_TRUE);
+    *src = s;
+    *dst = o;
+    return SCE_OK;
+fail:
+    SCE_free (pixels);
+    SCE_TexData_Delete (s);
+    SCEE_LogSrc ();
+    return SCE_ERROR;
+}
+/* resamples the data prepared by SCE_RPrepareTextureResample(), doesn't
+   call the image loader */
+static int SCE_RRunTextureResample (SCE_STexData *src, SCE_STexData *dst)
+{
+    int n_comps;
+
+    n_comps = SCE_RGetImageFormatComponents (SCE_TexData_GetDataFormat (src));
+    if (SCE_RResampleImage (SCE_TexData_GetData (src),
+                            SCE_TexData_GetWidth (src),
+                            SCE_TexData_GetHeight (src),
+                            SCE_TexData_GetDepth (src), n_comps,
+                            SCE_TexData_GetDataType (src),
+                            MAX (SCE_TexData_GetWidth (dst), 1),
+                            MAX (SCE_TexData_GetHeight (dst), 1),
+                            MAX (SCE_TexData_GetDepth (dst), 1),
+                            sce_tex_resize_filter,
+                            SCE_TexData_GetData (dst)) < 0) {
+        SCEE_LogSrc ();
+        return SCE_ERROR;
+    }
+    return SCE_OK;
+}
+/* resamples the current level of \p img to hardware compatible dimensions
+   into a new texture data, stored in \p data; \p data is set to NULL when
+   \p img is used as is */
+static int SCE_RResampleTextureImage (SCE_SImage *img, int w, int h, int d,
+                                      SCE_STexData **data)
+{
+    SCE_STexData *src = NULL;
+
+    if (SCE_RPrepareTextureResample (img, w, h, d, &src, data) < 0)
+        goto fail;
+    if (src && SCE_RRunTextureResample (src, *data) < 0) {
+        SCE_TexData_Delete (src);
+        SCE_TexData_Delete (*data);
+        *data = NULL;
+        goto fail;
+    }
+    SCE_TexData_Delete (src);
+    return SCE_OK;
+fail:
+    SCEE_LogSrc ();
+    return SCE_ERROR;
+}
+
+/* SCE_RAddTextureImage() with an explicit size */
+static int SCE_RAddTextureImageSize (SCE_RTexture *tex, int target,
+                                     SCE_SImage *img, int w, int h, int d,
+                                     int canfree)
+{
+    SCE_STexData *data = NULL;
     unsigned int i, n_mipmaps;
-    int old_level;
+    int old_level, resampled = SCE_FALSE;
 
     old_level = SCE_Image_GetMipmapLevel (img);
 
-    /* verification des dimensions de l'image */
-    SCE_RResizeTextureImage (img, 0, 0, 0);
-#if 0
-    /* log de l'operation */
-    SCEE_SendMsg ("your hardware doesn't support non-power of two "
-                  "textures.\n%s of '%s' forced.\nnew dimentions: "
-                  "%d*%d\n", sce_img_reduce ? "shrinkage":"extention",
-                  fname, w, h);
-#endif
-
     /**
      * \todo fucking hack de merde, le mipmapping DDS chie "un peu"
      *       avec DevIL, le nombre de mipmap semble changer...
@@ -616,22 +1035,51 @@ int SCE_RAddTextureImage (SCE_RTexture *tex, int target,
     /* assignation des donnees de l'image */
     for (i = 0; i < n_mipmaps; i++) {
         SCE_Image_SetMipmapLevel (img, i);
+        /* verification des dimensions de l'image */
+        if (SCE_RResampleTextureImage (img, w, h, d, &data) < 0) {
+            SCEE_LogSrc ();
+            return SCE_ERROR;
+        }
+        if (data)
+            resampled = SCE_TRUE;
         /* creation des donnees a partir du niveau de mipmap j de l'image img */
-        d = SCE_TexData_CreateFromImage (img, canfree);
-        if (!d) {
+        else if (!(data = SCE_TexData_CreateFromImage (img, canfree))) {
             SCEE_LogSrc ();
             return SCE_ERROR;
         }
 
-        SCE_RAddTextureTexData (tex, target, d);
-        d = NULL;
+        SCE_RAddTextureTexData (tex, target, data);
+        data = NULL;
     }
 
     SCE_Image_SetMipmapLevel (img, old_level);
+    /* the resampled data don't refer to the image */
+    if (resampled && canfree)
+        SCE_Image_Delete (img);
     tex->have_data = SCE_TRUE;
     return SCE_OK;
 }
 
+/**
+ * \brief Adds an image to a texture
+ * \param tex the texture where add the image
+ * \param target the target where bind the image
+ * \param img the image to add
+ * \param canfree can \p tex's deletion deletes \p img ?
+ *
+ * Add an image to a texture and bind it as \p target, this parameter can be 0
+ * then is automatically set, or can be SCE_TEX_nD for n dimension texture or
+ * SCE_TEX_POSX + n where n is the cube face of the cubemap (requires that
+ * \p tex is a cubemap). \p img is automatically resized to hardware compatibles
+ * dimentions with SCE_RResampleImage(), see SCE_RSetTextureResizeFilter(); if
+ * so and \p canfree is true, \p img is deleted as soon as resized.
+ */
+int SCE_RAddTextureImage (SCE_RTexture *tex, int target,
+                          SCE_SImage *img, int canfree)
+{
+    return SCE_RAddTextureImageSize (tex, target, img, 0, 0, 0, canfree);
+}
+
 
 /**
  * \brief Adds a new texture data to a texture
@@ -654,7 +1102,15 @@ void SCE_RAddTextureTexData (SCE_RTexture *tex, SCE_RTexCubeFace face,
     SCE_TexData_SetTarget (d, target);
     SCE_List_Appendl (&tex->data[i], SCE_TexData_GetIterator (d));
     tex->have_data = SCE_TRUE;
-    if (force_pxf) SCE_TexData_SetPixelFormat (d, forced_pxf);
+    if (force_pxf) {
+        SCE_RBlockFormat bc;
+        /* uncompressed data is encoded by SCE_RBuildTexture() */
+        if (!SCE_TexData_IsCompressed (d) &&
+            SCE_RGetPxfBlockFormat (forced_pxf, &bc))
+            tex->compression = forced_pxf;
+        else
+            SCE_TexData_SetPixelFormat (d, forced_pxf);
+    }
     if (force_type) SCE_TexData_SetDataType (d, forced_type);
     if (force_fmt) SCE_TexData_SetDataFormat (d, forced_fmt);
 }
@@ -789,15 +1245,91 @@ typedef struct
     const char **names;
 } SCE_RTexResInfo;
 
+/* a file of SCE_RLoadTextureResource() */
+typedef struct
+{
+    SCE_SImage *img;
+    SCE_STexData *src, *dst;    /* resampling of img, or NULL */
+    SCE_STexData *layer;        /* 2D arrays: the data of the layer */
+    int target, w, h, d;
+} SCE_RTexResFile;
+
+typedef struct
+{
+    SCE_RTexResFile *files;
+    unsigned char *layers;      /* merged data of a 2D array, or NULL */
+    size_t layer_size;
+    int failed;
+} SCE_RTexResJob;
+
+static void SCE_RClearTexResFile (SCE_RTexResFile *f)
+{
+    if (f->layer != f->dst)
+        SCE_TexData_Delete (f->layer);
+    SCE_TexData_Delete (f->src);
+    SCE_TexData_Delete (f->dst);
+    SCE_Image_Delete (f->img);
+}
+
+/* allocates the merged data of a 2D array for its first layer, checks that
+   the next layers match */
+static int SCE_RCheckTextureLayer (SCE_STexData *final, SCE_STexData *layer,
+                                   unsigned int n)
+{
+    unsigned char *data = SCE_TexData_GetData (final);
+    size_t size = SCE_TexData_GetDataSize (layer);
+
+    if (!data) {
+        if (!(data = SCE_malloc (size * n)))
+            return SCE_ERROR;
+        SCE_TexData_SetDimensions (final, SCE_TexData_GetWidth (layer),
+                                   SCE_TexData_GetHeight (layer), n);
+        SCE_TexData_SetPixelFormat (final,SCE_TexData_GetPixelFormat (layer));
+        SCE_TexData_SetDataType (final, SCE_TexData_GetDataType (layer));
+        SCE_TexData_SetDataFormat (final, SCE_TexData_GetDataFormat (layer));
+        SCE_TexData_SetData (final, data, SCE_TRUE);
+    } else if (SCE_TexData_GetWidth (layer) != SCE_TexData_GetWidth (final) ||
+               SCE_TexData_GetHeight (layer) != SCE_TexData_GetHeight (final)||
+               SCE_TexData_GetPixelFormat (layer) !=
+               SCE_TexData_GetPixelFormat (final) ||
+               size * n != SCE_TexData_GetDataSize (final)) {
+        SCEE_Log (SCE_INVALID_ARG);
+        SCEE_LogMsg ("the layers of a 2D array texture must have the "
+                     "same size and format");
+        return SCE_ERROR;
+    }
+    return SCE_OK;
+}
+
+/* resamples the decoded files [begin, end[ and copies the layers of a 2D
+   array, on the worker threads */
+static void SCE_RProcessTextureFiles (size_t begin, size_t end, void *data)
+{
+    SCE_RTexResJob *job = data;
+    size_t i;
+
+    for (i = begin; i < end; i++) {
+        SCE_RTexResFile *f = &job->files[i];
+        if (f->src && SCE_RRunTextureResample (f->src, f->dst) < 0) {
+            job->failed = SCE_TRUE;
+            continue;
+        }
+        if (job->layers)
+            memcpy (&job->layers[job->layer_size * i],
+                    SCE_TexData_GetData (f->layer), job->layer_size);
+    }
+}
+
 static void* SCE_RLoadTextureResource (const char *name, int force, void *data)
 {
-    unsigned int i = 0, j;
-    SCE_SImage *img = NULL;
+    unsigned int i = 0, j, n = 0;
     SCE_RTexture *tex = NULL;
     int resize;
     int type, w, h, d;
     SCE_RTexResInfo *rinfo = data;
-    SCE_STexData **tc = NULL;
+    SCE_RTexResFile *files = NULL;
+    SCE_RTexResJob job;
+    SCE_STexData *final = NULL;
 
     (void)name;
     type = rinfo->type;
@@ -805,72 +1337,137 @@ static void* SCE_RLoadTextureResource (const char *name, int force, void *data)
     /* dont account d if 2D array */
     resize = (w > 0 || h > 0 || (d > 0 && type != SCE_TEX_2D_ARRAY));
 
-    if (type == SCE_TEX_2D_ARRAY) {
-        if (!(tc = SCE_malloc (d * sizeof *tc)))
-            goto fail;
-        for (i = 0; i < d; i++)
-            tc[i] = NULL;
+    while (rinfo->names[n] && (n < d || type != SCE_TEX_2D_ARRAY))
+        n++;
+    if (type == SCE_TEX_CUBE)
+        n = MIN (n, 6);
+
+    /* containers already in GPU layout are mapped instead of decoded */
+    if (!resize && n > 0) {
+        for (i = 0; i < n && SCE_RIsTextureFileName (rinfo->names[i]); i++)
+            ;
+        /* the mapper rejects the layouts it can't upload as they are
+           (RGB, luminance, BC4, float DDS, cube map arrays, big endian
+           KTX...), the image loader takes over */
+        if (i == n && n == 1) {
+            if ((tex = SCE_RLoadTextureFile (rinfo->names[0]))) {
+                if (type <= 0 || type == tex->target)
+                    return tex;
+                /* let the image loader convert it to the requested type */
+                SCE_RDeleteTexture (tex);
+                tex = NULL;
+            } else
+                SCEE_Clear ();
+        } else if (i == n && (type == SCE_TEX_CUBE ||
+                              type == SCE_TEX_2D_ARRAY)) {
+            if ((tex = SCE_RLoadTextureFiles (type, rinfo->names, n)))
+                return tex;
+            SCEE_Clear ();
+        }
+        i = 0;
+    }
+
+    if (type == SCE_TEX_2D_ARRAY && !(final = SCE_TexData_Create ()))
+        goto fail;
+    if (!(files = SCE_malloc (MAX (n, 1) * sizeof *files)))
+        goto fail;
+    for (j = 0; j < n; j++) {
+        files[j].img = NULL;
+        files[j].src = files[j].dst = files[j].layer = NULL;
     }
 
     if (force > 0)
         force--;
 
-    for (j = 0; rinfo->names[j] && (j < d || type != SCE_TEX_2D_ARRAY); j++) {
+    /* the image loader isn't reentrant, the files are decoded in turn */
+    for (j = 0; j < n; j++) {
+        SCE_RTexResFile *f = &files[j];
         const char *fname = rinfo->names[j];
-        if (!(img = SCE_Resource_Load (SCE_Image_GetResourceType (),
-                                       fname, force, NULL)))
+        if (!(f->img = SCE_Resource_Load (SCE_Image_GetResourceType (),
+                                          fname, force, NULL)))
             goto fail;
 
-        if (resize)
-            SCE_RResizeTextureImage (img, w, h,
-                                     (type == SCE_TEX_2D_ARRAY ? 1 : d));
+        f->w = f->h = f->d = 0;
+        if (resize) {
+            f->w = w; f->h = h; f->d = (type == SCE_TEX_2D_ARRAY ? 1 : d);
+        }
 
         if (!tex) {
             if (type <= 0)
-                type = SCE_Image_GetType (img);
+                type = SCE_Image_GetType (f->img);
             if (!(tex = SCE_RCreateTexture (type)))
                 goto fail;
         }
 
         if (type == SCE_TEX_2D_ARRAY) {
-            if (!(tc[j] = SCE_TexData_CreateFromImage (img, SCE_TRUE)))
+            if (resize && SCE_RPrepareTextureResample (f->img, f->w, f->h,
+                                                       f->d, &f->src,
+                                                       &f->dst) < 0)
+                goto fail;
+            if (f->dst)
+                f->layer = f->dst;
+            else if (!(f->layer = SCE_TexData_CreateFromImage (f->img,
+                                                               SCE_FALSE)))
+                goto fail;
+            if (SCE_RCheckTextureLayer (final, f->layer, n) < 0)
                 goto fail;
         } else {
-            int t = type == SCE_TEX_CUBE ? SCE_TEX_POSX + i : 0;
-            if (SCE_RAddTextureImage (tex, t, img, SCE_TRUE) < 0)
+            f->target = type == SCE_TEX_CUBE ? SCE_TEX_POSX + i : 0;
+            /* size of the next mipmap level */
+            if (resize && type != SCE_TEX_CUBE) {
+                int iw = f->w, ih = f->h, id = f->d;
+                SCE_RGetTextureImageSize (f->img, &iw, &ih, &id);
+                w = iw / 2; h = ih / 2; d = id / 2;
+            }
+            if (SCE_RPrepareTextureResample (f->img, f->w, f->h, f->d,
+                                             &f->src, &f->dst) < 0)
                 goto fail;
         }
 
         /* cubemap..? */
         if (type == SCE_TEX_CUBE)
             i++;
-        /* && type != SCE_TEX_3D ? */
-        else if (resize && type != SCE_TEX_2D_ARRAY) {
-            /* mipmapping */
-            w = SCE_Image_GetWidth (img) / 2;
-            h = SCE_Image_GetHeight (img) / 2;
-            d = SCE_Image_GetDepth (img) / 2;
-        }
+    }
 
-        if (i == 6)             /* cube map completed */
-            break;
+    /* the resamplings and the layer copies of all the files at once */
+    job.files = files;
+    job.layers = final ? SCE_TexData_GetData (final) : NULL;
+    job.layer_size = job.layers ? SCE_TexData_GetDataSize (files[0].layer) : 0;
+    job.failed = SCE_FALSE;
+    SCE_RParallelFor (n, 1, SCE_RProcessTextureFiles, &job);
+    if (job.failed)
+        goto fail;
+
+    for (j = 0; j < n && !final; j++) {
+        SCE_RTexResFile *f = &files[j];
+        if (f->dst) {
+            /* the resampled data don't refer to the image */
+            SCE_RAddTextureTexData (tex, f->target, f->dst);
+            f->dst = NULL;
+            tex->have_data = SCE_TRUE;
+        } else {
+            if (SCE_RAddTextureImageSize (tex, f->target, f->img, f->w, f->h,
+                                          f->d, SCE_TRUE) < 0)
+                goto fail;
+            f->img = NULL;
+        }
     }
+    for (j = 0; j < n; j++)
+        SCE_RClearTexResFile (&files[j]);
+    SCE_free (files);
 
-    if (type == SCE_TEX_2D_ARRAY) {
-        SCE_STexData *final = NULL;
-        if (!(final = SCE_TexData_Merge2D (tc, j)))
-            goto fail;
-        /* remove original texdata and images (sad, but that's life.) */
-        for (i = 0; i < j; i++)
-            SCE_TexData_Delete (tc[i]);
+    if (final)
         SCE_RAddTextureTexData (tex, 0, final);
-    }
 
     return tex;
 fail:
+    if (files) {
+        for (j = 0; j < n; j++)
+            SCE_RClearTexResFile (&files[j]);
+        SCE_free (files);
+    }
     SCE_RDeleteTexture (tex);
-    for (i = 0; i < j; i++)
-        SCE_TexData_Delete (tc[i]);
+    SCE_TexData_Delete (final);
     SCEE_LogSrc ();
     return NULL;
 }
@@ -883,18 +1480,28 @@ SCE_RTexture* SCE_RLoadTexturev (int type, int w, int h, int d, int force,
                                  const char **names)
 {
     unsigned int i;
-    char buf[2048] = {0};       /* TODO: hahaha */
+    size_t len = 1;
+    char *buf = NULL;
     SCE_RTexResInfo info;
     SCE_RTexture *tex;
 
     info.type = type;
     info.w = w; info.h = h; info.d = d;
     info.names = names;
-    /* TODO: omg just fix that. */
+    /* the resource name is the concatenation of all the file names */
     for (i = 0; names[i]; i++)
-        strcat (buf, names[i]);
+        len += strlen (names[i]);
+    if (!(buf = SCE_malloc (len)))
+        goto fail;
+    for (len = 0, i = 0; names[i]; i++) {
+        strcpy (&buf[len], names[i]);
+        len += strlen (names[i]);
+    }
+    buf[len] = 0;
 
-    if (!(tex = SCE_Resource_Load (resource_type, buf, force, &info)))
+    tex = SCE_Resource_Load (resource_type, buf, force, &info);
+    SCE_free (buf);
+    if (!tex)
         goto fail;
 
     return tex;
@@ -935,18 +1542,29 @@ SCE_RTexture* SCE_RLoadTexture (int type, int w, int h, int d, int force, ...)
 }
 
 
-typedef void (*SCE_RMakeTextureFunc)(SCE_STexData*);
+/* GL internal format of the images of a texture */
+static SCEenum SCE_RGetTextureGLFormat (SCE_RTexture *tex, SCE_STexData *d)
+{
+    if (tex->internal_fmt != SCE_IFMT_NONE)
+        return SCE_RInternalFormatToGL (tex->internal_fmt);
+    return SCE_RSCEPxfToGL (SCE_TexData_GetPixelFormat (d));
+}
+
+typedef void (*SCE_RMakeTextureFunc)(SCE_RTexture*, SCE_STexData*,
+                                     const void*);
 
-static void SCE_RMakeTexture1DComp (SCE_STexData *d)
+static void SCE_RMakeTexture1DComp (SCE_RTexture *tex, SCE_STexData *d,
+                                    const void *data)
 {
     int pxf = SCE_RSCEPxfToGL (SCE_TexData_GetPixelFormat (d));
     glCompressedTexImage1D (SCE_TexData_GetTarget (d),
                             SCE_TexData_GetMipmapLevel (d), pxf,
                             SCE_TexData_GetWidth (d), 0,
                             SCE_TexData_GetDataSize (d),
-                            SCE_TexData_GetData (d));
+                            data);
 }
-static void SCE_RMakeTexture2DComp (SCE_STexData *d)
+static void SCE_RMakeTexture2DComp (SCE_RTexture *tex, SCE_STexData *d,
+                                    const void *data)
 {
     int pxf = SCE_RSCEPxfToGL (SCE_TexData_GetPixelFormat (d));
     glCompressedTexImage2D (SCE_TexData_GetTarget (d),
@@ -954,9 +1572,10 @@ static void SCE_RMakeTexture2DComp (SCE_STexData *d)
                             SCE_TexData_GetWidth (d),
                             SCE_TexData_GetHeight (d), 0,
                             SCE_TexData_GetDataSize (d),
-                            SCE_TexData_GetData (d));
+                            data);
 }
-static void SCE_RMakeTexture3DComp (SCE_STexData *d)
+static void SCE_RMakeTexture3DComp (SCE_RTexture *tex, SCE_STexData *d,
+                                    const void *data)
 {
     int pxf = SCE_RSCEPxfToGL (SCE_TexData_GetPixelFormat (d));
     glCompressedTexImage3D (SCE_TexData_GetTarget (d),
@@ -965,47 +1584,52 @@ static void SCE_RMakeTexture3DComp (SCE_STexData *d)
                             SCE_TexData_GetHeight (d),
                             SCE_TexData_GetDepth (d), 0,
                             SCE_TexData_GetDataSize (d),
-                            SCE_TexData_GetData (d));
+                            data);
 }
-static void SCE_RMakeTexture1D (SCE_STexData *d)
+static void SCE_RMakeTexture1D (SCE_RTexture *tex, SCE_STexData *d,
+                                const void *data)
 {
-    int pxf = SCE_RSCEPxfToGL (SCE_TexData_GetPixelFormat (d));
+    int pxf = SCE_RGetTextureGLFormat (tex, d);
     int fmt = SCE_RSCEImgFormatToGL (SCE_TexData_GetDataFormat (d));
     glTexImage1D (SCE_TexData_GetTarget (d), SCE_TexData_GetMipmapLevel (d),
                   pxf, SCE_TexData_GetWidth (d), 0, fmt,
                   sce_rgltypes[SCE_TexData_GetDataType (d)],
-                  SCE_TexData_GetData (d));
+                  data);
 }
-static void SCE_RMakeTexture2D (SCE_STexData *d)
+static void SCE_RMakeTexture2D (SCE_RTexture *tex, SCE_STexData *d,
+                                const void *data)
 {
-    int pxf = SCE_RSCEPxfToGL (SCE_TexData_GetPixelFormat (d));
+    int pxf = SCE_RGetTextureGLFormat (tex, d);
     int fmt = SCE_RSCEImgFormatToGL (SCE_TexData_GetDataFormat (d));
     glTexImage2D (SCE_TexData_GetTarget (d), SCE_TexData_GetMipmapLevel (d),
                   pxf, SCE_TexData_GetWidth (d), SCE_TexData_GetHeight (d), 0,
                   fmt, sce_rgltypes[SCE_TexData_GetDataType (d)],
-                  SCE_TexData_GetData (d));
+                  data);
 }
-static void SCE_RMakeTexture3D (SCE_STexData *d)
+static void SCE_RMakeTexture3D (SCE_RTexture *tex, SCE_STexData *d,
+                                const void *data)
 {
-    int pxf = SCE_RSCEPxfToGL (SCE_TexData_GetPixelFormat (d));
+    int pxf = SCE_RGetTextureGLFormat (tex, d);
     int fmt = SCE_RSCEImgFormatToGL (SCE_TexData_GetDataFormat (d));
     glTexImage3D (SCE_TexData_GetTarget (d), SCE_TexData_GetMipmapLevel (d),
                   pxf, SCE_TexData_GetWidth (d), SCE_TexData_GetHeight (d),
                   SCE_TexData_GetDepth (d), 0, fmt,
                   sce_rgltypes[SCE_TexData_GetDataType (d)],
-                  SCE_TexData_GetData (d));
+                  data);
 }
 /* fonctions de mise a jour */
-static void SCE_RMakeTexture1DCompUp (SCE_STexData *d)
+static void SCE_RMakeTexture1DCompUp (SCE_RTexture *tex, SCE_STexData *d,
+                                      const void *data)
 {
     int pxf = SCE_RSCEPxfToGL (SCE_TexData_GetPixelFormat (d));
     glCompressedTexSubImage1D (SCE_TexData_GetTarget (d),
                                SCE_TexData_GetMipmapLevel (d),
                                0, SCE_TexData_GetWidth (d),
                                pxf, SCE_TexData_GetDataSize (d),
-                               SCE_TexData_GetData (d));
+                               data);
 }
-static void SCE_RMakeTexture2DCompUp (SCE_STexData *d)
+static void SCE_RMakeTexture2DCompUp (SCE_RTexture *tex, SCE_STexData *d,
+                                      const void *data)
 {
     int pxf = SCE_RSCEPxfToGL (SCE_TexData_GetPixelFormat (d));
     glCompressedTexSubImage2D (SCE_TexData_GetTarget (d),
@@ -1013,9 +1637,10 @@ static void SCE_RMakeTexture2DCompUp (SCE_STexData *d)
                                0, 0, SCE_TexData_GetWidth (d),
                                SCE_TexData_GetHeight (d),
                                pxf, SCE_TexData_GetDataSize (d),
-                               SCE_TexData_GetData (d));
+                               data);
 }
-static void SCE_RMakeTexture3DCompUp (SCE_STexData *d)
+static void SCE_RMakeTexture3DCompUp (SCE_RTexture *tex, SCE_STexData *d,
+                                      const void *data)
 {
     int pxf = SCE_RSCEPxfToGL (SCE_TexData_GetPixelFormat (d));
     glCompressedTexSubImage3D (SCE_TexData_GetTarget (d),
@@ -1024,67 +1649,36 @@ static void SCE_RMakeTexture3DCompUp (SCE_STexData *d)
                                SCE_TexData_GetHeight (d),
                                SCE_TexData_GetDepth (d),
                                pxf, SCE_TexData_GetDataSize (d),
-                               SCE_TexData_GetData (d));
+                               data);
 }
-static void SCE_RMakeTexture1DUp (SCE_STexData *d)
+/* the modified regions are uploaded by SCE_RUploadTextureBox() */
+static void SCE_RMakeTexture1DUp (SCE_RTexture *tex, SCE_STexData *d,
+                                  const void *data)
 {
     int fmt = SCE_RSCEImgFormatToGL (SCE_TexData_GetDataFormat (d));
-    if (SCE_TexData_IsModified (d)) {
-        int x, w;
-        SCE_TexData_GetModified1 (d, &x, &w);
-        glTexSubImage1D (SCE_TexData_GetTarget(d),SCE_TexData_GetMipmapLevel(d),
-                         x, w, fmt,
-                         sce_rgltypes[SCE_TexData_GetDataType (d)],
-                         SCE_TexData_GetData (d));
-        SCE_TexData_Unmofidied (d);
-    } else {
-        glTexSubImage1D (SCE_TexData_GetTarget(d),SCE_TexData_GetMipmapLevel(d),
-                         0, SCE_TexData_GetWidth (d), fmt,
-                         sce_rgltypes[SCE_TexData_GetDataType (d)],
-                         SCE_TexData_GetData (d));
-    }
+    glTexSubImage1D (SCE_TexData_GetTarget(d),SCE_TexData_GetMipmapLevel(d),
+                     0, SCE_TexData_GetWidth (d), fmt,
+                     sce_rgltypes[SCE_TexData_GetDataType (d)],
+                     data);
 }
-static void SCE_RMakeTexture2DUp (SCE_STexData *d)
+static void SCE_RMakeTexture2DUp (SCE_RTexture *tex, SCE_STexData *d,
+                                  const void *data)
 {
     int fmt = SCE_RSCEImgFormatToGL (SCE_TexData_GetDataFormat (d));
-    if (SCE_TexData_IsModified (d)) {
-        int x, y, w, h;
-        SCE_TexData_GetModified2 (d, &x, &y, &w, &h);
-        glTexSubImage2D (SCE_TexData_GetTarget(d),SCE_TexData_GetMipmapLevel(d),
-                         x, y, w, h, fmt,
-                         sce_rgltypes[SCE_TexData_GetDataType (d)],
-                         SCE_TexData_GetData (d));
-        SCE_TexData_Unmofidied (d);
-    } else {
-        glTexSubImage2D (SCE_TexData_GetTarget(d),SCE_TexData_GetMipmapLevel(d),
-                         0,0, SCE_TexData_GetWidth(d), SCE_TexData_GetHeight(d),
-                         fmt, sce_rgltypes[SCE_TexData_GetDataType (d)],
-                         SCE_TexData_GetData (d));
-    }
+    glTexSubImage2D (SCE_TexData_GetTarget(d),SCE_TexData_GetMipmapLevel(d),
+                     0,0, SCE_TexData_GetWidth(d), SCE_TexData_GetHeight(d),
+                     fmt, sce_rgltypes[SCE_TexData_GetDataType (d)],
+                     data);
 }
-static void SCE_RMakeTexture3DUp (SCE_STexData *t)
+static void SCE_RMakeTexture3DUp (SCE_RTexture *tex, SCE_STexData *t,
+                                  const void *data)
 {
     int fmt = SCE_RSCEImgFormatToGL (SCE_TexData_GetDataFormat (t));
-#if 0
-    if (SCE_TexData_IsModified (t) && 0) {
-        int x, y, z, w, h, d;
-        SCE_TexData_GetModified3 (t, &x, &y, &z, &w, &h, &d);
-        glTexSubImage3D (SCE_TexData_GetTarget(t),SCE_TexData_GetMipmapLevel(t),
-                         x, y, z, w, h, d, fmt,
-                         sce_rgltypes[SCE_TexData_GetDataType (t)],
-                         SCE_TexData_GetData (t));
-        SCE_TexData_Unmofidied (t);
-    } else
-#endif
-    {
-        /* scumbag yno doesnt always update, but when he does he makes
-           sure there's nothing to update */
-        glTexSubImage3D (SCE_TexData_GetTarget(t),SCE_TexData_GetMipmapLevel(t),
-                         0, 0, 0, SCE_TexData_GetWidth (t),
-                         SCE_TexData_GetHeight (t), SCE_TexData_GetDepth (t),
-                         fmt, sce_rgltypes[SCE_TexData_GetDataType (t)],
-                         SCE_TexData_GetData (t));
-    }
+    glTexSubImage3D (SCE_TexData_GetTarget(t),SCE_TexData_GetMipmapLevel(t),
+                     0, 0, 0, SCE_TexData_GetWidth (t),
+                     SCE_TexData_GetHeight (t), SCE_TexData_GetDepth (t),
+                     fmt, sce_rgltypes[SCE_TexData_GetDataType (t)],
+                     data);
 }
 /* determine quelle fonction utiliser pour le stockage des donnees */
 static SCE_RMakeTextureFunc
@@ -1109,34 +1703,555 @@ SCE_RGetMakeTextureFunc (int type, int comp, int texsub)
     /* NOTE: make may be NULL here */
     return make;
 }
+/* uploads a region of an image, the whole image lies in client memory */
+static void SCE_RUploadTextureBox (SCE_RTexture *tex, SCE_STexData *d,
+                                   const SCE_RTextureBox *b)
+{
+    const unsigned char *data = SCE_TexData_GetData (d);
+    SCEenum target = SCE_TexData_GetTarget (d);
+    int level = SCE_TexData_GetMipmapLevel (d);
+    int w = MAX (SCE_TexData_GetWidth (d), 1);
+    int h = MAX (SCE_TexData_GetHeight (d), 1);
+    SCE_RBlockFormat bc;
+
+    if (!data)
+        return;
+    if (SCE_TexData_IsCompressed (d) && (tex->target == SCE_TEX_1D ||
+        !SCE_RGetPxfBlockFormat (SCE_TexData_GetPixelFormat (d), &bc))) {
+        /* the box covers the whole level */
+        SCE_RGetMakeTextureFunc (tex->target, SCE_TRUE, SCE_TRUE) (tex, d,
+                                                                    data);
+    } else if (SCE_TexData_IsCompressed (d)) {
+        /* blocks rows of the box aren't contiguous, gather them */
+        size_t bs = SCE_RGetCompressedSize (4, 4, bc);
+        int bw = (w + 3) / 4, bh = (h + 3) / 4;
+        int nx = (b->w + 3) / 4, ny = (b->h + 3) / 4;
+        int pxf = SCE_RSCEPxfToGL (SCE_TexData_GetPixelFormat (d));
+        size_t size = bs * nx * ny * b->d;
+        unsigned char *buf = NULL;
+        int y, z;
+
+        if (!(buf = SCE_malloc (size))) {
+            SCEE_LogSrc ();
+            return;
+        }
+        for (z = 0; z < b->d; z++) {
+            for (y = 0; y < ny; y++) {
+                memcpy (&buf[((size_t)z * ny + y) * nx * bs],
+                        &data[(((size_t)(b->z + z) * bh + b->y / 4 + y) * bw +
+                               b->x / 4) * bs], nx * bs);
+            }
+        }
+        if (tex->target == SCE_TEX_3D || tex->target == SCE_TEX_2D_ARRAY)
+            glCompressedTexSubImage3D (target, level, b->x, b->y, b->z,
+                                       b->w, b->h, b->d, pxf, size, buf);
+        else
+            glCompressedTexSubImage2D (target, level, b->x, b->y,
+                                       b->w, b->h, pxf, size, buf);
+        SCE_free (buf);
+    } else {
+        int fmt = SCE_RSCEImgFormatToGL (SCE_TexData_GetDataFormat (d));
+        SCEenum type = sce_rgltypes[SCE_TexData_GetDataType (d)];
+
+        glPixelStorei (GL_UNPACK_ALIGNMENT, 1);
+        glPixelStorei (GL_UNPACK_ROW_LENGTH, w);
+        glPixelStorei (GL_UNPACK_IMAGE_HEIGHT, h);
+        glPixelStorei (GL_UNPACK_SKIP_PIXELS, b->x);
+        glPixelStorei (GL_UNPACK_SKIP_ROWS, b->y);
+        glPixelStorei (GL_UNPACK_SKIP_IMAGES, b->z);
+        switch (tex->target) {
+        case SCE_TEX_1D:
+            glTexSubImage1D (target, level, b->x, b->w, fmt, type, data);
+            break;
+        case SCE_TEX_3D:
+        case SCE_TEX_2D_ARRAY:
+            glTexSubImage3D (target, level, b->x, b->y, b->z, b->w, b->h, b->d,
+                             fmt, type, data);
+            break;
+        default:
+            glTexSubImage2D (target, level, b->x, b->y, b->w, b->h,
+                             fmt, type, data);
+        }
+        glPixelStorei (GL_UNPACK_SKIP_IMAGES, 0);
+        glPixelStorei (GL_UNPACK_SKIP_ROWS, 0);
+        glPixelStorei (GL_UNPACK_SKIP_PIXELS, 0);
+        glPixelStorei (GL_UNPACK_IMAGE_HEIGHT, 0);
+        glPixelStorei (GL_UNPACK_ROW_LENGTH, 0);
+        glPixelStorei (GL_UNPACK_ALIGNMENT, 4);
+    }
+}
+/* are only the dirty boxes uploaded by SCE_RUpdateTexture()? */
+static int SCE_RHasTextureDirtyBoxes (SCE_RTexture *tex)
+{
+    return tex->n_dirty > 0 && !tex->dirty_overflow;
+}
+/* are the levels uploaded right away when streaming progressively? */
+static int SCE_RIsTextureMipTail (SCE_RTexture *tex, SCE_STexData *d)
+{
+    int m = MAX (SCE_TexData_GetWidth (d), SCE_TexData_GetHeight (d));
+    if (tex->target == SCE_TEX_3D)
+        m = MAX (m, SCE_TexData_GetDepth (d));
+    return m <= SCE_TEXTURE_MIP_TAIL_SIZE;
+}
 /* construit une texture avec les infos minimales */
-static void SCE_RMakeTexture (SCEenum textype, SCE_SList *data,
+static void SCE_RMakeTexture (SCE_RTexture *tex, SCE_SList *data,
                               SCEenum target, int use_mipmap, int texsub)
 {
     SCE_SListIterator *it = NULL;
     SCE_STexData *d = NULL;
     SCE_RMakeTextureFunc make = NULL;
+    unsigned int i, level = 0;
+    unsigned int face = target ? target - SCE_TEX_POSX : 0;
 
     SCE_List_ForEach (it, data) {
+        /* the levels dropped by the budget manager stay unallocated */
+        if (level++ < tex->base_level)
+            continue;
         d = SCE_List_GetData (it);
-        make = SCE_RGetMakeTextureFunc (textype, SCE_TexData_IsCompressed (d),
-                                        texsub);
+        make = SCE_RGetMakeTextureFunc (tex->target,
+                                        SCE_TexData_IsCompressed (d), texsub);
         /* si un target specifique a ete specifie */
         if (target != 0)
             SCE_TexData_SetTarget (d, target);
-        make (d);
+        if (texsub && SCE_RHasTextureDirtyBoxes (tex)) {
+            /* small regions, not worth going through the stream */
+            for (i = 0; i < tex->n_dirty; i++) {
+                if (tex->dirty[i].face == face &&
+                    tex->dirty[i].level == level - 1)
+                    SCE_RUploadTextureBox (tex, d, &tex->dirty[i]);
+            }
+        } else if (!SCE_TexData_GetData (d)) {
+            /* no data to update, e.g. render targets with a storage */
+            if (!texsub)
+                make (tex, d, NULL);
+        } else if (tex->stream && !SCE_RIsUploadThread () &&
+                   !(tex->progressive && SCE_RIsTextureMipTail (tex, d)))
+            SCE_RQueueTextureStream (tex->stream, tex, d, texsub);
+        else
+            make (tex, d, SCE_TexData_GetData (d));
         if (!use_mipmap)
             break;
-        /* TODO: penser a generer les niveaux non-existants dans 'data' */
     }
 }
-void SCE_RBuildTexture (SCE_RTexture *tex, int use_mipmap, int hw_mipmap)
+/* number of levels of a complete mipmap chain */
+static unsigned int SCE_RGetMipmapChainLength (int w, int h, int d)
+{
+    unsigned int n = 1;
+    int m = MAX (w, MAX (h, d));
+    while (m > 1) {
+        m /= 2;
+        n++;
+    }
+    return n;
+}
+/* allocates all the levels of a texture at once with glTexStorage*(),
+   returns SCE_FALSE when the texture must use glTexImage*() instead */
+static int SCE_RAllocTextureStorage (SCE_RTexture *tex, int use_mipmap,
+                                     int hw_mipmap)
+{
+    SCE_STexData *d = NULL;
+    SCEenum pxf;
+    int w, h, depth;
+    unsigned int levels = 1;
+
+    if (!SCE_RHasCap (SCE_TEX_STORAGE) ||
+        !SCE_List_HasElements (&tex->data[0]))
+        return SCE_FALSE;
+    d = SCE_List_GetData (SCE_List_GetIterator (&tex->data[0], 0));
+    if (tex->internal_fmt != SCE_IFMT_NONE)
+        pxf = SCE_RInternalFormatToGL (tex->internal_fmt);
+    else if (!(pxf = SCE_RSCEPxfToGLSized (SCE_TexData_GetPixelFormat (d))))
+        return SCE_FALSE;
+    w = MAX (SCE_TexData_GetWidth (d), 1);
+    h = MAX (SCE_TexData_GetHeight (d), 1);
+    depth = MAX (SCE_TexData_GetDepth (d), 1);
+
+    if (use_mipmap) {
+        levels = SCE_RGetMipmapChainLength (w, tex->target == SCE_TEX_1D ? 1:h,
+                                            tex->target == SCE_TEX_3D ? depth:1);
+        /* only the given levels, so that the texture is complete */
+        if (!(hw_mipmap && SCE_RHasCap (SCE_TEX_HW_GEN_MIPMAP)))
+            levels = MIN (levels, SCE_List_GetSize (&tex->data[0]));
+    }
+
+    if (tex->immutable) {
+        if (tex->storage_w == w && tex->storage_h == h &&
+            tex->storage_d == depth && tex->storage_levels == levels &&
+            tex->storage_pxf == pxf)
+            return SCE_TRUE;
+        /* an immutable storage can't be redefined, get a new texture */
+        SCE_RDeleteTextureObject (tex);
+        glGenTextures (1, &tex->id);
+        SCE_RBindTexture (tex);
+        if (!SCE_RHasCap (SCE_SAMPLER_OBJECTS))
+            SCE_RApplySamplerDesc (tex->target, &tex->sampler);
+        tex->immutable = SCE_FALSE;
+    }
+
+    switch (tex->target) {
+    case SCE_TEX_1D:
+        glTexStorage1D (tex->target, levels, pxf, w);
+        break;
+    case SCE_TEX_2D:
+    case SCE_TEX_CUBE:
+        glTexStorage2D (tex->target, levels, pxf, w, h);
+        break;
+    case SCE_TEX_3D:
+    case SCE_TEX_2D_ARRAY:
+        glTexStorage3D (tex->target, levels, pxf, w, h, depth);
+        break;
+    default:
+        return SCE_FALSE;
+    }
+
+    tex->immutable = SCE_TRUE;
+    tex->storage_w = w;
+    tex->storage_h = h;
+    tex->storage_d = depth;
+    tex->storage_levels = levels;
+    tex->storage_pxf = pxf;
+    return SCE_TRUE;
+}
+static int SCE_RGetImageFormatComponents (SCE_EImageFormat fmt)
+{
+    switch (fmt) {
+    case SCE_IMAGE_RED: return 1;
+    case SCE_IMAGE_RG: return 2;
+    case SCE_IMAGE_RGB:
+    case SCE_IMAGE_BGR: return 3;
+    case SCE_IMAGE_RGBA:
+    case SCE_IMAGE_BGRA: return 4;
+    default: return 0;
+    }
+}
+/**
+ * \brief Generates the mipmap levels missing from the data of a texture
+ * \param tex a texture
+ *
+ * Downsamples the last level of each face down to 1x1 with the filter set by
+ * SCE_RSetTextureMipmapFilter(), the new levels are added to the data of
+ * \p tex. Compressed data, 3D textures and formats not supported by
+ * SCE_RDownsampleImage() are left untouched. Called by SCE_RBuildTexture()
+ * when the GL doesn't generate the mipmaps.
+ * \returns SCE_ERROR on error, SCE_OK otherwise
+ */
+int SCE_RGenerateTextureMipmaps (SCE_RTexture *tex)
 {
     unsigned int i, n = 1;
-    SCEenum t;
-    void (*make)(SCEenum, SCE_SList*, SCEenum, int, int) = SCE_RMakeTexture;
+    unsigned char *src = NULL, *dst = NULL;
 
-    t = tex->target;
+    if (tex->target == SCE_TEX_3D)
+        return SCE_OK;
+    if (tex->target == SCE_TEX_CUBE)
+        n = 6;
+
+    for (i = 0; i < n; i++) {
+        SCE_STexData *d = NULL, *next = NULL;
+        SCE_EType type;
+        int n_comps, w, h, layers, l, level;
+        size_t src_size, dst_size;
+
+        if (!SCE_List_HasElements (&tex->data[i]))
+            continue;
+        d = SCE_List_GetData (SCE_List_GetLast (&tex->data[i]));
+        type = SCE_TexData_GetDataType (d);
+        n_comps = SCE_RGetImageFormatComponents (SCE_TexData_GetDataFormat (d));
+        if (SCE_TexData_IsCompressed (d) || !SCE_TexData_GetData (d) ||
+            !SCE_RIsMipmapFormatSupported (n_comps, type))
+            continue;
+
+        w = MAX (SCE_TexData_GetWidth (d), 1);
+        h = MAX (SCE_TexData_GetHeight (d), 1);
+        layers = 1;
+        if (tex->target == SCE_TEX_2D_ARRAY)
+            layers = MAX (SCE_TexData_GetDepth (d), 1);
+        level = SCE_List_GetSize (&tex->data[i]);
+
+        while (w > 1 || h > 1) {
+            int dw = MAX (w / 2, 1), dh = MAX (h / 2, 1);
+
+            src = SCE_TexData_GetData (d);
+            src_size = SCE_RGetMipmapLevelSize (w, h, n_comps, type);
+            dst_size = SCE_RGetMipmapLevelSize (dw, dh, n_comps, type);
+            if (!(dst = SCE_malloc (dst_size * layers)))
+                goto fail;
+            for (l = 0; l < layers; l++) {
+                if (SCE_RDownsampleImage (&src[l * src_size], w, h, n_comps,
+                                          type, tex->mipmap_filter, tex->srgb,
+                                          &dst[l * dst_size]) < 0)
+                    goto fail;
+            }
+
+            if (!(next = SCE_TexData_Create ()))
+                goto fail;
+            SCE_TexData_SetDimensions (next, dw,
+                                       SCE_TexData_GetHeight (d) ? dh : 0,
+                                       SCE_TexData_GetDepth (d));
+            SCE_TexData_SetPixelFormat (next, SCE_TexData_GetPixelFormat (d));
+            SCE_TexData_SetDataType (next, type);
+            SCE_TexData_SetDataFormat (next, SCE_TexData_GetDataFormat (d));
+            SCE_TexData_SetTarget (next, SCE_TexData_GetTarget (d));
+            SCE_TexData_SetMipmapLevel (next, level++);
+            SCE_TexData_SetData (next, dst, SCE_TRUE);
+            dst = NULL;
+            SCE_List_Appendl (&tex->data[i], SCE_TexData_GetIterator (next));
+
+            d = next;
+            w = dw;
+            h = dh;
+        }
+    }
+    return SCE_OK;
+fail:
+    SCE_free (dst);
+    SCEE_LogSrc ();
+    return SCE_ERROR;
+}
+/**
+ * \brief Converts the data of a texture into the format it is uploaded in
+ * \param tex a texture
+ *
+ * Converts every uncompressed level to the format and type set by
+ * SCE_RSetTextureConversion(), does nothing if no conversion was set.
+ * Called by SCE_RBuildTexture(), the formats not supported by
+ * SCE_RConvertImage() are left untouched.
+ * \returns SCE_ERROR on error, SCE_OK otherwise
+ */
+int SCE_RConvertTexture (SCE_RTexture *tex)
+{
+    unsigned int i;
+    SCE_SListIterator *it = NULL;
+
+    if (tex->conv_fmt == SCE_IMAGE_NONE && tex->conv_type == SCE_NONE_TYPE &&
+        !(tex->conv_flags & SCE_CONVERT_PREMULTIPLY))
+        return SCE_OK;
+
+    for (i = 0; i < 6; i++) {
+        SCE_List_ForEach (it, &tex->data[i]) {
+            SCE_STexData *d = SCE_List_GetData (it);
+            SCE_EImageFormat sfmt = SCE_TexData_GetDataFormat (d), dfmt;
+            SCE_EType stype = SCE_TexData_GetDataType (d), dtype;
+            int w = MAX (SCE_TexData_GetWidth (d), 1);
+            int h = MAX (SCE_TexData_GetHeight (d), 1);
+            int depth = MAX (SCE_TexData_GetDepth (d), 1);
+            unsigned char *dst = NULL;
+
+            if (SCE_TexData_IsCompressed (d) || !SCE_TexData_GetData (d))
+                continue;
+            dfmt = tex->conv_fmt != SCE_IMAGE_NONE ? tex->conv_fmt : sfmt;
+            dtype = tex->conv_type != SCE_NONE_TYPE ? tex->conv_type : stype;
+            if ((dfmt == sfmt && dtype == stype &&
+                 !(tex->conv_flags & SCE_CONVERT_PREMULTIPLY)) ||
+                !SCE_RIsConversionSupported (sfmt, stype, dfmt, dtype))
+                continue;
+
+            /* layers and slices are rows too */
+            if (!(dst = SCE_malloc (SCE_RGetConvertedImageSize (w, h * depth,
+                                                                dfmt, dtype))))
+                goto fail;
+            if (SCE_RConvertImage (SCE_TexData_GetData (d), sfmt, stype, w,
+                                   h * depth, dfmt, dtype, tex->conv_flags,
+                                   dst) < 0) {
+                SCE_free (dst);
+                goto fail;
+            }
+            SCE_TexData_SetDataFormat (d, dfmt);
+            SCE_TexData_SetDataType (d, dtype);
+            SCE_TexData_SetData (d, dst, SCE_TRUE);
+        }
+    }
+    /* the data is premultiplied now */
+    tex->conv_flags &= ~SCE_CONVERT_PREMULTIPLY;
+    return SCE_OK;
+fail:
+    SCEE_LogSrc ();
+    return SCE_ERROR;
+}
+/**
+ * \brief Compresses the data of a texture
+ * \param tex a texture
+ *
+ * Encodes every uncompressed 8 bits level of \p tex into the format set by
+ * SCE_RSetTextureCompression(). Called by SCE_RBuildTexture(), does nothing
+ * if the GL doesn't support the format, or for 1D and 3D textures which the
+ * block formats can't be used with.
+ * \returns SCE_ERROR on error, SCE_OK otherwise
+ */
+int SCE_RCompressTexture (SCE_RTexture *tex)
+{
+    unsigned int i;
+    SCE_RBlockFormat bc;
+    SCE_RCap cap;
+    SCE_SListIterator *it = NULL;
+
+    if (!SCE_RGetPxfBlockFormat (tex->compression, &bc))
+        return SCE_OK;
+    /* S3TC and RGTC only apply to 2D images, arrays and cube maps */
+    if (tex->target == SCE_TEX_1D || tex->target == SCE_TEX_3D)
+        return SCE_OK;
+    switch (bc) {
+    case SCE_BC1: cap = SCE_TEX_DXT1; break;
+    case SCE_BC2: cap = SCE_TEX_DXT3; break;
+    case SCE_BC3: cap = SCE_TEX_DXT5; break;
+    default: cap = SCE_TEX_3DC;
+    }
+    if (!SCE_RHasCap (cap)) {
+        SCEE_SendMsg ("SCERTexture: compressed format %d isn't supported\n",
+                      (int)tex->compression);
+        return SCE_OK;
+    }
+
+    for (i = 0; i < 6; i++) {
+        SCE_List_ForEach (it, &tex->data[i]) {
+            SCE_STexData *d = SCE_List_GetData (it);
+            int w = MAX (SCE_TexData_GetWidth (d), 1);
+            int h = MAX (SCE_TexData_GetHeight (d), 1);
+            int l, layers = MAX (SCE_TexData_GetDepth (d), 1);
+            size_t src_size, dst_size;
+            unsigned char *src = SCE_TexData_GetData (d), *dst = NULL;
+            SCE_EImageFormat fmt = SCE_TexData_GetDataFormat (d);
+
+            if (SCE_TexData_IsCompressed (d) || !src ||
+                SCE_TexData_GetDataType (d) != SCE_UNSIGNED_BYTE ||
+                !SCE_RGetImageFormatComponents (fmt))
+                continue;
+
+            src_size = (size_t)w * h * SCE_RGetImageFormatComponents (fmt);
+            dst_size = SCE_RGetCompressedSize (w, h, bc);
+            if (!(dst = SCE_malloc (dst_size * layers)))
+                goto fail;
+            for (l = 0; l < layers; l++) {
+                if (SCE_RCompressImage (&src[l * src_size], w, h, fmt, bc,
+                                        tex->compression_quality,
+                                        &dst[l * dst_size]) < 0) {
+                    SCE_free (dst);
+                    goto fail;
+                }
+            }
+            SCE_TexData_SetPixelFormat (d, tex->compression);
+            SCE_TexData_SetData (d, dst, SCE_TRUE);
+        }
+    }
+    return SCE_OK;
+fail:
+    SCEE_LogSrc ();
+    return SCE_ERROR;
+}
+/* bytes an image takes in video memory */
+static size_t SCE_RGetTextureTexDataVRAM (SCE_RTexture *tex, SCE_STexData *d)
+{
+    if (tex->internal_fmt == SCE_IFMT_NONE)
+        return SCE_TexData_GetDataSize (d);
+    return (size_t)MAX (SCE_TexData_GetWidth (d), 1) *
+        MAX (SCE_TexData_GetHeight (d), 1) *
+        MAX (SCE_TexData_GetDepth (d), 1) *
+        SCE_RGetInternalFormatSize (tex->internal_fmt);
+}
+/* bytes of each level allocated by SCE_RBuildTexture(), the levels the GL
+   generates are estimated from the last given one */
+static void SCE_RComputeTextureLevelSizes (SCE_RTexture *tex, int use_mipmap,
+                                           int hw_mipmap)
+{
+    unsigned int i, l, n = 1, levels, data_levels;
+
+    for (l = 0; l < SCE_MAX_TEXTURE_LEVELS; l++)
+        tex->level_size[l] = 0;
+    tex->n_levels = 0;
+    if (!SCE_List_HasElements (&tex->data[0]))
+        return;
+    if (tex->target == SCE_TEX_CUBE)
+        n = 6;
+
+    data_levels = use_mipmap ? SCE_List_GetSize (&tex->data[0]) : 1;
+    data_levels = MIN (data_levels, SCE_MAX_TEXTURE_LEVELS);
+    for (i = 0; i < n; i++) {
+        SCE_SListIterator *it = NULL;
+        l = 0;
+        SCE_List_ForEach (it, &tex->data[i]) {
+            if (l >= data_levels)
+                break;
+            tex->level_size[l++] +=
+                SCE_RGetTextureTexDataVRAM (tex, SCE_List_GetData (it));
+        }
+    }
+
+    levels = data_levels;
+    if (tex->immutable)
+        levels = tex->storage_levels;
+    else if (use_mipmap && hw_mipmap && SCE_RHasCap (SCE_TEX_HW_GEN_MIPMAP)) {
+        SCE_STexData *d = SCE_List_GetData (SCE_List_GetFirst (&tex->data[0]));
+        levels = SCE_RGetMipmapChainLength (
+            SCE_TexData_GetWidth (d),
+            tex->target == SCE_TEX_1D ? 1 : SCE_TexData_GetHeight (d),
+            tex->target == SCE_TEX_3D ? SCE_TexData_GetDepth (d) : 1);
+    }
+    levels = MIN (levels, SCE_MAX_TEXTURE_LEVELS);
+    for (l = data_levels; l < levels; l++) {
+        size_t s = tex->level_size[l - 1] / (tex->target == SCE_TEX_3D ? 8:4);
+        tex->level_size[l] = MAX (s, 1);
+    }
+    tex->n_levels = levels;
+}
+/* the whole images are uploaded into a new storage */
+static void SCE_RResetTextureModified (SCE_RTexture *tex)
+{
+    unsigned int i;
+    SCE_SListIterator *it = NULL;
+    for (i = 0; i < 6; i++) {
+        SCE_List_ForEach (it, &tex->data[i])
+            SCE_TexData_Unmofidied (SCE_List_GetData (it));
+    }
+}
+/* turns the modified regions of the data into dirty boxes */
+static void SCE_RGatherTextureModified (SCE_RTexture *tex)
+{
+    unsigned int i, level;
+    SCE_SListIterator *it = NULL;
+    for (i = 0; i < 6; i++) {
+        level = 0;
+        SCE_List_ForEach (it, &tex->data[i]) {
+            SCE_STexData *d = SCE_List_GetData (it);
+            int x = 0, y = 0, z = 0, w = 1, h = 1, depth = 1;
+            if (!SCE_TexData_IsModified (d)) {
+                level++;
+                continue;
+            }
+            if (tex->target == SCE_TEX_1D)
+                SCE_TexData_GetModified1 (d, &x, &w);
+            else if (tex->target == SCE_TEX_3D ||
+                     tex->target == SCE_TEX_2D_ARRAY)
+                SCE_TexData_GetModified3 (d, &x, &y, &z, &w, &h, &depth);
+            else
+                SCE_TexData_GetModified2 (d, &x, &y, &w, &h);
+            SCE_RAddTextureDirtyBox (tex, tex->target == SCE_TEX_CUBE ?
+                                     SCE_TEX_POSX + i : 0,
+                                     level++, x, y, z, w, h, depth);
+            SCE_TexData_Unmofidied (d);
+        }
+    }
+}
+/**
+ * \brief Builds a texture from its data
+ * \param tex a texture
+ * \param use_mipmap upload the mipmap levels, -1 to keep the previous setting
+ * \param hw_mipmap let the GL generate the mipmap levels, -1 to keep the
+ *        previous setting
+ *
+ * When GL_ARB_texture_storage is supported and the pixel format of the
+ * texture has a sized equivalent, all the levels are allocated at once with
+ * glTexStorage*() and filled with glTexSubImage*(). Otherwise each level is
+ * allocated by glTexImage*().
+ *
+ * Unless the realization mode is SCE_TEX_REALIZE_NOW, the build of a texture
+ * having pixels is only recorded and done later, see
+ * SCE_RSetTextureRealizeMode().
+ */
+void SCE_RBuildTexture (SCE_RTexture *tex, int use_mipmap, int hw_mipmap)
+{
+    unsigned int i, n = 1;
+    int texsub;
+    void (*make)(SCE_RTexture*, SCE_SList*, SCEenum, int, int) =
+        SCE_RMakeTexture;
 
     if (use_mipmap < 0)
         use_mipmap = tex->use_mipmap;
@@ -1147,56 +2262,83 @@ void SCE_RBuildTexture (SCE_RTexture *tex, int use_mipmap, int hw_mipmap)
     else
         tex->hw_mipmap = hw_mipmap;
 
+    if (SCE_RDeferTextureBuild (tex))
+        return;
+
     if (tex->target == SCE_TEX_CUBE)
         n = 6;
 
+    if (SCE_RConvertTexture (tex) < 0)
+        SCEE_SendMsg ("SCERTexture: failed to convert the texture\n");
+    if (use_mipmap && !(hw_mipmap && SCE_RHasCap (SCE_TEX_HW_GEN_MIPMAP))) {
+        if (SCE_RGenerateTextureMipmaps (tex) < 0)
+            SCEE_SendMsg ("SCERTexture: failed to generate mipmaps\n");
+    }
+    if (tex->compression != SCE_PXF_NONE && SCE_RCompressTexture (tex) < 0)
+        SCEE_SendMsg ("SCERTexture: failed to compress the texture\n");
+
     SCE_RBindTexture (tex);
-    {
-        SCEfloat max;
-        glGetFloatv (GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &max);
-        if (tex->aniso_level > 1.0 - SCE_EPSILONF &&
-            tex->aniso_level < max + SCE_EPSILONF)
-            glTexParameterf (tex->target, GL_TEXTURE_MAX_ANISOTROPY_EXT,
-                             tex->aniso_level);
+    /* everything is uploaded */
+    SCE_RClearTextureDirtyBoxes (tex);
+    if (tex->base_level) {
+        /* the dropped levels are uploaded again */
+        tex->base_level = 0;
+        glTexParameteri (tex->target, GL_TEXTURE_BASE_LEVEL, 0);
     }
+    if ((texsub = SCE_RAllocTextureStorage (tex, use_mipmap, hw_mipmap)))
+        SCE_RResetTextureModified (tex);
+    if (tex->aniso_level > 1.0 - SCE_EPSILONF &&
+        tex->aniso_level < SCE_RGetMaxAnisotropy () + SCE_EPSILONF)
+        SCE_RSetTextureSamplerAnisotropy (tex, tex->aniso_level);
     if (use_mipmap) {
         if (hw_mipmap && SCE_RHasCap (SCE_TEX_HW_GEN_MIPMAP)) {
             SCE_RSetTextureParam (tex, GL_GENERATE_MIPMAP_SGIS, SCE_TRUE);
             for (i = 0; i < n; i++)
-                make (t, &tex->data[i], (n > 1 ? SCE_TEX_POSX+i:0),
-                      SCE_FALSE, SCE_FALSE);
+                make (tex, &tex->data[i], (n > 1 ? SCE_TEX_POSX+i:0),
+                      SCE_FALSE, texsub);
         } else {
             if (hw_mipmap)
                 SCEE_SendMsg ("SCERTexture: hardware mipmap "
                               "generation isn't supported");
             for (i = 0; i < n; i++)
-                make (t, &tex->data[i], (n > 1 ? SCE_TEX_POSX+i : 0),
-                      SCE_TRUE, SCE_FALSE);
+                make (tex, &tex->data[i], (n > 1 ? SCE_TEX_POSX+i : 0),
+                      SCE_TRUE, texsub);
         }
         /* SCE_RSetTextureParam (tex, GL_TEXTURE_MAX_LEVEL, max_mipmap_level);*/
         SCE_RSetTextureFilter (tex, SCE_TEX_TRILINEAR);
     } else {
         for (i = 0; i < n; i++)
-            make (t, &tex->data[i], (n > 1 ? SCE_TEX_POSX + i : 0),
-                  SCE_FALSE, SCE_FALSE);
+            make (tex, &tex->data[i], (n > 1 ? SCE_TEX_POSX + i : 0),
+                  SCE_FALSE, texsub);
         SCE_RSetTextureParam (tex, GL_TEXTURE_MAX_LEVEL, 0);
     }
 
     SCE_RPixelizeTexture (tex, SCE_FALSE);
+    SCE_RComputeTextureLevelSizes (tex, use_mipmap, hw_mipmap);
+    /* the rendering thread tracks it once the upload is done */
+    if (!SCE_RIsUploadThread ())
+        SCE_RTrackTexture (tex);
+    /* the GL has its own copy, unless the uploads are still queued */
+    if (tex->file && !tex->pending)
+        SCE_RReleaseTextureFile (tex);
 }
 
 
 /**
- * \brief 
- * \param 
+ * \brief Uploads the data of a texture into its existing storage
+ * \param tex a texture
+ * \param use_mipmap see SCE_RBuildTexture()
+ * \param hw_mipmap see SCE_RBuildTexture()
+ *
+ * When dirty boxes were added, only those regions are sent, otherwise all
+ * the levels are. The modified region of a SCE_STexData counts as a box.
+ * \sa SCE_RAddTextureDirtyBox()
  */
 void SCE_RUpdateTexture (SCE_RTexture *tex, int use_mipmap, int hw_mipmap)
 {
     unsigned int i, n = 1;
-    SCEenum t;
-    void (*make)(SCEenum, SCE_SList*, SCEenum, int, int) = SCE_RMakeTexture;
-
-    t = tex->target;
+    void (*make)(SCE_RTexture*, SCE_SList*, SCEenum, int, int) =
+        SCE_RMakeTexture;
 
     if (use_mipmap < 0)
         use_mipmap = tex->use_mipmap;
@@ -1207,33 +2349,386 @@ void SCE_RUpdateTexture (SCE_RTexture *tex, int use_mipmap, int hw_mipmap)
     else
         tex->hw_mipmap = hw_mipmap;
 
+    /* everything is uploaded when the texture is realized */
+    if (tex->unrealized) {
+        SCE_RClearTextureDirtyBoxes (tex);
+        return;
+    }
+
     if (tex->target == SCE_TEX_CUBE)
         n = 6;
 
+    SCE_RGatherTextureModified (tex);
     SCE_RBindTexture (tex);
     /* this code is just the same as the one in SCE_RBuildTexture() */
     if (use_mipmap) {
         if (hw_mipmap && SCE_RHasCap (SCE_TEX_HW_GEN_MIPMAP)) {
             SCE_RSetTextureParam (tex, GL_GENERATE_MIPMAP_SGIS, SCE_TRUE);
             for (i = 0; i < n; i++)
-                make (t, &tex->data[i], (n > 1 ? SCE_TEX_POSX+i:0),
+                make (tex, &tex->data[i], (n > 1 ? SCE_TEX_POSX+i:0),
                       SCE_FALSE, SCE_TRUE);
         } else {
             if (hw_mipmap)
                 SCEE_SendMsg ("SCERTexture: hardware mipmap "
                               "generation isn't supported");
             for (i = 0; i < n; i++)
-                make (t, &tex->data[i], (n > 1 ? SCE_TEX_POSX+i : 0),
+                make (tex, &tex->data[i], (n > 1 ? SCE_TEX_POSX+i : 0),
                       SCE_TRUE, SCE_TRUE);
         }
         /* SCE_RSetTextureParam (tex, GL_TEXTURE_MAX_LEVEL, max_mipmap_level);*/
         SCE_RSetTextureFilter (tex, SCE_TEX_TRILINEAR);
     } else {
         for (i = 0; i < n; i++)
-            make (t, &tex->data[i], (n > 1 ? SCE_TEX_POSX + i : 0),
+            make (tex, &tex->data[i], (n > 1 ? SCE_TEX_POSX + i : 0),
                   SCE_FALSE, SCE_TRUE);
         SCE_RSetTextureParam (tex, GL_TEXTURE_MAX_LEVEL, 0);
     }
+    SCE_RClearTextureDirtyBoxes (tex);
+}
+
+/**
+ * \brief Uploads one image of a texture
+ * \param tex a texture
+ * \param d an image of \p tex, its target must be set
+ * \param texsub update (TRUE) or allocate (FALSE) the image
+ * \param data pixels of \p d, or an offset in the bound pixel unpack buffer
+ * \sa SCE_RStreamTexture()
+ */
+void SCE_RUploadTextureTexData (SCE_RTexture *tex, SCE_STexData *d, int texsub,
+                                const void *data)
+{
+    SCE_RMakeTextureFunc make = NULL;
+    make = SCE_RGetMakeTextureFunc (tex->target, SCE_TexData_IsCompressed (d),
+                                    texsub);
+    SCE_RBindTexture (tex);
+    make (tex, d, data);
+}
+
+
+static long SCE_RGetTextureBoxVolume (const SCE_RTextureBox *b)
+{
+    return (long)b->w * b->h * b->d;
+}
+/* do the boxes overlap or touch? */
+static int SCE_RTouchTextureBoxes (const SCE_RTextureBox *a,
+                                   const SCE_RTextureBox *b)
+{
+    return a->face == b->face && a->level == b->level &&
+        a->x <= b->x + b->w && b->x <= a->x + a->w &&
+        a->y <= b->y + b->h && b->y <= a->y + a->h &&
+        a->z <= b->z + b->d && b->z <= a->z + a->d;
+}
+static void SCE_RMergeTextureBoxes (SCE_RTextureBox *a,
+                                    const SCE_RTextureBox *b)
+{
+    int x1 = MAX (a->x + a->w, b->x + b->w);
+    int y1 = MAX (a->y + a->h, b->y + b->h);
+    int z1 = MAX (a->z + a->d, b->z + b->d);
+    a->x = MIN (a->x, b->x);
+    a->y = MIN (a->y, b->y);
+    a->z = MIN (a->z, b->z);
+    a->w = x1 - a->x;
+    a->h = y1 - a->y;
+    a->d = z1 - a->z;
+}
+
+/**
+ * \brief Marks a region of a texture as modified
+ * \param tex a texture
+ * \param face cube face (ignored if \p tex is not a cubemap)
+ * \param level mipmap level
+ * \param x,y,z origin of the region, in pixels
+ * \param w,h,d size of the region, 1 for the unused dimensions
+ *
+ * The next SCE_RUpdateTexture() uploads only the marked regions, straight
+ * from the data of \p tex with the GL_UNPACK_* row and image parameters.
+ * The region is clamped to the level, and grown to whole 4x4 blocks for
+ * compressed formats. Overlapping or touching regions are merged; beyond
+ * #SCE_MAX_TEXTURE_DIRTY_BOXES regions, the new one is merged into the box
+ * of the same level that grows the least, or the whole texture is uploaded
+ * if there is none.
+ * \returns SCE_ERROR on error, SCE_OK otherwise
+ */
+int SCE_RAddTextureDirtyBox (SCE_RTexture *tex, SCE_RTexCubeFace face,
+                             int level, int x, int y, int z, int w, int h,
+                             int d)
+{
+    SCE_STexData *data = NULL;
+    SCE_RTextureBox box;
+    SCE_RBlockFormat bc;
+    SCEenum target;
+    int tw, th, td, x1, y1, z1;
+    unsigned int i, best;
+    long cost, best_cost = 0;
+
+    i = SCE_RGetTextureTargetID (tex, face, &target);
+    if (level < 0 || level >= SCE_List_GetSize (&tex->data[i])) {
+        SCEE_Log (SCE_INVALID_ARG);
+        SCEE_LogMsg ("the texture has no level %d", level);
+        return SCE_ERROR;
+    }
+    if (tex->dirty_overflow)
+        return SCE_OK;
+
+    data = SCE_List_GetData (SCE_List_GetIterator (&tex->data[i], level));
+    tw = MAX (SCE_TexData_GetWidth (data), 1);
+    th = MAX (SCE_TexData_GetHeight (data), 1);
+    td = MAX (SCE_TexData_GetDepth (data), 1);
+    x1 = MIN (x + w, tw); y1 = MIN (y + h, th); z1 = MIN (z + d, td);
+    x = MAX (x, 0); y = MAX (y, 0); z = MAX (z, 0);
+    if (x >= x1 || y >= y1 || z >= z1)
+        return SCE_OK;
+    if (SCE_RGetPxfBlockFormat (SCE_TexData_GetPixelFormat (data), &bc)) {
+        x &= ~3; y &= ~3;
+        x1 = MIN ((x1 + 3) & ~3, tw);
+        y1 = MIN ((y1 + 3) & ~3, th);
+    } else if (SCE_TexData_IsCompressed (data)) {
+        /* unknown block size, take the whole level */
+        x = y = z = 0;
+        x1 = tw; y1 = th; z1 = td;
+    }
+    box.face = i;
+    box.level = level;
+    box.x = x; box.y = y; box.z = z;
+    box.w = x1 - x; box.h = y1 - y; box.d = z1 - z;
+
+    if (!tex->dirty &&
+        !(tex->dirty = SCE_malloc (SCE_MAX_TEXTURE_DIRTY_BOXES *
+                                   sizeof *tex->dirty))) {
+        SCEE_LogSrc ();
+        return SCE_ERROR;
+    }
+    /* the union may touch boxes the original region didn't */
+    for (i = 0; i < tex->n_dirty;) {
+        if (SCE_RTouchTextureBoxes (&box, &tex->dirty[i])) {
+            SCE_RMergeTextureBoxes (&box, &tex->dirty[i]);
+            tex->dirty[i] = tex->dirty[--tex->n_dirty];
+            i = 0;
+        } else
+            i++;
+    }
+    if (tex->n_dirty < SCE_MAX_TEXTURE_DIRTY_BOXES) {
+        tex->dirty[tex->n_dirty++] = box;
+        return SCE_OK;
+    }
+
+    best = SCE_MAX_TEXTURE_DIRTY_BOXES;
+    for (i = 0; i < tex->n_dirty; i++) {
+        SCE_RTextureBox u = tex->dirty[i];
+        if (u.face != box.face || u.level != box.level)
+            continue;
+        SCE_RMergeTextureBoxes (&u, &box);
+        cost = SCE_RGetTextureBoxVolume (&u) -
+            SCE_RGetTextureBoxVolume (&tex->dirty[i]);
+        if (best == SCE_MAX_TEXTURE_DIRTY_BOXES || cost < best_cost) {
+            best = i;
+            best_cost = cost;
+        }
+    }
+    if (best < SCE_MAX_TEXTURE_DIRTY_BOXES)
+        SCE_RMergeTextureBoxes (&tex->dirty[best], &box);
+    else
+        tex->dirty_overflow = SCE_TRUE;
+    return SCE_OK;
+}
+/**
+ * \brief Gets the number of regions the next update will upload, 0 when
+ * the whole texture will be
+ */
+unsigned int SCE_RGetNumTextureDirtyBoxes (const SCE_RTexture *tex)
+{
+    return tex->dirty_overflow ? 0 : tex->n_dirty;
+}
+/**
+ * \brief Forgets the regions added by SCE_RAddTextureDirtyBox()
+ */
+void SCE_RClearTextureDirtyBoxes (SCE_RTexture *tex)
+{
+    tex->n_dirty = 0;
+    tex->dirty_overflow = SCE_FALSE;
+}
+
+/**
+ * \brief Checks whether all the data of a texture have been uploaded
+ * \returns FALSE while uploads queued by SCE_RStreamTexture() are not done,
+ * or while the texture isn't realized, see SCE_RIsTextureRealized()
+ */
+int SCE_RIsTextureResident (SCE_RTexture *tex)
+{
+    return tex->pending == 0 && !tex->unrealized;
+}
+
+/**
+ * \brief Gets the video memory used by the resident levels of a texture
+ * \returns the size in bytes, estimated from the data of the texture
+ * \sa SCE_RGetTextureFullVRAM(), SCE_RSetTextureBaseLevel()
+ */
+size_t SCE_RGetTextureUsedVRAM (const SCE_RTexture *tex)
+{
+    size_t size = 0;
+    unsigned int i;
+    for (i = tex->base_level; i < tex->n_levels; i++)
+        size += tex->level_size[i];
+    return size;
+}
+/**
+ * \brief Gets the video memory a texture uses with all its levels resident
+ */
+size_t SCE_RGetTextureFullVRAM (const SCE_RTexture *tex)
+{
+    size_t size = 0;
+    unsigned int i;
+    for (i = 0; i < tex->n_levels; i++)
+        size += tex->level_size[i];
+    return size;
+}
+
+/* number of leading levels of every face having their pixels in memory */
+static unsigned int SCE_RGetTextureDataLevels (SCE_RTexture *tex)
+{
+    unsigned int i, n = 1, levels = SCE_MAX_TEXTURE_LEVELS;
+    if (tex->target == SCE_TEX_CUBE)
+        n = 6;
+    for (i = 0; i < n; i++) {
+        SCE_SListIterator *it = NULL;
+        unsigned int l = 0;
+        SCE_List_ForEach (it, &tex->data[i]) {
+            if (!SCE_TexData_GetData (SCE_List_GetData (it)))
+                break;
+            l++;
+        }
+        levels = MIN (levels, l);
+    }
+    return levels;
+}
+/* can SCE_RGenerateTextureMipmaps() add the missing levels? */
+static int SCE_RCanGenerateTextureMipmaps (SCE_RTexture *tex)
+{
+    SCE_STexData *d = NULL;
+    if (tex->target == SCE_TEX_3D)
+        return SCE_FALSE;
+    d = SCE_List_GetData (SCE_List_GetLast (&tex->data[0]));
+    return !SCE_TexData_IsCompressed (d) &&
+        SCE_RIsMipmapFormatSupported (
+            SCE_RGetImageFormatComponents (SCE_TexData_GetDataFormat (d)),
+            SCE_TexData_GetDataType (d));
+}
+/**
+ * \brief Gets the highest level a texture can be reduced to
+ *
+ * Dropped levels are uploaded again from the data of the texture, so only
+ * the levels whose pixels are in memory, or can be generated from them, can
+ * be dropped.
+ * \returns the level, 0 if the texture can't be reduced
+ * \sa SCE_RSetTextureBaseLevel()
+ */
+unsigned int SCE_RGetTextureMaxBaseLevel (SCE_RTexture *tex)
+{
+    unsigned int levels;
+
+    if (!tex->use_mipmap || tex->pending || tex->n_levels < 2)
+        return 0;
+    levels = SCE_RGetTextureDataLevels (tex);
+    if (levels == 0)
+        return 0;
+    if (levels < tex->n_levels && SCE_RCanGenerateTextureMipmaps (tex))
+        levels = tex->n_levels;
+    return MIN (levels, tex->n_levels) - 1;
+}
+
+/* replaces the GL texture by a new one with the same parameters */
+static void SCE_RRecreateTexture (SCE_RTexture *tex)
+{
+    SCE_RDeleteTextureObject (tex);
+    glGenTextures (1, &tex->id);
+    SCE_RBindTexture (tex);
+    if (!SCE_RHasCap (SCE_SAMPLER_OBJECTS))
+        SCE_RApplySamplerDesc (tex->target, &tex->sampler);
+    glTexParameteri (tex->target, GL_TEXTURE_MAX_LEVEL, tex->n_levels - 1);
+    tex->immutable = SCE_FALSE;
+}
+/* releases the memory of a level of a mutable texture */
+static void SCE_RFreeTextureLevel (SCE_RTexture *tex, SCEenum target,
+                                   int level)
+{
+    switch (tex->target) {
+    case SCE_TEX_1D:
+        glTexImage1D (target, level, GL_RGBA, 0, 0, GL_RGBA,
+                      GL_UNSIGNED_BYTE, NULL);
+        break;
+    case SCE_TEX_2D:
+    case SCE_TEX_CUBE:
+        glTexImage2D (target, level, GL_RGBA, 0, 0, 0, GL_RGBA,
+                      GL_UNSIGNED_BYTE, NULL);
+        break;
+    default:
+        glTexImage3D (target, level, GL_RGBA, 0, 0, 0, 0, GL_RGBA,
+                      GL_UNSIGNED_BYTE, NULL);
+    }
+}
+/**
+ * \brief Drops or restores the highest resolution levels of a texture
+ * \param tex a built texture
+ * \param base first level to keep resident, at most
+ *        SCE_RGetTextureMaxBaseLevel()
+ *
+ * The levels below \p base are released and GL_TEXTURE_BASE_LEVEL clamps
+ * the sampling to the remaining ones; lowering \p base uploads the levels
+ * again from the data of \p tex. A storage allocated by glTexStorage*()
+ * can't release its levels, so the first reduction replaces it by a mutable
+ * texture. Used by the texture budget manager.
+ * \returns SCE_ERROR on error, SCE_OK otherwise
+ * \sa SCE_RUpdateTextureBudget()
+ */
+int SCE_RSetTextureBaseLevel (SCE_RTexture *tex, unsigned int base)
+{
+    unsigned int i, n = 1, old = tex->base_level;
+    int recreated = SCE_FALSE;
+
+    if (base == old)
+        return SCE_OK;
+    if (base > SCE_RGetTextureMaxBaseLevel (tex)) {
+        SCEE_Log (SCE_INVALID_ARG);
+        SCEE_LogMsg ("the texture can't be reduced to its level %u", base);
+        return SCE_ERROR;
+    }
+    if (base >= SCE_RGetTextureDataLevels (tex) &&
+        SCE_RGenerateTextureMipmaps (tex) < 0) {
+        SCEE_LogSrc ();
+        return SCE_ERROR;
+    }
+    if (tex->target == SCE_TEX_CUBE)
+        n = 6;
+
+    if (tex->immutable) {
+        SCE_RRecreateTexture (tex);
+        /* nothing is allocated anymore */
+        old = tex->n_levels;
+        recreated = SCE_TRUE;
+    } else
+        SCE_RBindTexture (tex);
+
+    for (i = 0; i < n; i++) {
+        SCE_SListIterator *it = NULL;
+        unsigned int l = 0;
+        SCE_List_ForEach (it, &tex->data[i]) {
+            SCE_STexData *d = SCE_List_GetData (it);
+            if (l >= base && l < old) {
+                SCE_RMakeTextureFunc make = SCE_RGetMakeTextureFunc (
+                    tex->target, SCE_TexData_IsCompressed (d), SCE_FALSE);
+                make (tex, d, SCE_TexData_GetData (d));
+            } else if (l >= old && l < base)
+                SCE_RFreeTextureLevel (tex, SCE_TexData_GetTarget (d), l);
+            if (++l >= tex->n_levels)
+                break;
+        }
+    }
+    glTexParameteri (tex->target, GL_TEXTURE_BASE_LEVEL, base);
+    /* the levels the GL generated are lost with the old texture */
+    if (recreated && SCE_RGetTextureDataLevels (tex) < tex->n_levels)
+        glGenerateMipmap (tex->target);
+    tex->base_level = base;
+    return SCE_OK;
 }
 
 /**
@@ -1243,64 +2738,95 @@ void SCE_RUpdateTexture (SCE_RTexture *tex, int use_mipmap, int hw_mipmap)
  */
 void SCE_RSetActiveTextureUnit (unsigned int unit)
 {
-    glActiveTexture (SCE_TEX0 + unit);
+    SCE_RActivateTextureUnit (unit);
 }
-
 /**
- * \todo l'organisation des deux prochaines fonctions pue peut-etre :
- *       je suppose qu'il y a un BindTexture a faire pour chaque unite
- *       de texturage, or c'est peut-etre faux... a voir.
- *       et y'a-t-il un glDisable/Enable a faire pour chaque unite ?
+ * \brief Gets the texture unit activated last by the textures manager
  */
+int SCE_RGetActiveTextureUnit (void)
+{
+    return active_unit;
+}
+
 static void SCE_RSetTextureUsed (SCE_RTexture *tex, int unit)
 {
+    SCE_RTexture *prev = texused[unit];
+
     if (tex) {
-        glActiveTexture (SCE_TEX0 + unit);
-        glEnable (tex->target);
-        glBindTexture (tex->target, tex->id);
-        n_textype[tex->type]++;
-        texused[unit] = tex;
+        /* a placeholder may be bound instead */
+        SCEuint id = tex->unrealized ?
+            SCE_RRequestTextureRealization (tex) : tex->id;
+        if (prev != tex) {
+            if (prev)
+                n_textype[prev->type]--;
+            n_textype[tex->type]++;
+            texused[unit] = tex;
+        }
+        SCE_REnableTextureUnit (unit, tex->type, SCE_TRUE);
+        SCE_RBindTextureUnit (unit, tex->type, id);
+        SCE_RMarkTextureUsed (tex);
 #if 0
         nbatchs++;
 #endif
-    } else if (texused[unit]) {
-        glActiveTexture (SCE_TEX0 + unit);
-        glBindTexture (texused[unit]->target, 0);
-        n_textype[texused[unit]->type]--;
-        if (n_textype[texused[unit]->type] <= 0) {
-            n_textype[texused[unit]->type] = 0;
-            glDisable (texused[unit]->target);
+    } else if (prev) {
+        SCE_RBindTextureUnit (unit, prev->type, 0);
+        n_textype[prev->type]--;
+        if (n_textype[prev->type] <= 0) {
+            n_textype[prev->type] = 0;
+            SCE_REnableTextureUnit (unit, prev->type, SCE_FALSE);
         }
         texused[unit] = NULL;
     }
 }
 /**
- * \brief 
- * \param 
- * \todo reviser
+ * \brief Binds a texture to a texture unit
+ * \param tex a texture, NULL to unbind the texture of \p unit
+ * \param unit a texture unit, -1 to unbind the textures of all the units
+ *
+ * The sampler object of the sampling state of \p tex is bound along with
+ * it. The bindings and the enabled targets of every unit are cached, the GL
+ * calls that wouldn't change them are dropped.
+ * \sa SCE_RUseTextureSampler(), SCE_RGetTextureBindCounters()
  */
 void SCE_RUseTexture (SCE_RTexture *tex, int unit)
+{
+    SCE_RUseTextureSampler (tex, NULL, unit);
+}
+/**
+ * \brief Binds a texture to a texture unit with a given sampler
+ * \param tex a texture, NULL to unbind the texture of \p unit
+ * \param sampler the sampler to use, NULL for the one of \p tex
+ * \param unit a texture unit, -1 to unbind the textures of all the units
+ *
+ * Samples \p tex with another state than its own without modifying it.
+ * Without sampler objects support, \p sampler is ignored.
+ * \sa SCE_RUseTexture(), SCE_RGetSampler()
+ */
+void SCE_RUseTextureSampler (SCE_RTexture *tex, SCE_RSampler *sampler,
+                             int unit)
 {
     /* invalid texture unit */
     if (unit >= max_tex_units)
         return;
-    else if (unit >= 0)
+    counters.requested++;
+    if (unit >= 0) {
         SCE_RSetTextureUsed (tex, unit);
-    else {
-        glDisable (SCE_TEX_1D);
-        glDisable (SCE_TEX_2D);
-        glDisable (SCE_TEX_3D);
-        glDisable (SCE_TEX_CUBE);
-
+        if (tex && SCE_RHasCap (SCE_SAMPLER_OBJECTS))
+            SCE_RUseSampler (sampler ? sampler : SCE_RGetTextureSampler (tex),
+                             unit);
+    } else {
+        int i;
+        /* only the units holding something are touched */
         for (unit = 0; unit < max_tex_units; unit++) {
             texused[unit] = NULL;
-            glActiveTexture (SCE_TEX0 + unit);
-            glBindTexture (SCE_TEX_1D, 0);
-            glBindTexture (SCE_TEX_2D, 0);
-            glBindTexture (SCE_TEX_3D, 0);
-            glBindTexture (SCE_TEX_CUBE, 0);
-            /* don't do any glDisable here? */
+            for (i = 0; i < SCE_NUM_TEXTYPE; i++) {
+                SCE_RBindTextureUnit (unit, i, 0);
+                SCE_REnableTextureUnit (unit, i, SCE_FALSE);
+            }
+            SCE_RUseSampler (NULL, unit);
         }
+        for (i = 0; i < SCE_NUM_TEXTYPE; i++)
+            n_textype[i] = 0;
     }
 }
 
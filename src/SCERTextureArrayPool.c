@@ -0,0 +1,508 @@
+/*------------------------------------------------------------------------------
+    SCEngine - A 3D real time rendering engine written in the C language
+    Copyright (C) 2006-2013  Antony Martin <martin(dot)antony(at)yahoo(dot)fr>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/* created: 19/10/2026
+   updated: 19/10/2026 */
+
+#include <string.h>
+#include <GL/glew.h>
+#include <SCE/utils/SCEUtils.h>
+#include "SCE/renderer/SCERType.h"
+#include "SCE/renderer/SCERSupport.h"
+#include "SCE/renderer/SCERTextureArrayPool.h"
+
+/**
+ * \file SCERTextureArrayPool.c
+ * \copydoc texturearraypool
+ *
+ * \file SCERTextureArrayPool.h
+ * \copydoc texturearraypool
+ */
+
+/**
+ * \defgroup texturearraypool Texture array pools
+ * \ingroup renderer-gl
+ * \brief Groups compatible textures into shared 2D array textures
+ *
+ * Textures of the same pixel format, size, number of mipmap levels and
+ * sampling state are copied into the layers of a common 2D array texture,
+ * so that draws of different materials can be merged and select their
+ * texture with a layer index given per draw or per instance. A full array
+ * grows by allocating twice as many layers and copying the old ones on the
+ * GPU, with glCopyImageSubData() or through a pixel buffer otherwise. Once
+ * an array reaches the maximum number of layers, a new one is started.
+ *
+ * Growing replaces the array texture: get it again with
+ * SCE_RGetTextureArrayEntryTexture() rather than keeping it around.
+ * @{
+ */
+
+static void SCE_RFreeTextureArray (void *a)
+{
+    SCE_RTextureArray *array = a;
+    int i;
+    for (i = 0; i < array->capacity; i++)
+        SCE_free (array->entries[i]);
+    SCE_free (array->entries);
+    SCE_RDeleteTexture (array->tex);
+    SCE_free (array);
+}
+
+
+void SCE_RInitTextureArrayPool (SCE_RTextureArrayPool *pool)
+{
+    SCE_List_Init (&pool->arrays);
+    SCE_List_SetFreeFunc (&pool->arrays, SCE_RFreeTextureArray);
+    pool->initial_layers = 8;
+    pool->max_layers = 0;
+    pool->n_grows = 0;
+}
+void SCE_RClearTextureArrayPool (SCE_RTextureArrayPool *pool)
+{
+    SCE_List_Clear (&pool->arrays);
+}
+SCE_RTextureArrayPool* SCE_RCreateTextureArrayPool (void)
+{
+    SCE_RTextureArrayPool *pool = NULL;
+    if (!(pool = SCE_malloc (sizeof *pool)))
+        SCEE_LogSrc ();
+    else
+        SCE_RInitTextureArrayPool (pool);
+    return pool;
+}
+void SCE_RDeleteTextureArrayPool (SCE_RTextureArrayPool *pool)
+{
+    if (pool) {
+        SCE_RClearTextureArrayPool (pool);
+        SCE_free (pool);
+    }
+}
+
+/**
+ * \brief Sets the number of layers of the arrays
+ * \param pool a texture array pool
+ * \param initial layers of a new array, default 8
+ * \param max maximum layers of an array, 0 for the GL limit (default)
+ */
+void SCE_RSetTextureArrayPoolLayers (SCE_RTextureArrayPool *pool,
+                                     int initial, int max)
+{
+    pool->initial_layers = MAX (initial, 1);
+    pool->max_layers = MAX (max, 0);
+}
+
+
+static int SCE_RGetTextureArrayPoolMaxLayers (SCE_RTextureArrayPool *pool)
+{
+    if (!pool->max_layers) {
+        GLint n = 0;
+        glGetIntegerv (GL_MAX_ARRAY_TEXTURE_LAYERS, &n);
+        pool->max_layers = MAX (n, 1);
+    }
+    return pool->max_layers;
+}
+
+/* creates an array texture of the format of an array */
+static SCE_RTexture* SCE_RAllocTextureArray (SCE_RTextureArray *array,
+                                             int layers)
+{
+    SCE_RTexture *tex = NULL;
+    SCEenum fmt = SCE_RSCEImgFormatToGL (array->fmt);
+    SCEenum type = sce_rgltypes[array->type];
+    int w = array->width, h = array->height;
+    unsigned int i;
+
+    if (!(tex = SCE_RCreateTexture (SCE_TEX_2D_ARRAY))) {
+        SCEE_LogSrc ();
+        return NULL;
+    }
+    SCE_RBindTexture (tex);
+    if (SCE_RHasCap (SCE_TEX_STORAGE) &&
+        SCE_RSCEPxfToGLSized (array->pxf)) {
+        glTexStorage3D (tex->target, array->n_levels, array->gl_pxf, w, h,
+                        layers);
+    } else {
+        for (i = 0; i < array->n_levels; i++) {
+            if (array->compressed)
+                glCompressedTexImage3D (tex->target, i, array->gl_pxf, w, h,
+                                        layers, 0,
+                                        array->layer_size[i] * layers, NULL);
+            else
+                glTexImage3D (tex->target, i, array->gl_pxf, w, h, layers,
+                              0, fmt, type, NULL);
+            w = MAX (w / 2, 1);
+            h = MAX (h / 2, 1);
+        }
+    }
+    glTexParameteri (tex->target, GL_TEXTURE_MAX_LEVEL, array->n_levels - 1);
+    tex->sampler = array->sampler;
+    tex->sampler_obj = NULL;
+    if (!SCE_RHasCap (SCE_SAMPLER_OBJECTS))
+        SCE_RApplySamplerDesc (tex->target, &tex->sampler);
+    return tex;
+}
+
+/* bytes of a pixel read back in the format and type of an array */
+static size_t SCE_RGetTextureArrayPixelSize (SCE_RTextureArray *array)
+{
+    size_t n;
+
+    switch (array->fmt) {
+    case SCE_IMAGE_RG:
+    case SCE_IMAGE_RG_INTEGER: n = 2; break;
+    case SCE_IMAGE_RGB:
+    case SCE_IMAGE_BGR:
+    case SCE_IMAGE_RGB_INTEGER:
+    case SCE_IMAGE_BGR_INTEGER: n = 3; break;
+    case SCE_IMAGE_RGBA:
+    case SCE_IMAGE_BGRA:
+    case SCE_IMAGE_RGBA_INTEGER:
+    case SCE_IMAGE_BGRA_INTEGER: n = 4; break;
+    default: n = 1;
+    }
+    switch (array->type) {
+    case SCE_UNSIGNED_BYTE_3_3_2:
+    case SCE_UNSIGNED_BYTE_2_3_3_REV: return 1;
+    case SCE_UNSIGNED_SHORT_5_6_5:
+    case SCE_UNSIGNED_SHORT_5_6_5_REV:
+    case SCE_UNSIGNED_SHORT_4_4_4_4:
+    case SCE_UNSIGNED_SHORT_4_4_4_4_REV:
+    case SCE_UNSIGNED_SHORT_5_5_5_1:
+    case SCE_UNSIGNED_SHORT_1_5_5_5_REV: return 2;
+    case SCE_UNSIGNED_INT_8_8_8_8:
+    case SCE_UNSIGNED_INT_8_8_8_8_REV:
+    case SCE_UNSIGNED_INT_10_10_10_2:
+    case SCE_UNSIGNED_INT_2_10_10_10_REV:
+    case SCE_UNSIGNED_INT_24_8:
+    case SCE_UNSIGNED_INT_10F_11F_11F_REV:
+    case SCE_UNSIGNED_INT_5_9_9_9_REV: return 4;
+    case SCE_FLOAT_32_UNSIGNED_INT_24_8_REV: return 8;
+    case SCE_HALF_FLOAT: return n * 2;
+    default: return n * SCE_Type_Sizeof (array->type);
+    }
+}
+
+/* bytes of a level of src as read back, src must be bound */
+static size_t SCE_RGetTextureArrayReadSize (SCE_RTextureArray *array,
+                                            SCE_RTexture *src, int level,
+                                            int w, int h, int n_layers)
+{
+    GLint size = 0;
+
+    if (array->compressed) {
+        glGetTexLevelParameteriv (src->target, level,
+                                  GL_TEXTURE_COMPRESSED_IMAGE_SIZE, &size);
+        return size;
+    }
+    return SCE_RGetTextureArrayPixelSize (array) * w * h * n_layers;
+}
+
+/* copies all the layers of src into dst, starting at layer */
+static int SCE_RCopyTextureArrayLayers (SCE_RTextureArray *array,
+                                        SCE_RTexture *src, int n_layers,
+                                        SCE_RTexture *dst, int layer)
+{
+    SCEenum fmt = SCE_RSCEImgFormatToGL (array->fmt);
+    SCEenum type = sce_rgltypes[array->type];
+    int w = array->width, h = array->height;
+    unsigned int i;
+    SCEuint pbo = 0;
+    size_t size, level_size;
+    void *buffer = NULL, *p = NULL;
+
+    if (SCE_RHasCap (SCE_COPY_IMAGE)) {
+        for (i = 0; i < array->n_levels; i++) {
+            glCopyImageSubData (src->id, src->target, i, 0, 0, 0,
+                                dst->id, dst->target, i, 0, 0, layer,
+                                w, h, n_layers);
+            w = MAX (w / 2, 1);
+            h = MAX (h / 2, 1);
+        }
+        return SCE_OK;
+    }
+
+    /* through a pixel buffer, or client memory without PBO, sized for the
+       first level as it is actually read back */
+    SCE_RBindTexture (src);
+    size = SCE_RGetTextureArrayReadSize (array, src, 0, w, h, n_layers);
+    if (!size) {
+        SCEE_Log (SCE_INVALID_OPERATION);
+        SCEE_LogMsg ("cannot get the size of the texture to copy");
+        return SCE_ERROR;
+    }
+    if (SCE_RHasCap (SCE_PBO)) {
+        glGenBuffers (1, &pbo);
+        glBindBuffer (GL_PIXEL_PACK_BUFFER, pbo);
+        glBufferData (GL_PIXEL_PACK_BUFFER, size, NULL, GL_STREAM_COPY);
+        glBindBuffer (GL_PIXEL_PACK_BUFFER, 0);
+    } else if (!(buffer = SCE_malloc (size))) {
+        SCEE_LogSrc ();
+        return SCE_ERROR;
+    }
+    glPixelStorei (GL_PACK_ALIGNMENT, 1);
+    glPixelStorei (GL_UNPACK_ALIGNMENT, 1);
+    for (i = 0; i < array->n_levels; i++) {
+        p = pbo ? NULL : buffer;
+        SCE_RBindTexture (src);
+        level_size = SCE_RGetTextureArrayReadSize (array, src, i, w, h,
+                                                   n_layers);
+        glBindBuffer (GL_PIXEL_PACK_BUFFER, pbo);
+        if (array->compressed)
+            glGetCompressedTexImage (src->target, i, p);
+        else
+            glGetTexImage (src->target, i, fmt, type, p);
+        glBindBuffer (GL_PIXEL_PACK_BUFFER, 0);
+
+        SCE_RBindTexture (dst);
+        glBindBuffer (GL_PIXEL_UNPACK_BUFFER, pbo);
+        if (array->compressed)
+            glCompressedTexSubImage3D (dst->target, i, 0, 0, layer, w, h,
+                                       n_layers, array->gl_pxf, level_size,
+                                       p);
+        else
+            glTexSubImage3D (dst->target, i, 0, 0, layer, w, h, n_layers,
+                             fmt, type, p);
+        glBindBuffer (GL_PIXEL_UNPACK_BUFFER, 0);
+        w = MAX (w / 2, 1);
+        h = MAX (h / 2, 1);
+    }
+    glPixelStorei (GL_PACK_ALIGNMENT, 4);
+    glPixelStorei (GL_UNPACK_ALIGNMENT, 4);
+    if (pbo)
+        glDeleteBuffers (1, &pbo);
+    SCE_free (buffer);
+    return SCE_OK;
+}
+
+/* doubles the layers of an array, copying them on the GPU */
+static int SCE_RGrowTextureArray (SCE_RTextureArray *array)
+{
+    SCE_RTextureArrayEntry **entries = NULL;
+    SCE_RTexture *tex = NULL;
+    int i, capacity;
+
+    capacity = MIN (array->capacity * 2,
+                    SCE_RGetTextureArrayPoolMaxLayers (array->pool));
+    if (capacity <= array->capacity)
+        return SCE_ERROR;
+    if (!(entries = SCE_realloc (array->entries,
+                                 capacity * sizeof *entries)))
+        goto fail;
+    array->entries = entries;
+    for (i = array->capacity; i < capacity; i++)
+        entries[i] = NULL;
+
+    if (!(tex = SCE_RAllocTextureArray (array, capacity)))
+        goto fail;
+    if (SCE_RCopyTextureArrayLayers (array, array->tex, array->capacity,
+                                     tex, 0) < 0)
+        goto fail;
+    SCE_RDeleteTexture (array->tex);
+    array->tex = tex;
+    array->capacity = capacity;
+    array->pool->n_grows++;
+    return SCE_OK;
+fail:
+    SCE_RDeleteTexture (tex);
+    SCEE_LogSrc ();
+    return SCE_ERROR;
+}
+
+static SCE_RTextureArray*
+SCE_RCreateTextureArray (SCE_RTextureArrayPool *pool, SCE_RTexture *src,
+                         SCE_STexData *d)
+{
+    SCE_RTextureArray *array = NULL;
+    unsigned int i;
+
+    if (!(array = SCE_malloc (sizeof *array)))
+        goto fail;
+    array->pool = pool;
+    array->tex = NULL;
+    array->pxf = SCE_TexData_GetPixelFormat (d);
+    array->ifmt = src->internal_fmt;
+    if (array->ifmt != SCE_IFMT_NONE)
+        array->gl_pxf = SCE_RInternalFormatToGL (array->ifmt);
+    else if (!(array->gl_pxf = SCE_RSCEPxfToGLSized (array->pxf)))
+        array->gl_pxf = SCE_RSCEPxfToGL (array->pxf);
+    array->fmt = SCE_TexData_GetDataFormat (d);
+    array->type = SCE_TexData_GetDataType (d);
+    array->compressed = SCE_TexData_IsCompressed (d);
+    array->width = SCE_TexData_GetWidth (d);
+    array->height = SCE_TexData_GetHeight (d);
+    array->n_levels = MAX (src->n_levels, 1);
+    for (i = 0; i < SCE_MAX_TEXTURE_LEVELS; i++)
+        array->layer_size[i] = src->level_size[i];
+    array->sampler = src->sampler;
+    array->capacity = MIN (pool->initial_layers,
+                           SCE_RGetTextureArrayPoolMaxLayers (pool));
+    array->n_used = 0;
+    array->entries = NULL;
+    SCE_List_InitIt (&array->it);
+    SCE_List_SetData (&array->it, array);
+
+    if (!(array->entries = SCE_malloc (array->capacity *
+                                       sizeof *array->entries)))
+        goto fail;
+    for (i = 0; i < array->capacity; i++)
+        array->entries[i] = NULL;
+    if (!(array->tex = SCE_RAllocTextureArray (array, array->capacity)))
+        goto fail;
+    SCE_List_Appendl (&pool->arrays, &array->it);
+    return array;
+fail:
+    if (array) {
+        SCE_free (array->entries);
+        SCE_free (array);
+    }
+    SCEE_LogSrc ();
+    return NULL;
+}
+
+static int SCE_RIsTextureArrayCompatible (SCE_RTextureArray *array,
+                                          SCE_RTexture *src,
+                                          SCE_STexData *d)
+{
+    return array->pxf == SCE_TexData_GetPixelFormat (d) &&
+        array->ifmt == src->internal_fmt &&
+        array->fmt == SCE_TexData_GetDataFormat (d) &&
+        array->type == SCE_TexData_GetDataType (d) &&
+        array->width == SCE_TexData_GetWidth (d) &&
+        array->height == SCE_TexData_GetHeight (d) &&
+        array->n_levels == MAX (src->n_levels, 1) &&
+        !memcmp (&array->sampler, &src->sampler, sizeof array->sampler);
+}
+
+/**
+ * \brief Copies a texture into a layer of a compatible array
+ * \param pool a texture array pool
+ * \param tex a built 2D texture, its data (or at least the first level
+ *        description) must still be attached, and all its levels must be
+ *        resident: see SCE_RIsTextureResident(), and its base level must
+ *        be 0
+ *
+ * Textures are compatible when they have the same pixel and internal
+ * formats, size, number of mipmap levels and sampling state. The first
+ * array of \p pool compatible with \p tex having a free layer gets it,
+ * otherwise a full one grows, otherwise a new array is created. \p tex
+ * isn't modified and can be deleted afterward.
+ * \returns the entry of the texture, NULL on error
+ * \sa SCE_RRemoveTextureArrayPoolEntry()
+ */
+SCE_RTextureArrayEntry*
+SCE_RAddTextureArrayPoolTexture (SCE_RTextureArrayPool *pool,
+                                 SCE_RTexture *tex)
+{
+    SCE_RTextureArray *array = NULL, *full = NULL;
+    SCE_RTextureArrayEntry *entry = NULL;
+    SCE_SListIterator *it = NULL;
+    SCE_STexData *d = NULL;
+    int layer;
+
+    if (tex->type != SCE_TEXTYPE_2D || !(d = SCE_RGetTextureTexData (tex, 0,
+                                                                     0))) {
+        SCEE_Log (SCE_INVALID_ARG);
+        SCEE_LogMsg ("only 2D textures with data can be pooled");
+        return NULL;
+    }
+    /* the copies read every level from the GL texture */
+    if (!SCE_RIsTextureResident (tex) || tex->base_level != 0) {
+        SCEE_Log (SCE_INVALID_OPERATION);
+        SCEE_LogMsg ("only fully resident textures can be pooled");
+        return NULL;
+    }
+
+    SCE_List_ForEach (it, &pool->arrays) {
+        SCE_RTextureArray *a = SCE_List_GetData (it);
+        if (!SCE_RIsTextureArrayCompatible (a, tex, d))
+            continue;
+        if (a->n_used < a->capacity) {
+            array = a;
+            break;
+        }
+        if (!full && a->capacity < SCE_RGetTextureArrayPoolMaxLayers (pool))
+            full = a;
+    }
+    if (!array && full && SCE_RGrowTextureArray (full) == SCE_OK)
+        array = full;
+    if (!array && !(array = SCE_RCreateTextureArray (pool, tex, d)))
+        goto fail;
+
+    for (layer = 0; array->entries[layer]; layer++)
+        ;
+    if (!(entry = SCE_malloc (sizeof *entry)))
+        goto fail;
+    if (SCE_RCopyTextureArrayLayers (array, tex, 1, array->tex, layer) < 0) {
+        SCE_free (entry);
+        goto fail;
+    }
+    entry->array = array;
+    entry->layer = layer;
+    array->entries[layer] = entry;
+    array->n_used++;
+    return entry;
+fail:
+    SCEE_LogSrc ();
+    return NULL;
+}
+
+/**
+ * \brief Frees the layer of a texture, arrays never shrink
+ * \param entry an entry returned by SCE_RAddTextureArrayPoolTexture()
+ */
+void SCE_RRemoveTextureArrayPoolEntry (SCE_RTextureArrayEntry *entry)
+{
+    if (entry) {
+        entry->array->entries[entry->layer] = NULL;
+        entry->array->n_used--;
+        SCE_free (entry);
+    }
+}
+
+/**
+ * \brief Gets the array texture holding an entry, it changes when the array
+ * grows
+ */
+SCE_RTexture* SCE_RGetTextureArrayEntryTexture (SCE_RTextureArrayEntry *entry)
+{
+    return entry->array->tex;
+}
+/**
+ * \brief Gets the layer of an entry in its array texture
+ */
+int SCE_RGetTextureArrayEntryLayer (SCE_RTextureArrayEntry *entry)
+{
+    return entry->layer;
+}
+
+/**
+ * \brief Gets the number of array textures of a pool
+ */
+unsigned int SCE_RGetTextureArrayPoolNumArrays (SCE_RTextureArrayPool *pool)
+{
+    return SCE_List_GetSize (&pool->arrays);
+}
+/**
+ * \brief Gets the number of times the arrays of a pool grew
+ */
+unsigned int SCE_RGetTextureArrayPoolNumGrows (SCE_RTextureArrayPool *pool)
+{
+    return pool->n_grows;
+}
+
+/** @} */
@@ -0,0 +1,224 @@
+/*------------------------------------------------------------------------------
+    SCEngine - A 3D real time rendering engine written in the C language
+    Copyright (C) 2006-2013  Antony Martin <martin(dot)antony(at)yahoo(dot)fr>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/* created: 19/10/2026
+   updated: 19/10/2026 */
+
+#include <GL/glew.h>
+#include <SCE/utils/SCEUtils.h>
+#include "SCE/renderer/SCERTexture.h"
+#include "SCE/renderer/SCERTextureBudget.h"
+
+/**
+ * \file SCERTextureBudget.c
+ * \copydoc texturebudget
+ *
+ * \file SCERTextureBudget.h
+ * \copydoc texturebudget
+ */
+
+/**
+ * \defgroup texturebudget Texture memory budget
+ * \ingroup renderer-gl
+ * \brief Keeps the textures within a video memory budget
+ *
+ * Every built texture is tracked with the bytes of its levels and the last
+ * frame it was bound by SCE_RUseTexture(), in a list sorted from the least
+ * to the most recently used. When the resident levels exceed the budget,
+ * SCE_RUpdateTextureBudget() drops the highest resolution levels of the
+ * least recently used textures first, see SCE_RSetTextureBaseLevel(), and
+ * restores them once the textures are used again and the budget allows it.
+ * @{
+ */
+
+/* textures, least recently used first */
+static SCE_SList textures;
+static size_t budget = 0;
+static unsigned long frame = 1;
+static size_t evicted = 0, restored = 0;
+
+/**
+ * \internal
+ * \brief Initializes the texture budget manager
+ */
+int SCE_RTextureBudgetInit (void)
+{
+    SCE_List_Init (&textures);
+    budget = 0;
+    frame = 1;
+    evicted = restored = 0;
+    return SCE_OK;
+}
+/**
+ * \internal
+ * \brief Quits the texture budget manager
+ */
+void SCE_RTextureBudgetQuit (void)
+{
+    /* textures are owned by the user */
+    SCE_List_Flush (&textures);
+}
+
+/**
+ * \brief Sets the video memory budget of the textures
+ * \param bytes the budget in bytes, 0 for no limit (default)
+ */
+void SCE_RSetTextureBudget (size_t bytes)
+{
+    budget = bytes;
+}
+/**
+ * \brief Gets the budget set by SCE_RSetTextureBudget()
+ */
+size_t SCE_RGetTextureBudget (void)
+{
+    return budget;
+}
+
+/**
+ * \internal
+ * \brief Adds a texture to the budget manager, called by SCE_RBuildTexture()
+ */
+void SCE_RTrackTexture (SCE_RTexture *tex)
+{
+    if (!tex->budgeted) {
+        tex->budgeted = SCE_TRUE;
+        tex->last_used = frame;
+        SCE_List_Appendl (&textures, &tex->budget_it);
+    }
+}
+/**
+ * \internal
+ * \brief Removes a texture from the budget manager
+ */
+void SCE_RUntrackTexture (SCE_RTexture *tex)
+{
+    if (tex->budgeted) {
+        tex->budgeted = SCE_FALSE;
+        SCE_List_Removel (&tex->budget_it);
+    }
+}
+/**
+ * \internal
+ * \brief Marks a texture as used during the current frame, called by
+ * SCE_RUseTexture()
+ */
+void SCE_RMarkTextureUsed (SCE_RTexture *tex)
+{
+    if (tex->budgeted && tex->last_used != frame) {
+        tex->last_used = frame;
+        SCE_List_Removel (&tex->budget_it);
+        SCE_List_Appendl (&textures, &tex->budget_it);
+    }
+}
+
+static int SCE_RSetBudgetedTextureLevel (SCE_RTexture *tex, unsigned int base)
+{
+    if (SCE_RSetTextureBaseLevel (tex, base) < 0) {
+        SCEE_SendMsg ("SCERTextureBudget: failed to change the resident "
+                      "levels of a texture, it is not managed anymore\n");
+        SCE_RUntrackTexture (tex);
+        return SCE_ERROR;
+    }
+    return SCE_OK;
+}
+
+/**
+ * \brief Enforces the budget, call it once at the end of each frame
+ *
+ * Drops levels of the textures not used during the frame, least recently
+ * used first, until the resident levels and the levels missing from the
+ * textures used during the frame fit in the budget. Then restores the
+ * levels of the latter, lowest resolution first, as long as they fit.
+ * \sa SCE_RSetTextureBudget(), SCE_RGetTextureBudgetReport()
+ */
+void SCE_RUpdateTextureBudget (void)
+{
+    SCE_SListIterator *it = NULL, *pro = NULL;
+    size_t resident = 0, wanted = 0;
+
+    evicted = restored = 0;
+    SCE_List_ForEach (it, &textures) {
+        SCE_RTexture *tex = SCE_List_GetData (it);
+        size_t used = SCE_RGetTextureUsedVRAM (tex);
+        resident += used;
+        if (tex->last_used == frame)
+            wanted += SCE_RGetTextureFullVRAM (tex) - used;
+    }
+
+    if (budget) {
+        SCE_List_ForEachProtected (pro, it, &textures) {
+            SCE_RTexture *tex = SCE_List_GetData (it);
+            unsigned int max;
+
+            /* the textures used during the frame are at the end */
+            if (resident + wanted <= budget || tex->last_used == frame)
+                break;
+            max = SCE_RGetTextureMaxBaseLevel (tex);
+            while (tex->base_level < max && resident + wanted > budget) {
+                size_t size = tex->level_size[tex->base_level];
+                if (SCE_RSetBudgetedTextureLevel (tex, tex->base_level + 1) < 0)
+                    break;
+                resident -= size;
+                evicted += size;
+            }
+        }
+    }
+
+    SCE_List_ForEachProtected (pro, it, &textures) {
+        SCE_RTexture *tex = SCE_List_GetData (it);
+        /* streamed textures manage their base level themselves */
+        if (tex->last_used != frame || tex->pending)
+            continue;
+        while (tex->base_level > 0) {
+            size_t size = tex->level_size[tex->base_level - 1];
+            if (budget && resident + size > budget)
+                break;
+            if (SCE_RSetBudgetedTextureLevel (tex, tex->base_level - 1) < 0)
+                break;
+            resident += size;
+            restored += size;
+        }
+    }
+    frame++;
+}
+
+/**
+ * \brief Gets the memory used by the textures against the budget
+ * \param r filled with the statistics of the managed textures
+ */
+void SCE_RGetTextureBudgetReport (SCE_RTextureBudgetReport *r)
+{
+    SCE_SListIterator *it = NULL;
+
+    r->budget = budget;
+    r->resident = r->full = 0;
+    r->n_textures = r->n_reduced = 0;
+    SCE_List_ForEach (it, &textures) {
+        SCE_RTexture *tex = SCE_List_GetData (it);
+        r->resident += SCE_RGetTextureUsedVRAM (tex);
+        r->full += SCE_RGetTextureFullVRAM (tex);
+        r->n_textures++;
+        if (tex->base_level > 0)
+            r->n_reduced++;
+    }
+    r->evicted = evicted;
+    r->restored = restored;
+}
+
+/** @} */
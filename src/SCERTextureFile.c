@@ -0,0 +1,673 @@
+/*------------------------------------------------------------------------------
+    SCEngine - A 3D real time rendering engine written in the C language
+    Copyright (C) 2006-2013  Antony Martin <martin(dot)antony(at)yahoo(dot)fr>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/* created: 19/10/2026
+   updated: 19/10/2026 */
+
+#include <string.h>
+#include <strings.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <GL/glew.h>
+#include <SCE/utils/SCEUtils.h>
+#include <SCE/core/SCECore.h>
+#include "SCE/renderer/SCERType.h"
+#include "SCE/renderer/SCERWorker.h"
+#include "SCE/renderer/SCERCompress.h"
+#include "SCE/renderer/SCERTexture.h"
+#include "SCE/renderer/SCERTextureFile.h"
+
+/**
+ * \file SCERTextureFile.c
+ * \copydoc texturefile
+ *
+ * \file SCERTextureFile.h
+ * \copydoc texturefile
+ */
+
+/**
+ * \defgroup texturefile DDS and KTX files
+ * \ingroup renderer-gl
+ * \brief Zero-copy loading of texture container files
+ *
+ * DDS and KTX files already store the images in their GPU layout, decoding
+ * them through the generic image loader only makes heap copies. These files
+ * are memory mapped instead, their headers give the offsets of every level,
+ * face and layer, and the texture data point straight into the mapping:
+ * SCE_RBuildTexture() uploads from it, or copies it into the ring of a
+ * texture stream. The mapping is released once the texture is uploaded.
+ *
+ * Supported are 1D, 2D, 3D, cube and 2D array textures, DXT1, DXT3, DXT5
+ * and 3DC (BC5) block compression and 32 bits RGBA or BGRA pixels. Cube
+ * maps and 2D arrays can also be made of one file per face or layer, the
+ * files are then read by the worker threads, see SCE_RLoadTextureFiles().
+ * SCE_RLoadTexture() gives the files this loader rejects to the generic
+ * image loader.
+ * @{
+ */
+
+#define SCE_DDS_MAGIC 0x20534444        /* "DDS " */
+#define SCE_DDS_HEADER_SIZE 124
+#define SCE_DDS_DX10_SIZE 20
+#define SCE_DDSD_MIPMAPCOUNT 0x20000
+#define SCE_DDPF_FOURCC 0x4
+#define SCE_DDPF_RGB 0x40
+#define SCE_DDSCAPS2_CUBEMAP 0x200
+#define SCE_DDSCAPS2_VOLUME 0x200000
+#define SCE_DDS_RESOURCE_MISC_TEXTURECUBE 0x4
+#define SCE_DDS_DIMENSION_TEXTURE1D 2
+#define SCE_DDS_DIMENSION_TEXTURE3D 4
+#define SCE_FOURCC(a, b, c, d)\
+    ((a) | ((b) << 8) | ((c) << 16) | ((unsigned long)(d) << 24))
+
+#define SCE_KTX_HEADER_SIZE 64
+static const unsigned char ktx_identifier[12] = {
+    0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n'
+};
+
+
+static unsigned long SCE_RReadU32 (const unsigned char *p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned long)p[3] << 24);
+}
+
+/**
+ * \brief Checks whether a file name has the extension of a container the
+ * mapped loader reads
+ */
+int SCE_RIsTextureFileName (const char *fname)
+{
+    const char *ext = strrchr (fname, '.');
+    return ext && (!strcasecmp (ext, ".dds") || !strcasecmp (ext, ".ktx"));
+}
+
+
+static int SCE_RParseDDSFormat (SCE_RTextureFile *f, const unsigned char *pf)
+{
+    unsigned long flags = SCE_RReadU32 (&pf[4]);
+    unsigned long fourcc = SCE_RReadU32 (&pf[8]);
+
+    f->fmt = SCE_IMAGE_RGBA;
+    f->data_type = SCE_UNSIGNED_BYTE;
+    f->pixel_size = 0;
+    if (flags & SCE_DDPF_FOURCC) {
+        if (fourcc == SCE_FOURCC ('D', 'X', 'T', '1'))
+            f->pxf = SCE_PXF_DXT1;
+        else if (fourcc == SCE_FOURCC ('D', 'X', 'T', '3'))
+            f->pxf = SCE_PXF_DXT3;
+        else if (fourcc == SCE_FOURCC ('D', 'X', 'T', '5'))
+            f->pxf = SCE_PXF_DXT5;
+        else if (fourcc == SCE_FOURCC ('A', 'T', 'I', '2') ||
+                 fourcc == SCE_FOURCC ('B', 'C', '5', 'U'))
+            f->pxf = SCE_PXF_3DC;
+        else
+            return SCE_ERROR;
+    } else if ((flags & SCE_DDPF_RGB) && SCE_RReadU32 (&pf[12]) == 32) {
+        unsigned long rmask = SCE_RReadU32 (&pf[16]);
+        f->pxf = SCE_PXF_RGBA;
+        f->pixel_size = 4;
+        if (rmask == 0x00ff0000)
+            f->fmt = SCE_IMAGE_BGRA;
+        else if (rmask != 0x000000ff)
+            return SCE_ERROR;
+    } else
+        return SCE_ERROR;
+    return SCE_OK;
+}
+static int SCE_RParseDXGIFormat (SCE_RTextureFile *f, unsigned long dxgi)
+{
+    f->fmt = SCE_IMAGE_RGBA;
+    f->data_type = SCE_UNSIGNED_BYTE;
+    f->pixel_size = 0;
+    switch (dxgi) {
+    case 71: case 72: f->pxf = SCE_PXF_DXT1; break; /* BC1 */
+    case 74: case 75: f->pxf = SCE_PXF_DXT3; break; /* BC2 */
+    case 77: case 78: f->pxf = SCE_PXF_DXT5; break; /* BC3 */
+    case 83: f->pxf = SCE_PXF_3DC; break;           /* BC5 */
+    case 87: case 91:                               /* B8G8R8A8 */
+        f->fmt = SCE_IMAGE_BGRA;
+        /* fall through */
+    case 28: case 29:                               /* R8G8B8A8 */
+        f->pxf = SCE_PXF_RGBA;
+        f->pixel_size = 4;
+        break;
+    default:
+        return SCE_ERROR;
+    }
+    return SCE_OK;
+}
+static int SCE_RParseDDS (SCE_RTextureFile *f)
+{
+    const unsigned char *h = &f->map[4];
+    unsigned long flags, caps2;
+
+    if (f->size < 4 + SCE_DDS_HEADER_SIZE ||
+        SCE_RReadU32 (h) != SCE_DDS_HEADER_SIZE)
+        return SCE_ERROR;
+    flags = SCE_RReadU32 (&h[4]);
+    f->height = SCE_RReadU32 (&h[8]);
+    f->width = SCE_RReadU32 (&h[12]);
+    f->depth = 1;
+    f->n_levels = 1;
+    if (flags & SCE_DDSD_MIPMAPCOUNT)
+        f->n_levels = MAX (SCE_RReadU32 (&h[24]), 1);
+    caps2 = SCE_RReadU32 (&h[108]);
+    f->n_layers = f->n_faces = 1;
+    f->data_offset = 4 + SCE_DDS_HEADER_SIZE;
+    f->type = SCE_TEX_2D;
+
+    if (SCE_RReadU32 (&h[80]) == SCE_FOURCC ('D', 'X', '1', '0')) {
+        const unsigned char *x = &f->map[f->data_offset];
+        unsigned long dim;
+        if (f->size < f->data_offset + SCE_DDS_DX10_SIZE ||
+            SCE_RParseDXGIFormat (f, SCE_RReadU32 (x)) < 0)
+            return SCE_ERROR;
+        dim = SCE_RReadU32 (&x[4]);
+        f->n_layers = MAX (SCE_RReadU32 (&x[12]), 1);
+        if (SCE_RReadU32 (&x[8]) & SCE_DDS_RESOURCE_MISC_TEXTURECUBE) {
+            f->type = SCE_TEX_CUBE;
+            f->n_faces = 6;
+        } else if (dim == SCE_DDS_DIMENSION_TEXTURE1D)
+            f->type = SCE_TEX_1D;
+        else if (dim == SCE_DDS_DIMENSION_TEXTURE3D)
+            f->type = SCE_TEX_3D;
+        else if (f->n_layers > 1)
+            f->type = SCE_TEX_2D_ARRAY;
+        f->data_offset += SCE_DDS_DX10_SIZE;
+    } else {
+        if (SCE_RParseDDSFormat (f, &h[72]) < 0)
+            return SCE_ERROR;
+        if (caps2 & SCE_DDSCAPS2_CUBEMAP) {
+            f->type = SCE_TEX_CUBE;
+            f->n_faces = 6;
+        } else if (caps2 & SCE_DDSCAPS2_VOLUME)
+            f->type = SCE_TEX_3D;
+    }
+    if (f->type == SCE_TEX_3D)
+        f->depth = MAX (SCE_RReadU32 (&h[20]), 1);
+    if (f->type == SCE_TEX_CUBE && f->n_layers > 1)
+        return SCE_ERROR;       /* cube map arrays */
+    return SCE_OK;
+}
+
+static int SCE_RParseKTX (SCE_RTextureFile *f)
+{
+    const unsigned char *h = f->map;
+    unsigned long glformat, internal, layers, faces, depth;
+
+    if (f->size < SCE_KTX_HEADER_SIZE)
+        return SCE_ERROR;
+    /* only files written on little endian machines */
+    if (SCE_RReadU32 (&h[12]) != 0x04030201)
+        return SCE_ERROR;
+    glformat = SCE_RReadU32 (&h[24]);
+    internal = SCE_RReadU32 (&h[28]);
+    f->width = SCE_RReadU32 (&h[36]);
+    f->height = MAX (SCE_RReadU32 (&h[40]), 1);
+    depth = SCE_RReadU32 (&h[44]);
+    layers = SCE_RReadU32 (&h[48]);
+    faces = SCE_RReadU32 (&h[52]);
+    f->n_levels = MAX (SCE_RReadU32 (&h[56]), 1);
+    f->data_offset = SCE_KTX_HEADER_SIZE + SCE_RReadU32 (&h[60]);
+    f->depth = MAX (depth, 1);
+    f->n_layers = MAX (layers, 1);
+    f->n_faces = faces == 6 ? 6 : 1;
+
+    f->fmt = SCE_IMAGE_RGBA;
+    f->data_type = SCE_UNSIGNED_BYTE;
+    f->pixel_size = 0;
+    switch (internal) {
+    case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+    case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT: f->pxf = SCE_PXF_DXT1; break;
+    case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT: f->pxf = SCE_PXF_DXT3; break;
+    case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT: f->pxf = SCE_PXF_DXT5; break;
+    case GL_COMPRESSED_RG_RGTC2: f->pxf = SCE_PXF_3DC; break;
+    case GL_RGBA8:
+    case GL_RGBA:
+        if (SCE_RReadU32 (&h[16]) != GL_UNSIGNED_BYTE ||
+            (glformat != GL_RGBA && glformat != GL_BGRA))
+            return SCE_ERROR;
+        f->pxf = SCE_PXF_RGBA;
+        f->fmt = glformat == GL_BGRA ? SCE_IMAGE_BGRA : SCE_IMAGE_RGBA;
+        f->pixel_size = 4;
+        break;
+    default:
+        return SCE_ERROR;
+    }
+
+    if (f->n_faces == 6) {
+        if (layers > 0)
+            return SCE_ERROR;   /* cube map arrays */
+        f->type = SCE_TEX_CUBE;
+    } else if (layers > 0)
+        f->type = SCE_TEX_2D_ARRAY;
+    else if (depth > 0)
+        f->type = SCE_TEX_3D;
+    else if (SCE_RReadU32 (&h[40]) == 0)
+        f->type = SCE_TEX_1D;
+    else
+        f->type = SCE_TEX_2D;
+    return SCE_OK;
+}
+
+/* size of one image (a face or a layer) of a level */
+static size_t SCE_RGetTextureFileImageSize (const SCE_RTextureFile *f,
+                                            unsigned int level)
+{
+    int w = MAX (f->width >> level, 1);
+    int h = MAX (f->height >> level, 1);
+    int d = MAX (f->depth >> level, 1);
+    SCE_RBlockFormat bc;
+
+    if (SCE_RGetPxfBlockFormat (f->pxf, &bc))
+        return SCE_RGetCompressedSize (w, h, bc) * d;
+    return (size_t)w * h * d * f->pixel_size;
+}
+
+/**
+ * \brief Gets an image of a mapped file
+ * \param f a mapped file
+ * \param level mipmap level
+ * \param layer array layer
+ * \param face cube face, 0 to 5
+ * \param size if not NULL, receives the size of the image
+ * \returns a pointer into the mapping, NULL if the file is truncated
+ */
+const unsigned char*
+SCE_RGetTextureFileImage (const SCE_RTextureFile *f, unsigned int level,
+                          unsigned int layer, unsigned int face, size_t *size)
+{
+    size_t offset = f->data_offset, image = 0;
+    unsigned int i;
+
+    if (f->format == SCE_TEXFILE_DDS) {
+        /* layers and faces one after another, each with all its levels */
+        size_t chain = 0;
+        for (i = 0; i < f->n_levels; i++)
+            chain += SCE_RGetTextureFileImageSize (f, i);
+        offset += (layer * f->n_faces + face) * chain;
+        for (i = 0; i < level; i++)
+            offset += SCE_RGetTextureFileImageSize (f, i);
+    } else {
+        /* levels one after another, each with all its layers and faces,
+           every size here is a multiple of 4 so there's no padding */
+        for (i = 0; i < level; i++)
+            offset += 4 + SCE_RGetTextureFileImageSize (f, i) *
+                f->n_faces * f->n_layers;
+        offset += 4;
+        offset += (layer * f->n_faces + face) *
+            SCE_RGetTextureFileImageSize (f, level);
+    }
+    image = SCE_RGetTextureFileImageSize (f, level);
+    if (offset + image > f->size)
+        return NULL;
+    if (size)
+        *size = image;
+    return &f->map[offset];
+}
+
+/**
+ * \brief Maps a DDS or KTX file and parses its header
+ * \param f the file to fill
+ * \param fname name of the file
+ * \returns SCE_ERROR on error, SCE_OK otherwise
+ * \sa SCE_RUnmapTextureFile()
+ */
+int SCE_RMapTextureFile (SCE_RTextureFile *f, const char *fname)
+{
+    struct stat st;
+    int fd, ok;
+
+    f->map = NULL;
+    f->next = NULL;
+    if ((fd = open (fname, O_RDONLY)) < 0) {
+        SCEE_Log (SCE_FILE_NOT_FOUND);
+        SCEE_LogMsg ("can't open '%s' for reading", fname);
+        return SCE_ERROR;
+    }
+    if (fstat (fd, &st) < 0 || st.st_size < 4) {
+        close (fd);
+        goto bad;
+    }
+    f->size = st.st_size;
+    f->map = mmap (NULL, f->size, PROT_READ, MAP_PRIVATE, fd, 0);
+    /* the mapping stays valid once the descriptor is closed */
+    close (fd);
+    if (f->map == MAP_FAILED) {
+        f->map = NULL;
+        SCEE_Log (SCE_INVALID_OPERATION);
+        SCEE_LogMsg ("can't map '%s'", fname);
+        return SCE_ERROR;
+    }
+    madvise (f->map, f->size, MADV_WILLNEED);
+
+    if (SCE_RReadU32 (f->map) == SCE_DDS_MAGIC) {
+        f->format = SCE_TEXFILE_DDS;
+        ok = SCE_RParseDDS (f) == SCE_OK;
+    } else if (f->size >= sizeof ktx_identifier &&
+               !memcmp (f->map, ktx_identifier, sizeof ktx_identifier)) {
+        f->format = SCE_TEXFILE_KTX;
+        ok = SCE_RParseKTX (f) == SCE_OK;
+    } else
+        ok = SCE_FALSE;
+    if (!ok || f->width <= 0 || f->n_levels > SCE_MAX_TEXTURE_LEVELS ||
+        !SCE_RGetTextureFileImage (f, f->n_levels - 1, f->n_layers - 1,
+                                   f->n_faces - 1, NULL)) {
+        SCE_RUnmapTextureFile (f);
+        goto bad;
+    }
+    return SCE_OK;
+bad:
+    SCEE_Log (SCE_INVALID_ARG);
+    SCEE_LogMsg ("'%s' is not a supported DDS or KTX file", fname);
+    return SCE_ERROR;
+}
+/**
+ * \brief Unmaps a file mapped by SCE_RMapTextureFile()
+ */
+void SCE_RUnmapTextureFile (SCE_RTextureFile *f)
+{
+    if (f->map) {
+        munmap (f->map, f->size);
+        f->map = NULL;
+    }
+}
+
+
+/* the layers of a level of a DDS array aren't contiguous */
+static unsigned char* SCE_RGatherTextureFileLayers (const SCE_RTextureFile *f,
+                                                    unsigned int level)
+{
+    unsigned char *data = NULL;
+    size_t size = SCE_RGetTextureFileImageSize (f, level);
+    unsigned int i;
+
+    if (!(data = SCE_malloc (size * f->n_layers)))
+        return NULL;
+    for (i = 0; i < f->n_layers; i++)
+        memcpy (&data[i * size], SCE_RGetTextureFileImage (f, level, i, 0,
+                                                           NULL), size);
+    return data;
+}
+
+/* creates the data of a level, \p depth is 0 for 1D and 2D images */
+static SCE_STexData* SCE_RCreateTextureFileLevel (const SCE_RTextureFile *f,
+                                                  unsigned int level,
+                                                  int depth)
+{
+    SCE_STexData *d = NULL;
+    int w = MAX (f->width >> level, 1);
+    int h = f->type == SCE_TEX_1D ? 0 : MAX (f->height >> level, 1);
+
+    if (!(d = SCE_TexData_Create ()))
+        return NULL;
+    SCE_TexData_SetDimensions (d, w, h, depth);
+    SCE_TexData_SetPixelFormat (d, f->pxf);
+    SCE_TexData_SetDataType (d, f->data_type);
+    SCE_TexData_SetDataFormat (d, f->fmt);
+    SCE_TexData_SetMipmapLevel (d, level);
+    return d;
+}
+
+/**
+ * \brief Loads a texture from a DDS or KTX file without copying its images
+ * \param fname name of the file
+ *
+ * The data of the returned texture point into the mapping of the file,
+ * which is released once SCE_RBuildTexture() uploaded them, or once a
+ * texture stream submitted them. The levels of a DDS 2D array are copied,
+ * since the file doesn't store the layers of a level contiguously. A texture
+ * whose data were released can't be built again.
+ * \returns a new texture, NULL on error
+ * \sa SCE_RLoadTexture(), SCE_RReleaseTextureFile()
+ */
+SCE_RTexture* SCE_RLoadTextureFile (const char *fname)
+{
+    SCE_RTextureFile *f = NULL;
+    SCE_RTexture *tex = NULL;
+    unsigned int face, level;
+
+    if (!(f = SCE_malloc (sizeof *f)))
+        goto fail;
+    if (SCE_RMapTextureFile (f, fname) < 0) {
+        SCE_free (f);
+        goto fail;
+    }
+    if (!(tex = SCE_RCreateTexture (f->type))) {
+        SCE_RUnmapTextureFile (f);
+        SCE_free (f);
+        goto fail;
+    }
+    tex->file = f;
+
+    for (face = 0; face < f->n_faces; face++) {
+        for (level = 0; level < f->n_levels; level++) {
+            SCE_STexData *d = NULL;
+            int depth = 0;
+
+            if (f->type == SCE_TEX_3D)
+                depth = MAX (f->depth >> level, 1);
+            else if (f->type == SCE_TEX_2D_ARRAY)
+                depth = f->n_layers;
+            if (!(d = SCE_RCreateTextureFileLevel (f, level, depth)))
+                goto fail;
+            if (f->type == SCE_TEX_2D_ARRAY && f->format == SCE_TEXFILE_DDS &&
+                f->n_layers > 1) {
+                unsigned char *data = SCE_RGatherTextureFileLayers (f, level);
+                if (!data) {
+                    SCE_TexData_Delete (d);
+                    goto fail;
+                }
+                SCE_TexData_SetData (d, data, SCE_TRUE);
+            } else {
+                SCE_TexData_SetData (d, (void*)SCE_RGetTextureFileImage (
+                                         f, level, 0, face, NULL), SCE_FALSE);
+            }
+            SCE_RAddTextureTexData (tex, f->n_faces == 6 ?
+                                    SCE_TEX_POSX + face : 0, d);
+        }
+    }
+    return tex;
+fail:
+    SCE_RDeleteTexture (tex);
+    SCEE_LogSrc ();
+    return NULL;
+}
+
+
+typedef struct {
+    SCE_RTextureFile **files;
+    unsigned char **levels;     /* merged levels of an array, or NULL */
+} SCE_RTextureFilesJob;
+
+/* reads files [begin, end[, on the worker threads */
+static void SCE_RReadTextureFiles (size_t begin, size_t end, void *data)
+{
+    SCE_RTextureFilesJob *job = data;
+    size_t i, k, page = sysconf (_SC_PAGESIZE);
+    unsigned int l;
+
+    for (i = begin; i < end; i++) {
+        const SCE_RTextureFile *f = job->files[i];
+        if (job->levels) {
+            for (l = 0; l < f->n_levels; l++) {
+                size_t size;
+                const unsigned char *p = SCE_RGetTextureFileImage (f, l, 0, 0,
+                                                                   &size);
+                memcpy (&job->levels[l][size * i], p, size);
+            }
+        } else {
+            /* faults the pages in now rather than one at a time during
+               the upload */
+            volatile unsigned char sum = 0;
+            for (k = 0; k < f->size; k += page)
+                sum ^= f->map[k];
+        }
+    }
+}
+
+/**
+ * \brief Loads a cube map or a 2D array from one DDS or KTX file per face
+ * or layer
+ * \param type SCE_TEX_CUBE or SCE_TEX_2D_ARRAY
+ * \param names names of the files, 2D images of the same size, format and
+ * number of levels
+ * \param n number of files, must be 6 for a cube map
+ *
+ * The files are mapped in turn and read concurrently by the worker threads.
+ * The faces of a cube map point into the mappings, like
+ * SCE_RLoadTextureFile() does; the layers of an array are copied straight
+ * into the merged levels and the files are unmapped right away.
+ * \returns a new texture, NULL on error
+ */
+SCE_RTexture* SCE_RLoadTextureFiles (SCE_RTexType type, const char **names,
+                                     unsigned int n)
+{
+    SCE_RTextureFile **files = NULL, *f = NULL;
+    unsigned char *levels[SCE_MAX_TEXTURE_LEVELS] = {NULL};
+    SCE_RTextureFilesJob job;
+    SCE_RTexture *tex = NULL;
+    unsigned int i, l;
+
+    if ((type != SCE_TEX_CUBE || n != 6) &&
+        (type != SCE_TEX_2D_ARRAY || n == 0)) {
+        SCEE_Log (SCE_INVALID_ARG);
+        SCEE_LogMsg ("only cube maps of 6 files and 2D arrays can be loaded "
+                     "from several files");
+        return NULL;
+    }
+    if (!(files = SCE_malloc (n * sizeof *files)))
+        goto fail;
+    for (i = 0; i < n; i++)
+        files[i] = NULL;
+    for (i = 0; i < n; i++) {
+        if (!(files[i] = SCE_malloc (sizeof *files[i])))
+            goto fail;
+        if (SCE_RMapTextureFile (files[i], names[i]) < 0) {
+            SCE_free (files[i]);
+            files[i] = NULL;
+            goto fail;
+        }
+        f = files[i];
+        if (f->type != SCE_TEX_2D || f->width != files[0]->width ||
+            f->height != files[0]->height || f->pxf != files[0]->pxf ||
+            f->fmt != files[0]->fmt || f->n_levels != files[0]->n_levels) {
+            SCEE_Log (SCE_INVALID_ARG);
+            SCEE_LogMsg ("'%s' doesn't match the 2D image of '%s'",
+                         names[i], names[0]);
+            goto fail;
+        }
+    }
+    f = files[0];
+    if (!(tex = SCE_RCreateTexture (type)))
+        goto fail;
+
+    job.files = files;
+    job.levels = NULL;
+    if (type == SCE_TEX_2D_ARRAY) {
+        for (l = 0; l < f->n_levels; l++) {
+            size_t size = SCE_RGetTextureFileImageSize (f, l) * n;
+            if (!(levels[l] = SCE_malloc (size)))
+                goto fail;
+        }
+        job.levels = levels;
+    }
+    SCE_RParallelFor (n, 1, SCE_RReadTextureFiles, &job);
+
+    for (i = 0; i < (type == SCE_TEX_CUBE ? 6 : 1); i++) {
+        for (l = 0; l < f->n_levels; l++) {
+            SCE_STexData *d = NULL;
+            if (!(d = SCE_RCreateTextureFileLevel (
+                      f, l, type == SCE_TEX_2D_ARRAY ? n : 0)))
+                goto fail;
+            if (type == SCE_TEX_2D_ARRAY) {
+                SCE_TexData_SetData (d, levels[l], SCE_TRUE);
+                levels[l] = NULL;
+            } else {
+                SCE_TexData_SetData (d, (void*)SCE_RGetTextureFileImage (
+                                         files[i], l, 0, 0, NULL), SCE_FALSE);
+            }
+            SCE_RAddTextureTexData (tex, type == SCE_TEX_CUBE ?
+                                    SCE_TEX_POSX + i : 0, d);
+        }
+    }
+
+    for (i = n; i > 0; i--) {
+        if (type == SCE_TEX_CUBE) {
+            files[i - 1]->next = tex->file;
+            tex->file = files[i - 1];
+        } else {
+            SCE_RUnmapTextureFile (files[i - 1]);
+            SCE_free (files[i - 1]);
+        }
+    }
+    SCE_free (files);
+    return tex;
+fail:
+    /* the data of the texture may point into the mappings */
+    SCE_RDeleteTexture (tex);
+    for (l = 0; l < SCE_MAX_TEXTURE_LEVELS; l++)
+        SCE_free (levels[l]);
+    for (i = 0; files && i < n; i++) {
+        if (files[i]) {
+            SCE_RUnmapTextureFile (files[i]);
+            SCE_free (files[i]);
+        }
+    }
+    SCE_free (files);
+    SCEE_LogSrc ();
+    return NULL;
+}
+
+/**
+ * \brief Releases the mapped files the data of a texture point into
+ *
+ * Called once the data were uploaded, the data pointing into the mappings
+ * are set to NULL. Does nothing if \p tex wasn't loaded by
+ * SCE_RLoadTextureFile() or SCE_RLoadTextureFiles().
+ */
+void SCE_RReleaseTextureFile (SCE_RTexture *tex)
+{
+    SCE_RTextureFile *f = NULL;
+    SCE_SListIterator *it = NULL;
+    unsigned int i;
+
+    if (!tex->file)
+        return;
+    for (i = 0; i < 6; i++) {
+        SCE_List_ForEach (it, &tex->data[i]) {
+            SCE_STexData *d = SCE_List_GetData (it);
+            unsigned char *p = SCE_TexData_GetData (d);
+            for (f = tex->file; f; f = f->next) {
+                if (p >= f->map && p < f->map + f->size) {
+                    SCE_TexData_SetData (d, NULL, SCE_FALSE);
+                    break;
+                }
+            }
+        }
+    }
+    while ((f = tex->file)) {
+        tex->file = f->next;
+        SCE_RUnmapTextureFile (f);
+        SCE_free (f);
+    }
+}
+
+/** @} */
@@ -0,0 +1,274 @@
+/*------------------------------------------------------------------------------
+    SCEngine - A 3D real time rendering engine written in the C language
+    Copyright (C) 2006-2013  Antony Martin <martin(dot)antony(at)yahoo(dot)fr>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/* created: 19/10/2026
+   updated: 19/10/2026 */
+
+#include <GL/glew.h>
+#include <SCE/utils/SCEUtils.h>
+#include <SCE/core/SCECore.h>
+#include "SCE/renderer/SCERTexture.h"
+#include "SCE/renderer/SCERTextureRealize.h"
+#include "SCE/renderer/SCERUpload.h"
+
+/**
+ * \file SCERTextureRealize.c
+ * \copydoc texturerealize
+ *
+ * \file SCERTextureRealize.h
+ * \copydoc texturerealize
+ */
+
+/**
+ * \defgroup texturerealize Lazy texture realization
+ * \ingroup renderer-gl
+ * \brief Defers the upload of the textures until they are needed
+ *
+ * Outside of SCE_TEX_REALIZE_NOW, SCE_RBuildTexture() only records the
+ * build of the textures having pixels; their conversion, compression,
+ * storage and upload are done when they are realized. Textures without
+ * pixels, such as render targets, are always built at once. The GL name of
+ * a texture is still generated by SCE_RCreateTexture(), it owns no memory.
+ *
+ * With SCE_TEX_REALIZE_ON_BIND, the first SCE_RUseTexture() realizes the
+ * texture before binding it. With SCE_TEX_REALIZE_IDLE, a 1 pixel grey
+ * placeholder of the same type is bound instead and the texture moves to the
+ * head of the queue of SCE_RRealizeTextures(), to be called when the
+ * application has time to spare, so that draws never wait for an upload.
+ * @{
+ */
+
+/* unrealized textures, the ones already bound first */
+static SCE_SList requested;
+static SCE_SList queued;
+static SCE_RTextureRealizeMode mode = SCE_TEX_REALIZE_NOW;
+/* texture being built by SCE_RRealizeTexture() */
+static SCE_RTexture *realizing = NULL;
+
+static SCE_RTexture *placeholders[SCE_NUM_TEXTYPE];
+static unsigned char placeholder_pixel[4] = {128, 128, 128, 255};
+
+/**
+ * \internal
+ * \brief Initializes the lazy texture realization
+ */
+int SCE_RTextureRealizeInit (void)
+{
+    unsigned int i;
+    SCE_List_Init (&requested);
+    SCE_List_Init (&queued);
+    mode = SCE_TEX_REALIZE_NOW;
+    realizing = NULL;
+    for (i = 0; i < SCE_NUM_TEXTYPE; i++)
+        placeholders[i] = NULL;
+    return SCE_OK;
+}
+/**
+ * \internal
+ * \brief Quits the lazy texture realization
+ */
+void SCE_RTextureRealizeQuit (void)
+{
+    unsigned int i;
+    SCE_SListIterator *it = NULL;
+    /* textures are owned by the user */
+    SCE_List_ForEach (it, &requested)
+        ((SCE_RTexture*)SCE_List_GetData (it))->unrealized = SCE_FALSE;
+    SCE_List_ForEach (it, &queued)
+        ((SCE_RTexture*)SCE_List_GetData (it))->unrealized = SCE_FALSE;
+    SCE_List_Flush (&requested);
+    SCE_List_Flush (&queued);
+    for (i = 0; i < SCE_NUM_TEXTYPE; i++) {
+        SCE_RDeleteTexture (placeholders[i]);
+        placeholders[i] = NULL;
+    }
+}
+
+/**
+ * \brief Sets when the textures are built, see \ref texturerealize
+ * \param m the realization mode, SCE_TEX_REALIZE_NOW by default
+ *
+ * The textures already waiting to be realized are not affected.
+ */
+void SCE_RSetTextureRealizeMode (SCE_RTextureRealizeMode m)
+{
+    mode = m;
+}
+/**
+ * \brief Gets the mode set by SCE_RSetTextureRealizeMode()
+ */
+SCE_RTextureRealizeMode SCE_RGetTextureRealizeMode (void)
+{
+    return mode;
+}
+
+static int SCE_RIsPlaceholder (SCE_RTexture *tex)
+{
+    return tex == placeholders[tex->type];
+}
+/**
+ * \internal
+ * \brief Queues the build of a texture instead of doing it, called by
+ * SCE_RBuildTexture()
+ * \returns TRUE if the build is deferred, FALSE if it has to be done now
+ */
+int SCE_RDeferTextureBuild (SCE_RTexture *tex)
+{
+    SCE_STexData *d = NULL;
+
+    if (mode == SCE_TEX_REALIZE_NOW || tex == realizing ||
+        SCE_RIsPlaceholder (tex) || SCE_RIsUploadThread ())
+        return SCE_FALSE;
+    if (!SCE_List_HasElements (&tex->data[0]))
+        return SCE_FALSE;
+    d = SCE_RGetTextureTexData (tex, 0, 0);
+    if (!SCE_TexData_GetData (d))
+        return SCE_FALSE;       /* nothing to upload */
+    if (!tex->unrealized) {
+        tex->unrealized = SCE_TRUE;
+        SCE_List_Appendl (&queued, &tex->realize_it);
+    }
+    return SCE_TRUE;
+}
+/**
+ * \internal
+ * \brief Forgets the deferred build of a texture, called by
+ * SCE_RDeleteTexture()
+ */
+void SCE_RCancelTextureRealization (SCE_RTexture *tex)
+{
+    if (tex->unrealized) {
+        tex->unrealized = SCE_FALSE;
+        SCE_List_Removel (&tex->realize_it);
+    }
+}
+
+/* 1 pixel texture of the given type */
+static SCE_RTexture* SCE_RCreatePlaceholder (SCE_RTexture *model)
+{
+    SCE_RTexture *tex = NULL;
+    SCE_STexData *d = NULL;
+    unsigned int i, n = (model->target == SCE_TEX_CUBE ? 6 : 1);
+
+    if (!(tex = SCE_RCreateTexture (model->target)))
+        goto fail;
+    for (i = 0; i < n; i++) {
+        if (!(d = SCE_TexData_Create ()))
+            goto fail;
+        SCE_TexData_SetDimensions (d, 1, 1, 1);
+        SCE_TexData_SetPixelFormat (d, SCE_PXF_RGBA);
+        SCE_TexData_SetDataType (d, SCE_UNSIGNED_BYTE);
+        SCE_TexData_SetDataFormat (d, SCE_IMAGE_RGBA);
+        SCE_TexData_SetData (d, placeholder_pixel, SCE_FALSE);
+        SCE_RAddTextureTexData (tex, n > 1 ? SCE_TEX_POSX + i : 0, d);
+    }
+    placeholders[tex->type] = tex;
+    SCE_RBuildTexture (tex, SCE_FALSE, SCE_FALSE);
+    return tex;
+fail:
+    SCE_RDeleteTexture (tex);
+    SCEE_LogSrc ();
+    return NULL;
+}
+/**
+ * \internal
+ * \brief Called by SCE_RUseTexture() to bind an unrealized texture
+ * \returns the GL texture to bind in place of \p tex
+ */
+SCEuint SCE_RRequestTextureRealization (SCE_RTexture *tex)
+{
+    SCE_RTexture *p = placeholders[tex->type];
+
+    if (mode != SCE_TEX_REALIZE_IDLE) {
+        SCE_RRealizeTexture (tex);
+        return tex->id;
+    }
+    if (tex->unrealized) {
+        /* bound textures are realized first */
+        SCE_List_Removel (&tex->realize_it);
+        SCE_List_Appendl (&requested, &tex->realize_it);
+    }
+    if (!p && !(p = SCE_RCreatePlaceholder (tex)))
+        SCEE_SendMsg ("SCERTextureRealize: failed to create a placeholder\n");
+    return p ? p->id : 0;
+}
+
+/**
+ * \brief Checks whether a texture has been built
+ * \returns FALSE while the build of \p tex is deferred
+ * \sa SCE_RRealizeTexture()
+ */
+int SCE_RIsTextureRealized (const SCE_RTexture *tex)
+{
+    return !tex->unrealized;
+}
+/**
+ * \brief Does the deferred build of a texture now
+ *
+ * Does nothing if \p tex is already built.
+ * \sa SCE_RBuildTexture()
+ */
+void SCE_RRealizeTexture (SCE_RTexture *tex)
+{
+    if (!tex->unrealized)
+        return;
+    SCE_RCancelTextureRealization (tex);
+    realizing = tex;
+    SCE_RBuildTexture (tex, -1, -1);
+    realizing = NULL;
+}
+/**
+ * \brief Realizes the queued textures, those already bound first
+ * \param bytes stop once this amount of video memory has been filled, 0 to
+ * realize all the textures
+ * \returns the number of textures realized
+ *
+ * At least one texture is realized per call when the queue isn't empty.
+ * \sa SCE_RGetNumUnrealizedTextures()
+ */
+unsigned int SCE_RRealizeTextures (size_t bytes)
+{
+    unsigned int n = 0;
+    size_t done = 0;
+    SCE_SList *lists[2];
+    unsigned int i;
+
+    lists[0] = &requested;
+    lists[1] = &queued;
+    for (i = 0; i < 2; i++) {
+        while (SCE_List_HasElements (lists[i])) {
+            SCE_RTexture *tex =
+                SCE_List_GetData (SCE_List_GetFirst (lists[i]));
+            if (bytes && done >= bytes)
+                return n;
+            SCE_RRealizeTexture (tex);
+            done += SCE_RGetTextureFullVRAM (tex);
+            n++;
+        }
+    }
+    return n;
+}
+/**
+ * \brief Gets the number of textures waiting to be realized
+ */
+unsigned int SCE_RGetNumUnrealizedTextures (void)
+{
+    return SCE_List_GetSize (&requested) + SCE_List_GetSize (&queued);
+}
+
+/** @} */
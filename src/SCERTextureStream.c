@@ -0,0 +1,611 @@
+/*------------------------------------------------------------------------------
+    SCEngine - A 3D real time rendering engine written in the C language
+    Copyright (C) 2006-2013  Antony Martin <martin(dot)antony(at)yahoo(dot)fr>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/* created: 19/10/2026
+   updated: 19/10/2026 */
+
+#include <string.h>
+#include <GL/glew.h>
+#include <SCE/utils/SCEUtils.h>
+#include "SCE/renderer/SCERSupport.h"
+#include "SCE/renderer/SCERWorker.h"
+#include "SCE/renderer/SCERTextureStream.h"
+#include "SCE/renderer/SCERTextureFile.h"
+
+/**
+ * \file SCERTextureStream.c
+ * \copydoc texturestream
+ *
+ * \file SCERTextureStream.h
+ * \copydoc texturestream
+ */
+
+/**
+ * \defgroup texturestream Texture streaming
+ * \ingroup renderer-gl
+ * \brief Asynchronous texture uploads through a pixel buffer ring
+ *
+ * A texture built or updated with SCE_RStreamTexture() doesn't upload its
+ * data immediately: each level is queued into a stream. Once per frame,
+ * SCE_RUpdateTextureStream() copies queued levels into a ring of pixel
+ * unpack buffer, on the worker threads when the ring is persistently
+ * mapped, issues the glTexImage*() calls from the ring and fences them.
+ * Ring space is reused once the fence of an upload is signaled, so the
+ * application never stalls on the driver. SCE_RIsTextureResident() tells
+ * whether all the levels of a texture have been uploaded.
+ *
+ * SCE_RStreamTextureProgressive() uploads the mipmap tail at once and
+ * streams the higher levels one by one, so that the texture is usable right
+ * away; GL_TEXTURE_BASE_LEVEL follows the levels uploaded so far. The
+ * levels of the textures the furthest from their requested LOD are
+ * uploaded first, see SCE_RSetTextureRequestedLOD().
+ *
+ * The texture data (SCE_STexData) must remain valid and unmodified until
+ * the texture is resident.
+ * @{
+ */
+
+/* alignment of the uploads in the ring */
+#define SCE_STREAM_ALIGN 64
+
+typedef struct sce_rtextureupload SCE_RTextureUpload;
+struct sce_rtextureupload {
+    SCE_RTexture *tex;          /* NULL when the upload has been canceled */
+    SCE_STexData *data;
+    unsigned int level;
+    int texsub;
+    size_t offset;              /* position in the ring, never wraps */
+    size_t end;                 /* head of the ring after this upload */
+    size_t size;
+    unsigned char *dst;         /* copy destination */
+    int async;                  /* is the copy done by a worker? */
+    SCE_RWorkerJob job;
+    GLsync fence;
+    SCE_SListIterator it;
+};
+
+static SCE_SList streams;
+
+
+/* the upload won't update its texture anymore */
+static void SCE_RDetachTextureUpload (SCE_RTextureUpload *up)
+{
+    up->tex->pending--;
+    up->tex->level_pending[up->level]--;
+    up->tex = NULL;
+}
+static void SCE_RFreeTextureUpload (void *p)
+{
+    SCE_RTextureUpload *up = p;
+    /* the ring may be reused or unmapped once freed */
+    if (up->async)
+        SCE_RWaitWorkerJob (&up->job);
+    if (up->fence)
+        glDeleteSync (up->fence);
+    if (up->tex)
+        SCE_RDetachTextureUpload (up);
+    SCE_free (up);
+}
+
+/**
+ * \internal
+ */
+int SCE_RTextureStreamInit (void)
+{
+    SCE_List_Init (&streams);
+    return SCE_OK;
+}
+void SCE_RTextureStreamQuit (void)
+{
+    /* streams are owned by the user */
+    SCE_List_Flush (&streams);
+}
+
+
+void SCE_RInitTextureStream (SCE_RTextureStream *stream)
+{
+    stream->pbo = 0;
+    stream->size = 0;
+    stream->head = stream->tail = 0;
+    stream->map = NULL;
+    stream->budget = 0;
+    SCE_List_Init (&stream->pending);
+    SCE_List_SetFreeFunc (&stream->pending, SCE_RFreeTextureUpload);
+    SCE_List_Init (&stream->copying);
+    SCE_List_SetFreeFunc (&stream->copying, SCE_RFreeTextureUpload);
+    SCE_List_Init (&stream->submitted);
+    SCE_List_SetFreeFunc (&stream->submitted, SCE_RFreeTextureUpload);
+    stream->n_bytes = 0;
+    SCE_List_InitIt (&stream->it);
+    SCE_List_SetData (&stream->it, stream);
+}
+void SCE_RClearTextureStream (SCE_RTextureStream *stream)
+{
+    SCE_List_Remove (&stream->it);
+    /* waits for the copies, the buffer must stay mapped until then */
+    SCE_List_Clear (&stream->copying);
+    SCE_List_Clear (&stream->submitted);
+    SCE_List_Clear (&stream->pending);
+    if (stream->pbo) {
+        if (stream->map) {
+            glBindBuffer (GL_PIXEL_UNPACK_BUFFER, stream->pbo);
+            glUnmapBuffer (GL_PIXEL_UNPACK_BUFFER);
+            glBindBuffer (GL_PIXEL_UNPACK_BUFFER, 0);
+        }
+        glDeleteBuffers (1, &stream->pbo);
+    }
+}
+SCE_RTextureStream* SCE_RCreateTextureStream (void)
+{
+    SCE_RTextureStream *stream = NULL;
+    if (!(stream = SCE_malloc (sizeof *stream)))
+        SCEE_LogSrc ();
+    else {
+        SCE_RInitTextureStream (stream);
+        SCE_List_Appendl (&streams, &stream->it);
+    }
+    return stream;
+}
+void SCE_RDeleteTextureStream (SCE_RTextureStream *stream)
+{
+    if (stream) {
+        SCE_RClearTextureStream (stream);
+        SCE_free (stream);
+    }
+}
+
+/**
+ * \brief Creates the ring of a stream
+ * \param size size of the ring in bytes, 0 for
+ *        SCE_TEXTURE_STREAM_DEFAULT_SIZE
+ *
+ * The ring is persistently mapped when GL_ARB_buffer_storage is supported,
+ * the copies are then done by the worker threads. Without pixel buffer
+ * objects, the stream uploads synchronously.
+ * \returns SCE_ERROR on error, SCE_OK otherwise
+ */
+int SCE_RBuildTextureStream (SCE_RTextureStream *stream, size_t size)
+{
+    if (!SCE_RHasCap (SCE_PBO))
+        return SCE_OK;
+    if (size == 0)
+        size = SCE_TEXTURE_STREAM_DEFAULT_SIZE;
+    size = (size + SCE_STREAM_ALIGN - 1) & ~(size_t)(SCE_STREAM_ALIGN - 1);
+
+    glGenBuffers (1, &stream->pbo);
+    glBindBuffer (GL_PIXEL_UNPACK_BUFFER, stream->pbo);
+    if (SCE_RHasCap (SCE_BUFFER_STORAGE) && SCE_RHasCap (SCE_SYNC)) {
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT |
+            GL_MAP_COHERENT_BIT;
+        glBufferStorage (GL_PIXEL_UNPACK_BUFFER, size, NULL, flags);
+        stream->map = glMapBufferRange (GL_PIXEL_UNPACK_BUFFER, 0, size, flags);
+    } else
+        glBufferData (GL_PIXEL_UNPACK_BUFFER, size, NULL, GL_STREAM_DRAW);
+    glBindBuffer (GL_PIXEL_UNPACK_BUFFER, 0);
+
+    if (glGetError () != GL_NO_ERROR) {
+        SCEE_Log (SCE_GL_ERROR);
+        SCEE_LogMsg ("failed to create a texture stream of %lu bytes",
+                     (unsigned long)size);
+        glDeleteBuffers (1, &stream->pbo);
+        stream->pbo = 0;
+        stream->map = NULL;
+        return SCE_ERROR;
+    }
+    stream->size = size;
+    stream->head = stream->tail = 0;
+    return SCE_OK;
+}
+
+/**
+ * \brief Sets the number of bytes a stream starts uploading per frame
+ * \param budget budget in bytes, 0 for no limit
+ *
+ * At least one level is started each frame, whatever its size.
+ */
+void SCE_RSetTextureStreamBudget (SCE_RTextureStream *stream, size_t budget)
+{
+    stream->budget = budget;
+}
+
+static size_t SCE_RGetUploadsSize (SCE_SList *l)
+{
+    SCE_SListIterator *it = NULL;
+    size_t size = 0;
+    SCE_List_ForEach (it, l) {
+        SCE_RTextureUpload *up = SCE_List_GetData (it);
+        size += up->size;
+    }
+    return size;
+}
+/**
+ * \brief Gets the number of bytes not uploaded yet
+ */
+size_t SCE_RGetTextureStreamQueuedBytes (SCE_RTextureStream *stream)
+{
+    return SCE_RGetUploadsSize (&stream->pending) +
+        SCE_RGetUploadsSize (&stream->copying);
+}
+
+
+/**
+ * \brief Builds a texture through a stream
+ * \param stream a stream built with SCE_RBuildTextureStream()
+ * \param tex texture to build
+ * \param use_mipmap \param hw_mipmap see SCE_RBuildTexture()
+ *
+ * The texture is created immediately, its levels are uploaded by the next
+ * calls to SCE_RUpdateTextureStream().
+ * \sa SCE_RIsTextureResident(), SCE_RStreamTextureUpdate()
+ */
+void SCE_RStreamTexture (SCE_RTextureStream *stream, SCE_RTexture *tex,
+                         int use_mipmap, int hw_mipmap)
+{
+    if (stream->pbo)
+        tex->stream = stream;
+    SCE_RBuildTexture (tex, use_mipmap, hw_mipmap);
+    tex->stream = NULL;
+}
+/**
+ * \brief Updates a texture through a stream
+ * \sa SCE_RStreamTexture(), SCE_RUpdateTexture()
+ */
+void SCE_RStreamTextureUpdate (SCE_RTextureStream *stream, SCE_RTexture *tex,
+                               int use_mipmap, int hw_mipmap)
+{
+    if (stream->pbo)
+        tex->stream = stream;
+    SCE_RUpdateTexture (tex, use_mipmap, hw_mipmap);
+    tex->stream = NULL;
+}
+
+/**
+ * \brief Builds a texture through a stream, lowest resolution first
+ * \param stream a stream built with SCE_RBuildTextureStream()
+ * \param tex texture to build
+ * \param use_mipmap \param hw_mipmap see SCE_RBuildTexture()
+ *
+ * The levels no larger than #SCE_TEXTURE_MIP_TAIL_SIZE are uploaded
+ * immediately and GL_TEXTURE_BASE_LEVEL is clamped to them, so the texture
+ * can be used at once. The other levels are queued; each time one is
+ * uploaded, the base level goes down to it. Levels generated by the GL
+ * can't be streamed, SCE_RStreamTexture() is then used.
+ * \sa SCE_RSetTextureRequestedLOD(), SCE_RIsTextureResident()
+ */
+void SCE_RStreamTextureProgressive (SCE_RTextureStream *stream,
+                                    SCE_RTexture *tex, int use_mipmap,
+                                    int hw_mipmap)
+{
+    int hw = hw_mipmap < 0 ? tex->hw_mipmap : hw_mipmap;
+
+    if (stream->pbo) {
+        tex->stream = stream;
+        tex->progressive = !(hw && SCE_RHasCap (SCE_TEX_HW_GEN_MIPMAP));
+    }
+    SCE_RBuildTexture (tex, use_mipmap, hw_mipmap);
+    tex->stream = NULL;
+    if (tex->progressive && !tex->pending)
+        tex->progressive = SCE_FALSE;
+    else if (tex->progressive) {
+        unsigned int base = tex->n_levels;
+        while (base > 0 && !tex->level_pending[base - 1])
+            base--;
+        /* nothing to sample until the smallest level arrives */
+        tex->base_level = base;
+        glTexParameteri (tex->target, GL_TEXTURE_BASE_LEVEL, base);
+    }
+}
+
+/**
+ * \brief Sets the most detailed level a texture needs
+ * \param tex a texture
+ * \param lod mipmap level, e.g. computed from the screen space size of the
+ *        objects using \p tex
+ *
+ * The pending levels of progressive textures are uploaded in order of their
+ * distance to the requested level: a texture wanting its level 0 and
+ * having its level 3 resident gets it before a texture wanting its level 2.
+ * The levels more detailed than requested are uploaded last.
+ * \sa SCE_RStreamTextureProgressive()
+ */
+void SCE_RSetTextureRequestedLOD (SCE_RTexture *tex, float lod)
+{
+    tex->requested_lod = lod;
+}
+/**
+ * \brief Gets the level set by SCE_RSetTextureRequestedLOD()
+ */
+float SCE_RGetTextureRequestedLOD (SCE_RTexture *tex)
+{
+    return tex->requested_lod;
+}
+
+/**
+ * \internal
+ * \brief Queues the upload of a level, called by the texture module
+ */
+void SCE_RQueueTextureStream (SCE_RTextureStream *stream, SCE_RTexture *tex,
+                              SCE_STexData *d, int texsub)
+{
+    SCE_RTextureUpload *up = NULL;
+
+    if (!(up = SCE_malloc (sizeof *up))) {
+        /* upload it now rather than losing it */
+        SCEE_LogSrc ();
+        SCE_RUploadTextureTexData (tex, d, texsub, SCE_TexData_GetData (d));
+        return;
+    }
+    up->tex = tex;
+    up->data = d;
+    up->level = MIN (SCE_TexData_GetMipmapLevel (d),
+                     SCE_MAX_TEXTURE_LEVELS - 1);
+    up->texsub = texsub;
+    up->offset = up->end = 0;
+    up->size = SCE_TexData_GetDataSize (d);
+    up->dst = NULL;
+    up->async = SCE_FALSE;
+    SCE_RInitWorkerJob (&up->job, NULL, up);
+    up->fence = NULL;
+    SCE_List_InitIt (&up->it);
+    SCE_List_SetData (&up->it, up);
+    SCE_List_Appendl (&stream->pending, &up->it);
+    tex->pending++;
+    tex->level_pending[up->level]++;
+}
+
+static void SCE_RCancelUploads (SCE_SList *l, SCE_RTexture *tex, int keep)
+{
+    SCE_SListIterator *it = NULL, *pro = NULL;
+    SCE_List_ForEachProtected (pro, it, l) {
+        SCE_RTextureUpload *up = SCE_List_GetData (it);
+        if (up->tex != tex)
+            continue;
+        if (keep) {
+            /* ring space is released in order, keep it until retired */
+            SCE_RDetachTextureUpload (up);
+        } else {
+            SCE_List_Remove (it);
+            SCE_RFreeTextureUpload (up);
+        }
+    }
+}
+/**
+ * \internal
+ * \brief Cancels the uploads of a texture, called when it is deleted
+ */
+void SCE_RCancelTextureStream (SCE_RTexture *tex)
+{
+    SCE_SListIterator *it = NULL;
+    SCE_List_ForEach (it, &streams) {
+        SCE_RTextureStream *stream = SCE_List_GetData (it);
+        SCE_RCancelUploads (&stream->pending, tex, SCE_FALSE);
+        SCE_RCancelUploads (&stream->copying, tex, SCE_TRUE);
+    }
+}
+
+
+static void SCE_RCopyTextureUpload (void *p)
+{
+    SCE_RTextureUpload *up = p;
+    memcpy (up->dst, SCE_TexData_GetData (up->data), up->size);
+}
+
+/* allocates contiguous space in the ring, returns SCE_FALSE if full */
+static int SCE_RAllocTextureStream (SCE_RTextureStream *stream,
+                                    SCE_RTextureUpload *up)
+{
+    size_t size, start, pos;
+
+    size = (up->size + SCE_STREAM_ALIGN - 1) & ~(size_t)(SCE_STREAM_ALIGN - 1);
+    start = stream->head;
+    pos = start % stream->size;
+    if (pos + size > stream->size)
+        start += stream->size - pos;  /* wrap, skip the end of the ring */
+    if (start + size - stream->tail > stream->size)
+        return SCE_FALSE;
+    up->offset = start;
+    up->end = stream->head = start + size;
+    return SCE_TRUE;
+}
+
+/* copies a level into the ring */
+static void SCE_RStartTextureUpload (SCE_RTextureStream *stream,
+                                     SCE_RTextureUpload *up)
+{
+    size_t pos = up->offset % stream->size;
+
+    if (stream->map) {
+        up->dst = &stream->map[pos];
+        up->async = SCE_TRUE;
+        SCE_RInitWorkerJob (&up->job, SCE_RCopyTextureUpload, up);
+        SCE_RPushWorkerJob (&up->job);
+    } else {
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT;
+        /* fences guarantee that this range isn't read anymore */
+        if (SCE_RHasCap (SCE_SYNC))
+            flags |= GL_MAP_UNSYNCHRONIZED_BIT;
+        glBindBuffer (GL_PIXEL_UNPACK_BUFFER, stream->pbo);
+        up->dst = glMapBufferRange (GL_PIXEL_UNPACK_BUFFER, pos, up->size,
+                                    flags);
+        if (up->dst) {
+            SCE_RCopyTextureUpload (up);
+            glUnmapBuffer (GL_PIXEL_UNPACK_BUFFER);
+        }
+        glBindBuffer (GL_PIXEL_UNPACK_BUFFER, 0);
+    }
+}
+
+/* the level of an upload was sent to the GL */
+static void SCE_RFinishTextureUpload (SCE_RTextureStream *stream,
+                                      SCE_RTextureUpload *up)
+{
+    SCE_RTexture *tex = up->tex;
+    unsigned int base = tex->base_level;
+
+    stream->n_bytes += up->size;
+    /* the GL orders the upload before any use of the texture */
+    SCE_RDetachTextureUpload (up);
+    if (tex->progressive) {
+        /* the levels must stay contiguous */
+        while (base > 0 && !tex->level_pending[base - 1])
+            base--;
+        if (base != tex->base_level) {
+            glTexParameteri (tex->target, GL_TEXTURE_BASE_LEVEL, base);
+            tex->base_level = base;
+        }
+        if (!tex->pending)
+            tex->progressive = SCE_FALSE;
+    }
+    if (!tex->pending)
+        SCE_RReleaseTextureFile (tex);
+}
+
+/* issues the GL upload of a level copied into the ring */
+static void SCE_RSubmitTextureUpload (SCE_RTextureStream *stream,
+                                      SCE_RTextureUpload *up)
+{
+    if (up->tex) {
+        if (up->dst) {
+            size_t pos = up->offset % stream->size;
+            glBindBuffer (GL_PIXEL_UNPACK_BUFFER, stream->pbo);
+            SCE_RUploadTextureTexData (up->tex, up->data, up->texsub,
+                                       (const unsigned char*)NULL + pos);
+            glBindBuffer (GL_PIXEL_UNPACK_BUFFER, 0);
+        } else {
+            /* mapping failed, upload from client memory */
+            SCE_RUploadTextureTexData (up->tex, up->data, up->texsub,
+                                       SCE_TexData_GetData (up->data));
+        }
+        SCE_RFinishTextureUpload (stream, up);
+    }
+    if (SCE_RHasCap (SCE_SYNC))
+        up->fence = glFenceSync (GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+/* releases the ring space of the uploads whose fence is signaled */
+static void SCE_RRetireTextureUploads (SCE_RTextureStream *stream, int wait)
+{
+    SCE_SListIterator *it = NULL, *pro = NULL;
+
+    SCE_List_ForEachProtected (pro, it, &stream->submitted) {
+        SCE_RTextureUpload *up = SCE_List_GetData (it);
+        if (up->fence) {
+            GLuint64 timeout = wait ? 1000000000 : 0;
+            GLenum status = glClientWaitSync (up->fence,
+                                              GL_SYNC_FLUSH_COMMANDS_BIT,
+                                              timeout);
+            if (status == GL_TIMEOUT_EXPIRED)
+                break;          /* the next ones aren't signaled either */
+        }
+        stream->tail = up->end;
+        SCE_List_Remove (it);
+        SCE_RFreeTextureUpload (up);
+    }
+}
+
+/* regular uploads in order, then the levels of the progressive textures
+   the furthest from their requested LOD */
+static SCE_SListIterator* SCE_RNextTextureUpload (SCE_RTextureStream *stream)
+{
+    SCE_SListIterator *it = NULL, *best = NULL;
+    float score, best_score = 0.0f;
+
+    SCE_List_ForEach (it, &stream->pending) {
+        SCE_RTextureUpload *up = SCE_List_GetData (it);
+        if (!up->tex->progressive)
+            return it;
+        /* higher levels of a texture come first, they are needed first */
+        score = up->level - up->tex->requested_lod;
+        if (!best || score > best_score) {
+            best = it;
+            best_score = score;
+        }
+    }
+    return best;
+}
+
+/**
+ * \brief Runs a stream, call it once per frame from the GL thread
+ *
+ * Retires the completed uploads, issues the uploads copied since the
+ * previous call and starts copying queued levels, within the budget set by
+ * SCE_RSetTextureStreamBudget().
+ */
+void SCE_RUpdateTextureStream (SCE_RTextureStream *stream)
+{
+    SCE_SListIterator *it = NULL, *pro = NULL;
+    size_t frame_bytes = 0;
+
+    SCE_RRetireTextureUploads (stream, SCE_FALSE);
+
+    /* submit in order, ring space is released in the same order */
+    SCE_List_ForEachProtected (pro, it, &stream->copying) {
+        SCE_RTextureUpload *up = SCE_List_GetData (it);
+        if (up->async && !SCE_RIsWorkerJobDone (&up->job))
+            break;
+        SCE_List_Removel (it);
+        SCE_RSubmitTextureUpload (stream, up);
+        SCE_List_Appendl (&stream->submitted, it);
+    }
+
+    while ((it = SCE_RNextTextureUpload (stream))) {
+        SCE_RTextureUpload *up = SCE_List_GetData (it);
+        if (stream->budget && frame_bytes > 0 &&
+            frame_bytes + up->size > stream->budget)
+            break;
+        frame_bytes += up->size;
+        if (up->size + SCE_STREAM_ALIGN > stream->size) {
+            /* too big for the ring, upload it directly */
+            SCE_List_Removel (it);
+            SCE_RUploadTextureTexData (up->tex, up->data, up->texsub,
+                                       SCE_TexData_GetData (up->data));
+            SCE_RFinishTextureUpload (stream, up);
+            SCE_RFreeTextureUpload (up);
+        } else if (SCE_RAllocTextureStream (stream, up)) {
+            SCE_List_Removel (it);
+            SCE_RStartTextureUpload (stream, up);
+            SCE_List_Appendl (&stream->copying, it);
+        } else
+            break;              /* ring full, wait for retirements */
+    }
+}
+
+/**
+ * \brief Uploads everything queued into a stream, blocks until done
+ */
+void SCE_RFlushTextureStream (SCE_RTextureStream *stream)
+{
+    size_t budget = stream->budget;
+
+    stream->budget = 0;
+    while (SCE_List_HasElements (&stream->pending) ||
+           SCE_List_HasElements (&stream->copying) ||
+           SCE_List_HasElements (&stream->submitted)) {
+        SCE_SListIterator *it = NULL;
+        SCE_List_ForEach (it, &stream->copying) {
+            SCE_RTextureUpload *up = SCE_List_GetData (it);
+            if (up->async)
+                SCE_RWaitWorkerJob (&up->job);
+        }
+        SCE_RUpdateTextureStream (stream);
+        SCE_RRetireTextureUploads (stream, SCE_TRUE);
+    }
+    stream->budget = budget;
+}
+
+/** @} */
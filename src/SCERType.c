@@ -20,10 +20,12 @@
    updated: 08/04/2012 */
 
 #include <string.h>
+#include <float.h>
 #include <GL/glew.h>
 #include <SCE/utils/SCEUtils.h>
 #include <SCE/core/SCECore.h>   /* SCE_NUM_PRIMITIVE_TYPES */
 #include "SCE/renderer/SCERType.h"
+#include "SCE/renderer/SCERSupport.h"
 
 SCEenum sce_rgltypes[SCE_NUM_TYPES] = {
     GL_BYTE,                    /* SCE_NONE_TYPE */
@@ -93,7 +95,7 @@ SCEenum sce_rpxf[SCE_NUM_PIXEL_FORMATS] = {
     GL_COMPRESSED_RGBA_S3TC_DXT1_EXT,
     GL_COMPRESSED_RGBA_S3TC_DXT3_EXT,
     GL_COMPRESSED_RGBA_S3TC_DXT5_EXT,
-    /*GL_COMPRESSED_RGB_3DC_ATI*/ 0,
+    GL_COMPRESSED_RG_RGTC2,     /* 3DC */
     GL_DEPTH_COMPONENT24,
     GL_DEPTH_COMPONENT32,
     GL_DEPTH_COMPONENT32F,
@@ -111,6 +113,63 @@ SCEenum sce_rpxf[SCE_NUM_PIXEL_FORMATS] = {
     GL_R8UI
 };
 
+/* sized internal formats, 0 when there is none (immutable storage) */
+SCEenum sce_rpxf_sized[SCE_NUM_PIXEL_FORMATS] = {
+    GL_LUMINANCE8,              /* SCE_PXF_NONE */
+    GL_LUMINANCE8,
+    GL_LUMINANCE8_ALPHA8,
+    GL_RGB8,
+    GL_RGBA8,
+    GL_RGB8,
+    GL_RGBA8,
+    GL_COMPRESSED_RGBA_S3TC_DXT1_EXT,
+    GL_COMPRESSED_RGBA_S3TC_DXT3_EXT,
+    GL_COMPRESSED_RGBA_S3TC_DXT5_EXT,
+    GL_COMPRESSED_RG_RGTC2,
+    GL_DEPTH_COMPONENT24,
+    GL_DEPTH_COMPONENT32,
+    GL_DEPTH_COMPONENT32F,
+    0,
+    GL_STENCIL_INDEX1,
+    GL_STENCIL_INDEX4,
+    GL_STENCIL_INDEX8,
+    GL_STENCIL_INDEX16,
+    GL_DEPTH24_STENCIL8,
+    GL_DEPTH24_STENCIL8,
+    GL_DEPTH32F_STENCIL8,
+    GL_R32UI,
+    GL_RGBA8UI,
+    GL_R16UI,
+    GL_R8UI
+};
+
+/* description of the internal formats, see SCE_RChooseInternalFormat() */
+typedef struct {
+    SCEenum gl;
+    unsigned int n_comps;
+    size_t size;                /* bytes per pixel */
+    unsigned int bits;          /* precision, mantissa bits of the floats */
+    float range;                /* largest value */
+    int flags;                  /* SCE_IFMT_* it satisfies */
+    int cap;                    /* SCE_RCap needed, -1 if none */
+} SCE_RInternalFormatDesc;
+
+static const SCE_RInternalFormatDesc
+sce_rifmt[SCE_NUM_INTERNAL_FORMATS] = {
+    {0, 0, 0, 0, 0.0f, 0, -1},  /* SCE_IFMT_NONE */
+    {GL_R8, 1, 1, 8, 1.0f, SCE_IFMT_RENDERABLE, SCE_TEX_RG},
+    {GL_RG8, 2, 2, 8, 1.0f, SCE_IFMT_RENDERABLE, SCE_TEX_RG},
+    {GL_RGBA8, 4, 4, 8, 1.0f, SCE_IFMT_ALPHA | SCE_IFMT_RENDERABLE, -1},
+    {GL_RGB10_A2, 4, 4, 10, 1.0f, SCE_IFMT_RENDERABLE, -1},
+    {GL_R11F_G11F_B10F, 3, 4, 5, 65024.0f, SCE_IFMT_RENDERABLE,
+     SCE_TEX_PACKED_FLOAT},
+    {GL_RGB9_E5, 3, 4, 9, 65408.0f, 0, SCE_TEX_SHARED_EXPONENT},
+    {GL_RGBA16F, 4, 8, 10, 65504.0f,
+     SCE_IFMT_ALPHA | SCE_IFMT_SIGNED | SCE_IFMT_RENDERABLE, SCE_TEX_FLOAT},
+    {GL_RGBA32F, 4, 16, 23, FLT_MAX,
+     SCE_IFMT_ALPHA | SCE_IFMT_SIGNED | SCE_IFMT_RENDERABLE, SCE_TEX_FLOAT}
+};
+
 SCEenum sce_rprimtypes_true[SCE_NUM_PRIMITIVE_TYPES] = {
     GL_POINTS,
     GL_LINES,
@@ -192,6 +251,24 @@ void SCE_RGetFloatv (SCEenum t, float *v)
     glGetFloatv (t, v);
 }
 
+/**
+ * \internal
+ * \brief Hashes bytes (FNV-1a), used by the caches of the renderer
+ * \param data bytes to hash
+ * \param size number of bytes
+ * \param h hash to continue, or SCE_HASH_INIT
+ */
+SCEuint SCE_RHashData (const void *data, size_t size, SCEuint h)
+{
+    const unsigned char *p = data;
+    size_t i;
+    for (i = 0; i < size; i++) {
+        h ^= p[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
 SCE_EType SCE_RGLTypeToSCE (SCEenum t)
 {
 #define SCE_TYPE_CASE(t)\
@@ -232,3 +309,75 @@ SCEenum SCE_RSCEPxfToGL (SCE_EPixelFormat p)
 {
     return sce_rpxf[p];
 }
+/**
+ * \brief Gets the sized internal format of a pixel format
+ * \returns the GL format, or 0 if \p p has no sized equivalent
+ */
+SCEenum SCE_RSCEPxfToGLSized (SCE_EPixelFormat p)
+{
+    return sce_rpxf_sized[p];
+}
+
+/**
+ * \brief Gets the GL sized internal format of an internal format
+ * \returns the GL format, 0 for SCE_IFMT_NONE
+ */
+SCEenum SCE_RInternalFormatToGL (SCE_RInternalFormat f)
+{
+    return sce_rifmt[f].gl;
+}
+/**
+ * \brief Gets the bytes per pixel of an internal format
+ */
+size_t SCE_RGetInternalFormatSize (SCE_RInternalFormat f)
+{
+    return sce_rifmt[f].size;
+}
+/**
+ * \brief Checks whether an internal format stores an alpha channel
+ */
+int SCE_RHasInternalFormatAlpha (SCE_RInternalFormat f)
+{
+    return sce_rifmt[f].flags & SCE_IFMT_ALPHA;
+}
+/**
+ * \brief Checks whether the implementation supports an internal format
+ * \param f an internal format
+ * \param render TRUE to check that \p f can be rendered to
+ */
+int SCE_RIsInternalFormatSupported (SCE_RInternalFormat f, int render)
+{
+    if (f == SCE_IFMT_NONE)
+        return SCE_FALSE;
+    if (render && !(sce_rifmt[f].flags & SCE_IFMT_RENDERABLE))
+        return SCE_FALSE;
+    return sce_rifmt[f].cap < 0 || SCE_RHasCap (sce_rifmt[f].cap);
+}
+/**
+ * \brief Picks the smallest supported color internal format meeting a
+ * precision and a range
+ * \param bits minimum precision: bits of the normalized formats, mantissa
+ * bits of the floating point ones (a 10 bits mantissa of the half floats
+ * gives a relative error of 2^-11)
+ * \param range largest value to store, values above 1 need floats
+ * \param flags SCE_IFMT_ALPHA, SCE_IFMT_SIGNED and/or SCE_IFMT_RENDERABLE
+ * \returns the internal format, or SCE_IFMT_NONE if none meets them
+ *
+ * Lighting buffers asking for 5 bits and a range of a few thousands get
+ * SCE_IFMT_R11F_G11F_B10F, half the size of SCE_IFMT_RGBA16F; HDR textures
+ * that are only sampled and need more precision get SCE_IFMT_RGB9_E5.
+ */
+SCE_RInternalFormat
+SCE_RChooseInternalFormat (unsigned int bits, float range, int flags)
+{
+    unsigned int i;
+
+    for (i = SCE_IFMT_NONE + 1; i < SCE_NUM_INTERNAL_FORMATS; i++) {
+        const SCE_RInternalFormatDesc *desc = &sce_rifmt[i];
+        if (desc->n_comps >= 3 && desc->bits >= bits &&
+            desc->range >= range && (desc->flags & flags) == flags &&
+            SCE_RIsInternalFormatSupported (i, SCE_FALSE))
+            return i;
+    }
+    return SCE_IFMT_NONE;
+}
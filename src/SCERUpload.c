@@ -0,0 +1,394 @@
+/*------------------------------------------------------------------------------
+    SCEngine - A 3D real time rendering engine written in the C language
+    Copyright (C) 2006-2013  Antony Martin <martin(dot)antony(at)yahoo(dot)fr>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/* created: 19/10/2026
+   updated: 19/10/2026 */
+
+#include <pthread.h>
+#include <GL/glew.h>
+#include <SCE/utils/SCEUtils.h>
+#include "SCE/renderer/SCERenderer.h"
+#include "SCE/renderer/SCERSupport.h"
+#include "SCE/renderer/SCERTextureBudget.h"
+#include "SCE/renderer/SCERTextureRealize.h"
+#include "SCE/renderer/SCERUpload.h"
+
+/**
+ * \file SCERUpload.c
+ * \copydoc upload
+ *
+ * \file SCERUpload.h
+ * \copydoc upload
+ */
+
+/**
+ * \defgroup upload Upload thread
+ * \ingroup renderer-gl
+ * \brief Builds buffers, textures and programs on a thread of their own
+ *
+ * The library doesn't create GL contexts: the application creates a
+ * context sharing its objects with the rendering one, and gives
+ * SCE_RStartUploadThread() the functions making it current on the upload
+ * thread and releasing it. The buffers, textures and programs submitted by
+ * the rendering thread are then built in the order they were submitted,
+ * while the rendering goes on.
+ *
+ * Each submission fills a SCE_RUpload handle. The upload thread puts a
+ * fence after the GL commands of the work, SCE_RIsUploadReady() and
+ * SCE_RWaitUpload() check it before the object can be used by the rendering
+ * thread, and only then give the texture to the budget manager and drop the
+ * cached bindings of the texture. Until then, the object must be neither
+ * used nor modified. Without upload thread, the submissions are done at
+ * once.
+ * @{
+ */
+
+enum {
+    SCE_UPLOAD_IDLE,
+    SCE_UPLOAD_QUEUED,
+    SCE_UPLOAD_RUNNING,
+    SCE_UPLOAD_DONE
+};
+
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t queued_cond = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t done_cond = PTHREAD_COND_INITIALIZER;
+static pthread_t thread;
+static int running = SCE_FALSE;
+static int started = 0;         /* 1 when the context is current, -1 if it
+                                   failed */
+static int quit = SCE_FALSE;
+static SCE_RUpload *first = NULL, *last = NULL;
+static SCE_FUploadContext make_current = NULL, release_current = NULL;
+static void *context_data = NULL;
+
+
+/**
+ * \internal
+ */
+int SCE_RUploadInit (void)
+{
+    running = SCE_FALSE;
+    first = last = NULL;
+    return SCE_OK;
+}
+/**
+ * \internal
+ */
+void SCE_RUploadQuit (void)
+{
+    SCE_RStopUploadThread ();
+}
+
+
+static void SCE_RRunUpload (SCE_RUpload *up)
+{
+    switch (up->type) {
+    case SCE_UPLOAD_BUFFER:
+        SCE_RBuildBuffer (up->object, up->target, up->usage);
+        break;
+    case SCE_UPLOAD_TEXTURE:
+        SCE_RBuildTexture (up->object, up->use_mipmap, up->hw_mipmap);
+        break;
+    case SCE_UPLOAD_TEXTURE_UPDATE:
+        SCE_RUpdateTexture (up->object, up->use_mipmap, up->hw_mipmap);
+        break;
+    case SCE_UPLOAD_PROGRAM:
+        up->status = SCE_RBuildProgram (up->object);
+    }
+    if (!SCE_RIsUploadThread ())
+        return;
+    if (SCE_RHasCap (SCE_SYNC)) {
+        up->fence = glFenceSync (GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        /* the rendering context can only wait for a flushed fence */
+        glFlush ();
+    } else
+        glFinish ();
+}
+
+static void* SCE_RUploadThread (void *unused)
+{
+    (void)unused;
+    pthread_mutex_lock (&mutex);
+    started = (make_current (context_data) < 0 ? -1 : 1);
+    pthread_cond_broadcast (&done_cond);
+    if (started < 0) {
+        pthread_mutex_unlock (&mutex);
+        return NULL;
+    }
+    /* the queued uploads are done before quitting */
+    while (!quit || first) {
+        SCE_RUpload *up = first;
+        if (!up) {
+            pthread_cond_wait (&queued_cond, &mutex);
+            continue;
+        }
+        first = up->next;
+        if (!first)
+            last = NULL;
+        up->next = NULL;
+        up->state = SCE_UPLOAD_RUNNING;
+        pthread_mutex_unlock (&mutex);
+        SCE_RRunUpload (up);
+        pthread_mutex_lock (&mutex);
+        up->state = SCE_UPLOAD_DONE;
+        pthread_cond_broadcast (&done_cond);
+    }
+    pthread_mutex_unlock (&mutex);
+    if (release_current)
+        release_current (context_data);
+    return NULL;
+}
+
+/**
+ * \brief Starts the upload thread
+ * \param make function making a context that shares the objects of the
+ * rendering context current on the calling thread, called once by the
+ * upload thread
+ * \param release function releasing the context, called by the upload
+ * thread when it stops, can be NULL
+ * \param data given to \p make and \p release
+ * \returns SCE_ERROR on error, SCE_OK otherwise
+ * \sa SCE_RStopUploadThread()
+ */
+int SCE_RStartUploadThread (SCE_FUploadContext make, SCE_FUploadContext release,
+                            void *data)
+{
+    if (running) {
+        SCEE_Log (SCE_INVALID_OPERATION);
+        SCEE_LogMsg ("the upload thread is already running");
+        return SCE_ERROR;
+    }
+    make_current = make;
+    release_current = release;
+    context_data = data;
+    quit = SCE_FALSE;
+    started = 0;
+    if (pthread_create (&thread, NULL, SCE_RUploadThread, NULL) != 0) {
+        SCEE_Log (SCE_ERROR);
+        SCEE_LogMsg ("failed to start the upload thread");
+        return SCE_ERROR;
+    }
+    pthread_mutex_lock (&mutex);
+    while (!started)
+        pthread_cond_wait (&done_cond, &mutex);
+    pthread_mutex_unlock (&mutex);
+    if (started < 0) {
+        pthread_join (thread, NULL);
+        SCEE_Log (SCE_ERROR);
+        SCEE_LogMsg ("failed to make the upload context current");
+        return SCE_ERROR;
+    }
+    running = SCE_TRUE;
+    return SCE_OK;
+}
+/**
+ * \brief Stops the upload thread once the submitted uploads are done
+ */
+void SCE_RStopUploadThread (void)
+{
+    if (!running)
+        return;
+    pthread_mutex_lock (&mutex);
+    quit = SCE_TRUE;
+    pthread_cond_broadcast (&queued_cond);
+    pthread_mutex_unlock (&mutex);
+    pthread_join (thread, NULL);
+    running = SCE_FALSE;
+    started = 0;
+}
+/**
+ * \brief Checks whether the upload thread is running
+ */
+int SCE_RHasUploadThread (void)
+{
+    return running;
+}
+/**
+ * \brief Checks whether the calling thread is the upload thread
+ *
+ * The code shared with the rendering thread uses it to leave alone the
+ * states of the rendering context it caches.
+ */
+int SCE_RIsUploadThread (void)
+{
+    return started > 0 && pthread_equal (pthread_self (), thread);
+}
+
+
+/**
+ * \brief Initializes an upload handle
+ */
+void SCE_RInitUpload (SCE_RUpload *up)
+{
+    up->type = SCE_UPLOAD_BUFFER;
+    up->object = NULL;
+    up->target = 0;
+    up->usage = 0;
+    up->use_mipmap = up->hw_mipmap = -1;
+    up->status = SCE_OK;
+    up->state = SCE_UPLOAD_IDLE;
+    up->fence = 0;
+    up->next = NULL;
+}
+
+static void SCE_RSubmitUpload (SCE_RUpload *up)
+{
+    up->status = SCE_OK;
+    up->fence = 0;
+    up->next = NULL;
+    if (!running) {
+        SCE_RRunUpload (up);
+        up->state = SCE_UPLOAD_DONE;
+        return;
+    }
+    pthread_mutex_lock (&mutex);
+    up->state = SCE_UPLOAD_QUEUED;
+    if (last)
+        last->next = up;
+    else
+        first = up;
+    last = up;
+    pthread_cond_signal (&queued_cond);
+    pthread_mutex_unlock (&mutex);
+}
+/**
+ * \brief Submits the build of a buffer, see SCE_RBuildBuffer()
+ * \param up an idle upload, it must remain valid until it is ready
+ * \sa SCE_RIsUploadReady()
+ */
+void SCE_RSubmitBuffer (SCE_RUpload *up, SCE_RBuffer *buf, SCEenum target,
+                        SCE_RBufferUsage usage)
+{
+    up->type = SCE_UPLOAD_BUFFER;
+    up->object = buf;
+    up->target = target;
+    up->usage = usage;
+    SCE_RSubmitUpload (up);
+}
+/**
+ * \brief Submits the build of a texture, see SCE_RBuildTexture()
+ * \param up an idle upload, it must remain valid until it is ready
+ *
+ * The texture is built even if its build was deferred by the realization
+ * mode, see SCE_RSetTextureRealizeMode().
+ */
+void SCE_RSubmitTexture (SCE_RUpload *up, SCE_RTexture *tex, int use_mipmap,
+                         int hw_mipmap)
+{
+    SCE_RCancelTextureRealization (tex);
+    up->type = SCE_UPLOAD_TEXTURE;
+    up->object = tex;
+    up->use_mipmap = use_mipmap;
+    up->hw_mipmap = hw_mipmap;
+    SCE_RSubmitUpload (up);
+}
+/**
+ * \brief Submits the update of a texture, see SCE_RUpdateTexture()
+ * \param up an idle upload, it must remain valid until it is ready
+ */
+void SCE_RSubmitTextureUpdate (SCE_RUpload *up, SCE_RTexture *tex,
+                               int use_mipmap, int hw_mipmap)
+{
+    up->type = SCE_UPLOAD_TEXTURE_UPDATE;
+    up->object = tex;
+    up->use_mipmap = use_mipmap;
+    up->hw_mipmap = hw_mipmap;
+    SCE_RSubmitUpload (up);
+}
+/**
+ * \brief Submits the link of a program, see SCE_RBuildProgram()
+ * \param up an idle upload, it must remain valid until it is ready
+ * \sa SCE_RGetUploadStatus()
+ */
+void SCE_RSubmitProgram (SCE_RUpload *up, SCE_RProgram *prog)
+{
+    /* the pipelines belong to the rendering context */
+    if (running && !prog->linked)
+        SCE_RDropProgramPipelines (prog);
+    up->type = SCE_UPLOAD_PROGRAM;
+    up->object = prog;
+    SCE_RSubmitUpload (up);
+}
+
+/* done by the rendering thread once the GL is done */
+static void SCE_RFinishUpload (SCE_RUpload *up)
+{
+    if (up->fence) {
+        glDeleteSync (up->fence);
+        up->fence = 0;
+    }
+    if (up->type == SCE_UPLOAD_TEXTURE ||
+        up->type == SCE_UPLOAD_TEXTURE_UPDATE) {
+        SCE_RTexture *tex = up->object;
+        SCE_RForgetTextureBindings (tex);
+        if (up->type == SCE_UPLOAD_TEXTURE)
+            SCE_RTrackTexture (tex);
+    }
+    up->state = SCE_UPLOAD_IDLE;
+}
+/**
+ * \brief Checks whether the object of an upload can be used, never blocks
+ * \returns TRUE if the upload is done or was never submitted
+ */
+int SCE_RIsUploadReady (SCE_RUpload *up)
+{
+    int state;
+
+    pthread_mutex_lock (&mutex);
+    state = up->state;
+    pthread_mutex_unlock (&mutex);
+    if (state == SCE_UPLOAD_IDLE)
+        return SCE_TRUE;
+    if (state != SCE_UPLOAD_DONE)
+        return SCE_FALSE;
+    if (up->fence &&
+        glClientWaitSync (up->fence, 0, 0) == GL_TIMEOUT_EXPIRED)
+        return SCE_FALSE;
+    SCE_RFinishUpload (up);
+    return SCE_TRUE;
+}
+/**
+ * \brief Waits until the object of an upload can be used
+ *
+ * Blocks until the upload thread has submitted the GL commands of \p up,
+ * the rendering context then waits for them on the GPU side only.
+ */
+void SCE_RWaitUpload (SCE_RUpload *up)
+{
+    pthread_mutex_lock (&mutex);
+    while (up->state == SCE_UPLOAD_QUEUED || up->state == SCE_UPLOAD_RUNNING)
+        pthread_cond_wait (&done_cond, &mutex);
+    pthread_mutex_unlock (&mutex);
+    if (up->state == SCE_UPLOAD_IDLE)
+        return;
+    if (up->fence)
+        glWaitSync (up->fence, 0, GL_TIMEOUT_IGNORED);
+    SCE_RFinishUpload (up);
+}
+/**
+ * \brief Gets the result of an upload
+ * \returns SCE_ERROR if the program of \p up failed to link, SCE_OK
+ * otherwise; meaningful once SCE_RIsUploadReady() returns TRUE
+ */
+int SCE_RGetUploadStatus (const SCE_RUpload *up)
+{
+    return up->status;
+}
+
+/** @} */
@@ -21,6 +21,7 @@
 
 #include <GL/glew.h>
 #include "SCE/renderer/SCERType.h"
+#include "SCE/renderer/SCERMatrix.h"  /* SCE_RFlushMatrices() */
 #include "SCE/renderer/SCERTexture.h" /* CGetMaxTextureUnits() */
 #include "SCE/renderer/SCERVertexArray.h"
 
@@ -380,22 +381,26 @@ void SCE_RDisableVertexAttributesMap (void)
 
 void SCE_RRender (SCE_EPrimitiveType prim, SCEuint n_vertices)
 {
+    SCE_RFlushMatrices ();
     glDrawArrays (sce_rprimtypes[prim], 0, n_vertices);
 }
 void SCE_RRenderInstanced (SCE_EPrimitiveType prim, SCEuint n_vertices,
                            SCEuint n_inst)
 {
+    SCE_RFlushMatrices ();
     glDrawArraysInstanced (sce_rprimtypes[prim], 0, n_vertices, n_inst);
 }
 void SCE_RRenderIndexed (SCE_EPrimitiveType prim, SCE_RIndexArray *ia,
                          SCEuint n_indices)
 {
+    SCE_RFlushMatrices ();
     glDrawElements (sce_rprimtypes[prim], n_indices,
                     sce_rgltypes[ia->type], ia->data);
 }
 void SCE_RRenderIndexedInstanced (SCE_EPrimitiveType prim, SCE_RIndexArray *ia,
                                   SCEuint n_indices, SCEuint n_instances)
 {
+    SCE_RFlushMatrices ();
     glDrawElementsInstanced (sce_rprimtypes[prim], n_indices,
                              sce_rgltypes[ia->type], ia->data, n_instances);
 }
@@ -21,6 +21,7 @@
 
 #include <GL/glew.h>
 #include "SCE/renderer/SCERType.h"
+#include "SCE/renderer/SCERMatrix.h"  /* SCE_RFlushMatrices() */
 #include "SCE/renderer/SCERBufferPool.h"
 #include "SCE/renderer/SCERVertexBuffer.h"
 
@@ -482,6 +483,7 @@ void SCE_RUseVertexBuffer (SCE_RVertexBuffer *vb)
  */
 void SCE_RRenderVertexBuffer (SCE_EPrimitiveType prim)
 {
+    SCE_RFlushMatrices ();
     glDrawArrays (sce_rprimtypes[prim], 0, vb_bound->n_vertices);
 }
 /**
@@ -489,6 +491,7 @@ void SCE_RRenderVertexBuffer (SCE_EPrimitiveType prim)
  */
 void SCE_RRenderVertexBufferInstanced (SCE_EPrimitiveType prim, SCEuint num)
 {
+    SCE_RFlushMatrices ();
     glDrawArraysInstanced (sce_rprimtypes[prim], 0, vb_bound->n_vertices, num);
 }
 
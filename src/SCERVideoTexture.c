@@ -0,0 +1,572 @@
+/*------------------------------------------------------------------------------
+    SCEngine - A 3D real time rendering engine written in the C language
+    Copyright (C) 2006-2013  Antony Martin <martin(dot)antony(at)yahoo(dot)fr>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/* created: 19/10/2026
+   updated: 19/10/2026 */
+
+#include <string.h>
+#include <GL/glew.h>
+#include <SCE/utils/SCEUtils.h>
+#include "SCE/renderer/SCERenderer.h"
+#include "SCE/renderer/SCERType.h"
+#include "SCE/renderer/SCERSupport.h"
+#include "SCE/renderer/SCERShaderVariant.h"
+#include "SCE/renderer/SCERVideoTexture.h"
+
+/**
+ * \file SCERVideoTexture.c
+ * \copydoc videotexture
+ *
+ * \file SCERVideoTexture.h
+ * \copydoc videotexture
+ */
+
+/**
+ * \defgroup videotexture Video textures
+ * \ingroup renderer-gl
+ * \brief YUV 4:2:0 frames uploaded as is and converted to RGB by the shaders
+ *
+ * A video texture holds the planes of a frame in R8 and RG8 textures, a
+ * quarter of the chroma resolution and 1.5 bytes per pixel instead of the 4
+ * of a frame converted to RGBA by the CPU. The shaders sample them with
+ * sce_video_sample(), see SCE_RGetVideoTextureGLSL().
+ *
+ * It has #SCE_VIDEO_TEXTURE_SLOTS slots, each one a pixel unpack buffer and
+ * the textures of one frame, so that the decoding of a frame, the upload of
+ * the previous one and the sampling of the one before overlap:
+ * - SCE_RMapVideoFrame() gives the memory of a free slot to decode a frame
+ *   into, which the decoder may fill from any thread;
+ * - SCE_RUnmapVideoFrame() uploads it from the buffer into the textures of
+ *   the slot and fences the upload;
+ * - SCE_RUpdateVideoTexture(), once per frame, makes the most recent
+ *   uploaded frame the one SCE_RUseVideoTexture() binds. Older uploaded
+ *   frames are dropped.
+ *
+ * When the buffers can be persistently mapped, mapping a frame doesn't call
+ * the GL. Without pixel buffer objects, the frames are decoded into client
+ * memory and uploaded from it.
+ * @{
+ */
+
+/* alignment of the planes in a slot */
+#define SCE_VIDEO_ALIGN 64
+
+enum {
+    SCE_VIDEO_SLOT_FREE,
+    SCE_VIDEO_SLOT_MAPPED,      /* being decoded into */
+    SCE_VIDEO_SLOT_UPLOADING,   /* waiting for its fence */
+    SCE_VIDEO_SLOT_READY,       /* uploaded, not sampled yet */
+    SCE_VIDEO_SLOT_FRONT        /* sampled */
+};
+
+static const char *sce_video_glsl =
+    "uniform sampler2D sce_video_y;\n"
+    "uniform sampler2D sce_video_u;\n"
+    "uniform sampler2D sce_video_v;\n"
+    "/* u is dot (u.rg, xy), v is dot (v.rg, zw) */\n"
+    "uniform vec4 sce_video_chroma;\n"
+    "/* YUV to RGB, range expansion included */\n"
+    "uniform mat4 sce_video_matrix;\n"
+    "\n"
+    "vec3 sce_video_sample (vec2 uv)\n"
+    "{\n"
+    "    vec4 yuv;\n"
+    "    yuv.x = texture (sce_video_y, uv).r;\n"
+    "    yuv.y = dot (texture (sce_video_u, uv).rg, sce_video_chroma.xy);\n"
+    "    yuv.z = dot (texture (sce_video_v, uv).rg, sce_video_chroma.zw);\n"
+    "    yuv.w = 1.0;\n"
+    "    return clamp ((sce_video_matrix * yuv).rgb, 0.0, 1.0);\n"
+    "}\n";
+
+/** Name of the GLSL functions for the \#include directive */
+#define SCE_VIDEO_INCLUDE "sce_video.glsl"
+
+
+/**
+ * \internal
+ * \brief Registers the GLSL include of the video textures
+ */
+int SCE_RVideoTextureInit (void)
+{
+    if (SCE_RAddShaderInclude (SCE_VIDEO_INCLUDE, sce_video_glsl) < 0) {
+        SCEE_LogSrc ();
+        return SCE_ERROR;
+    }
+    return SCE_OK;
+}
+/**
+ * \internal
+ */
+void SCE_RVideoTextureQuit (void)
+{
+    SCE_RRemoveShaderInclude (SCE_VIDEO_INCLUDE);
+}
+
+
+void SCE_RInitVideoTexture (SCE_RVideoTexture *vt)
+{
+    unsigned int i, j;
+    vt->format = SCE_VIDEO_I420;
+    vt->width = vt->height = 0;
+    vt->n_planes = 0;
+    for (j = 0; j < SCE_VIDEO_MAX_PLANES; j++) {
+        vt->plane_w[j] = vt->plane_h[j] = 0;
+        vt->pitch[j] = vt->offset[j] = 0;
+    }
+    vt->frame_size = 0;
+    for (i = 0; i < SCE_VIDEO_TEXTURE_SLOTS; i++) {
+        for (j = 0; j < SCE_VIDEO_MAX_PLANES; j++)
+            vt->planes[i][j] = NULL;
+        vt->pbo[i] = 0;
+        vt->map[i] = NULL;
+        vt->state[i] = SCE_VIDEO_SLOT_FREE;
+        vt->fences[i] = NULL;
+        vt->seq[i] = 0;
+    }
+    vt->persistent = SCE_FALSE;
+    vt->n_frames = 0;
+    vt->front = -1;
+    vt->n_dropped = 0;
+    SCE_RSetVideoTextureColorSpace (vt, SCE_VIDEO_BT709, SCE_FALSE);
+}
+void SCE_RClearVideoTexture (SCE_RVideoTexture *vt)
+{
+    unsigned int i, j;
+    for (i = 0; i < SCE_VIDEO_TEXTURE_SLOTS; i++) {
+        for (j = 0; j < SCE_VIDEO_MAX_PLANES; j++)
+            SCE_RDeleteTexture (vt->planes[i][j]);
+        if (vt->fences[i])
+            glDeleteSync (vt->fences[i]);
+        if (vt->pbo[i]) {
+            if (vt->persistent || vt->state[i] == SCE_VIDEO_SLOT_MAPPED) {
+                glBindBuffer (GL_PIXEL_UNPACK_BUFFER, vt->pbo[i]);
+                glUnmapBuffer (GL_PIXEL_UNPACK_BUFFER);
+            }
+        } else
+            SCE_free (vt->map[i]);
+    }
+    glBindBuffer (GL_PIXEL_UNPACK_BUFFER, 0);
+    if (vt->pbo[0])
+        glDeleteBuffers (SCE_VIDEO_TEXTURE_SLOTS, vt->pbo);
+}
+SCE_RVideoTexture* SCE_RCreateVideoTexture (void)
+{
+    SCE_RVideoTexture *vt = NULL;
+    if (!(vt = SCE_malloc (sizeof *vt)))
+        SCEE_LogSrc ();
+    else
+        SCE_RInitVideoTexture (vt);
+    return vt;
+}
+void SCE_RDeleteVideoTexture (SCE_RVideoTexture *vt)
+{
+    if (vt) {
+        SCE_RClearVideoTexture (vt);
+        SCE_free (vt);
+    }
+}
+
+
+static SCE_RTexture* SCE_RCreateVideoPlane (int w, int h, int n_comps)
+{
+    SCE_RTexture *tex = NULL;
+    SCE_STexData data;
+
+    if (!(tex = SCE_RCreateTexture (SCE_TEX_2D)))
+        goto fail;
+    SCE_RSetTextureInternalFormat (tex, n_comps == 2 ? SCE_IFMT_RG8 :
+                                   SCE_IFMT_R8);
+    SCE_TexData_Init (&data);
+    SCE_TexData_SetDimensions (&data, w, h, 0);
+    SCE_TexData_SetDataType (&data, SCE_UNSIGNED_BYTE);
+    SCE_TexData_SetPixelFormat (&data, n_comps == 2 ?
+                                SCE_PXF_LUMINANCE_ALPHA : SCE_PXF_LUMINANCE);
+    SCE_TexData_SetDataFormat (&data, n_comps == 2 ? SCE_IMAGE_RG :
+                               SCE_IMAGE_RED);
+    if (!SCE_RAddTextureTexDataDup (tex, 0, &data))
+        goto fail;
+    /* no pixels, only allocates the planes */
+    SCE_RBuildTexture (tex, SCE_FALSE, SCE_FALSE);
+    SCE_RBindTexture (tex);
+    glTexParameteri (tex->target, GL_TEXTURE_MAX_LEVEL, 0);
+    SCE_RSetTextureFilter (tex, SCE_TEX_LINEAR);
+    SCE_RPixelizeTexture (tex, SCE_FALSE);
+    SCE_RSetTextureWrapMode (tex, SCE_TEX_CLAMP);
+    return tex;
+fail:
+    SCE_RDeleteTexture (tex);
+    SCEE_LogSrc ();
+    return NULL;
+}
+
+static int SCE_RBuildVideoBuffers (SCE_RVideoTexture *vt)
+{
+    unsigned int i;
+
+    if (!SCE_RHasCap (SCE_PBO)) {
+        for (i = 0; i < SCE_VIDEO_TEXTURE_SLOTS; i++) {
+            if (!(vt->map[i] = SCE_malloc (vt->frame_size))) {
+                SCEE_LogSrc ();
+                return SCE_ERROR;
+            }
+        }
+        return SCE_OK;
+    }
+
+    glGenBuffers (SCE_VIDEO_TEXTURE_SLOTS, vt->pbo);
+    vt->persistent = SCE_RHasCap (SCE_BUFFER_STORAGE) && SCE_RHasCap (SCE_SYNC);
+    for (i = 0; i < SCE_VIDEO_TEXTURE_SLOTS; i++) {
+        glBindBuffer (GL_PIXEL_UNPACK_BUFFER, vt->pbo[i]);
+        if (vt->persistent) {
+            GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT |
+                GL_MAP_COHERENT_BIT;
+            glBufferStorage (GL_PIXEL_UNPACK_BUFFER, vt->frame_size, NULL,
+                             flags);
+            vt->map[i] = glMapBufferRange (GL_PIXEL_UNPACK_BUFFER, 0,
+                                           vt->frame_size, flags);
+        } else
+            glBufferData (GL_PIXEL_UNPACK_BUFFER, vt->frame_size, NULL,
+                          GL_STREAM_DRAW);
+    }
+    glBindBuffer (GL_PIXEL_UNPACK_BUFFER, 0);
+
+    if (glGetError () != GL_NO_ERROR) {
+        SCEE_Log (SCE_GL_ERROR);
+        SCEE_LogMsg ("failed to create the pixel buffers of a video texture");
+        return SCE_ERROR;
+    }
+    return SCE_OK;
+}
+
+/**
+ * \brief Allocates the textures and the pixel buffers of a video texture
+ * \param vt a video texture
+ * \param fmt layout of the frames
+ * \param w \param h size of the frames, the chroma planes are half of it
+ *        rounded up
+ *
+ * Fails when the SCE_TEX_RG capability is missing.
+ * \returns SCE_ERROR on error, SCE_OK otherwise
+ */
+int SCE_RBuildVideoTexture (SCE_RVideoTexture *vt, SCE_RVideoFormat fmt,
+                            int w, int h)
+{
+    unsigned int i, j;
+    int n_comps[SCE_VIDEO_MAX_PLANES] = {1, 1, 1};
+    size_t offset = 0;
+
+    if (w <= 0 || h <= 0) {
+        SCEE_Log (SCE_INVALID_ARG);
+        SCEE_LogMsg ("invalid video size %dx%d", w, h);
+        return SCE_ERROR;
+    }
+    /* the planes are R8 and RG8 textures */
+    if (!SCE_RHasCap (SCE_TEX_RG)) {
+        SCEE_Log (SCE_INVALID_OPERATION);
+        SCEE_LogMsg ("video textures need GL_ARB_texture_rg or GL 3.0");
+        return SCE_ERROR;
+    }
+    vt->format = fmt;
+    vt->width = w;
+    vt->height = h;
+    vt->n_planes = (fmt == SCE_VIDEO_NV12 ? 2 : 3);
+    if (fmt == SCE_VIDEO_NV12) {
+        n_comps[1] = 2;
+        vt->chroma[0] = 1.0f; vt->chroma[1] = 0.0f;
+        vt->chroma[2] = 0.0f; vt->chroma[3] = 1.0f;
+    } else {
+        vt->chroma[0] = 1.0f; vt->chroma[1] = 0.0f;
+        vt->chroma[2] = 1.0f; vt->chroma[3] = 0.0f;
+    }
+
+    for (j = 0; j < vt->n_planes; j++) {
+        vt->plane_w[j] = j ? (w + 1) / 2 : w;
+        vt->plane_h[j] = j ? (h + 1) / 2 : h;
+        /* rows aligned like GL_UNPACK_ALIGNMENT expects them */
+        vt->pitch[j] = ((size_t)vt->plane_w[j] * n_comps[j] + 3) & ~(size_t)3;
+        vt->offset[j] = offset;
+        offset += vt->pitch[j] * vt->plane_h[j];
+        offset = (offset + SCE_VIDEO_ALIGN - 1) &
+            ~(size_t)(SCE_VIDEO_ALIGN - 1);
+    }
+    vt->frame_size = offset;
+
+    for (i = 0; i < SCE_VIDEO_TEXTURE_SLOTS; i++) {
+        for (j = 0; j < vt->n_planes; j++) {
+            if (!(vt->planes[i][j] = SCE_RCreateVideoPlane (vt->plane_w[j],
+                                                            vt->plane_h[j],
+                                                            n_comps[j])))
+                goto fail;
+        }
+    }
+    if (SCE_RBuildVideoBuffers (vt) < 0)
+        goto fail;
+    return SCE_OK;
+fail:
+    SCEE_LogSrc ();
+    return SCE_ERROR;
+}
+
+/**
+ * \brief Sets the conversion of the frames to RGB
+ * \param vt a video texture
+ * \param space the color space of the video, SCE_VIDEO_BT709 by default
+ * \param full TRUE if the components use the whole [0, 255] range, FALSE
+ *        for the usual video range (Y in [16, 235], U and V in [16, 240])
+ */
+void SCE_RSetVideoTextureColorSpace (SCE_RVideoTexture *vt,
+                                     SCE_RVideoColorSpace space, int full)
+{
+    float kr = 0.2126f, kb = 0.0722f, kg;
+    float ys = 1.0f, yo = 0.0f, cs = 1.0f, co = 128.0f / 255.0f;
+    float rv, gu, gv, bu;
+    float *m = vt->matrix;
+
+    if (space == SCE_VIDEO_BT601) {
+        kr = 0.299f;
+        kb = 0.114f;
+    }
+    kg = 1.0f - kr - kb;
+    if (!full) {
+        ys = 255.0f / 219.0f;
+        yo = 16.0f / 255.0f;
+        cs = 255.0f / 224.0f;
+    }
+    rv = 2.0f * (1.0f - kr) * cs;
+    gu = -2.0f * kb * (1.0f - kb) / kg * cs;
+    gv = -2.0f * kr * (1.0f - kr) / kg * cs;
+    bu = 2.0f * (1.0f - kb) * cs;
+
+    m[0] = ys;  m[1] = 0.0f; m[2] = rv;   m[3] = -ys * yo - rv * co;
+    m[4] = ys;  m[5] = gu;   m[6] = gv;   m[7] = -ys * yo - (gu + gv) * co;
+    m[8] = ys;  m[9] = bu;   m[10] = 0.0f; m[11] = -ys * yo - bu * co;
+    m[12] = 0.0f; m[13] = 0.0f; m[14] = 0.0f; m[15] = 1.0f;
+}
+
+
+/**
+ * \brief Gets the memory to decode the next frame into
+ * \param vt a video texture
+ * \param frame receives the planes of the frame
+ * \returns TRUE if \p frame is mapped, FALSE if all the slots are busy, in
+ * which case the frame should be dropped or decoded later
+ *
+ * Must be called by the rendering thread. The planes can be written by any
+ * thread, until SCE_RUnmapVideoFrame() is called with \p frame.
+ */
+int SCE_RMapVideoFrame (SCE_RVideoTexture *vt, SCE_RVideoFrame *frame)
+{
+    int i, slot = -1;
+    unsigned int j;
+    unsigned char *p = NULL;
+
+    for (i = 0; i < SCE_VIDEO_TEXTURE_SLOTS; i++) {
+        if (vt->state[i] == SCE_VIDEO_SLOT_FREE &&
+            (slot < 0 || vt->seq[i] < vt->seq[slot]))
+            slot = i;
+    }
+    if (slot < 0)
+        return SCE_FALSE;
+
+    if (vt->pbo[slot] && !vt->persistent) {
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT;
+        /* the last upload from this buffer has been fenced */
+        if (SCE_RHasCap (SCE_SYNC))
+            flags |= GL_MAP_UNSYNCHRONIZED_BIT;
+        glBindBuffer (GL_PIXEL_UNPACK_BUFFER, vt->pbo[slot]);
+        vt->map[slot] = glMapBufferRange (GL_PIXEL_UNPACK_BUFFER, 0,
+                                          vt->frame_size, flags);
+        glBindBuffer (GL_PIXEL_UNPACK_BUFFER, 0);
+    }
+    if (!(p = vt->map[slot])) {
+        SCEE_Log (SCE_GL_ERROR);
+        SCEE_LogMsg ("failed to map the pixel buffer of a video frame");
+        return SCE_FALSE;
+    }
+
+    for (j = 0; j < SCE_VIDEO_MAX_PLANES; j++) {
+        frame->planes[j] = j < vt->n_planes ? &p[vt->offset[j]] : NULL;
+        frame->pitch[j] = vt->pitch[j];
+        frame->width[j] = vt->plane_w[j];
+        frame->height[j] = vt->plane_h[j];
+    }
+    frame->slot = slot;
+    vt->state[slot] = SCE_VIDEO_SLOT_MAPPED;
+    vt->seq[slot] = ++vt->n_frames;
+    return SCE_TRUE;
+}
+/**
+ * \brief Uploads a frame decoded into the memory given by
+ * SCE_RMapVideoFrame()
+ *
+ * The upload is asynchronous, the frame is sampled once
+ * SCE_RUpdateVideoTexture() finds it done.
+ */
+void SCE_RUnmapVideoFrame (SCE_RVideoTexture *vt, SCE_RVideoFrame *frame)
+{
+    unsigned int j, slot = frame->slot;
+    const unsigned char *base = vt->map[slot];
+
+    if (vt->pbo[slot]) {
+        glBindBuffer (GL_PIXEL_UNPACK_BUFFER, vt->pbo[slot]);
+        if (!vt->persistent) {
+            glUnmapBuffer (GL_PIXEL_UNPACK_BUFFER);
+            vt->map[slot] = NULL;
+        }
+        base = NULL;            /* offsets in the bound buffer */
+    }
+    for (j = 0; j < vt->n_planes; j++) {
+        SCE_RTexture *tex = vt->planes[slot][j];
+        SCE_RUploadTextureTexData (tex, SCE_RGetTextureTexData (tex, 0, 0),
+                                   SCE_TRUE, base + vt->offset[j]);
+    }
+    if (vt->pbo[slot])
+        glBindBuffer (GL_PIXEL_UNPACK_BUFFER, 0);
+
+    if (SCE_RHasCap (SCE_SYNC))
+        vt->fences[slot] = glFenceSync (GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    vt->state[slot] = SCE_VIDEO_SLOT_UPLOADING;
+    frame->planes[0] = frame->planes[1] = frame->planes[2] = NULL;
+}
+/**
+ * \brief Uploads a frame decoded into client memory
+ * \param vt a video texture
+ * \param planes Y, U and V planes, or Y and UV planes
+ * \param pitch bytes between two rows of each plane
+ * \returns TRUE if the frame is uploaded, FALSE if all the slots are busy
+ * \sa SCE_RMapVideoFrame()
+ */
+int SCE_RUploadVideoFrame (SCE_RVideoTexture *vt,
+                           const unsigned char *const *planes,
+                           const size_t *pitch)
+{
+    SCE_RVideoFrame frame;
+    unsigned int j;
+    int y;
+
+    if (!SCE_RMapVideoFrame (vt, &frame))
+        return SCE_FALSE;
+    for (j = 0; j < vt->n_planes; j++) {
+        size_t row = frame.width[j];
+        if (vt->format == SCE_VIDEO_NV12 && j == 1)
+            row *= 2;           /* interleaved UV */
+        for (y = 0; y < frame.height[j]; y++)
+            memcpy (&frame.planes[j][y * frame.pitch[j]],
+                    &planes[j][y * pitch[j]], row);
+    }
+    SCE_RUnmapVideoFrame (vt, &frame);
+    return SCE_TRUE;
+}
+
+/**
+ * \brief Makes the most recent uploaded frame the sampled one
+ * \returns TRUE if the sampled frame changed
+ *
+ * Call it once per frame, before SCE_RUseVideoTexture(). It never waits
+ * for the GPU.
+ */
+int SCE_RUpdateVideoTexture (SCE_RVideoTexture *vt)
+{
+    int i, latest = -1;
+
+    for (i = 0; i < SCE_VIDEO_TEXTURE_SLOTS; i++) {
+        if (vt->state[i] != SCE_VIDEO_SLOT_UPLOADING)
+            continue;
+        if (vt->fences[i]) {
+            if (glClientWaitSync (vt->fences[i], GL_SYNC_FLUSH_COMMANDS_BIT,
+                                  0) == GL_TIMEOUT_EXPIRED)
+                continue;
+            glDeleteSync (vt->fences[i]);
+            vt->fences[i] = NULL;
+        }
+        vt->state[i] = SCE_VIDEO_SLOT_READY;
+    }
+    for (i = 0; i < SCE_VIDEO_TEXTURE_SLOTS; i++) {
+        if (vt->state[i] == SCE_VIDEO_SLOT_READY &&
+            (latest < 0 || vt->seq[i] > vt->seq[latest]))
+            latest = i;
+    }
+    if (latest < 0)
+        return SCE_FALSE;
+
+    for (i = 0; i < SCE_VIDEO_TEXTURE_SLOTS; i++) {
+        if (vt->state[i] == SCE_VIDEO_SLOT_READY && i != latest) {
+            vt->state[i] = SCE_VIDEO_SLOT_FREE;
+            vt->n_dropped++;
+        }
+    }
+    /* the GL orders the next uploads into it after the draws sampling it */
+    if (vt->front >= 0)
+        vt->state[vt->front] = SCE_VIDEO_SLOT_FREE;
+    vt->front = latest;
+    vt->state[latest] = SCE_VIDEO_SLOT_FRONT;
+    return SCE_TRUE;
+}
+/**
+ * \brief Gets the number of frames uploaded but never sampled
+ */
+unsigned int SCE_RGetVideoTextureDroppedFrames (SCE_RVideoTexture *vt)
+{
+    return vt->n_dropped;
+}
+
+
+/**
+ * \brief Gets the GLSL source of the video sampling function
+ *
+ * The source declares the uniforms set by SCE_RUseVideoTexture() and the
+ * function vec3 sce_video_sample (vec2 uv), returning the RGB color of the
+ * frame at \c uv. It needs GLSL 1.30 and has no \#version directive: use
+ * \#include "sce_video.glsl" in the sources given to the shader variants,
+ * or insert it after the \#version directive of a pixel shader.
+ */
+const char* SCE_RGetVideoTextureGLSL (void)
+{
+    return sce_video_glsl;
+}
+
+/**
+ * \brief Binds the planes of the sampled frame and sets the uniforms of
+ * SCE_RGetVideoTextureGLSL()
+ * \param vt a video texture
+ * \param prog the program in use
+ * \param unit texture unit of the Y plane, the next ones get the U and V
+ *        planes (the UV plane for NV12)
+ *
+ * Until a frame is uploaded, the content of the planes is undefined.
+ */
+void SCE_RUseVideoTexture (SCE_RVideoTexture *vt, SCE_RProgram *prog,
+                           int unit)
+{
+    int slot = vt->front >= 0 ? vt->front : 0;
+    unsigned int j;
+
+    for (j = 0; j < vt->n_planes; j++)
+        SCE_RUseTexture (vt->planes[slot][j], unit + j);
+    SCE_RSetProgramParam (SCE_RGetProgramIndex (prog, "sce_video_y"), unit);
+    SCE_RSetProgramParam (SCE_RGetProgramIndex (prog, "sce_video_u"),
+                          unit + 1);
+    SCE_RSetProgramParam (SCE_RGetProgramIndex (prog, "sce_video_v"),
+                          unit + vt->n_planes - 1);
+    SCE_RSetProgramParam4fv (SCE_RGetProgramIndex (prog, "sce_video_chroma"),
+                             1, vt->chroma);
+    SCE_RSetProgramMatrix4 (SCE_RGetProgramIndex (prog, "sce_video_matrix"),
+                            1, vt->matrix);
+}
+
+/** @} */
@@ -0,0 +1,979 @@
+/*------------------------------------------------------------------------------
+    SCEngine - A 3D real time rendering engine written in the C language
+    Copyright (C) 2006-2013  Antony Martin <martin(dot)antony(at)yahoo(dot)fr>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/* created: 19/10/2026
+   updated: 19/10/2026 */
+
+#include <string.h>
+#include <stdlib.h>
+#include <GL/glew.h>
+#include <SCE/utils/SCEUtils.h>
+#include "SCE/renderer/SCERenderer.h"
+#include "SCE/renderer/SCERType.h"
+#include "SCE/renderer/SCERSupport.h"
+#include "SCE/renderer/SCERShaderVariant.h"
+#include "SCE/renderer/SCERVirtualTexture.h"
+
+/**
+ * \file SCERVirtualTexture.c
+ * \copydoc virtualtexture
+ *
+ * \file SCERVirtualTexture.h
+ * \copydoc virtualtexture
+ */
+
+/**
+ * \defgroup virtualtexture Virtual textures
+ * \ingroup renderer-gl
+ * \brief Huge textures of which only the visible pages are resident
+ *
+ * A virtual texture is cut into square pages at every mipmap level, a page
+ * of level \c l at \c (x, y) covers 1/pages_w[l] of the width and
+ * 1/pages_h[l] of the height of the texture. Pages are given by a loader
+ * function run on the worker threads, and uploaded into the slots of a
+ * cache texture. An indirection texture, one texel per page of every
+ * level, tells the shaders which slot holds the most detailed resident
+ * page covering a point. The shaders get the functions with \#include
+ * "sce_vt.glsl", see SCE_RGetVirtualTextureGLSL().
+ *
+ * Each frame, the scene is rendered into a small feedback framebuffer
+ * with the shader function sce_vt_feedback(), writing the page each pixel
+ * needs, see SCE_RBeginVirtualTextureFeedback(). The framebuffer is read
+ * back asynchronously into a ring of pixel buffers, and
+ * SCE_RUpdateVirtualTexture() turns the oldest completed readback into
+ * requests, coarse levels and most seen pages first. Requested pages
+ * evict the least recently seen ones, the loads and the uploads per frame
+ * are bounded by SCE_RSetVirtualTextureBudget(). The top level page is
+ * loaded when building and never evicted, so that something is always
+ * displayed.
+ *
+ * Sampling is bilinear within a level: the borders of the pages, replicated
+ * by the loader, keep the filtering from bleeding into the neighbour slots.
+ * @{
+ */
+
+#define SCE_VT_REQUESTED(v) ((v) <= -2)
+#define SCE_VT_REQUEST_INDEX(v) (-2 - (v))
+
+static const char *sce_vt_glsl =
+    "uniform sampler2D sce_vt_cache;\n"
+    "uniform sampler2D sce_vt_indirection;\n"
+    "/* width, height, page size, border */\n"
+    "uniform vec4 sce_vt_size;\n"
+    "/* cache width, cache height, feedback bias, last level */\n"
+    "uniform vec4 sce_vt_cache_size;\n"
+    "\n"
+    "float sce_vt_level (vec2 uv)\n"
+    "{\n"
+    "    vec2 dx = dFdx (uv * sce_vt_size.xy);\n"
+    "    vec2 dy = dFdy (uv * sce_vt_size.xy);\n"
+    "    float d = max (dot (dx, dx), dot (dy, dy));\n"
+    "    return clamp (0.5 * log2 (max (d, 1.0)), 0.0, sce_vt_cache_size.w);\n"
+    "}\n"
+    "\n"
+    "vec4 sce_vt_sample (vec2 uv)\n"
+    "{\n"
+    "    int level = int (sce_vt_level (uv));\n"
+    "    vec2 pages = vec2 (textureSize (sce_vt_indirection, level));\n"
+    "    ivec2 p = clamp (ivec2 (uv * pages), ivec2 (0), ivec2 (pages) - 1);\n"
+    "    vec4 e = texelFetch (sce_vt_indirection, p, level) * 255.0;\n"
+    "    pages = vec2 (textureSize (sce_vt_indirection, int (e.z)));\n"
+    "    float full = sce_vt_size.z + 2.0 * sce_vt_size.w;\n"
+    "    vec2 t = e.xy * full + sce_vt_size.w\n"
+    "           + clamp (fract (uv * pages), 0.0, 1.0) * sce_vt_size.z;\n"
+    "    return textureLod (sce_vt_cache, t / sce_vt_cache_size.xy, 0.0);\n"
+    "}\n"
+    "\n"
+    "vec4 sce_vt_feedback (vec2 uv)\n"
+    "{\n"
+    "    float l = max (sce_vt_level (uv) - sce_vt_cache_size.z, 0.0);\n"
+    "    int level = int (l);\n"
+    "    ivec2 pages = textureSize (sce_vt_indirection, level);\n"
+    "    ivec2 p = clamp (ivec2 (uv * vec2 (pages)), ivec2 (0), pages - 1);\n"
+    "    return vec4 (float (p.x & 255), float (p.y & 255),\n"
+    "                 float ((p.x >> 8) | ((p.y >> 8) << 4)),\n"
+    "                 float (level + 1)) / 255.0;\n"
+    "}\n";
+
+/** Name of the GLSL functions for the \#include directive */
+#define SCE_VT_INCLUDE "sce_vt.glsl"
+
+
+/**
+ * \internal
+ * \brief Registers the GLSL include of the virtual textures
+ */
+int SCE_RVirtualTextureInit (void)
+{
+    if (SCE_RAddShaderInclude (SCE_VT_INCLUDE, sce_vt_glsl) < 0) {
+        SCEE_LogSrc ();
+        return SCE_ERROR;
+    }
+    return SCE_OK;
+}
+/**
+ * \internal
+ */
+void SCE_RVirtualTextureQuit (void)
+{
+    SCE_RRemoveShaderInclude (SCE_VT_INCLUDE);
+}
+
+
+static void SCE_RInitVirtualPage (SCE_RVirtualPage *page,
+                                  SCE_RVirtualTexture *vt, int slot)
+{
+    page->vt = vt;
+    page->slot = slot;
+    page->state = SCE_VT_PAGE_FREE;
+    page->level = page->x = page->y = 0;
+    page->last_used = 0;
+    page->pinned = SCE_FALSE;
+    page->texels = NULL;
+    page->loaded = SCE_FALSE;
+    SCE_RInitWorkerJob (&page->job, NULL, NULL);
+    SCE_List_InitIt (&page->it);
+    SCE_List_SetData (&page->it, page);
+}
+
+void SCE_RInitVirtualTexture (SCE_RVirtualTexture *vt)
+{
+    int i;
+    vt->width = vt->height = 0;
+    vt->page_size = 0;
+    vt->border = 0;
+    vt->n_levels = 0;
+    for (i = 0; i < SCE_VT_MAX_LEVELS; i++) {
+        vt->pages_w[i] = vt->pages_h[i] = 0;
+        vt->table[i] = NULL;
+        vt->indirection_data[i] = NULL;
+    }
+    vt->indirection = NULL;
+    vt->indirection_dirty = SCE_FALSE;
+    vt->cache = NULL;
+    vt->cache_w = vt->cache_h = 0;
+    vt->pages = NULL;
+    vt->free_slots = NULL;
+    vt->n_free = 0;
+    SCE_List_Init (&vt->lru);
+    SCE_List_Init (&vt->loading);
+    vt->load = NULL;
+    vt->load_data = NULL;
+    vt->max_loads = 16;
+    vt->max_uploads = 8;
+    vt->feedback = NULL;
+    vt->feedback_w = vt->feedback_h = 0;
+    vt->feedback_bias = 0.0f;
+    for (i = 0; i < SCE_VT_READBACK_FRAMES; i++) {
+        vt->pbo[i] = 0;
+        vt->fences[i] = NULL;
+    }
+    vt->rb_head = vt->rb_tail = 0;
+    vt->readback = NULL;
+    vt->requests = NULL;
+    vt->n_requests = vt->max_requests = 0;
+    vt->frame = 0;
+    vt->n_uploaded = vt->n_evicted = 0;
+}
+
+static void SCE_RClearVirtualTextureFeedback (SCE_RVirtualTexture *vt)
+{
+    int i;
+    for (i = 0; i < SCE_VT_READBACK_FRAMES; i++) {
+        if (vt->fences[i])
+            glDeleteSync (vt->fences[i]);
+        vt->fences[i] = NULL;
+    }
+    if (vt->pbo[0])
+        glDeleteBuffers (SCE_VT_READBACK_FRAMES, vt->pbo);
+    for (i = 0; i < SCE_VT_READBACK_FRAMES; i++)
+        vt->pbo[i] = 0;
+    vt->rb_head = vt->rb_tail = 0;
+    SCE_free (vt->readback);
+    vt->readback = NULL;
+    SCE_RDeleteFramebuffer (vt->feedback);
+    vt->feedback = NULL;
+}
+
+void SCE_RClearVirtualTexture (SCE_RVirtualTexture *vt)
+{
+    int i;
+    if (vt->pages) {
+        /* the jobs write into the pages */
+        for (i = 0; i < vt->cache_w * vt->cache_h; i++) {
+            if (vt->pages[i].state == SCE_VT_PAGE_LOADING)
+                SCE_RWaitWorkerJob (&vt->pages[i].job);
+            SCE_free (vt->pages[i].texels);
+        }
+    }
+    SCE_List_Flush (&vt->loading);
+    SCE_List_Flush (&vt->lru);
+    SCE_free (vt->pages);
+    SCE_free (vt->free_slots);
+    for (i = 0; i < SCE_VT_MAX_LEVELS; i++)
+        SCE_free (vt->table[i]);
+    /* indirection_data is owned by the texture */
+    SCE_RDeleteTexture (vt->indirection);
+    SCE_RDeleteTexture (vt->cache);
+    SCE_RClearVirtualTextureFeedback (vt);
+    SCE_free (vt->requests);
+}
+
+SCE_RVirtualTexture* SCE_RCreateVirtualTexture (void)
+{
+    SCE_RVirtualTexture *vt = NULL;
+    if (!(vt = SCE_malloc (sizeof *vt)))
+        SCEE_LogSrc ();
+    else
+        SCE_RInitVirtualTexture (vt);
+    return vt;
+}
+
+void SCE_RDeleteVirtualTexture (SCE_RVirtualTexture *vt)
+{
+    if (vt) {
+        SCE_RClearVirtualTexture (vt);
+        SCE_free (vt);
+    }
+}
+
+/**
+ * \brief Bounds the work done by SCE_RUpdateVirtualTexture()
+ * \param vt a virtual texture
+ * \param loads maximum number of page loads started per frame
+ * \param uploads maximum number of pages uploaded per frame
+ */
+void SCE_RSetVirtualTextureBudget (SCE_RVirtualTexture *vt,
+                                   unsigned int loads, unsigned int uploads)
+{
+    vt->max_loads = MAX (loads, 1);
+    vt->max_uploads = MAX (uploads, 1);
+}
+
+
+static size_t SCE_RGetVirtualPageSize (const SCE_RVirtualTexture *vt)
+{
+    size_t full = vt->page_size + 2 * vt->border;
+    return full * full * 4;
+}
+
+static SCE_RTexture* SCE_RCreateVirtualTextureCache (SCE_RVirtualTexture *vt)
+{
+    SCE_RTexture *tex = NULL;
+    int full = vt->page_size + 2 * vt->border;
+    int w = vt->cache_w * full, h = vt->cache_h * full;
+
+    if (!(tex = SCE_RCreateTexture (SCE_TEX_2D)))
+        return NULL;
+    SCE_RBindTexture (tex);
+    if (SCE_RHasCap (SCE_TEX_STORAGE))
+        glTexStorage2D (tex->target, 1, GL_RGBA8, w, h);
+    else
+        glTexImage2D (tex->target, 0, GL_RGBA8, w, h, 0, GL_RGBA,
+                      GL_UNSIGNED_BYTE, NULL);
+    glTexParameteri (tex->target, GL_TEXTURE_MAX_LEVEL, 0);
+    SCE_RSetTextureFilter (tex, SCE_TEX_LINEAR);
+    SCE_RPixelizeTexture (tex, SCE_FALSE);
+    SCE_RSetTextureWrapMode (tex, SCE_TEX_CLAMP);
+    return tex;
+}
+
+static SCE_RTexture*
+SCE_RCreateVirtualTextureIndirection (SCE_RVirtualTexture *vt)
+{
+    SCE_RTexture *tex = NULL;
+    SCE_STexData *d = NULL;
+    int i;
+
+    if (!(tex = SCE_RCreateTexture (SCE_TEX_2D)))
+        goto fail;
+    for (i = 0; i < vt->n_levels; i++) {
+        size_t size = vt->pages_w[i] * vt->pages_h[i] * 4;
+        if (!(d = SCE_TexData_Create ()))
+            goto fail;
+        if (!(vt->indirection_data[i] = SCE_malloc (size)))
+            goto fail;
+        memset (vt->indirection_data[i], 0, size);
+        SCE_TexData_SetDimensions (d, vt->pages_w[i], vt->pages_h[i], 1);
+        SCE_TexData_SetPixelFormat (d, SCE_PXF_RGBA);
+        SCE_TexData_SetDataType (d, SCE_UNSIGNED_BYTE);
+        SCE_TexData_SetDataFormat (d, SCE_IMAGE_RGBA);
+        SCE_TexData_SetMipmapLevel (d, i);
+        SCE_TexData_SetData (d, vt->indirection_data[i], SCE_TRUE);
+        SCE_RAddTextureTexData (tex, 0, d);
+        d = NULL;
+    }
+    SCE_RSetTextureFilter (tex, SCE_TEX_BILINEAR);
+    SCE_RPixelizeTexture (tex, SCE_TRUE);
+    SCE_RSetTextureWrapMode (tex, SCE_TEX_CLAMP);
+    return tex;
+fail:
+    if (i < vt->n_levels) {
+        SCE_free (vt->indirection_data[i]);
+        vt->indirection_data[i] = NULL;
+    }
+    SCE_TexData_Delete (d);
+    SCE_RDeleteTexture (tex);
+    SCEE_LogSrc ();
+    return NULL;
+}
+
+
+static int* SCE_RGetVirtualPageEntry (SCE_RVirtualTexture *vt, int level,
+                                      int x, int y)
+{
+    return &vt->table[level][y * vt->pages_w[level] + x];
+}
+
+static void SCE_RSetIndirectionEntry (SCE_RVirtualTexture *vt, int level,
+                                      int x, int y)
+{
+    unsigned char *e = &vt->indirection_data[level][(y * vt->pages_w[level]
+                                                     + x) * 4];
+    int slot = *SCE_RGetVirtualPageEntry (vt, level, x, y);
+
+    if (slot >= 0 && vt->pages[slot].state == SCE_VT_PAGE_RESIDENT) {
+        e[0] = slot % vt->cache_w;
+        e[1] = slot / vt->cache_w;
+        e[2] = level;
+        e[3] = 255;
+    } else if (level + 1 < vt->n_levels) {
+        /* fall back to the parent, already up to date */
+        int px = x * vt->pages_w[level + 1] / vt->pages_w[level];
+        int py = y * vt->pages_h[level + 1] / vt->pages_h[level];
+        memcpy (e, &vt->indirection_data[level + 1][
+                    (py * vt->pages_w[level + 1] + px) * 4], 4);
+    } else
+        memset (e, 0, 4);
+}
+
+/* updates the indirection entries covered by a page that has been loaded
+ * or evicted, coarse levels first */
+static void SCE_RUpdateIndirection (SCE_RVirtualTexture *vt, int level,
+                                    int x, int y)
+{
+    int l, i, j;
+
+    for (l = level; l >= 0; l--) {
+        int rw = vt->pages_w[l] / vt->pages_w[level];
+        int rh = vt->pages_h[l] / vt->pages_h[level];
+        int x0 = x * rw, y0 = y * rh;
+        for (j = y0; j < y0 + rh; j++) {
+            for (i = x0; i < x0 + rw; i++)
+                SCE_RSetIndirectionEntry (vt, l, i, j);
+        }
+        SCE_RAddTextureDirtyBox (vt->indirection, 0, l, x0, y0, 0, rw, rh, 1);
+    }
+    vt->indirection_dirty = SCE_TRUE;
+}
+
+
+static void SCE_RLoadVirtualPage (void *data)
+{
+    SCE_RVirtualPage *page = data;
+    SCE_RVirtualTexture *vt = page->vt;
+    page->loaded = vt->load (page->level, page->x, page->y, page->texels,
+                             vt->load_data) >= 0;
+}
+
+static void SCE_RUploadVirtualPage (SCE_RVirtualTexture *vt,
+                                    SCE_RVirtualPage *page)
+{
+    int full = vt->page_size + 2 * vt->border;
+    SCEint unpack;
+    SCE_RBindTexture (vt->cache);
+    glGetIntegerv (GL_UNPACK_ALIGNMENT, &unpack);
+    glPixelStorei (GL_UNPACK_ALIGNMENT, 1);
+    glTexSubImage2D (vt->cache->target, 0, (page->slot % vt->cache_w) * full,
+                     (page->slot / vt->cache_w) * full, full, full, GL_RGBA,
+                     GL_UNSIGNED_BYTE, page->texels);
+    glPixelStorei (GL_UNPACK_ALIGNMENT, unpack);
+}
+
+/* takes a free slot, or evicts the least recently seen page */
+static SCE_RVirtualPage* SCE_RAcquireVirtualPage (SCE_RVirtualTexture *vt)
+{
+    SCE_RVirtualPage *page = NULL;
+    SCE_SListIterator *it = NULL;
+
+    if (vt->n_free > 0)
+        return &vt->pages[vt->free_slots[--vt->n_free]];
+
+    SCE_List_ForEach (it, &vt->lru) {
+        SCE_RVirtualPage *p = SCE_List_GetData (it);
+        if (p->last_used >= vt->frame)
+            return NULL;        /* everything else is visible too */
+        if (!p->pinned) {
+            page = p;
+            break;
+        }
+    }
+    if (!page)
+        return NULL;
+    SCE_List_Remove (&page->it);
+    page->state = SCE_VT_PAGE_FREE;
+    *SCE_RGetVirtualPageEntry (vt, page->level, page->x, page->y) = -1;
+    SCE_RUpdateIndirection (vt, page->level, page->x, page->y);
+    vt->n_evicted++;
+    return page;
+}
+
+static void SCE_RReleaseVirtualPage (SCE_RVirtualTexture *vt,
+                                     SCE_RVirtualPage *page)
+{
+    page->state = SCE_VT_PAGE_FREE;
+    SCE_free (page->texels);
+    page->texels = NULL;
+    vt->free_slots[vt->n_free++] = page->slot;
+}
+
+static void SCE_RMakeVirtualPageResident (SCE_RVirtualTexture *vt,
+                                          SCE_RVirtualPage *page)
+{
+    SCE_RUploadVirtualPage (vt, page);
+    SCE_free (page->texels);
+    page->texels = NULL;
+    page->state = SCE_VT_PAGE_RESIDENT;
+    page->last_used = vt->frame;
+    SCE_List_Appendl (&vt->lru, &page->it);
+    SCE_RUpdateIndirection (vt, page->level, page->x, page->y);
+}
+
+/* reserves a slot for a page and starts loading it */
+static int SCE_RRequestVirtualPage (SCE_RVirtualTexture *vt, int level,
+                                    int x, int y)
+{
+    SCE_RVirtualPage *page = NULL;
+
+    if (!(page = SCE_RAcquireVirtualPage (vt)))
+        return SCE_ERROR;
+    if (!page->texels && !(page->texels = SCE_malloc (
+                               SCE_RGetVirtualPageSize (vt)))) {
+        vt->free_slots[vt->n_free++] = page->slot;
+        return SCE_ERROR;
+    }
+    page->state = SCE_VT_PAGE_LOADING;
+    page->level = level;
+    page->x = x;
+    page->y = y;
+    page->last_used = vt->frame;
+    page->loaded = SCE_FALSE;
+    *SCE_RGetVirtualPageEntry (vt, level, x, y) = page->slot;
+    SCE_List_Appendl (&vt->loading, &page->it);
+    SCE_RInitWorkerJob (&page->job, SCE_RLoadVirtualPage, page);
+    SCE_RPushWorkerJob (&page->job);
+    return SCE_OK;
+}
+
+
+/**
+ * \brief Builds a virtual texture and loads its top level page
+ * \param vt a virtual texture
+ * \param w \param h size of the virtual texture, powers of two
+ * \param page_size size of the side of a page, border excluded, power of two
+ * \param border number of texels replicated around each page by the loader
+ * \param cache_w \param cache_h size of the cache, in pages, at most 256
+ * \param load the page loader, must be thread-safe
+ * \param data given to \p load
+ *
+ * The top level page is loaded immediately and never evicted.
+ * \returns SCE_ERROR on error, SCE_OK otherwise
+ * \sa SCE_RBuildVirtualTextureFeedback()
+ */
+int SCE_RBuildVirtualTexture (SCE_RVirtualTexture *vt, int w, int h,
+                              int page_size, int border, int cache_w,
+                              int cache_h, SCE_FLoadVirtualPage load,
+                              void *data)
+{
+    int i, n_slots, full = page_size + 2 * border;
+    int pw, ph;
+    SCE_RVirtualPage *top = NULL;
+
+    if (w < page_size || h < page_size || page_size <= 0 || border < 0 ||
+        !SCE_Math_PowerOfTwo (w) || !SCE_Math_PowerOfTwo (h) ||
+        !SCE_Math_PowerOfTwo (page_size) || cache_w <= 0 || cache_h <= 0 ||
+        cache_w > 256 || cache_h > 256 || !load) {
+        SCEE_Log (SCE_INVALID_ARG);
+        SCEE_LogMsg ("invalid virtual texture parameters");
+        return SCE_ERROR;
+    }
+    if (cache_w * full > SCE_RGetMaxTextureSize () ||
+        cache_h * full > SCE_RGetMaxTextureSize ()) {
+        SCEE_Log (SCE_INVALID_ARG);
+        SCEE_LogMsg ("virtual texture cache of %dx%d pages of %d texels is "
+                     "too big", cache_w, cache_h, full);
+        return SCE_ERROR;
+    }
+
+    vt->width = w;
+    vt->height = h;
+    vt->page_size = page_size;
+    vt->border = border;
+    vt->load = load;
+    vt->load_data = data;
+    pw = w / page_size;
+    ph = h / page_size;
+    for (vt->n_levels = 0; ; vt->n_levels++) {
+        if (vt->n_levels >= SCE_VT_MAX_LEVELS) {
+            SCEE_Log (SCE_INVALID_ARG);
+            SCEE_LogMsg ("virtual texture has more than %d levels",
+                         SCE_VT_MAX_LEVELS);
+            return SCE_ERROR;
+        }
+        vt->pages_w[vt->n_levels] = pw;
+        vt->pages_h[vt->n_levels] = ph;
+        if (pw == 1 && ph == 1)
+            break;
+        pw = MAX (pw / 2, 1);
+        ph = MAX (ph / 2, 1);
+    }
+    vt->n_levels++;
+
+    for (i = 0; i < vt->n_levels; i++) {
+        size_t n = vt->pages_w[i] * vt->pages_h[i];
+        if (!(vt->table[i] = SCE_malloc (n * sizeof *vt->table[i])))
+            goto fail;
+        memset (vt->table[i], 0xff, n * sizeof *vt->table[i]);
+    }
+
+    vt->cache_w = cache_w;
+    vt->cache_h = cache_h;
+    n_slots = cache_w * cache_h;
+    if (!(vt->pages = SCE_malloc (n_slots * sizeof *vt->pages)) ||
+        !(vt->free_slots = SCE_malloc (n_slots * sizeof *vt->free_slots)))
+        goto fail;
+    for (i = 0; i < n_slots; i++) {
+        SCE_RInitVirtualPage (&vt->pages[i], vt, i);
+        vt->free_slots[i] = n_slots - 1 - i;
+    }
+    vt->n_free = n_slots;
+
+    if (!(vt->cache = SCE_RCreateVirtualTextureCache (vt)) ||
+        !(vt->indirection = SCE_RCreateVirtualTextureIndirection (vt)))
+        goto fail;
+
+    /* the top level page, synchronously */
+    top = &vt->pages[vt->free_slots[--vt->n_free]];
+    if (!(top->texels = SCE_malloc (SCE_RGetVirtualPageSize (vt))))
+        goto fail;
+    top->level = vt->n_levels - 1;
+    top->x = top->y = 0;
+    top->pinned = SCE_TRUE;
+    if (load (top->level, 0, 0, top->texels, data) < 0) {
+        SCEE_LogSrc ();
+        SCEE_LogSrcMsg ("failed to load the top level page");
+        return SCE_ERROR;
+    }
+    *SCE_RGetVirtualPageEntry (vt, top->level, 0, 0) = top->slot;
+    SCE_RMakeVirtualPageResident (vt, top);
+    SCE_RBuildTexture (vt->indirection, SCE_TRUE, SCE_FALSE);
+    vt->indirection_dirty = SCE_FALSE;
+    return SCE_OK;
+fail:
+    SCEE_LogSrc ();
+    return SCE_ERROR;
+}
+
+/**
+ * \brief Creates the feedback framebuffer of a virtual texture
+ * \param vt a virtual texture built by SCE_RBuildVirtualTexture()
+ * \param w \param h size of the screen
+ * \param divisor the feedback framebuffer is \p divisor times smaller than
+ *        the screen, a power of two
+ *
+ * Readbacks are asynchronous when pixel buffers and sync objects are
+ * supported, otherwise glReadPixels() stalls until the feedback pass is
+ * rendered.
+ * \returns SCE_ERROR on error, SCE_OK otherwise
+ */
+int SCE_RBuildVirtualTextureFeedback (SCE_RVirtualTexture *vt, int w, int h,
+                                      int divisor)
+{
+    size_t size;
+    int i;
+
+    SCE_RClearVirtualTextureFeedback (vt);
+    divisor = MAX (divisor, 1);
+    vt->feedback_w = MAX (w / divisor, 1);
+    vt->feedback_h = MAX (h / divisor, 1);
+    for (vt->feedback_bias = 0.0f, i = divisor; i > 1; i /= 2)
+        vt->feedback_bias += 1.0f;
+    size = vt->feedback_w * vt->feedback_h * 4;
+
+    if (!(vt->feedback = SCE_RCreateFramebuffer ()))
+        goto fail;
+    if (!SCE_RAddNewRenderTexture (vt->feedback, SCE_COLOR_BUFFER0,
+                                   SCE_PXF_RGBA, SCE_IMAGE_RGBA,
+                                   SCE_UNSIGNED_BYTE, vt->feedback_w,
+                                   vt->feedback_h))
+        goto fail;
+    if (SCE_RAddRenderBuffer (vt->feedback, SCE_DEPTH_BUFFER, SCE_PXF_NONE,
+                              vt->feedback_w, vt->feedback_h) < 0)
+        goto fail;
+
+    if (SCE_RHasCap (SCE_PBO) && SCE_RHasCap (SCE_SYNC)) {
+        glGenBuffers (SCE_VT_READBACK_FRAMES, vt->pbo);
+        for (i = 0; i < SCE_VT_READBACK_FRAMES; i++) {
+            glBindBuffer (GL_PIXEL_PACK_BUFFER, vt->pbo[i]);
+            glBufferData (GL_PIXEL_PACK_BUFFER, size, NULL, GL_STREAM_READ);
+        }
+        glBindBuffer (GL_PIXEL_PACK_BUFFER, 0);
+    } else if (!(vt->readback = SCE_malloc (size)))
+        goto fail;
+    return SCE_OK;
+fail:
+    SCE_RClearVirtualTextureFeedback (vt);
+    SCEE_LogSrc ();
+    return SCE_ERROR;
+}
+
+
+/**
+ * \brief Gets the GLSL source of the virtual texturing functions
+ *
+ * The source declares the uniforms set by SCE_RUseVirtualTexture() and the
+ * functions:
+ * - vec4 sce_vt_sample (vec2 uv), samples the virtual texture
+ * - vec4 sce_vt_feedback (vec2 uv), the color to write during the
+ *   feedback pass
+ *
+ * It needs GLSL 1.30 and has no \#version directive: use
+ * \#include "sce_vt.glsl" in the sources given to the shader variants,
+ * insert it after the \#version directive of a pixel shader, or build it
+ * alone with SCE_RCreateVirtualTextureShader() and declare the prototypes of
+ * the functions in the other shaders of the program.
+ */
+const char* SCE_RGetVirtualTextureGLSL (void)
+{
+    return sce_vt_glsl;
+}
+
+/**
+ * \brief Creates a pixel shader of the virtual texturing functions
+ *
+ * Attach it to a program with SCE_RSetProgramShader().
+ * \returns a new built shader, NULL on error
+ * \sa SCE_RGetVirtualTextureGLSL()
+ */
+SCE_RShaderGLSL* SCE_RCreateVirtualTextureShader (void)
+{
+    SCE_RShaderGLSL *shader = NULL;
+    char *src = NULL;
+
+    src = SCE_RPreprocessShaderSource ("#version 130\n"
+                                       "#include \"" SCE_VT_INCLUDE "\"\n",
+                                       NULL, 0);
+    if (!src)
+        goto fail;
+    if (!(shader = SCE_RCreateShaderGLSL (SCE_PIXEL_SHADER)))
+        goto fail;
+    SCE_RSetShaderGLSLSource (shader, src);
+    if (SCE_RBuildShaderGLSL (shader) < 0)
+        goto fail;
+    /* the shader doesn't own its source */
+    SCE_RSetShaderGLSLSource (shader, NULL);
+    SCE_free (src);
+    return shader;
+fail:
+    SCE_RDeleteShaderGLSL (shader);
+    SCE_free (src);
+    SCEE_LogSrc ();
+    return NULL;
+}
+
+
+/**
+ * \brief Starts the feedback pass of a virtual texture
+ *
+ * Binds and clears the feedback framebuffer, render the scene after with
+ * shaders writing sce_vt_feedback(), then call
+ * SCE_REndVirtualTextureFeedback().
+ */
+void SCE_RBeginVirtualTextureFeedback (SCE_RVirtualTexture *vt)
+{
+    const float zero[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    const float one = 1.0f;
+
+    SCE_RUseFramebuffer (vt->feedback, NULL, -1);
+    glClearBufferfv (GL_COLOR, 0, zero);
+    glClearBufferfv (GL_DEPTH, 0, &one);
+}
+
+/**
+ * \brief Ends the feedback pass of a virtual texture, reads it back
+ *
+ * When the readbacks of the previous frames are all still in flight, the
+ * feedback of this frame is dropped rather than waited for.
+ */
+void SCE_REndVirtualTextureFeedback (SCE_RVirtualTexture *vt)
+{
+    glReadBuffer (GL_COLOR_ATTACHMENT0);
+    if (vt->pbo[0]) {
+        if (vt->rb_head - vt->rb_tail < SCE_VT_READBACK_FRAMES) {
+            unsigned int i = vt->rb_head % SCE_VT_READBACK_FRAMES;
+            glBindBuffer (GL_PIXEL_PACK_BUFFER, vt->pbo[i]);
+            glReadPixels (0, 0, vt->feedback_w, vt->feedback_h, GL_RGBA,
+                          GL_UNSIGNED_BYTE, NULL);
+            glBindBuffer (GL_PIXEL_PACK_BUFFER, 0);
+            vt->fences[i] = glFenceSync (GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            vt->rb_head++;
+        }
+    } else {
+        glPixelStorei (GL_PACK_ALIGNMENT, 1);
+        glReadPixels (0, 0, vt->feedback_w, vt->feedback_h, GL_RGBA,
+                      GL_UNSIGNED_BYTE, vt->readback);
+        glPixelStorei (GL_PACK_ALIGNMENT, 4);
+        vt->rb_tail = vt->rb_head;
+        vt->rb_head++;
+    }
+    SCE_RUseFramebuffer (NULL, NULL, -1);
+}
+
+
+static void SCE_RTouchVirtualPage (SCE_RVirtualTexture *vt,
+                                   SCE_RVirtualPage *page)
+{
+    page->last_used = vt->frame;
+    if (page->state == SCE_VT_PAGE_RESIDENT) {
+        SCE_List_Remove (&page->it);
+        SCE_List_Appendl (&vt->lru, &page->it);
+    }
+}
+
+static int SCE_RAddVirtualPageRequest (SCE_RVirtualTexture *vt, int level,
+                                       int x, int y)
+{
+    SCE_RVirtualPageRequest *r = NULL;
+
+    if (vt->n_requests >= vt->max_requests) {
+        size_t n = MAX (vt->max_requests * 2, 64);
+        if (!(r = SCE_realloc (vt->requests, n * sizeof *r)))
+            return SCE_ERROR;
+        vt->requests = r;
+        vt->max_requests = n;
+    }
+    r = &vt->requests[vt->n_requests];
+    r->level = level;
+    r->x = x;
+    r->y = y;
+    r->count = 1;
+    *SCE_RGetVirtualPageEntry (vt, level, x, y) = -2 - vt->n_requests;
+    vt->n_requests++;
+    return SCE_OK;
+}
+
+/* touches the page seen by a feedback pixel and its ancestors, or requests
+ * those that are absent */
+static void SCE_RProcessFeedbackPixel (SCE_RVirtualTexture *vt,
+                                       const unsigned char *p)
+{
+    int level = p[3] - 1;
+    int x = p[0] | (p[2] & 0xf) << 8;
+    int y = p[1] | (p[2] >> 4) << 8;
+
+    if (level >= vt->n_levels || x >= vt->pages_w[level] ||
+        y >= vt->pages_h[level])
+        return;
+
+    for (; level < vt->n_levels; level++) {
+        int *v = SCE_RGetVirtualPageEntry (vt, level, x, y);
+        if (*v >= 0) {
+            SCE_RVirtualPage *page = &vt->pages[*v];
+            if (page->last_used == vt->frame)
+                break;          /* and so are its ancestors */
+            SCE_RTouchVirtualPage (vt, page);
+        } else if (SCE_VT_REQUESTED (*v)) {
+            vt->requests[SCE_VT_REQUEST_INDEX (*v)].count++;
+        } else if (SCE_RAddVirtualPageRequest (vt, level, x, y) < 0)
+            break;
+        if (level + 1 < vt->n_levels) {
+            x = x * vt->pages_w[level + 1] / vt->pages_w[level];
+            y = y * vt->pages_h[level + 1] / vt->pages_h[level];
+        }
+    }
+}
+
+static void SCE_RProcessFeedback (SCE_RVirtualTexture *vt,
+                                  const unsigned char *pixels)
+{
+    size_t i, n = vt->feedback_w * vt->feedback_h;
+    unsigned int prev = 0;
+
+    for (i = 0; i < n; i++, pixels += 4) {
+        unsigned int v;
+        if (!pixels[3])
+            continue;
+        /* neighbour pixels mostly see the same page */
+        memcpy (&v, pixels, 4);
+        if (v == prev)
+            continue;
+        prev = v;
+        SCE_RProcessFeedbackPixel (vt, pixels);
+    }
+}
+
+static int SCE_RCompareVirtualPageRequests (const void *a, const void *b)
+{
+    const SCE_RVirtualPageRequest *r1 = a, *r2 = b;
+    if (r1->level != r2->level)
+        return r2->level - r1->level;
+    return (r2->count > r1->count) - (r2->count < r1->count);
+}
+
+/* reads back the completed feedback passes, returns whether any was */
+static int SCE_RReadVirtualTextureFeedback (SCE_RVirtualTexture *vt)
+{
+    int read = SCE_FALSE;
+
+    if (!vt->pbo[0]) {
+        if (vt->rb_tail == vt->rb_head)
+            return SCE_FALSE;
+        SCE_RProcessFeedback (vt, vt->readback);
+        vt->rb_tail = vt->rb_head;
+        return SCE_TRUE;
+    }
+
+    while (vt->rb_tail != vt->rb_head) {
+        unsigned int i = vt->rb_tail % SCE_VT_READBACK_FRAMES;
+        const unsigned char *p = NULL;
+        GLenum status = glClientWaitSync (vt->fences[i], 0, 0);
+        if (status != GL_ALREADY_SIGNALED &&
+            status != GL_CONDITION_SATISFIED)
+            break;
+        glDeleteSync (vt->fences[i]);
+        vt->fences[i] = NULL;
+        glBindBuffer (GL_PIXEL_PACK_BUFFER, vt->pbo[i]);
+        p = glMapBufferRange (GL_PIXEL_PACK_BUFFER, 0,
+                              vt->feedback_w * vt->feedback_h * 4,
+                              GL_MAP_READ_BIT);
+        if (p) {
+            SCE_RProcessFeedback (vt, p);
+            glUnmapBuffer (GL_PIXEL_PACK_BUFFER);
+            read = SCE_TRUE;
+        }
+        glBindBuffer (GL_PIXEL_PACK_BUFFER, 0);
+        vt->rb_tail++;
+    }
+    return read;
+}
+
+/* starts loading the most wanted requests, forgets the others */
+static void SCE_RServeVirtualPageRequests (SCE_RVirtualTexture *vt)
+{
+    size_t i;
+    unsigned int started = 0;
+
+    qsort (vt->requests, vt->n_requests, sizeof *vt->requests,
+           SCE_RCompareVirtualPageRequests);
+    for (i = 0; i < vt->n_requests; i++) {
+        SCE_RVirtualPageRequest *r = &vt->requests[i];
+        *SCE_RGetVirtualPageEntry (vt, r->level, r->x, r->y) = -1;
+        if (started < vt->max_loads &&
+            SCE_RRequestVirtualPage (vt, r->level, r->x, r->y) == SCE_OK)
+            started++;
+    }
+    vt->n_requests = 0;
+}
+
+static void SCE_RUploadVirtualPages (SCE_RVirtualTexture *vt)
+{
+    SCE_SListIterator *it = NULL, *pro = NULL;
+
+    SCE_List_ForEachProtected (pro, it, &vt->loading) {
+        SCE_RVirtualPage *page = SCE_List_GetData (it);
+        if (vt->n_uploaded >= vt->max_uploads)
+            break;
+        if (!SCE_RIsWorkerJobDone (&page->job))
+            continue;
+        SCE_List_Remove (it);
+        if (page->loaded) {
+            SCE_RMakeVirtualPageResident (vt, page);
+            vt->n_uploaded++;
+        } else {
+            *SCE_RGetVirtualPageEntry (vt, page->level, page->x,
+                                       page->y) = -1;
+            SCE_RReleaseVirtualPage (vt, page);
+        }
+    }
+}
+
+/**
+ * \brief Updates the resident pages of a virtual texture
+ * \param vt a virtual texture
+ *
+ * Call it once per frame, after SCE_REndVirtualTextureFeedback(). Processes
+ * the completed readbacks, starts the loads of the requested pages,
+ * uploads the loaded pages and the modified parts of the indirection
+ * texture, within the budget set by SCE_RSetVirtualTextureBudget().
+ */
+void SCE_RUpdateVirtualTexture (SCE_RVirtualTexture *vt)
+{
+    vt->frame++;
+    vt->n_uploaded = vt->n_evicted = 0;
+
+    if (SCE_RReadVirtualTextureFeedback (vt))
+        SCE_RServeVirtualPageRequests (vt);
+    SCE_RUploadVirtualPages (vt);
+
+    if (vt->indirection_dirty) {
+        SCE_RUpdateTexture (vt->indirection, SCE_TRUE, SCE_FALSE);
+        vt->indirection_dirty = SCE_FALSE;
+    }
+}
+
+/**
+ * \brief Binds the textures of a virtual texture and sets the uniforms of
+ * SCE_RGetVirtualTextureGLSL()
+ * \param vt a virtual texture
+ * \param prog the program in use
+ * \param unit texture unit of the cache, the indirection uses \p unit + 1
+ */
+void SCE_RUseVirtualTexture (SCE_RVirtualTexture *vt, SCE_RProgram *prog,
+                             int unit)
+{
+    float size[4], cache[4];
+    int full = vt->page_size + 2 * vt->border;
+
+    SCE_RUseTexture (vt->cache, unit);
+    SCE_RUseTexture (vt->indirection, unit + 1);
+    size[0] = vt->width;
+    size[1] = vt->height;
+    size[2] = vt->page_size;
+    size[3] = vt->border;
+    cache[0] = vt->cache_w * full;
+    cache[1] = vt->cache_h * full;
+    cache[2] = vt->feedback_bias;
+    cache[3] = vt->n_levels - 1;
+    SCE_RSetProgramParam (SCE_RGetProgramIndex (prog, "sce_vt_cache"), unit);
+    SCE_RSetProgramParam (SCE_RGetProgramIndex (prog, "sce_vt_indirection"),
+                          unit + 1);
+    SCE_RSetProgramParam4fv (SCE_RGetProgramIndex (prog, "sce_vt_size"), 1,
+                             size);
+    SCE_RSetProgramParam4fv (SCE_RGetProgramIndex (prog, "sce_vt_cache_size"),
+                             1, cache);
+}
+
+/**
+ * \brief Gets the number of resident pages of a virtual texture
+ */
+unsigned int SCE_RGetVirtualTextureResidentPages (SCE_RVirtualTexture *vt)
+{
+    return SCE_List_GetSize (&vt->lru);
+}
+
+/** @} */
@@ -0,0 +1,284 @@
+/*------------------------------------------------------------------------------
+    SCEngine - A 3D real time rendering engine written in the C language
+    Copyright (C) 2006-2013  Antony Martin <martin(dot)antony(at)yahoo(dot)fr>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/* created: 19/10/2026
+   updated: 19/10/2026 */
+
+#include <unistd.h>
+#include <pthread.h>
+#include <SCE/utils/SCEUtils.h>
+#include "SCE/renderer/SCERWorker.h"
+
+/**
+ * \file SCERWorker.c
+ * \copydoc worker
+ *
+ * \file SCERWorker.h
+ * \copydoc worker
+ */
+
+/**
+ * \defgroup worker Worker threads
+ * \ingroup renderer-gl
+ * \brief Pool of threads for the CPU side work of the renderer
+ *
+ * The pool runs jobs that don't touch the GL: pixel copies into mapped
+ * buffers, image decoding, mipmaps generation, conversions... It starts one
+ * thread less than the number of processors, the calling thread takes part
+ * in the work when it waits for a job. Without worker threads, jobs run
+ * when they are waited for.
+ * @{
+ */
+
+enum {
+    SCE_JOB_IDLE,
+    SCE_JOB_QUEUED,
+    SCE_JOB_RUNNING,
+    SCE_JOB_DONE
+};
+
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t queued_cond = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t done_cond = PTHREAD_COND_INITIALIZER;
+static pthread_t threads[SCE_MAX_WORKERS];
+static unsigned int n_threads = 0;
+static int quit = SCE_FALSE;
+static SCE_RWorkerJob *first = NULL, *last = NULL;
+
+
+/* called with the mutex locked */
+static SCE_RWorkerJob* SCE_RPopWorkerJob (void)
+{
+    SCE_RWorkerJob *job = first;
+    if (job) {
+        first = job->next;
+        if (!first)
+            last = NULL;
+        job->next = NULL;
+        job->state = SCE_JOB_RUNNING;
+    }
+    return job;
+}
+/* called with the mutex locked, unlocks it while running the job */
+static void SCE_RRunWorkerJob (SCE_RWorkerJob *job)
+{
+    pthread_mutex_unlock (&mutex);
+    job->fun (job->data);
+    pthread_mutex_lock (&mutex);
+    job->state = SCE_JOB_DONE;
+    pthread_cond_broadcast (&done_cond);
+}
+
+static void* SCE_RWorkerThread (void *unused)
+{
+    (void)unused;
+    pthread_mutex_lock (&mutex);
+    while (!quit) {
+        SCE_RWorkerJob *job = SCE_RPopWorkerJob ();
+        if (job)
+            SCE_RRunWorkerJob (job);
+        else
+            pthread_cond_wait (&queued_cond, &mutex);
+    }
+    pthread_mutex_unlock (&mutex);
+    return NULL;
+}
+
+
+static void SCE_RStartWorkers (unsigned int n)
+{
+    if (n > SCE_MAX_WORKERS)
+        n = SCE_MAX_WORKERS;
+    quit = SCE_FALSE;
+    for (n_threads = 0; n_threads < n; n_threads++) {
+        if (pthread_create (&threads[n_threads], NULL, SCE_RWorkerThread,
+                            NULL) != 0) {
+            /* run with the threads we got */
+            SCEE_SendMsg ("SCERWorker: failed to start worker thread %u\n",
+                          n_threads);
+            break;
+        }
+    }
+}
+
+int SCE_RWorkerInit (void)
+{
+    long n = sysconf (_SC_NPROCESSORS_ONLN) - 1;
+
+    first = last = NULL;
+    SCE_RStartWorkers (n < 0 ? 0 : n);
+    return SCE_OK;
+}
+void SCE_RWorkerQuit (void)
+{
+    unsigned int i;
+
+    pthread_mutex_lock (&mutex);
+    quit = SCE_TRUE;
+    pthread_cond_broadcast (&queued_cond);
+    pthread_mutex_unlock (&mutex);
+    for (i = 0; i < n_threads; i++)
+        pthread_join (threads[i], NULL);
+    n_threads = 0;
+
+    /* jobs left in the queue still have to complete */
+    pthread_mutex_lock (&mutex);
+    while (first)
+        SCE_RRunWorkerJob (SCE_RPopWorkerJob ());
+    pthread_mutex_unlock (&mutex);
+}
+
+/**
+ * \brief Restarts the pool with another number of threads
+ * \param n number of worker threads, at most #SCE_MAX_WORKERS, 0 to run
+ *        the jobs on the waiting threads only
+ *
+ * The queued jobs are done first. Mostly useful to measure how some work
+ * scales with the number of threads.
+ */
+void SCE_RSetNumWorkers (unsigned int n)
+{
+    SCE_RWorkerQuit ();
+    SCE_RStartWorkers (n);
+}
+/**
+ * \brief Gets the number of worker threads
+ */
+unsigned int SCE_RGetNumWorkers (void)
+{
+    return n_threads;
+}
+
+
+void SCE_RInitWorkerJob (SCE_RWorkerJob *job, SCE_FWorkerJob fun, void *data)
+{
+    job->fun = fun;
+    job->data = data;
+    job->state = SCE_JOB_IDLE;
+    job->next = NULL;
+}
+
+/**
+ * \brief Queues a job
+ * \param job an idle or done job, it must remain valid until it is done
+ * \sa SCE_RIsWorkerJobDone(), SCE_RWaitWorkerJob()
+ */
+void SCE_RPushWorkerJob (SCE_RWorkerJob *job)
+{
+    pthread_mutex_lock (&mutex);
+    job->state = SCE_JOB_QUEUED;
+    job->next = NULL;
+    if (last)
+        last->next = job;
+    else
+        first = job;
+    last = job;
+    pthread_cond_signal (&queued_cond);
+    pthread_mutex_unlock (&mutex);
+}
+
+/**
+ * \brief Checks whether a job is done, never blocks
+ */
+int SCE_RIsWorkerJobDone (SCE_RWorkerJob *job)
+{
+    int done;
+    pthread_mutex_lock (&mutex);
+    done = (job->state == SCE_JOB_DONE);
+    pthread_mutex_unlock (&mutex);
+    return done;
+}
+
+/**
+ * \brief Waits for a job to complete
+ *
+ * The calling thread runs queued jobs while waiting, so waiting from a job
+ * or without worker threads doesn't deadlock. Waiting for an idle job
+ * returns immediately.
+ */
+void SCE_RWaitWorkerJob (SCE_RWorkerJob *job)
+{
+    pthread_mutex_lock (&mutex);
+    while (job->state == SCE_JOB_QUEUED || job->state == SCE_JOB_RUNNING) {
+        SCE_RWorkerJob *j = SCE_RPopWorkerJob ();
+        if (j)
+            SCE_RRunWorkerJob (j);
+        else
+            pthread_cond_wait (&done_cond, &mutex);
+    }
+    pthread_mutex_unlock (&mutex);
+}
+
+
+typedef struct {
+    SCE_RWorkerJob job;
+    SCE_FWorkerRange fun;
+    size_t begin, end;
+    void *data;
+} SCE_RWorkerRange;
+
+static void SCE_RRunWorkerRange (void *r)
+{
+    SCE_RWorkerRange *range = r;
+    range->fun (range->begin, range->end, range->data);
+}
+
+/**
+ * \brief Runs a loop over the worker threads
+ * \param n number of iterations
+ * \param grain minimum number of iterations per job, 0 for 1
+ * \param fun loop body, called on sub ranges of [0, n[
+ * \param data given to \p fun
+ *
+ * Returns when all the iterations are done.
+ */
+void SCE_RParallelFor (size_t n, size_t grain, SCE_FWorkerRange fun,
+                       void *data)
+{
+    SCE_RWorkerRange ranges[SCE_MAX_WORKERS + 1];
+    size_t i, n_jobs, step;
+
+    if (grain == 0)
+        grain = 1;
+    n_jobs = n_threads + 1;
+    if (n_jobs > (n + grain - 1) / grain)
+        n_jobs = (n + grain - 1) / grain;
+    if (n_jobs <= 1) {
+        if (n > 0)
+            fun (0, n, data);
+        return;
+    }
+
+    step = (n + n_jobs - 1) / n_jobs;
+    n_jobs = (n + step - 1) / step;
+    for (i = 0; i < n_jobs; i++) {
+        ranges[i].fun = fun;
+        ranges[i].data = data;
+        ranges[i].begin = i * step;
+        ranges[i].end = (i + 1) * step < n ? (i + 1) * step : n;
+        SCE_RInitWorkerJob (&ranges[i].job, SCE_RRunWorkerRange, &ranges[i]);
+    }
+    /* the last range is run by the calling thread */
+    for (i = 0; i + 1 < n_jobs; i++)
+        SCE_RPushWorkerJob (&ranges[i].job);
+    SCE_RRunWorkerRange (&ranges[n_jobs - 1]);
+    for (i = 0; i + 1 < n_jobs; i++)
+        SCE_RWaitWorkerJob (&ranges[i].job);
+}
+
+/** @} */
@@ -69,9 +69,19 @@ int SCE_RInit (FILE *outlog, SCEbitfield flags)
             SCE_RSupportInit () < 0 ||
             SCE_RBufferInit () < 0 ||
             SCE_RVertexArrayInit () < 0 ||
+            SCE_RWorkerInit () < 0 ||
+            SCE_RMipmapInit () < 0 ||
             SCE_RTextureInit () < 0 ||
+            SCE_RSamplerInit () < 0 ||
+            SCE_RTextureStreamInit () < 0 ||
+            SCE_RTextureBudgetInit () < 0 ||
+            SCE_RTextureRealizeInit () < 0 ||
+            SCE_RUploadInit () < 0 ||
             SCE_RFramebufferInit () < 0 ||
             SCE_RShaderInit () < 0 ||
+            SCE_RShaderVariantInit () < 0 ||
+            SCE_RVideoTextureInit () < 0 ||
+            SCE_RVirtualTextureInit () < 0 ||
             SCE_ROcclusionQueryInit () < 0) {
             ret = SCE_ERROR;
         } else {
@@ -104,10 +114,20 @@ void SCE_RQuit (void)
         if (init_n < 0) {
             init_n = 0;         /* user made an useless call */
         } else if (init_n == 0) {
+            SCE_RUploadQuit ();
             SCE_ROcclusionQueryQuit ();
+            SCE_RVirtualTextureQuit ();
+            SCE_RVideoTextureQuit ();
+            SCE_RShaderVariantQuit ();
             SCE_RShaderQuit ();
             SCE_RFramebufferQuit ();
+            SCE_RTextureRealizeQuit ();
+            SCE_RTextureBudgetQuit ();
+            SCE_RTextureStreamQuit ();
+            SCE_RSamplerQuit ();
             SCE_RTextureQuit ();
+            SCE_RMipmapQuit ();
+            SCE_RWorkerQuit ();
             SCE_RVertexArrayQuit ();
             SCE_RBufferQuit ();
             SCE_RSupportQuit ();
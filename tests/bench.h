@@ -0,0 +1,61 @@
+/*------------------------------------------------------------------------------
+    SCEngine - A 3D real time rendering engine written in the C language
+    Copyright (C) 2006-2013  Antony Martin <martin(dot)antony(at)yahoo(dot)fr>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/* created: 19/10/2026
+   updated: 19/10/2026 */
+
+/* Helpers shared by the benchmark programs of the tests directory: a
+   monotonic clock, and the numbers of threads to measure the scaling with,
+   1, 2, 4... up to the number of processors. */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <time.h>
+#include <unistd.h>
+#include "SCE/renderer/SCERWorker.h"
+
+#define BENCH_RUNS 5            /* the best run is reported */
+
+static double bench_time (void)
+{
+    struct timespec t;
+    clock_gettime (CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+static int bench_max_threads (void)
+{
+    long n = sysconf (_SC_NPROCESSORS_ONLN);
+    return (int)MAX (1, MIN (n, SCE_MAX_WORKERS + 1));
+}
+/* next number of threads to measure, 0 when done */
+static int bench_next_threads (int n)
+{
+    int max = bench_max_threads ();
+    if (n >= max)
+        return 0;
+    return MIN (n * 2, max);
+}
+/* the calling thread takes part in the work, one worker thread less */
+static void bench_set_threads (int n)
+{
+    SCE_RSetNumWorkers (n - 1);
+}
+
+#endif /* guard */
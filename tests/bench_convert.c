@@ -0,0 +1,131 @@
+/*------------------------------------------------------------------------------
+    SCEngine - A 3D real time rendering engine written in the C language
+    Copyright (C) 2006-2013  Antony Martin <martin(dot)antony(at)yahoo(dot)fr>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/* created: 19/10/2026
+   updated: 19/10/2026 */
+
+/* Throughput of SCE_RConvertImage() for the conversions that have their own
+   kernels and for the generic float path, for each number of threads, in
+   millions of pixels per second. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <SCE/utils/SCEUtils.h>
+#include "SCE/renderer/SCERWorker.h"
+#include "SCE/renderer/SCERConvert.h"
+#include "bench.h"
+
+#define SIZE 2048
+
+typedef struct {
+    const char *name;
+    SCE_EImageFormat sfmt;
+    SCE_EType stype;
+    SCE_EImageFormat dfmt;
+    SCE_EType dtype;
+    int flags;
+} bench_case;
+
+static const bench_case cases[] = {
+    {"RGB8 -> RGBA8", SCE_IMAGE_RGB, SCE_UNSIGNED_BYTE,
+     SCE_IMAGE_RGBA, SCE_UNSIGNED_BYTE, 0},
+    {"BGRA8 -> RGBA8", SCE_IMAGE_BGRA, SCE_UNSIGNED_BYTE,
+     SCE_IMAGE_RGBA, SCE_UNSIGNED_BYTE, 0},
+    {"RGBA8 premultiply", SCE_IMAGE_RGBA, SCE_UNSIGNED_BYTE,
+     SCE_IMAGE_RGBA, SCE_UNSIGNED_BYTE, SCE_CONVERT_PREMULTIPLY},
+    {"RGBA32F -> RGBA16F", SCE_IMAGE_RGBA, SCE_FLOAT,
+     SCE_IMAGE_RGBA, SCE_HALF_FLOAT, 0},
+    {"RGBA16F -> RGBA32F", SCE_IMAGE_RGBA, SCE_HALF_FLOAT,
+     SCE_IMAGE_RGBA, SCE_FLOAT, 0},
+    {"RGB16F -> RGBA8", SCE_IMAGE_RGB, SCE_HALF_FLOAT,
+     SCE_IMAGE_RGBA, SCE_UNSIGNED_BYTE, 0}
+};
+
+/* best time of BENCH_RUNS conversions, negative on error */
+static double bench_convert (const bench_case *c, const void *src,
+                             void *dst)
+{
+    double best = -1.0;
+    int i;
+
+    for (i = 0; i < BENCH_RUNS; i++) {
+        double t = bench_time ();
+        if (SCE_RConvertImage (src, c->sfmt, c->stype, SIZE, SIZE, c->dfmt,
+                               c->dtype, c->flags, dst) < 0)
+            return -1.0;
+        t = bench_time () - t;
+        if (best < 0.0 || t < best)
+            best = t;
+    }
+    return best;
+}
+
+int main (void)
+{
+    /* the largest pixel is RGBA32F */
+    const size_t size = (size_t)SIZE * SIZE * 4 * sizeof (float);
+    unsigned char *src = NULL, *dst = NULL;
+    size_t i;
+    int n;
+
+    if (SCE_Init_Utils (stderr) < 0 || SCE_RWorkerInit () < 0) {
+        fprintf (stderr, "initialization failed\n");
+        return EXIT_FAILURE;
+    }
+    src = malloc (size);
+    dst = malloc (size);
+    if (!src || !dst) {
+        fprintf (stderr, "out of memory\n");
+        return EXIT_FAILURE;
+    }
+
+    printf ("%-20s %8s %10s\n", "conversion", "threads", "Mpix/s");
+    for (i = 0; i < sizeof cases / sizeof *cases; i++) {
+        const bench_case *c = &cases[i];
+        size_t j;
+        /* finite values in [0, 1] whatever the source type */
+        if (c->stype == SCE_FLOAT) {
+            float *f = (float*)src;
+            for (j = 0; j < size / sizeof *f; j++)
+                f[j] = (j * 2654435761u >> 24) / 255.0f;
+        } else if (c->stype == SCE_HALF_FLOAT) {
+            unsigned short *h = (unsigned short*)src;
+            for (j = 0; j < size / sizeof *h; j++)
+                h[j] = SCE_RFloatToHalf ((j * 2654435761u >> 24) / 255.0f);
+        } else {
+            for (j = 0; j < size; j++)
+                src[j] = (unsigned char)(j * 2654435761u >> 24);
+        }
+        for (n = 1; n; n = bench_next_threads (n)) {
+            double t;
+            bench_set_threads (n);
+            if ((t = bench_convert (c, src, dst)) < 0.0) {
+                fprintf (stderr, "conversion failed\n");
+                return EXIT_FAILURE;
+            }
+            printf ("%-20s %8d %10.1f\n", c->name, n,
+                    (double)SIZE * SIZE / t * 1e-6);
+        }
+    }
+
+    free (dst);
+    free (src);
+    SCE_RWorkerQuit ();
+    SCE_Quit_Utils ();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,94 @@
+/*------------------------------------------------------------------------------
+    SCEngine - A 3D real time rendering engine written in the C language
+    Copyright (C) 2006-2013  Antony Martin <martin(dot)antony(at)yahoo(dot)fr>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/* created: 19/10/2026
+   updated: 19/10/2026 */
+
+/* GL context of the benchmarks that load textures: a GLX pixel buffer, so
+   that no window is needed, like the upload test. Xvfb and the Mesa
+   software rasterizer are enough, e.g. xvfb-run ./bench_load */
+
+#ifndef BENCH_GL_H
+#define BENCH_GL_H
+
+#include <GL/glew.h>
+#include <GL/glx.h>
+
+#define BENCH_SKIP 77           /* no X display or GLX 1.3 */
+
+typedef struct {
+    Display *dpy;
+    GLXContext ctx;
+    GLXPbuffer pbuffer;
+} bench_context;
+
+/* creates a context and makes it current, returns SCE_ERROR when the
+   benchmark has to be skipped */
+static int bench_create_context (bench_context *c)
+{
+    static const int fb_attribs[] = {
+        GLX_DRAWABLE_TYPE, GLX_PBUFFER_BIT,
+        GLX_RENDER_TYPE, GLX_RGBA_BIT,
+        GLX_RED_SIZE, 8, GLX_GREEN_SIZE, 8, GLX_BLUE_SIZE, 8,
+        None
+    };
+    static const int pbuffer_attribs[] = {
+        GLX_PBUFFER_WIDTH, 16, GLX_PBUFFER_HEIGHT, 16, None
+    };
+    GLXFBConfig *cfgs = NULL;
+    int n_cfgs = 0, major = 0, minor = 0;
+
+    c->ctx = NULL;
+    c->pbuffer = 0;
+    if (!(c->dpy = XOpenDisplay (NULL))) {
+        fprintf (stderr, "no X display, skipped\n");
+        return SCE_ERROR;
+    }
+    if (!glXQueryVersion (c->dpy, &major, &minor) ||
+        (major == 1 && minor < 3) ||
+        !(cfgs = glXChooseFBConfig (c->dpy, DefaultScreen (c->dpy),
+                                    fb_attribs, &n_cfgs)) || n_cfgs < 1) {
+        fprintf (stderr, "no GLX 1.3 pixel buffer config, skipped\n");
+        goto fail;
+    }
+    c->ctx = glXCreateNewContext (c->dpy, cfgs[0], GLX_RGBA_TYPE, NULL, True);
+    c->pbuffer = glXCreatePbuffer (c->dpy, cfgs[0], pbuffer_attribs);
+    XFree (cfgs);
+    if (!c->ctx || !c->pbuffer ||
+        !glXMakeContextCurrent (c->dpy, c->pbuffer, c->pbuffer, c->ctx)) {
+        fprintf (stderr, "failed to create a GL context, skipped\n");
+        goto fail;
+    }
+    return SCE_OK;
+fail:
+    if (c->pbuffer)
+        glXDestroyPbuffer (c->dpy, c->pbuffer);
+    if (c->ctx)
+        glXDestroyContext (c->dpy, c->ctx);
+    XCloseDisplay (c->dpy);
+    return SCE_ERROR;
+}
+static void bench_delete_context (bench_context *c)
+{
+    glXMakeContextCurrent (c->dpy, None, None, NULL);
+    glXDestroyPbuffer (c->dpy, c->pbuffer);
+    glXDestroyContext (c->dpy, c->ctx);
+    XCloseDisplay (c->dpy);
+}
+
+#endif /* guard */
@@ -0,0 +1,156 @@
+/*------------------------------------------------------------------------------
+    SCEngine - A 3D real time rendering engine written in the C language
+    Copyright (C) 2006-2013  Antony Martin <martin(dot)antony(at)yahoo(dot)fr>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/* created: 19/10/2026
+   updated: 19/10/2026 */
+
+/* Load time of textures made of several image files resized when they are
+   loaded, for each number of threads: the files are decoded in turn, the
+   resamplings and the layer copies run on the worker threads. The images
+   are written as TGA files in a temporary directory. Needs a GL context,
+   see bench_gl.h. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <SCE/utils/SCEUtils.h>
+#include <SCE/core/SCECore.h>
+#include "SCE/renderer/SCERenderer.h"
+#include "bench.h"
+#include "bench_gl.h"
+
+#define SIZE 1024               /* of the files */
+#define LOAD_SIZE 512           /* of the textures */
+#define MAX_FILES 8
+
+typedef struct {
+    const char *name;
+    int type, n_files;
+} bench_case;
+
+static const bench_case cases[] = {
+    {"2D array", SCE_TEX_2D_ARRAY, MAX_FILES},
+    {"cube map", SCE_TEX_CUBE, 6}
+};
+
+/* uncompressed 32 bits TGA, top-left origin */
+static int write_tga (const char *fname, int seed)
+{
+    unsigned char header[18] = {0};
+    unsigned char *p = NULL;
+    FILE *fp = NULL;
+    size_t i, size = (size_t)SIZE * SIZE * 4;
+    int ok;
+
+    if (!(p = malloc (size)))
+        return SCE_ERROR;
+    for (i = 0; i < size; i++)
+        p[i] = (unsigned char)((i + seed) * 2654435761u >> 24);
+    header[2] = 2;
+    header[12] = SIZE & 0xff;
+    header[13] = SIZE >> 8;
+    header[14] = SIZE & 0xff;
+    header[15] = SIZE >> 8;
+    header[16] = 32;
+    header[17] = 0x28;
+    ok = (fp = fopen (fname, "wb")) && fwrite (header, 18, 1, fp) == 1 &&
+        fwrite (p, size, 1, fp) == 1;
+    if (fp && fclose (fp) != 0)
+        ok = SCE_FALSE;
+    free (p);
+    return ok ? SCE_OK : SCE_ERROR;
+}
+
+/* best time of BENCH_RUNS loads, negative on error */
+static double bench_load (const bench_case *c, const char **names)
+{
+    double best = -1.0;
+    int i;
+
+    for (i = 0; i < BENCH_RUNS; i++) {
+        SCE_RTexture *tex = NULL;
+        double t = bench_time ();
+        /* force 2: neither the texture nor the images come from the
+           resource cache */
+        if (!(tex = SCE_RLoadTexturev (c->type, LOAD_SIZE, LOAD_SIZE,
+                                       c->n_files, 2, names)))
+            return -1.0;
+        t = bench_time () - t;
+        SCE_RDeleteTexture (tex);
+        if (best < 0.0 || t < best)
+            best = t;
+    }
+    return best;
+}
+
+int main (void)
+{
+    char dir[] = "/tmp/scebenchXXXXXX";
+    char fnames[MAX_FILES][64];
+    const char *names[MAX_FILES + 1];
+    bench_context ctx;
+    size_t i;
+    int j, n, ret = EXIT_FAILURE;
+
+    if (bench_create_context (&ctx) < 0)
+        return BENCH_SKIP;
+    if (SCE_RInit (stderr, 0) < 0) {
+        fprintf (stderr, "failed to initialize the renderer\n");
+        bench_delete_context (&ctx);
+        return EXIT_FAILURE;
+    }
+    if (!mkdtemp (dir)) {
+        fprintf (stderr, "failed to create a temporary directory\n");
+        goto end;
+    }
+    for (j = 0; j < MAX_FILES; j++) {
+        sprintf (fnames[j], "%s/%d.tga", dir, j);
+        if (write_tga (fnames[j], j) < 0) {
+            fprintf (stderr, "failed to write %s\n", fnames[j]);
+            goto clean;
+        }
+    }
+
+    printf ("%-10s %6s %8s %10s %10s\n", "texture", "files", "threads", "ms",
+            "Mpix/s");
+    for (i = 0; i < sizeof cases / sizeof *cases; i++) {
+        const bench_case *c = &cases[i];
+        for (j = 0; j < c->n_files; j++)
+            names[j] = fnames[j];
+        names[j] = NULL;
+        for (n = 1; n; n = bench_next_threads (n)) {
+            double t;
+            bench_set_threads (n);
+            if ((t = bench_load (c, names)) < 0.0) {
+                fprintf (stderr, "loading failed\n");
+                goto clean;
+            }
+            printf ("%-10s %6d %8d %10.1f %10.1f\n", c->name, c->n_files, n,
+                    t * 1e3, (double)SIZE * SIZE * c->n_files / t * 1e-6);
+        }
+    }
+    ret = EXIT_SUCCESS;
+clean:
+    for (j = 0; j < MAX_FILES; j++)
+        remove (fnames[j]);
+    rmdir (dir);
+end:
+    SCE_RQuit ();
+    bench_delete_context (&ctx);
+    return ret;
+}
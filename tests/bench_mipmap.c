@@ -0,0 +1,123 @@
+/*------------------------------------------------------------------------------
+    SCEngine - A 3D real time rendering engine written in the C language
+    Copyright (C) 2006-2013  Antony Martin <martin(dot)antony(at)yahoo(dot)fr>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/* created: 19/10/2026
+   updated: 19/10/2026 */
+
+/* Throughput of SCE_RDownsampleImage() for a few formats, each filter and
+   number of threads, in millions of source pixels per second. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <SCE/utils/SCEUtils.h>
+#include "SCE/renderer/SCERWorker.h"
+#include "SCE/renderer/SCERConvert.h"
+#include "SCE/renderer/SCERMipmap.h"
+#include "bench.h"
+
+#define SIZE 2048
+
+typedef struct {
+    const char *name;
+    int n_comps;
+    SCE_EType type;
+} bench_format;
+
+static const bench_format formats[] = {
+    {"RGBA8", 4, SCE_UNSIGNED_BYTE},
+    {"RGBA16F", 4, SCE_HALF_FLOAT},
+    {"R8", 1, SCE_UNSIGNED_BYTE},
+    {"RG8", 2, SCE_UNSIGNED_BYTE}
+};
+
+/* best time of BENCH_RUNS downsamplings, negative on error */
+static double bench_mipmap (const bench_format *f, SCE_RMipmapFilter filter,
+                            const void *src, void *dst)
+{
+    double best = -1.0;
+    int i;
+
+    for (i = 0; i < BENCH_RUNS; i++) {
+        double t = bench_time ();
+        if (SCE_RDownsampleImage (src, SIZE, SIZE, f->n_comps, f->type,
+                                  filter, SCE_FALSE, dst) < 0)
+            return -1.0;
+        t = bench_time () - t;
+        if (best < 0.0 || t < best)
+            best = t;
+    }
+    return best;
+}
+
+int main (void)
+{
+    const size_t size = SCE_RGetMipmapLevelSize (SIZE, SIZE, 4,
+                                                 SCE_HALF_FLOAT);
+    unsigned char *src = NULL, *dst = NULL;
+    size_t i;
+    int filter, n;
+
+    if (SCE_Init_Utils (stderr) < 0 || SCE_RWorkerInit () < 0 ||
+        SCE_RMipmapInit () < 0) {
+        fprintf (stderr, "initialization failed\n");
+        return EXIT_FAILURE;
+    }
+    src = malloc (size);
+    dst = malloc (size);
+    if (!src || !dst) {
+        fprintf (stderr, "out of memory\n");
+        return EXIT_FAILURE;
+    }
+
+    printf ("%-10s %-8s %8s %10s\n", "format", "filter", "threads",
+            "Mpix/s");
+    for (i = 0; i < sizeof formats / sizeof *formats; i++) {
+        const bench_format *f = &formats[i];
+        size_t j;
+        /* half floats in [0, 1] */
+        if (f->type == SCE_HALF_FLOAT) {
+            unsigned short *h = (unsigned short*)src;
+            for (j = 0; j < size / sizeof *h; j++)
+                h[j] = SCE_RFloatToHalf ((j * 2654435761u >> 24) / 255.0f);
+        } else {
+            for (j = 0; j < size; j++)
+                src[j] = (unsigned char)(j * 2654435761u >> 24);
+        }
+        for (filter = SCE_MIPMAP_BOX; filter <= SCE_MIPMAP_KAISER;
+             filter++) {
+            for (n = 1; n; n = bench_next_threads (n)) {
+                double t;
+                bench_set_threads (n);
+                if ((t = bench_mipmap (f, filter, src, dst)) < 0.0) {
+                    fprintf (stderr, "downsampling failed\n");
+                    return EXIT_FAILURE;
+                }
+                printf ("%-10s %-8s %8d %10.1f\n", f->name,
+                        filter == SCE_MIPMAP_BOX ? "box" : "kaiser", n,
+                        (double)SIZE * SIZE / t * 1e-6);
+            }
+        }
+    }
+
+    free (dst);
+    free (src);
+    SCE_RMipmapQuit ();
+    SCE_RWorkerQuit ();
+    SCE_Quit_Utils ();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,202 @@
+/*------------------------------------------------------------------------------
+    SCEngine - A 3D real time rendering engine written in the C language
+    Copyright (C) 2006-2013  Antony Martin <martin(dot)antony(at)yahoo(dot)fr>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/* created: 19/10/2026
+   updated: 19/10/2026 */
+
+/* Load time of DDS files mapped by SCE_RLoadTextureFile() against the
+   image loader, which decodes them into an image first; the texture is
+   then built, only its first level is uploaded. The files are written in
+   a temporary directory, they stay in the page cache. Needs a GL context,
+   see bench_gl.h. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <SCE/utils/SCEUtils.h>
+#include <SCE/core/SCECore.h>
+#include "SCE/renderer/SCERenderer.h"
+#include "bench.h"
+#include "bench_gl.h"
+
+#define SIZE 2048
+
+typedef struct {
+    const char *name;
+    int bc1;                    /* DXT1, or 32 bits RGBA */
+} bench_case;
+
+static const bench_case cases[] = {
+    {"DXT1", SCE_TRUE},
+    {"RGBA8", SCE_FALSE}
+};
+
+static void put32 (unsigned char *p, unsigned long v)
+{
+    p[0] = v & 0xff;
+    p[1] = (v >> 8) & 0xff;
+    p[2] = (v >> 16) & 0xff;
+    p[3] = (v >> 24) & 0xff;
+}
+
+/* DDS file with all its levels */
+static int write_dds (const char *fname, int bc1)
+{
+    unsigned char header[128] = {0}, *h = &header[4], *p = NULL;
+    size_t i, size = 0;
+    int w, n_levels = 0, ok;
+    FILE *fp = NULL;
+
+    for (w = SIZE; w > 0; w /= 2, n_levels++)
+        size += bc1 ? (size_t)((w + 3) / 4) * ((w + 3) / 4) * 8 :
+            (size_t)w * w * 4;
+    if (!(p = malloc (size)))
+        return SCE_ERROR;
+    for (i = 0; i < size; i++)
+        p[i] = (unsigned char)(i * 2654435761u >> 24);
+
+    memcpy (header, "DDS ", 4);
+    put32 (h, 124);
+    /* caps, height, width, pixel format, mipmap count, pitch or size */
+    put32 (&h[4], 0x1 | 0x2 | 0x4 | 0x1000 | 0x20000 |
+           (bc1 ? 0x80000 : 0x8));
+    put32 (&h[8], SIZE);
+    put32 (&h[12], SIZE);
+    put32 (&h[16], bc1 ? (SIZE / 4) * (SIZE / 4) * 8 : SIZE * 4);
+    put32 (&h[24], n_levels);
+    put32 (&h[72], 32);
+    if (bc1) {
+        put32 (&h[76], 0x4);    /* four CC */
+        memcpy (&h[80], "DXT1", 4);
+    } else {
+        put32 (&h[76], 0x40 | 0x1); /* RGB, alpha */
+        put32 (&h[84], 32);
+        put32 (&h[88], 0x000000ff);
+        put32 (&h[92], 0x0000ff00);
+        put32 (&h[96], 0x00ff0000);
+        put32 (&h[100], 0xff000000);
+    }
+    put32 (&h[104], 0x1000 | 0x8 | 0x400000); /* texture, complex, mipmap */
+
+    ok = (fp = fopen (fname, "wb")) && fwrite (header, 128, 1, fp) == 1 &&
+        fwrite (p, size, 1, fp) == 1;
+    if (fp && fclose (fp) != 0)
+        ok = SCE_FALSE;
+    free (p);
+    return ok ? SCE_OK : SCE_ERROR;
+}
+
+static SCE_RTexture* load_mapped (const char *fname)
+{
+    return SCE_RLoadTextureFile (fname);
+}
+static SCE_RTexture* load_image (const char *fname)
+{
+    SCE_RTexture *tex = NULL;
+    SCE_SImage *img = NULL;
+
+    if (!(img = SCE_Resource_Load (SCE_Image_GetResourceType (), fname,
+                                   SCE_TRUE, NULL)))
+        return NULL;
+    if (!(tex = SCE_RCreateTexture (SCE_TEX_2D)) ||
+        SCE_RAddTextureImage (tex, 0, img, SCE_TRUE) < 0) {
+        SCE_RDeleteTexture (tex);
+        SCE_Image_Delete (img);
+        return NULL;
+    }
+    return tex;
+}
+
+/* best times of BENCH_RUNS loads, with and without the build; SCE_ERROR
+   on error */
+static int bench_load (SCE_RTexture* (*load)(const char*), const char *fname,
+                       double *load_time, double *build_time)
+{
+    int i;
+
+    *load_time = *build_time = -1.0;
+    for (i = 0; i < BENCH_RUNS; i++) {
+        SCE_RTexture *tex = NULL;
+        double t0 = bench_time (), t1, t2;
+        if (!(tex = load (fname)))
+            return SCE_ERROR;
+        t1 = bench_time ();
+        SCE_RBuildTexture (tex, SCE_FALSE, SCE_FALSE);
+        glFinish ();
+        t2 = bench_time ();
+        SCE_RDeleteTexture (tex);
+        if (*load_time < 0.0 || t1 - t0 < *load_time)
+            *load_time = t1 - t0;
+        if (*build_time < 0.0 || t2 - t0 < *build_time)
+            *build_time = t2 - t0;
+    }
+    return SCE_OK;
+}
+
+int main (void)
+{
+    char dir[] = "/tmp/scebenchXXXXXX";
+    char fname[64];
+    bench_context ctx;
+    size_t i;
+    int ret = EXIT_FAILURE;
+
+    if (bench_create_context (&ctx) < 0)
+        return BENCH_SKIP;
+    if (SCE_RInit (stderr, 0) < 0) {
+        fprintf (stderr, "failed to initialize the renderer\n");
+        bench_delete_context (&ctx);
+        return EXIT_FAILURE;
+    }
+    if (!mkdtemp (dir)) {
+        fprintf (stderr, "failed to create a temporary directory\n");
+        goto end;
+    }
+    sprintf (fname, "%s/bench.dds", dir);
+
+    printf ("%-8s %-8s %12s %14s\n", "format", "loader", "load (ms)",
+            "+ build (ms)");
+    for (i = 0; i < sizeof cases / sizeof *cases; i++) {
+        double lt, bt;
+        if (write_dds (fname, cases[i].bc1) < 0) {
+            fprintf (stderr, "failed to write %s\n", fname);
+            goto clean;
+        }
+        if (bench_load (load_mapped, fname, &lt, &bt) < 0) {
+            fprintf (stderr, "mapping failed\n");
+            goto clean;
+        }
+        printf ("%-8s %-8s %12.2f %14.2f\n", cases[i].name, "mmap",
+                lt * 1e3, bt * 1e3);
+        if (bench_load (load_image, fname, &lt, &bt) < 0) {
+            fprintf (stderr, "image loading failed\n");
+            goto clean;
+        }
+        printf ("%-8s %-8s %12.2f %14.2f\n", cases[i].name, "image",
+                lt * 1e3, bt * 1e3);
+    }
+    ret = EXIT_SUCCESS;
+clean:
+    remove (fname);
+    rmdir (dir);
+end:
+    SCE_RQuit ();
+    bench_delete_context (&ctx);
+    return ret;
+}
@@ -0,0 +1,108 @@
+/*------------------------------------------------------------------------------
+    SCEngine - A 3D real time rendering engine written in the C language
+    Copyright (C) 2006-2013  Antony Martin <martin(dot)antony(at)yahoo(dot)fr>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/* created: 19/10/2026
+   updated: 19/10/2026 */
+
+/* Throughput of SCE_RResampleImage() for each filter and number of threads,
+   on 8 bits RGBA images, in millions of destination pixels per second. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <SCE/utils/SCEUtils.h>
+#include "SCE/renderer/SCERWorker.h"
+#include "SCE/renderer/SCERResample.h"
+#include "bench.h"
+
+#define N_COMPS 4
+
+static const char *filter_names[] = {"box", "mitchell", "lanczos"};
+
+/* best time of BENCH_RUNS resamplings, negative on error */
+static double bench_resample (const unsigned char *src, int w, int h,
+                              int dw, int dh, SCE_RResampleFilter filter,
+                              unsigned char *dst)
+{
+    double best = -1.0;
+    int i;
+
+    for (i = 0; i < BENCH_RUNS; i++) {
+        double t = bench_time ();
+        if (SCE_RResampleImage (src, w, h, 1, N_COMPS, SCE_UNSIGNED_BYTE,
+                                dw, dh, 1, filter, dst) < 0)
+            return -1.0;
+        t = bench_time () - t;
+        if (best < 0.0 || t < best)
+            best = t;
+    }
+    return best;
+}
+
+int main (void)
+{
+    /* a reduction to a non integer ratio and an enlargement */
+    static const int sizes[][4] = {
+        {2048, 2048, 1365, 1365},
+        {1024, 1024, 2048, 2048}
+    };
+    unsigned char *src = NULL, *dst = NULL;
+    size_t i;
+    int f, n;
+
+    if (SCE_Init_Utils (stderr) < 0 || SCE_RWorkerInit () < 0) {
+        fprintf (stderr, "initialization failed\n");
+        return EXIT_FAILURE;
+    }
+    src = malloc (SCE_RGetResampledImageSize (2048, 2048, 1, N_COMPS,
+                                              SCE_UNSIGNED_BYTE));
+    dst = malloc (SCE_RGetResampledImageSize (2048, 2048, 1, N_COMPS,
+                                              SCE_UNSIGNED_BYTE));
+    if (!src || !dst) {
+        fprintf (stderr, "out of memory\n");
+        return EXIT_FAILURE;
+    }
+    for (i = 0; i < (size_t)2048 * 2048 * N_COMPS; i++)
+        src[i] = (unsigned char)(i * 2654435761u >> 24);
+
+    printf ("%-10s %-24s %8s %10s\n", "filter", "size", "threads",
+            "Mpix/s");
+    for (f = SCE_RESAMPLE_BOX; f <= SCE_RESAMPLE_LANCZOS; f++) {
+        for (i = 0; i < sizeof sizes / sizeof *sizes; i++) {
+            const int *s = sizes[i];
+            char size[32];
+            sprintf (size, "%dx%d -> %dx%d", s[0], s[1], s[2], s[3]);
+            for (n = 1; n; n = bench_next_threads (n)) {
+                double t;
+                bench_set_threads (n);
+                t = bench_resample (src, s[0], s[1], s[2], s[3], f, dst);
+                if (t < 0.0) {
+                    fprintf (stderr, "resampling failed\n");
+                    return EXIT_FAILURE;
+                }
+                printf ("%-10s %-24s %8d %10.1f\n", filter_names[f], size, n,
+                        (double)s[2] * s[3] / t * 1e-6);
+            }
+        }
+    }
+
+    free (dst);
+    free (src);
+    SCE_RWorkerQuit ();
+    SCE_Quit_Utils ();
+    return EXIT_SUCCESS;
+}
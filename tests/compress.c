@@ -0,0 +1,260 @@
+/*------------------------------------------------------------------------------
+    SCEngine - A 3D real time rendering engine written in the C language
+    Copyright (C) 2006-2013  Antony Martin <martin(dot)antony(at)yahoo(dot)fr>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/* created: 19/10/2026
+   updated: 19/10/2026 */
+
+/* Image quality regression test of the block compression: an image with
+   smooth gradients and sharp edges is compressed in every format and at
+   every quality, decoded as the GL would and compared to the source. Also
+   reports the encoding speed for each number of threads. The encoder
+   doesn't call the GL, no context is needed. */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <SCE/utils/SCEUtils.h>
+#include "SCE/renderer/SCERWorker.h"
+#include "SCE/renderer/SCERCompress.h"
+#include "bench.h"
+
+#define SIZE 256
+
+static const char *format_names[SCE_NUM_BLOCK_FORMATS] = {
+    "BC1", "BC2", "BC3", "BC4", "BC5"
+};
+static const char *quality_names[] = {"fast", "normal", "high"};
+/* components compared for each format */
+static const int n_channels[SCE_NUM_BLOCK_FORMATS] = {3, 4, 4, 1, 2};
+
+/* minimum PSNR in dB of each format and quality, a few dB under the
+   measured values */
+static const double min_psnr[SCE_NUM_BLOCK_FORMATS][3] = {
+    {33.0, 36.0, 36.0},         /* BC1 */
+    {32.0, 34.0, 34.0},         /* BC2, 4 bits alpha */
+    {33.0, 36.0, 36.0},         /* BC3 */
+    {40.0, 43.0, 43.0},         /* BC4 */
+    {40.0, 43.0, 43.0}          /* BC5 */
+};
+
+static unsigned char* make_image (int w, int h)
+{
+    unsigned char *p = NULL;
+    int x, y, c;
+
+    if (!(p = malloc ((size_t)w * h * 4)))
+        return NULL;
+    for (y = 0; y < h; y++) {
+        for (x = 0; x < w; x++) {
+            double u = (x + 0.5) / w, v = (y + 0.5) / h;
+            for (c = 0; c < 4; c++) {
+                double s = 0.5 + 0.3 * sin (2.0 * M_PI * (2.0 * u + c * 0.3))
+                    * cos (2.0 * M_PI * (1.0 + c) * v);
+                /* a disc with a sharp edge in the middle */
+                if ((u - 0.5) * (u - 0.5) + (v - 0.5) * (v - 0.5) < 0.04)
+                    s = 1.0 - s;
+                p[(y * w + x) * 4 + c] = s * 255.0 + 0.5;
+            }
+        }
+    }
+    return p;
+}
+
+static unsigned int get16 (const unsigned char *p)
+{
+    return p[0] | (p[1] << 8);
+}
+static void unpack565 (unsigned int c, int *out)
+{
+    unsigned int r = (c >> 11) & 31, g = (c >> 5) & 63, b = c & 31;
+    out[0] = (r << 3) | (r >> 2);
+    out[1] = (g << 2) | (g >> 4);
+    out[2] = (b << 3) | (b >> 2);
+}
+
+/* decodes the color part of a block into the RGB components of px */
+static void decode_color (const unsigned char *b, int bc1,
+                          unsigned char px[16][4])
+{
+    unsigned int c0 = get16 (b), c1 = get16 (&b[2]);
+    unsigned int bits = get16 (&b[4]) | ((unsigned int)get16 (&b[6]) << 16);
+    int pal[4][3], i, c;
+
+    unpack565 (c0, pal[0]);
+    unpack565 (c1, pal[1]);
+    for (c = 0; c < 3; c++) {
+        if (c0 > c1 || !bc1) {
+            pal[2][c] = (2 * pal[0][c] + pal[1][c]) / 3;
+            pal[3][c] = (pal[0][c] + 2 * pal[1][c]) / 3;
+        } else {
+            pal[2][c] = (pal[0][c] + pal[1][c]) / 2;
+            pal[3][c] = 0;
+        }
+    }
+    for (i = 0; i < 16; i++)
+        for (c = 0; c < 3; c++)
+            px[i][c] = pal[(bits >> (2 * i)) & 3][c];
+}
+/* decodes an interpolated channel into component c of px */
+static void decode_channel (const unsigned char *b, int c,
+                            unsigned char px[16][4])
+{
+    int a0 = b[0], a1 = b[1], pal[8], i;
+    unsigned long long bits = 0;
+
+    pal[0] = a0;
+    pal[1] = a1;
+    if (a0 > a1) {
+        for (i = 1; i < 7; i++)
+            pal[i + 1] = ((7 - i) * a0 + i * a1 + 3) / 7;
+    } else {
+        for (i = 1; i < 5; i++)
+            pal[i + 1] = ((5 - i) * a0 + i * a1 + 2) / 5;
+        pal[6] = 0;
+        pal[7] = 255;
+    }
+    for (i = 5; i >= 0; i--)
+        bits = (bits << 8) | b[2 + i];
+    for (i = 0; i < 16; i++)
+        px[i][c] = pal[(bits >> (3 * i)) & 7];
+}
+
+static void decode_block (const unsigned char *b, SCE_RBlockFormat bc,
+                          unsigned char px[16][4])
+{
+    int i;
+    switch (bc) {
+    case SCE_BC1:
+        decode_color (b, SCE_TRUE, px);
+        break;
+    case SCE_BC2:
+        for (i = 0; i < 16; i++)
+            px[i][3] = ((b[i / 2] >> (4 * (i & 1))) & 15) * 17;
+        decode_color (&b[8], SCE_FALSE, px);
+        break;
+    case SCE_BC3:
+        decode_channel (b, 3, px);
+        decode_color (&b[8], SCE_FALSE, px);
+        break;
+    case SCE_BC4:
+        decode_channel (b, 0, px);
+        break;
+    case SCE_BC5:
+        decode_channel (b, 0, px);
+        decode_channel (&b[8], 1, px);
+        break;
+    default:;
+    }
+}
+
+/* PSNR of the compressed image over the components of the format */
+static double psnr (const unsigned char *src, const unsigned char *blocks,
+                    SCE_RBlockFormat bc)
+{
+    const size_t size = SCE_RGetCompressedSize (4, 4, bc);
+    const int bw = SIZE / 4;
+    double err = 0.0;
+    int bx, by, x, y, c;
+
+    for (by = 0; by < SIZE / 4; by++) {
+        for (bx = 0; bx < bw; bx++) {
+            unsigned char px[16][4];
+            decode_block (&blocks[(by * bw + bx) * size], bc, px);
+            for (y = 0; y < 4; y++) {
+                for (x = 0; x < 4; x++) {
+                    const unsigned char *s =
+                        &src[((by * 4 + y) * SIZE + bx * 4 + x) * 4];
+                    for (c = 0; c < n_channels[bc]; c++) {
+                        double d = (double)px[y * 4 + x][c] - s[c];
+                        err += d * d;
+                    }
+                }
+            }
+        }
+    }
+    err /= (double)SIZE * SIZE * n_channels[bc];
+    return err > 0.0 ? 10.0 * log10 (255.0 * 255.0 / err) : 100.0;
+}
+
+/* best time of BENCH_RUNS compressions, negative on error */
+static double time_compress (const unsigned char *src, SCE_RBlockFormat bc,
+                             SCE_RCompressQuality q, unsigned char *dst)
+{
+    double best = -1.0;
+    int i;
+
+    for (i = 0; i < BENCH_RUNS; i++) {
+        double t = bench_time ();
+        if (SCE_RCompressImage (src, SIZE, SIZE, SCE_IMAGE_RGBA, bc, q,
+                                dst) < 0)
+            return -1.0;
+        t = bench_time () - t;
+        if (best < 0.0 || t < best)
+            best = t;
+    }
+    return best;
+}
+
+static int test_compress (const unsigned char *src, SCE_RBlockFormat bc,
+                          SCE_RCompressQuality q, unsigned char *dst)
+{
+    double p;
+    int n;
+
+    for (n = 1; n; n = bench_next_threads (n)) {
+        double t;
+        bench_set_threads (n);
+        if ((t = time_compress (src, bc, q, dst)) < 0.0)
+            return SCE_ERROR;
+        printf ("%s %-6s, %d threads: %.2f Mblocks/s\n", format_names[bc],
+                quality_names[q], n, (SIZE / 4) * (SIZE / 4) / t * 1e-6);
+    }
+    p = psnr (src, dst, bc);
+    printf ("%s %-6s: %.2f dB (min %.2f)\n", format_names[bc],
+            quality_names[q], p, min_psnr[bc][q]);
+    return p >= min_psnr[bc][q] ? SCE_OK : SCE_ERROR;
+}
+
+int main (void)
+{
+    unsigned char *src = NULL, *dst = NULL;
+    int failed = 0;
+    int bc, q;
+
+    if (SCE_Init_Utils (stderr) < 0 || SCE_RWorkerInit () < 0) {
+        fprintf (stderr, "initialization failed\n");
+        return EXIT_FAILURE;
+    }
+    src = make_image (SIZE, SIZE);
+    dst = malloc (SCE_RGetCompressedSize (SIZE, SIZE, SCE_BC5));
+    if (!src || !dst) {
+        fprintf (stderr, "out of memory\n");
+        return EXIT_FAILURE;
+    }
+
+    for (bc = SCE_BC1; bc < SCE_NUM_BLOCK_FORMATS; bc++) {
+        for (q = SCE_COMPRESS_FAST; q <= SCE_COMPRESS_HIGH; q++)
+            failed |= test_compress (src, bc, q, dst) < 0;
+    }
+
+    free (dst);
+    free (src);
+    SCE_RWorkerQuit ();
+    SCE_Quit_Utils ();
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,161 @@
+/*------------------------------------------------------------------------------
+    SCEngine - A 3D real time rendering engine written in the C language
+    Copyright (C) 2006-2013  Antony Martin <martin(dot)antony(at)yahoo(dot)fr>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/* created: 19/10/2026
+   updated: 19/10/2026 */
+
+/* Image quality regression test of the resampling and of the CPU mipmap
+   generation: a smooth image is resized with every filter and compared to
+   its exact values at the destination pixels. The functions tested don't
+   call the GL, no context is needed. */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <SCE/utils/SCEUtils.h>
+#include "SCE/renderer/SCERWorker.h"
+#include "SCE/renderer/SCERMipmap.h"
+#include "SCE/renderer/SCERResample.h"
+
+#define N_COMPS 4
+/* 8 bits quantization alone gives about 58 dB, a half pixel shift 35 */
+#define MIN_PSNR 50.0
+
+/* band limited image, component c at (x, y) in [0, 1]^2 */
+static double image (double x, double y, int c)
+{
+    return 0.5 + 0.2 * sin (2.0 * M_PI * (3.0 * x + c * 0.25)) *
+        cos (2.0 * M_PI * 2.0 * y) + 0.15 * sin (2.0 * M_PI * (x + 2.0 * y));
+}
+
+static unsigned char* make_image (int w, int h)
+{
+    unsigned char *p = NULL;
+    int x, y, c;
+
+    if (!(p = malloc ((size_t)w * h * N_COMPS)))
+        return NULL;
+    for (y = 0; y < h; y++) {
+        for (x = 0; x < w; x++) {
+            for (c = 0; c < N_COMPS; c++) {
+                double v = image ((x + 0.5) / w, (y + 0.5) / h, c);
+                p[(y * w + x) * N_COMPS + c] = v * 255.0 + 0.5;
+            }
+        }
+    }
+    return p;
+}
+
+/* PSNR of an image against the exact values at its pixel centers */
+static double psnr (const unsigned char *p, int w, int h)
+{
+    double err = 0.0;
+    int x, y, c;
+
+    for (y = 0; y < h; y++) {
+        for (x = 0; x < w; x++) {
+            for (c = 0; c < N_COMPS; c++) {
+                double ref = image ((x + 0.5) / w, (y + 0.5) / h, c) * 255.0;
+                double d = p[(y * w + x) * N_COMPS + c] - ref;
+                err += d * d;
+            }
+        }
+    }
+    err /= (double)w * h * N_COMPS;
+    return err > 0.0 ? 10.0 * log10 (255.0 * 255.0 / err) : 100.0;
+}
+
+static const char *filter_names[] = {"box", "mitchell", "lanczos"};
+
+static int test_resample (const unsigned char *src, int w, int h, int dw,
+                          int dh, SCE_RResampleFilter filter, double min)
+{
+    unsigned char *dst = NULL;
+    double q;
+
+    if (!(dst = malloc (SCE_RGetResampledImageSize (dw, dh, 1, N_COMPS,
+                                                    SCE_UNSIGNED_BYTE))))
+        return SCE_ERROR;
+    if (SCE_RResampleImage (src, w, h, 1, N_COMPS, SCE_UNSIGNED_BYTE,
+                            dw, dh, 1, filter, dst) < 0) {
+        free (dst);
+        return SCE_ERROR;
+    }
+    q = psnr (dst, dw, dh);
+    free (dst);
+    printf ("resample %dx%d -> %dx%d, %s: %.2f dB (min %.2f)\n",
+            w, h, dw, dh, filter_names[filter], q, min);
+    return q >= min ? SCE_OK : SCE_ERROR;
+}
+
+static int test_mipmap (const unsigned char *src, int w, int h,
+                        SCE_RMipmapFilter filter, double min)
+{
+    unsigned char *dst = NULL;
+    int dw = MAX (w / 2, 1), dh = MAX (h / 2, 1);
+    double q;
+
+    if (!(dst = malloc (SCE_RGetMipmapLevelSize (dw, dh, N_COMPS,
+                                                 SCE_UNSIGNED_BYTE))))
+        return SCE_ERROR;
+    if (SCE_RDownsampleImage (src, w, h, N_COMPS, SCE_UNSIGNED_BYTE, filter,
+                              SCE_FALSE, dst) < 0) {
+        free (dst);
+        return SCE_ERROR;
+    }
+    q = psnr (dst, dw, dh);
+    free (dst);
+    printf ("mipmap %dx%d, %s: %.2f dB (min %.2f)\n", w, h,
+            filter == SCE_MIPMAP_BOX ? "box" : "kaiser", q, min);
+    return q >= min ? SCE_OK : SCE_ERROR;
+}
+
+int main (void)
+{
+    unsigned char *src = NULL;
+    int failed = 0;
+    int f;
+
+    if (SCE_Init_Utils (stderr) < 0 || SCE_RWorkerInit () < 0 ||
+        SCE_RMipmapInit () < 0) {
+        fprintf (stderr, "initialization failed\n");
+        return EXIT_FAILURE;
+    }
+    if (!(src = make_image (256, 192))) {
+        fprintf (stderr, "out of memory\n");
+        return EXIT_FAILURE;
+    }
+
+    for (f = SCE_RESAMPLE_BOX; f <= SCE_RESAMPLE_LANCZOS; f++) {
+        /* integer and non integer reductions, enlargement, one axis only */
+        failed |= test_resample (src, 256, 192, 128, 96, f, MIN_PSNR) < 0;
+        failed |= test_resample (src, 256, 192, 100, 75, f, MIN_PSNR) < 0;
+        failed |= test_resample (src, 256, 192, 256, 61, f, MIN_PSNR) < 0;
+        if (f != SCE_RESAMPLE_BOX) /* nearest when enlarging */
+            failed |= test_resample (src, 256, 192, 400, 300, f,
+                                     MIN_PSNR) < 0;
+    }
+    failed |= test_mipmap (src, 256, 192, SCE_MIPMAP_BOX, MIN_PSNR) < 0;
+    failed |= test_mipmap (src, 256, 192, SCE_MIPMAP_KAISER, MIN_PSNR) < 0;
+
+    free (src);
+    SCE_RMipmapQuit ();
+    SCE_RWorkerQuit ();
+    SCE_Quit_Utils ();
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,332 @@
+/*------------------------------------------------------------------------------
+    SCEngine - A 3D real time rendering engine written in the C language
+    Copyright (C) 2006-2013  Antony Martin <martin(dot)antony(at)yahoo(dot)fr>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+/* created: 19/10/2026
+   updated: 19/10/2026 */
+
+/* Multi-context test of the upload thread: a rendering context and two
+   contexts sharing its objects are created with GLX, on pixel buffers so
+   that no window is needed; Xvfb and the Mesa software rasterizer are
+   enough, e.g. xvfb-run make check. The upload thread is started on each
+   shared context in turn, builds textures and links programs submitted by
+   the rendering thread, which then reads them back. Skipped (exit status
+   77) when no X display or GLX 1.3 is available. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <GL/glew.h>
+#include <GL/glx.h>
+#include <SCE/utils/SCEUtils.h>
+#include <SCE/core/SCECore.h>
+#include "SCE/renderer/SCERenderer.h"
+
+#define SKIP 77
+#define N_CONTEXTS 2            /* shared contexts of the upload thread */
+#define N_TEXTURES 16           /* textures built per upload context */
+#define TEX_SIZE 64
+
+typedef struct {
+    Display *dpy;
+    GLXContext ctx;
+    GLXPbuffer pbuffer;
+} context;
+
+static const char *vs_source =
+    "#version 130\n"
+    "in vec4 sce_position;\n"
+    "void main (void) { gl_Position = sce_position; }\n";
+static const char *ps_source =
+    "#version 130\n"
+    "out vec4 color;\n"
+    "void main (void) { color = vec4 (1.0); }\n";
+/* compiles, but the link fails */
+static const char *ps_broken_source =
+    "#version 130\n"
+    "out vec4 color;\n"
+    "vec4 missing (void);\n"
+    "void main (void) { color = missing (); }\n";
+
+
+static int make_current (void *data)
+{
+    context *c = data;
+    return glXMakeContextCurrent (c->dpy, c->pbuffer, c->pbuffer, c->ctx) ?
+        SCE_OK : SCE_ERROR;
+}
+static int release_current (void *data)
+{
+    context *c = data;
+    glXMakeContextCurrent (c->dpy, None, None, NULL);
+    return SCE_OK;
+}
+
+static int create_context (Display *dpy, GLXFBConfig cfg, GLXContext share,
+                           context *c)
+{
+    static const int pbuffer_attribs[] = {
+        GLX_PBUFFER_WIDTH, 16, GLX_PBUFFER_HEIGHT, 16, None
+    };
+    c->dpy = dpy;
+    c->ctx = glXCreateNewContext (dpy, cfg, GLX_RGBA_TYPE, share, True);
+    c->pbuffer = glXCreatePbuffer (dpy, cfg, pbuffer_attribs);
+    return c->ctx && c->pbuffer ? SCE_OK : SCE_ERROR;
+}
+static void delete_context (context *c)
+{
+    if (c->pbuffer)
+        glXDestroyPbuffer (c->dpy, c->pbuffer);
+    if (c->ctx)
+        glXDestroyContext (c->dpy, c->ctx);
+}
+
+
+static unsigned char texel (int i, int x, int y, int c)
+{
+    return (unsigned char)(i * 31 + x * 7 + y * 13 + c * 61);
+}
+
+static SCE_RTexture* create_texture (int i)
+{
+    SCE_RTexture *tex = NULL;
+    SCE_STexData *d = NULL;
+    unsigned char *p = NULL;
+    int x, y, c;
+
+    if (!(p = SCE_malloc (TEX_SIZE * TEX_SIZE * 4)))
+        return NULL;
+    for (y = 0; y < TEX_SIZE; y++) {
+        for (x = 0; x < TEX_SIZE; x++) {
+            for (c = 0; c < 4; c++)
+                p[(y * TEX_SIZE + x) * 4 + c] = texel (i, x, y, c);
+        }
+    }
+    if (!(d = SCE_TexData_Create ())) {
+        SCE_free (p);
+        return NULL;
+    }
+    SCE_TexData_SetDimensions (d, TEX_SIZE, TEX_SIZE, 0);
+    SCE_TexData_SetPixelFormat (d, SCE_PXF_RGBA);
+    SCE_TexData_SetDataFormat (d, SCE_IMAGE_RGBA);
+    SCE_TexData_SetDataType (d, SCE_UNSIGNED_BYTE);
+    SCE_TexData_SetData (d, p, SCE_TRUE);
+    if (!(tex = SCE_RCreateTexture (SCE_TEX_2D))) {
+        SCE_TexData_Delete (d);
+        return NULL;
+    }
+    SCE_RAddTextureTexData (tex, 0, d);
+    return tex;
+}
+
+/* reads back a texture built by the upload thread */
+static int check_texture (SCE_RTexture *tex, int i)
+{
+    unsigned char p[TEX_SIZE * TEX_SIZE * 4];
+    int x, y, c;
+
+    SCE_RBindTexture (tex);
+    glPixelStorei (GL_PACK_ALIGNMENT, 1);
+    glGetTexImage (GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, p);
+    glPixelStorei (GL_PACK_ALIGNMENT, 4);
+    for (y = 0; y < TEX_SIZE; y++) {
+        for (x = 0; x < TEX_SIZE; x++) {
+            for (c = 0; c < 4; c++) {
+                if (p[(y * TEX_SIZE + x) * 4 + c] != texel (i, x, y, c)) {
+                    fprintf (stderr, "texture %d: wrong texel at %d, %d\n",
+                             i, x, y);
+                    return SCE_ERROR;
+                }
+            }
+        }
+    }
+    return SCE_OK;
+}
+
+static SCE_RProgram* create_program (SCE_RShaderGLSL *vs,
+                                     SCE_RShaderGLSL *ps)
+{
+    SCE_RProgram *prog = NULL;
+
+    if (!(prog = SCE_RCreateProgram ()))
+        return NULL;
+    if (SCE_RSetProgramShader (prog, vs, SCE_TRUE) < 0 ||
+        SCE_RSetProgramShader (prog, ps, SCE_TRUE) < 0) {
+        SCE_RDeleteProgram (prog);
+        return NULL;
+    }
+    return prog;
+}
+static SCE_RShaderGLSL* create_shader (SCE_RShaderType type, const char *src)
+{
+    SCE_RShaderGLSL *shader = NULL;
+
+    if (!(shader = SCE_RCreateShaderGLSL (type)))
+        return NULL;
+    SCE_RSetShaderGLSLSource (shader, (char*)src);
+    if (SCE_RBuildShaderGLSL (shader) < 0) {
+        SCE_RDeleteShaderGLSL (shader);
+        return NULL;
+    }
+    return shader;
+}
+
+/* submits textures and programs to the upload thread running on the
+   current upload context and checks them from the rendering thread */
+static int test_uploads (int n)
+{
+    SCE_RTexture *tex[N_TEXTURES] = {NULL};
+    SCE_RUpload up[N_TEXTURES], prog_up, broken_up;
+    SCE_RShaderGLSL *vs = NULL, *ps = NULL, *broken_ps = NULL;
+    SCE_RProgram *prog = NULL, *broken = NULL;
+    GLint linked = GL_FALSE;
+    int i, ret = SCE_ERROR;
+
+    SCE_RInitUpload (&prog_up);
+    SCE_RInitUpload (&broken_up);
+    if (!(vs = create_shader (SCE_VERTEX_SHADER, vs_source)) ||
+        !(ps = create_shader (SCE_PIXEL_SHADER, ps_source)) ||
+        !(broken_ps = create_shader (SCE_PIXEL_SHADER, ps_broken_source)) ||
+        !(prog = create_program (vs, ps)) ||
+        !(broken = create_program (vs, broken_ps)))
+        goto end;
+
+    for (i = 0; i < N_TEXTURES; i++) {
+        if (!(tex[i] = create_texture (n * N_TEXTURES + i)))
+            goto end;
+        SCE_RInitUpload (&up[i]);
+        SCE_RSubmitTexture (&up[i], tex[i], SCE_FALSE, SCE_FALSE);
+    }
+    SCE_RSubmitProgram (&prog_up, prog);
+    SCE_RSubmitProgram (&broken_up, broken);
+
+    /* the rendering context keeps working meanwhile */
+    glClear (GL_COLOR_BUFFER_BIT);
+
+    for (i = 0; i < N_TEXTURES; i++) {
+        SCE_RWaitUpload (&up[i]);
+        if (check_texture (tex[i], n * N_TEXTURES + i) < 0)
+            goto end;
+    }
+    while (!SCE_RIsUploadReady (&prog_up))
+        ;
+    SCE_RWaitUpload (&broken_up);
+    glGetProgramiv (prog->id, GL_LINK_STATUS, &linked);
+    if (SCE_RGetUploadStatus (&prog_up) < 0 || !linked) {
+        fprintf (stderr, "the program failed to link\n");
+        goto end;
+    }
+    if (SCE_RGetUploadStatus (&broken_up) != SCE_ERROR) {
+        fprintf (stderr, "the link error wasn't reported\n");
+        goto end;
+    }
+    if (glGetError () != GL_NO_ERROR) {
+        fprintf (stderr, "GL error on the rendering context\n");
+        goto end;
+    }
+    ret = SCE_OK;
+end:
+    /* nothing can be deleted while the upload thread uses it */
+    for (i = 0; i < N_TEXTURES; i++) {
+        if (tex[i])
+            SCE_RWaitUpload (&up[i]);
+        SCE_RDeleteTexture (tex[i]);
+    }
+    SCE_RWaitUpload (&prog_up);
+    SCE_RWaitUpload (&broken_up);
+    SCE_RDeleteProgram (broken);
+    SCE_RDeleteProgram (prog);
+    SCE_RDeleteShaderGLSL (broken_ps);
+    SCE_RDeleteShaderGLSL (ps);
+    SCE_RDeleteShaderGLSL (vs);
+    return ret;
+}
+
+int main (void)
+{
+    static const int fb_attribs[] = {
+        GLX_DRAWABLE_TYPE, GLX_PBUFFER_BIT,
+        GLX_RENDER_TYPE, GLX_RGBA_BIT,
+        GLX_RED_SIZE, 8, GLX_GREEN_SIZE, 8, GLX_BLUE_SIZE, 8,
+        None
+    };
+    Display *dpy = NULL;
+    GLXFBConfig *cfgs = NULL;
+    context render = {NULL, NULL, 0}, upload[N_CONTEXTS];
+    int i, n_cfgs = 0, major = 0, minor = 0, ret = SKIP;
+
+    for (i = 0; i < N_CONTEXTS; i++) {
+        upload[i].ctx = NULL;
+        upload[i].pbuffer = 0;
+    }
+    if (!(dpy = XOpenDisplay (NULL))) {
+        fprintf (stderr, "no X display, skipped\n");
+        return SKIP;
+    }
+    if (!glXQueryVersion (dpy, &major, &minor) ||
+        (major == 1 && minor < 3) ||
+        !(cfgs = glXChooseFBConfig (dpy, DefaultScreen (dpy), fb_attribs,
+                                    &n_cfgs)) || n_cfgs < 1) {
+        fprintf (stderr, "no GLX 1.3 pixel buffer config, skipped\n");
+        goto end;
+    }
+    if (create_context (dpy, cfgs[0], NULL, &render) < 0) {
+        fprintf (stderr, "failed to create the rendering context, skipped\n");
+        goto end;
+    }
+    for (i = 0; i < N_CONTEXTS; i++) {
+        if (create_context (dpy, cfgs[0], render.ctx, &upload[i]) < 0) {
+            fprintf (stderr, "failed to create a shared context, skipped\n");
+            goto end;
+        }
+    }
+    if (make_current (&render) < 0)
+        goto end;
+
+    ret = EXIT_FAILURE;
+    if (SCE_RInit (stderr, 0) < 0) {
+        fprintf (stderr, "failed to initialize the renderer\n");
+        goto end;
+    }
+    /* the same rendering context with each upload context in turn */
+    for (i = 0; i < N_CONTEXTS; i++) {
+        if (SCE_RStartUploadThread (make_current, release_current,
+                                    &upload[i]) < 0) {
+            fprintf (stderr, "failed to start the upload thread\n");
+            break;
+        }
+        if (!SCE_RHasUploadThread () || SCE_RIsUploadThread () ||
+            test_uploads (i) < 0) {
+            SCE_RStopUploadThread ();
+            break;
+        }
+        SCE_RStopUploadThread ();
+        printf ("upload context %d: %d textures and 2 programs checked\n",
+                i, N_TEXTURES);
+    }
+    if (i == N_CONTEXTS)
+        ret = EXIT_SUCCESS;
+    SCE_RQuit ();
+end:
+    release_current (&render);
+    for (i = 0; i < N_CONTEXTS; i++)
+        delete_context (&upload[i]);
+    delete_context (&render);
+    if (cfgs)
+        XFree (cfgs);
+    XCloseDisplay (dpy);
+    return ret;
+}